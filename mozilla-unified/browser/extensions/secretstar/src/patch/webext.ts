@@ -14,6 +14,9 @@ if (typeof browser === "undefined" || browser.berytus === undefined) {
         berytus: {
             unregisterRequestHandler: dummy,
             registerRequestHandler: dummy,
+            signingKeyRotated: dummyAsync,
+            generatePassword: dummyAsync,
+            generatePasswords: dummyAsync,
             resolveRequest: dummyAsync,
             rejectRequest: dummyAsync
         },
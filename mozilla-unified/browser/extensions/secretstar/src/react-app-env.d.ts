@@ -8,6 +8,9 @@ declare global {
             //enum: IEnumDictionary,
             registerRequestHandler(requestHandler: IUnderlyingRequestHandler): void,
             unregisterRequestHandler(): void,
+            signingKeyRotated(): Promise<void>,
+            generatePassword(passwordRules: string): Promise<string>,
+            generatePasswords(passwordRules: string, count: number): Promise<string[]>,
             resolveRequest(requestId: string, value: unknown): Promise<void>,
             rejectRequest(requestId: string, value: unknown): Promise<void>,
         }
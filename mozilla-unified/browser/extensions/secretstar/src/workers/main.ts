@@ -8,7 +8,7 @@ import { PAGECONTEXT_POPUP } from "@root/pagecontext";
 import { ab2base64, base64ToArrayBuffer } from "@root/key-utils";
 import { Channel, isChannelE2EReady } from "@root/db/Channel";
 import { ERejectionCode, EOperationType, EMetadataStatus, RequestType } from "@berytus/enums";
-import type { KeyAgreementParameters, PreliminaryRequestContext } from "@berytus/types";
+import type { KeyAgreementParameters, PreliminaryRequestContext, SignKeyAgreementParametersArgs, WebAppActor } from "@berytus/types";
 import { userAttributesLabels } from "@root/ui/utils/userAttributesLabels";
 import { stringifyArrayBufferOrEncryptedPacket, stringifyEncryptedPacket } from "./field-utils";
 import { openPageActionPopupIfNecessary } from "./pageAction-popup-fix";
@@ -69,27 +69,203 @@ async function showUi(
     );
 }
 
+/**
+ * Parses the CanonicalJSON-stringified key agreement parameters
+ * and ensures they match what was recorded for the channel.
+ */
+function parseKeyAgreementParameters(
+    channel: Channel,
+    canonicalJson: string
+): KeyAgreementParameters {
+    const parameters: KeyAgreementParameters = (() => {
+        const obj = JSON.parse(canonicalJson);
+        obj.session.fingerprint.salt =
+            new Uint8Array(obj.session.fingerprint.salt).buffer;
+        obj.session.fingerprint.value =
+            new Uint8Array(obj.session.fingerprint.value).buffer;
+        obj.derivation.salt =
+            new Uint8Array(obj.derivation.salt).buffer;
+        obj.derivation.info =
+            new Uint8Array(obj.derivation.info).buffer;
+        return obj;
+    })();
+    if (parameters.authentication.public.scm !== channel.scmEd25519?.public) {
+        throw new Error("Crypto scm actor mismatch");
+    }
+    if (parameters.authentication.public.webApp !== channel.webAppEd25519Pub) {
+        throw new Error("Crypto web app actor mismatch");
+    }
+    if (parameters.exchange.public.scm !== channel.scmX25519?.public) {
+        throw new Error("Scm X25519 mismatch");
+    }
+    return parameters;
+}
+
+/**
+ * Signs the key agreement parameters of the channel using
+ * our Ed25519 key.
+ */
+async function signKeyAgreementParameters(
+    channelId: string,
+    args: SignKeyAgreementParametersArgs
+): Promise<ArrayBuffer> {
+    const channel = await db.channel.get(channelId);
+    if (! channel) {
+        throw new Error('Unable to find channel by id ' + channelId);
+    }
+    if (! channel.scmEd25519) {
+        throw new Error('Expecting our scm ed25519Key to have been genenrated');
+    }
+    if (! channel.scmX25519) {
+        throw new Error('Expecting our scm scmX25519 to have been genenrated');
+    }
+    if (! channel.webAppEd25519Pub) {
+        throw new Error('Expecting web app ed25519 to have been given previously');
+    }
+    if (! channel.keyAgreement) {
+        // NOTE(berytus): Berytus verifies the web app signature
+        // itself and, by default, does not send a
+        // verifySignedKeyExchangeParameters request.
+        channel.keyAgreement = {
+            parameters: parseKeyAgreementParameters(
+                channel,
+                args.canonicalJson
+            ),
+            signatures: {
+                canonicalJson: args.canonicalJson,
+                webAppSignature: args.webAppSignature
+            }
+        };
+        await db.channel.update(channel, {
+            keyAgreement: channel.keyAgreement
+        });
+    }
+    if (channel.keyAgreement.signatures.scmSignature) {
+        throw new Error('Expecting our scm signature to be unset; got otherwise.');
+    }
+    if (channel.keyAgreement.signatures.canonicalJson !== args.canonicalJson) {
+        throw new Error('Expecting our stored key agreement JSON to match what was provided; got otherwise.');
+    }
+    const ed25519Key = await window.crypto.subtle.importKey(
+        'pkcs8',
+        channel.scmEd25519.private,
+        "Ed25519",
+        false,
+        ['sign']
+    );
+    const scmSignature = await window.crypto.subtle.sign(
+        "Ed25519",
+        ed25519Key,
+        new TextEncoder().encode(args.canonicalJson)
+    );
+    await db.channel.update(channel, {
+        'keyAgreement.signatures.scmSignature': scmSignature
+    });
+    return scmSignature;
+}
+
+/**
+ * Derives the end-to-end encryption key of the channel
+ * from the agreed parameters.
+ */
+async function enableChannelEndToEndEncryption(
+    channelId: string
+): Promise<void> {
+    const channel = await db.channel.get(channelId);
+    if (! channel) {
+        throw new Error('Expecting channel to be created; got otherwise.');
+    }
+    if (! isChannelE2EReady(channel)) {
+        throw new Error('Expecting channel to be E2E ready; got otherwise.');
+    }
+    const webAppKey = await crypto.subtle.importKey(
+        'spki',
+        // @ts-ignore: NOTE(berytus): Firefox only
+        Uint8Array.fromBase64(channel.keyAgreement.parameters.exchange.public.webApp),
+        'X25519',
+        false,
+        []
+    );
+    const scmKey = await window.crypto.subtle.importKey(
+        'pkcs8',
+        channel.scmX25519.private,
+        "X25519",
+        false,
+        ['deriveKey']
+    );
+    const sharedKey = await crypto.subtle.deriveKey(
+        {
+            name: "X25519",
+            public: webAppKey
+        },
+        scmKey,
+        'HKDF',
+        false,
+        ['deriveKey']
+    );
+    const encryptionKey = await crypto.subtle.deriveKey(
+        channel.keyAgreement.parameters.derivation,
+        sharedKey,
+        channel.keyAgreement.parameters.generation,
+        true,
+        ['encrypt', 'decrypt']
+    );
+    const change: Pick<Channel, 'e2eeActvie' | 'e2eeKey'> = {
+        e2eeActvie: true,
+        e2eeKey: await window.crypto.subtle.exportKey(
+            "raw",
+            encryptionKey
+        )
+    };
+    await db.channel.update(channel.id, change);
+}
+
+async function getOrCreateSigningKey(): Promise<string> {
+    const keys = await db.signingKeys.toArray();
+    if (keys.length > 0) {
+        return keys[0].public;
+    }
+    const keyPair = await window.crypto.subtle.generateKey(
+        "Ed25519",
+        true,
+        ['sign', 'verify']
+    ) as CryptoKeyPair;
+    const publicKey = ab2base64(
+        await window.crypto.subtle.exportKey("spki", keyPair.publicKey)
+    );
+    await db.signingKeys.add({
+        public: publicKey,
+        private: await window.crypto.subtle.exportKey("pkcs8", keyPair.privateKey)
+    })
+    return publicKey;
+}
+
+async function addChannel(
+    channelId: string,
+    scmEd25519Key: string,
+    webAppActor: WebAppActor
+) {
+    const key = await db.signingKeys.get(scmEd25519Key);
+    if (! key) {
+        throw new Error(
+            'Unable to find signing key '
+            + scmEd25519Key
+        );
+    }
+    await db.channel.add({
+        id: channelId,
+        scmEd25519: key,
+        webAppEd25519Pub: "ed25519Key" in webAppActor
+            ? webAppActor.ed25519Key
+            : undefined,
+        e2eeActvie: false
+    });
+}
+
 browser.berytus.registerRequestHandler({
     manager: {
         async getSigningKey(context, args): Promise<void> {
-            const keys = await db.signingKeys.toArray();
-            if (keys.length > 0) {
-                context.response.resolve(keys[0].public);
-                return;
-            }
-            const keyPair = await window.crypto.subtle.generateKey(
-                "Ed25519",
-                true,
-                ['sign', 'verify']
-            ) as CryptoKeyPair;
-            const publicKey = ab2base64(
-                await window.crypto.subtle.exportKey("spki", keyPair.publicKey)
-            );
-            await db.signingKeys.add({
-                public: publicKey,
-                private: await window.crypto.subtle.exportKey("pkcs8", keyPair.privateKey)
-            })
-            context.response.resolve(publicKey);
+            context.response.resolve(await getOrCreateSigningKey());
         },
         async getCredentialsMetadata(context, args): Promise<void> {
             const accounts = db.findCorrespondingAccounts(
@@ -102,23 +278,18 @@ browser.berytus.registerRequestHandler({
     },
     channel: {
         async createChannel(context, args) {
-            const key = await db.signingKeys.get(args.channel.scmActor.ed25519Key);
-            if (! key) {
-                throw new Error(
-                    'Unable to find signing key '
-                    + args.channel.scmActor.ed25519Key
-                );
-            }
-            await db.channel.add({
-                id: args.channel.id,
-                scmEd25519: key,
-                webAppEd25519Pub: "ed25519Key" in args.channel.webAppActor
-                    ? args.channel.webAppActor.ed25519Key
-                    : undefined,
-                e2eeActvie: false
-            });
+            await addChannel(
+                args.channel.id,
+                args.channel.scmActor.ed25519Key,
+                args.channel.webAppActor
+            );
             context.response.resolve();
         },
+        async bootstrapChannel(context, args) {
+            const publicKey = await getOrCreateSigningKey();
+            await addChannel(args.channelId, publicKey, args.webAppActor);
+            context.response.resolve(publicKey);
+        },
         async generateX25519Key(context) {
             const channel = await db.channel.get(context.channel.id);
             if (! channel) {
@@ -163,28 +334,10 @@ browser.berytus.registerRequestHandler({
             if (! channel.webAppEd25519Pub) {
                 throw new Error('Expecting channel to have a crypto web app actor set; got otherwise.');
             }
-            const parameters: KeyAgreementParameters = (() => {
-                const obj = JSON.parse(args.canonicalJson);
-                obj.session.fingerprint.salt =
-                    new Uint8Array(obj.session.fingerprint.salt).buffer;
-                obj.session.fingerprint.value =
-                    new Uint8Array(obj.session.fingerprint.value).buffer;
-                obj.derivation.salt =
-                    new Uint8Array(obj.derivation.salt).buffer;
-                obj.derivation.info =
-                    new Uint8Array(obj.derivation.info).buffer;
-                return obj;
-            })();
-            if (parameters.authentication.public.scm !== channel.scmEd25519.public) {
-                throw new Error("Crypto scm actor mismatch");
-            }
-            if (parameters.authentication.public.webApp !== channel.webAppEd25519Pub) {
-                throw new Error("Crypto web app actor mismatch");
-            }
-            if (parameters.exchange.public.scm !== channel.scmX25519.public) {
-
-                throw new Error("Scm X25519 mismatch");
-            }
+            const parameters = parseKeyAgreementParameters(
+                channel,
+                args.canonicalJson
+            );
             const webAppKey = await crypto.subtle.importKey(
                 'spki',
                 base64ToArrayBuffer(parameters.authentication.public.webApp),
@@ -216,43 +369,20 @@ browser.berytus.registerRequestHandler({
             context.response.resolve();
         },
         async signKeyExchangeParameters(context, args) {
-            const channel = await db.channel.get(context.channel.id);
-            if (! channel) {
-                throw new Error('Unable to find channel by id ' + context.channel.id);
-            }
-            if (! channel.scmEd25519) {
-                throw new Error('Expecting our scm ed25519Key to have been genenrated');
-            }
-            if (! channel.scmX25519) {
-                throw new Error('Expecting our scm scmX25519 to have been genenrated');
-            }
-            if (! channel.webAppEd25519Pub) {
-                throw new Error('Expecting web app ed25519 to have been given previously');
-            }
-            if (! channel.keyAgreement) {
-                throw new Error('Expecting key agreement parameters to be set; got otherwise.');
-            }
-            if (channel.keyAgreement.signatures.scmSignature) {
-                throw new Error('Expecting our scm signature to be unset; got otherwise.');
-            }
-            if (channel.keyAgreement.signatures.canonicalJson !== args.canonicalJson) {
-                throw new Error('Expecting our stored key agreement JSON to match what was provided; got otherwise.');
-            }
-            const ed25519Key = await window.crypto.subtle.importKey(
-                'pkcs8',
-                channel.scmEd25519.private,
-                "Ed25519",
-                false,
-                ['sign']
+            const scmSignature = await signKeyAgreementParameters(
+                context.channel.id,
+                args
             );
-            const scmSignature = await window.crypto.subtle.sign(
-                "Ed25519",
-                ed25519Key,
-                new TextEncoder().encode(args.canonicalJson)
-            );
-            await db.channel.update(channel, {
-                'keyAgreement.signatures.scmSignature': scmSignature
+            context.response.resolve({
+                scmSignature
             });
+        },
+        async establishEndToEndEncryption(context, args) {
+            const scmSignature = await signKeyAgreementParameters(
+                context.channel.id,
+                args
+            );
+            await enableChannelEndToEndEncryption(context.channel.id);
             context.response.resolve({
                 scmSignature
             });
@@ -272,53 +402,7 @@ browser.berytus.registerRequestHandler({
             //         url(relativePath, PAGECONTEXT_POPUP)
             //     );
             // }
-            const channel = await db.channel.get(context.channel.id);
-            if (! channel) {
-                throw new Error('Expecting channel to be created; got otherwise.');
-            }
-            if (! isChannelE2EReady(channel)) {
-                throw new Error('Expecting channel to be E2E ready; got otherwise.');
-            }
-            const webAppKey = await crypto.subtle.importKey(
-                'spki',
-                // @ts-ignore: NOTE(berytus): Firefox only
-                Uint8Array.fromBase64(channel.keyAgreement.parameters.exchange.public.webApp),
-                'X25519',
-                false,
-                []
-            );
-            const scmKey = await window.crypto.subtle.importKey(
-                'pkcs8',
-                channel.scmX25519.private,
-                "X25519",
-                false,
-                ['deriveKey']
-            );
-            const sharedKey = await crypto.subtle.deriveKey(
-                {
-                    name: "X25519",
-                    public: webAppKey
-                },
-                scmKey,
-                'HKDF',
-                false,
-                ['deriveKey']
-            );
-            const encryptionKey = await crypto.subtle.deriveKey(
-                channel.keyAgreement.parameters.derivation,
-                sharedKey,
-                channel.keyAgreement.parameters.generation,
-                true,
-                ['encrypt', 'decrypt']
-            );
-            const change: Pick<Channel, 'e2eeActvie' | 'e2eeKey'> = {
-                e2eeActvie: true,
-                e2eeKey: await window.crypto.subtle.exportKey(
-                    "raw",
-                    encryptionKey
-                )
-            };
-            await db.channel.update(channel.id, change);
+            await enableChannelEndToEndEncryption(context.channel.id);
             context.response.resolve();
         },
         closeChannel: function (context): void {
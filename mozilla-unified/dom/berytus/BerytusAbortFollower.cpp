@@ -0,0 +1,96 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/dom/BerytusAbortFollower.h"
+#include "mozilla/berytus/AgentProxy.h"
+#include "mozilla/dom/AbortSignal.h"
+#include "mozilla/dom/Promise.h"
+#include "mozilla/dom/Promise-inl.h" /* Needed for AddCallbacksWithCycleCollectedArgs */
+#include "mozilla/dom/ScriptSettings.h"
+
+namespace mozilla::dom {
+
+NS_IMPL_CYCLE_COLLECTION_CLASS(BerytusAbortFollower)
+
+NS_IMPL_CYCLE_COLLECTION_UNLINK_BEGIN(BerytusAbortFollower)
+  AbortFollower::Unlink(static_cast<AbortFollower*>(tmp));
+  NS_IMPL_CYCLE_COLLECTION_UNLINK(mPromise, mAgent)
+NS_IMPL_CYCLE_COLLECTION_UNLINK_END
+
+NS_IMPL_CYCLE_COLLECTION_TRAVERSE_BEGIN(BerytusAbortFollower)
+  AbortFollower::Traverse(static_cast<AbortFollower*>(tmp), cb);
+  NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mPromise, mAgent)
+NS_IMPL_CYCLE_COLLECTION_TRAVERSE_END
+
+NS_IMPL_CYCLE_COLLECTING_ADDREF(BerytusAbortFollower)
+NS_IMPL_CYCLE_COLLECTING_RELEASE(BerytusAbortFollower)
+NS_INTERFACE_MAP_BEGIN_CYCLE_COLLECTION(BerytusAbortFollower)
+  NS_INTERFACE_MAP_ENTRY(nsISupports)
+NS_INTERFACE_MAP_END
+
+BerytusAbortFollower::BerytusAbortFollower(Promise* aPromise)
+    : mPromise(aPromise), mAborted(false) {}
+
+already_AddRefed<BerytusAbortFollower> BerytusAbortFollower::Create(
+    const Optional<OwningNonNull<AbortSignal>>& aSignal,
+    Promise* aPromise) {
+  if (!aSignal.WasPassed()) {
+    return nullptr;
+  }
+  RefPtr<BerytusAbortFollower> follower = new BerytusAbortFollower(aPromise);
+  AbortSignal& signal = aSignal.Value();
+  if (signal.Aborted()) {
+    follower->Abort(&signal);
+    return follower.forget();
+  }
+  follower->Follow(&signal);
+  auto onSettled = [](JSContext* aCx, JS::Handle<JS::Value> aValue,
+                      ErrorResult& aRv,
+                      const RefPtr<BerytusAbortFollower>& aFollower) {
+    aFollower->Unfollow();
+  };
+  aPromise->AddCallbacksWithCycleCollectedArgs(onSettled, onSettled,
+                                               RefPtr{follower});
+  return follower.forget();
+}
+
+void BerytusAbortFollower::FollowQueries(
+    berytus::AgentProxy* aAgent, const nsTArray<nsString>& aRequestIds) {
+  MOZ_ASSERT(aAgent);
+  MOZ_ASSERT(!mAgent || mAgent == aAgent);
+  mAgent = aAgent;
+  mRequestIds.AppendElements(aRequestIds);
+  if (mAborted) {
+    mAgent->CancelQueries(mRequestIds);
+  }
+}
+
+bool BerytusAbortFollower::Aborted() const {
+  return mAborted;
+}
+
+void BerytusAbortFollower::RunAbortAlgorithm() {
+  RefPtr<AbortSignalImpl> signal = Signal();
+  Unfollow();
+  Abort(signal);
+}
+
+void BerytusAbortFollower::Abort(AbortSignalImpl* aSignal) {
+  mAborted = true;
+  AutoJSAPI jsapi;
+  if (NS_WARN_IF(!jsapi.Init(mPromise->GetParentObject()))) {
+    mPromise->MaybeRejectWithAbortError("The operation was aborted.");
+  } else {
+    JS::Rooted<JS::Value> reason(jsapi.cx());
+    aSignal->GetReason(jsapi.cx(), &reason);
+    mPromise->MaybeReject(reason);
+  }
+  if (mAgent) {
+    mAgent->CancelQueries(mRequestIds);
+  }
+}
+
+}  // namespace mozilla::dom
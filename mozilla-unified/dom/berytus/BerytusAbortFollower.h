@@ -0,0 +1,75 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef DOM_BERYTUSABORTFOLLOWER_H_
+#define DOM_BERYTUSABORTFOLLOWER_H_
+
+#include "mozilla/dom/AbortFollower.h"
+#include "mozilla/dom/BindingDeclarations.h"
+#include "mozilla/RefPtr.h"
+#include "nsCycleCollectionParticipant.h"
+#include "nsString.h"
+#include "nsTArray.h"
+
+namespace mozilla::berytus {
+class AgentProxy;
+}
+
+namespace mozilla::dom {
+
+class AbortSignal;
+class AbortSignalImpl;
+class Promise;
+
+/**
+ * Follows the AbortSignal passed in the options of a Berytus
+ * promise-returning API. Once the signal is aborted, the promise is
+ * rejected with the signal's abort reason and the queries sent on
+ * behalf of the API, if still pending, are cancelled so that the
+ * secret manager stops processing them.
+ */
+class BerytusAbortFollower final : public AbortFollower {
+public:
+  NS_DECL_CYCLE_COLLECTING_ISUPPORTS
+  NS_DECL_CYCLE_COLLECTION_CLASS(BerytusAbortFollower)
+
+  /**
+   * Returns nullptr if no signal was passed. If the signal is already
+   * aborted, aPromise is rejected right away; check Aborted() before
+   * starting any work. The follower stops following the signal once
+   * aPromise is settled.
+   */
+  static already_AddRefed<BerytusAbortFollower> Create(
+      const Optional<OwningNonNull<AbortSignal>>& aSignal,
+      Promise* aPromise);
+
+  /**
+   * The queries, recorded with AgentProxy::AutoRecordQueries, that
+   * are cancelled upon abortion, or right away if the signal is
+   * aborted already. The other queries of aAgent, e.g. those of
+   * another operation of the channel, are left untouched.
+   */
+  void FollowQueries(berytus::AgentProxy* aAgent,
+                     const nsTArray<nsString>& aRequestIds);
+  bool Aborted() const;
+
+  void RunAbortAlgorithm() override;
+
+protected:
+  explicit BerytusAbortFollower(Promise* aPromise);
+  ~BerytusAbortFollower() = default;
+
+  void Abort(AbortSignalImpl* aSignal);
+
+  RefPtr<Promise> mPromise;
+  RefPtr<berytus::AgentProxy> mAgent;
+  nsTArray<nsString> mRequestIds;
+  bool mAborted;
+};
+
+}  // namespace mozilla::dom
+
+#endif  // DOM_BERYTUSABORTFOLLOWER_H_
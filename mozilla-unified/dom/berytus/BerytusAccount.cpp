@@ -9,6 +9,8 @@
 #include "mozilla/dom/BerytusFieldBinding.h"
 #include "mozilla/dom/BerytusUserAttribute.h"
 #include "mozilla/dom/Promise.h"
+#include "mozilla/dom/ScriptSettings.h"
+#include "nsPrintfCString.h"
 
 namespace mozilla::dom {
 
@@ -426,6 +428,74 @@ already_AddRefed<Promise> BerytusAccount::SetUserAttributes(
   return outPromise.forget();
 }
 
+already_AddRefed<Promise> BerytusAccount::LoadUserAttributes(
+    const Optional<Sequence<nsString>>& aIds,
+    ErrorResult& aRv) {
+  RefPtr<Promise> outPromise = Promise::Create(GetParentObject(), aRv);
+  if (NS_WARN_IF(aRv.Failed())) {
+    return nullptr;
+  }
+  if (!Active()) {
+    aRv.ThrowInvalidStateError("Operation is closed; can no longer send secret manager requests");
+    return nullptr;
+  }
+  BerytusChannel* channel = Channel();
+  if (NS_WARN_IF(!channel->Active())) {
+    aRv.ThrowInvalidStateError("Channel no longer active");
+    return nullptr;
+  }
+  berytus::GetUserAttributeValuesArgs args;
+  if (aIds.WasPassed()) {
+    for (const nsString& id : aIds.Value()) {
+      RefPtr<BerytusUserAttribute> attr = UserAttributeMap()->GetAttribute(id);
+      if (!attr) {
+        aRv.ThrowTypeError(nsPrintfCString(
+          "Unknown user attribute '%s'.", NS_ConvertUTF16toUTF8(id).get()));
+        return nullptr;
+      }
+      if (!attr->Loaded() && !args.mIds.Contains(id)) {
+        args.mIds.AppendElement(id);
+      }
+    }
+  } else {
+    UserAttributeMap()->GetUnloadedAttributeIds(args.mIds);
+  }
+  if (args.mIds.IsEmpty()) {
+    outPromise->MaybeResolveWithUndefined();
+    return outPromise.forget();
+  }
+  berytus::AgentProxy& agent = channel->Agent();
+  MOZ_ASSERT(!agent.IsDisabled());
+  nsresult rv;
+  berytus::RequestContextWithLoginOperation ctx;
+  rv = berytus::Utils_RequestContextWithLoginOperationMetadata(
+      GetParentObject(), Channel(), Operation(), this, ctx);
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    aRv.Throw(rv);
+    return nullptr;
+  }
+  agent.AccountCreation_GetUserAttributeValues(ctx, args)
+    ->Then(GetCurrentSerialEventTarget(), __func__,
+      [this, self = RefPtr{Operation()}, outPromise](const nsTArray<berytus::UserAttribute>& aAttrs) {
+        AutoJSAPI jsapi;
+        if (NS_WARN_IF(!jsapi.Init(GetParentObject()))) {
+          outPromise->MaybeReject(NS_ERROR_FAILURE);
+          return;
+        }
+        nsresult res = ApplyUserAttributes(jsapi.cx(), aAttrs);
+        if (NS_WARN_IF(NS_FAILED(res))) {
+          outPromise->MaybeReject(res);
+          return;
+        }
+        outPromise->MaybeResolveWithUndefined();
+      },
+      [outPromise](const berytus::Failure& aFr) {
+        outPromise->MaybeReject(aFr.ToErrorResult());
+      }
+    );
+  return outPromise.forget();
+}
+
 // Return a raw pointer here to avoid refcounting, but make sure it's safe (the
 // object should be kept alive by the callee).
 already_AddRefed<Promise> BerytusAccount::AddFieldCategory(
@@ -435,60 +505,70 @@ already_AddRefed<Promise> BerytusAccount::AddFieldCategory(
   return nullptr;
 }
 
-RefPtr<MozPromise<void*, berytus::Failure, true>> BerytusAccount::PopulateUserAttributeMap(JSContext* aCx) {
-  nsresult rv;
-
-  berytus::RequestContextWithLoginOperation reqCtx;
-  rv = berytus::Utils_RequestContextWithLoginOperationMetadata(GetParentObject(), Channel(), Operation(), this, reqCtx);
-  if (NS_WARN_IF(NS_FAILED(rv))) {
-    RefPtr<MozPromise<void*, berytus::Failure, true>::Private> nextProm;
-    nextProm->Reject(berytus::Failure(rv), __func__);
-    return nextProm;
-  }
-  RefPtr<berytus::AccountCreationGetUserAttributesResult> res =
-    Channel()->Agent().AccountCreation_GetUserAttributes(reqCtx);
-  return res->Then(
-    GetCurrentSerialEventTarget(), __func__,
-    [this, aCx](const nsTArray<mozilla::berytus::UserAttribute>& attrs) -> RefPtr<MozPromise<void*, berytus::Failure, true>> {
-      auto *map = UserAttributeMap();
-      JSAutoRealm ar(aCx, GetParentObject()->GetGlobalJSObject());
-      for (const auto& attr: attrs) {
-        nsresult res;
-        BerytusUserAttribute::SourceValueType value;
-        res = berytus::utils::FromProxy::BerytusUserAttributeValue(GetParentObject(), attr.mValue, value);
-        if (NS_WARN_IF(NS_FAILED(res))) {
-          return MozPromise<void*, berytus::Failure, true>::CreateAndReject(berytus::Failure(res), __func__);
-        }
-        RefPtr<BerytusUserAttribute> newAttr = BerytusUserAttribute::Create(
-          aCx,
-          GetParentObject(),
-          attr.mId.AsString(),
-          attr.mMimeType.isSome() ? attr.mMimeType.ref() : nsString(),
-          attr.mInfo.isSome() ? attr.mInfo.ref() : nsString(),
-          value,
-          res
-        );
-        if (NS_WARN_IF(NS_FAILED(res))) {
-          return MozPromise<void*, berytus::Failure, true>::CreateAndReject(berytus::Failure(res), __func__);
-        }
-        ErrorResult rv;
-        map->AddAttribute(newAttr, rv);
-        if (NS_WARN_IF(rv.Failed())) {
-          berytus::Failure fr(rv.StealNSResult());
-          return MozPromise<void*, berytus::Failure, true>::CreateAndReject(fr, __func__);
-        }
+nsresult BerytusAccount::ApplyUserAttributes(
+    JSContext* aCx,
+    const nsTArray<berytus::UserAttribute>& aAttrs) {
+  auto *map = UserAttributeMap();
+  JSAutoRealm ar(aCx, GetParentObject()->GetGlobalJSObject());
+  for (const auto& attr: aAttrs) {
+    nsresult res;
+    nsString id(attr.mId.AsString());
+    RefPtr<BerytusUserAttribute> existing = map->GetAttribute(id);
+    if (existing) {
+      // The web app might have set the attribute while its
+      // value was being loaded.
+      if (existing->Loaded()) {
+        continue;
+      }
+      ErrorResult rv;
+      map->RemoveAttribute(id, rv);
+      if (NS_WARN_IF(rv.Failed())) {
+        return rv.StealNSResult();
       }
+    }
+    BerytusUserAttribute::SourceValueType value;
+    res = berytus::utils::FromProxy::BerytusUserAttributeValue(GetParentObject(), attr.mValue, value);
+    if (NS_WARN_IF(NS_FAILED(res))) {
+      return res;
+    }
+    RefPtr<BerytusUserAttribute> newAttr = BerytusUserAttribute::Create(
+      aCx,
+      GetParentObject(),
+      id,
+      attr.mMimeType.isSome() ? attr.mMimeType.ref() : nsString(),
+      attr.mInfo.isSome() ? attr.mInfo.ref() : nsString(),
+      value,
+      res
+    );
+    if (NS_WARN_IF(NS_FAILED(res))) {
+      return res;
+    }
+    ErrorResult rv;
+    map->AddAttribute(newAttr, rv);
+    if (NS_WARN_IF(rv.Failed())) {
+      return rv.StealNSResult();
+    }
+  }
+  return NS_OK;
+}
 
-      void* out = nullptr;
-      return MozPromise<void*, berytus::Failure, true>::CreateAndResolve(out, __func__);
-    },
-    [](const berytus::Failure& aFr) -> RefPtr<MozPromise<void*, berytus::Failure, true>> {
-      RefPtr<MozPromise<void*, berytus::Failure, true>::Private> nextProm =
-        new MozPromise<void*, berytus::Failure, true>::Private(__func__);
-      nextProm->Reject(aFr, __func__);
-      return nextProm;
+nsresult BerytusAccount::ApplyUnloadedUserAttributes(
+    const nsTArray<berytus::UserAttributeInfo>& aAttrs) {
+  auto *map = UserAttributeMap();
+  for (const auto& attr: aAttrs) {
+    RefPtr<BerytusUserAttribute> newAttr = BerytusUserAttribute::CreateUnloaded(
+      GetParentObject(),
+      attr.mId.AsString(),
+      attr.mMimeType.isSome() ? attr.mMimeType.ref() : nsString(),
+      attr.mInfo.isSome() ? attr.mInfo.ref() : nsString()
+    );
+    ErrorResult rv;
+    map->AddAttribute(newAttr, rv);
+    if (NS_WARN_IF(rv.Failed())) {
+      return rv.StealNSResult();
     }
-  );
+  }
+  return NS_OK;
 }
 
 }  // namespace mozilla::dom
\ No newline at end of file
@@ -28,7 +28,14 @@ protected:
   virtual BerytusUserAttributeMap* UserAttributeMap() const = 0;
   virtual bool Active() const = 0;
   
-  RefPtr<MozPromise<void*, berytus::Failure, true>> PopulateUserAttributeMap(JSContext* aCx);
+  /**
+   * Adds the attributes to the map. An attribute that is already in
+   * the map replaces it if it is not loaded, and is skipped otherwise.
+   */
+  nsresult ApplyUserAttributes(JSContext* aCx,
+                               const nsTArray<berytus::UserAttribute>& aAttrs);
+  nsresult ApplyUnloadedUserAttributes(
+      const nsTArray<berytus::UserAttributeInfo>& aAttrs);
 
   RefPtr<berytus::AccountCreationAddFieldResult::AllPromiseType> AddFieldsSequential(JSContext* aCx, nsTArray<RefPtr<BerytusField>>&& aFields, nsTArray<RefPtr<berytus::AccountCreationAddFieldResult>>&& aPromises = nsTArray<RefPtr<berytus::AccountCreationAddFieldResult>>(), const size_t& aIndex = 0);
   RefPtr<berytus::AccountCreationAddFieldResult> AddField(JSContext* aCx, const RefPtr<BerytusField>& aField, ErrorResult& aRv);
@@ -69,6 +76,11 @@ public:
     ErrorResult& aRv
   );
 
+  already_AddRefed<Promise> LoadUserAttributes(
+    const Optional<Sequence<nsString>>& aIds,
+    ErrorResult& aRv
+  );
+
   // Return a raw pointer here to avoid refcounting, but make sure it's safe (the object should be kept alive by the callee).
   already_AddRefed<Promise> AddFieldCategory(
     const nsAString& aId,
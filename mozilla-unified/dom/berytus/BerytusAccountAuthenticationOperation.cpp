@@ -91,14 +91,25 @@ already_AddRefed<Promise> BerytusAccountAuthenticationOperation::Challenge(
     aRv.Throw(rv);
     return nullptr;
   }
-  berytus::ApproveChallengeRequestArgs reqArgs;
-  berytus::utils::ToProxy::BerytusChallengeInfoUnion(aChallenge, reqArgs.mChallenge);
-  // TODO(berytus): Use BuildChallengeInfo
+  // Converts the challenge info to JS for the first time; the
+  // challenge messages reuse the converted object.
+  JS::Rooted<JS::Value> info(aCx);
+  aChallenge->GetInfo(aCx, &info, aRv);
+  if (NS_WARN_IF(aRv.Failed())) {
+    return nullptr;
+  }
+  JS::Rooted<JSObject*> reqArgs(aCx, JS_NewPlainObject(aCx));
+  if (NS_WARN_IF(!reqArgs) ||
+      NS_WARN_IF(!JS_SetProperty(aCx, reqArgs, "challenge", info))) {
+    aRv.Throw(NS_ERROR_FAILURE);
+    return nullptr;
+  }
+  JS::Rooted<JS::Value> reqArgsJs(aCx, JS::ObjectValue(*reqArgs));
   RefPtr<Promise> prom = agent.CallSendQuery(aCx,
                       u"accountAuthentication"_ns,
                       u"approveChallengeRequest"_ns,
                       reqCtx,
-                      &reqArgs,
+                      reqArgsJs,
                       aRv);
   if (NS_WARN_IF(aRv.Failed())) {
     return nullptr;
@@ -183,4 +194,21 @@ RefPtr<BerytusAccountAuthenticationOperation::CreationPromise> BerytusAccountAut
   );
 }
 
+RefPtr<BerytusAccountAuthenticationOperation::CreationPromise> BerytusAccountAuthenticationOperation::CreateApproved(
+    nsIGlobalObject* aGlobalObject,
+    const RefPtr<BerytusChannel>& aChannel,
+    const nsAString& aOperationId,
+    const berytus::OperationSnapshot& aSnapshot) {
+  if (NS_WARN_IF(aSnapshot.mMetadata.isNothing())) {
+    return CreationPromise::CreateAndReject(berytus::Failure(NS_ERROR_INVALID_ARG), __func__);
+  }
+  RefPtr<BerytusAccountAuthenticationOperation> op = new BerytusAccountAuthenticationOperation(
+    aGlobalObject, aChannel, aOperationId);
+  nsresult rv = op->ApplyRecordMetadata(aSnapshot.mMetadata.ref());
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    return CreationPromise::CreateAndReject(berytus::Failure(rv), __func__);
+  }
+  return CreationPromise::CreateAndResolve(op, __func__);
+}
+
 } // namespace mozilla::dom
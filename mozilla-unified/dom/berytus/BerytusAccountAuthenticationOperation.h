@@ -46,6 +46,11 @@ public:
     nsIGlobalObject* aGlobalObject,
     const RefPtr<BerytusChannel>& aChannel,
     const nsAString& aOperationId);
+  static RefPtr<CreationPromise> CreateApproved(
+    nsIGlobalObject* aGlobalObject,
+    const RefPtr<BerytusChannel>& aChannel,
+    const nsAString& aOperationId,
+    const berytus::OperationSnapshot& aSnapshot);
 protected:
   BerytusAccountAuthenticationOperation(nsIGlobalObject* aGlobalObject,
                                         const RefPtr<BerytusChannel>& aChannel,
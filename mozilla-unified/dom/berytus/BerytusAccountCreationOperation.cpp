@@ -176,17 +176,24 @@ RefPtr<BerytusAccountCreationOperation::CreationPromise> BerytusAccountCreationO
     JSContext* aCx,
     nsIGlobalObject* aGlobalObject,
     const RefPtr<BerytusChannel>& aChannel,
-    const nsAString& aOperationId) {
+    const nsAString& aOperationId,
+    const berytus::OperationSnapshot& aSnapshot) {
+  if (NS_WARN_IF(aSnapshot.mUserAttributes.isNothing())) {
+    return CreationPromise::CreateAndReject(berytus::Failure(NS_ERROR_INVALID_ARG), __func__);
+  }
   RefPtr<BerytusAccountCreationOperation> op = new BerytusAccountCreationOperation(
       aGlobalObject, aChannel, aOperationId);
-  return op->PopulateUserAttributeMap(aCx)->Then(GetCurrentSerialEventTarget(), __func__,
-    [op]() -> RefPtr<BerytusAccountCreationOperation::CreationPromise> {
-      return BerytusAccountCreationOperation::CreationPromise::CreateAndResolve(op, __func__);
-    },
-    [](const berytus::Failure& aFr) -> RefPtr<BerytusAccountCreationOperation::CreationPromise> {
-    return BerytusAccountCreationOperation::CreationPromise::CreateAndReject(aFr, __func__);
+  nsresult rv = op->ApplyUserAttributes(aCx, aSnapshot.mUserAttributes.ref());
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    return CreationPromise::CreateAndReject(berytus::Failure(rv), __func__);
+  }
+  if (aSnapshot.mUnloadedUserAttributes.isSome()) {
+    rv = op->ApplyUnloadedUserAttributes(aSnapshot.mUnloadedUserAttributes.ref());
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      return CreationPromise::CreateAndReject(berytus::Failure(rv), __func__);
     }
-  );
+  }
+  return CreationPromise::CreateAndResolve(op, __func__);
 }
 
 } // namespace mozilla::dom
@@ -46,7 +46,8 @@ public:
     JSContext* aCx, 
     nsIGlobalObject* aGlobalObject,
     const RefPtr<BerytusChannel>& aChannel,
-    const nsAString& aOperationId);
+    const nsAString& aOperationId,
+    const berytus::OperationSnapshot& aSnapshot);
 protected:
   BerytusAccountCreationOperation(
     nsIGlobalObject* aGlobal,
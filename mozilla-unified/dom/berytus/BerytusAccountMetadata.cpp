@@ -3,8 +3,10 @@
 #include "mozilla/berytus/AgentProxy.h"
 #include "mozilla/berytus/AgentProxyUtils.h"
 #include "mozilla/dom/BerytusAccountBinding.h"
+#include "mozilla/dom/BerytusLoginOperation.h"
 #include "mozilla/dom/BerytusWebAppActor.h"
 #include "mozilla/dom/Promise.h"
+#include "nsThreadUtils.h"
 
 namespace mozilla::dom {
 
@@ -69,31 +71,72 @@ BerytusAccountMetadata::UpdateMetadata(
     );
 }
 
-already_AddRefed<Promise> BerytusAccountMetadata::UpdateMetadataPromise(
-  const uint64_t& aVersion,
-  const BerytusAccountStatus& aStatus,
-  const nsAString& aCategory,
-  const nsAString& aChangePassUrl,
+already_AddRefed<Promise> BerytusAccountMetadata::EnqueueMetadataUpdate(
   ErrorResult& aRv
 ) {
-  RefPtr<Promise> outPromise = Promise::Create(GetParentObject(), aRv);
-  if (NS_WARN_IF(aRv.Failed())) {
+  if (!Active()) {
+    aRv.ThrowInvalidStateError("Operation is closed; can no longer send secret manager requests");
+    return nullptr;
+  }
+  if (NS_WARN_IF(!Channel()->Active())) {
+    aRv.ThrowInvalidStateError("Channel no longer active");
     return nullptr;
   }
-  RefPtr<berytus::LoginUpdateMetadataResult> pr = UpdateMetadata(aVersion, aStatus, aCategory, aChangePassUrl, aRv);
+  RefPtr<Promise> outPromise = Promise::Create(GetParentObject(), aRv);
   if (NS_WARN_IF(aRv.Failed())) {
     return nullptr;
   }
+  if (mPendingUpdate.isNothing()) {
+    // NOTE(berytus): The flush is dispatched as a task rather than
+    // a microtask so that setters called from the microtasks of the
+    // current task (e.g. after an await) join the same request.
+    nsresult rv = NS_DispatchToCurrentThread(NS_NewRunnableFunction(
+      "BerytusAccountMetadata::FlushMetadataUpdate",
+      [this, kungFuDeathGrip = RefPtr<BerytusLoginOperation>(Operation())]() {
+        FlushMetadataUpdate();
+      }));
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      aRv.Throw(rv);
+      return nullptr;
+    }
+    mPendingUpdate.emplace();
+  }
+  mPendingUpdate->mPromises.AppendElement(outPromise);
+  return outPromise.forget();
+}
+
+void BerytusAccountMetadata::FlushMetadataUpdate() {
+  MOZ_ASSERT(mPendingUpdate.isSome());
+  PendingMetadataUpdate update = mPendingUpdate.extract();
+  ErrorResult rv;
+  RefPtr<berytus::LoginUpdateMetadataResult> pr = UpdateMetadata(
+    update.mVersion.valueOr(mVersion),
+    update.mStatus.valueOr(mStatus),
+    update.mCategory.isSome() ? *update.mCategory : mCategory,
+    update.mChangePassUrl.isSome() ? *update.mChangePassUrl : mChangePassUrl,
+    rv);
+  if (NS_WARN_IF(rv.Failed())) {
+    for (const RefPtr<Promise>& p : update.mPromises) {
+      ErrorResult err;
+      rv.CloneTo(err);
+      p->MaybeReject(std::move(err));
+    }
+    rv.SuppressException();
+    return;
+  }
   pr->Then(
     GetCurrentSerialEventTarget(), __func__,
-    [outPromise]() {
-      outPromise->MaybeResolve(JS::UndefinedHandleValue);
+    [promises = update.mPromises.Clone()]() {
+      for (const RefPtr<Promise>& p : promises) {
+        p->MaybeResolve(JS::UndefinedHandleValue);
+      }
     },
-    [outPromise](const berytus::Failure& aFr) {
-      outPromise->MaybeReject(aFr.ToErrorResult());
+    [promises = update.mPromises.Clone()](const berytus::Failure& aFr) {
+      for (const RefPtr<Promise>& p : promises) {
+        p->MaybeReject(aFr.ToErrorResult());
+      }
     }
   );
-  return outPromise.forget();
 }
 
 void BerytusAccountMetadata::GetCategory(nsString& aRetVal) const {
@@ -110,28 +153,48 @@ void BerytusAccountMetadata::GetChangePasswordUrl(nsString& aRetVal) const {
 
 already_AddRefed<Promise> BerytusAccountMetadata::SetVersion(uint64_t aVersion,
                                                              ErrorResult& aRv) {
-  return UpdateMetadataPromise(aVersion, mStatus, mCategory, mChangePassUrl, aRv);
+  RefPtr<Promise> outPromise = EnqueueMetadataUpdate(aRv);
+  if (NS_WARN_IF(aRv.Failed())) {
+    return nullptr;
+  }
+  mPendingUpdate->mVersion = Some(aVersion);
+  return outPromise.forget();
 }
 
 // Return a raw pointer here to avoid refcounting, but make sure it's safe (the
 // object should be kept alive by the callee).
 already_AddRefed<Promise> BerytusAccountMetadata::SetCategory(
     const nsAString& aCategory, ErrorResult& aRv) {
-  return UpdateMetadataPromise(mVersion, mStatus, aCategory, mChangePassUrl, aRv);
+  RefPtr<Promise> outPromise = EnqueueMetadataUpdate(aRv);
+  if (NS_WARN_IF(aRv.Failed())) {
+    return nullptr;
+  }
+  mPendingUpdate->mCategory = Some(nsString(aCategory));
+  return outPromise.forget();
 }
 
 // Return a raw pointer here to avoid refcounting, but make sure it's safe (the
 // object should be kept alive by the callee).
 already_AddRefed<Promise> BerytusAccountMetadata::SetStatus(
     BerytusAccountStatus aStatus, ErrorResult& aRv) {
-  return UpdateMetadataPromise(mVersion, aStatus, mCategory, mChangePassUrl, aRv);
+  RefPtr<Promise> outPromise = EnqueueMetadataUpdate(aRv);
+  if (NS_WARN_IF(aRv.Failed())) {
+    return nullptr;
+  }
+  mPendingUpdate->mStatus = Some(aStatus);
+  return outPromise.forget();
 }
 
 // Return a raw pointer here to avoid refcounting, but make sure it's safe (the
 // object should be kept alive by the callee).
 already_AddRefed<Promise> BerytusAccountMetadata::SetChangePasswordUrl(
     const nsAString& aUrl, ErrorResult& aRv) {
-  return UpdateMetadataPromise(mVersion, mStatus, mCategory, aUrl, aRv);
+  RefPtr<Promise> outPromise = EnqueueMetadataUpdate(aRv);
+  if (NS_WARN_IF(aRv.Failed())) {
+    return nullptr;
+  }
+  mPendingUpdate->mChangePassUrl = Some(nsString(aUrl));
+  return outPromise.forget();
 }
 
 RefPtr<MozPromise<void*, berytus::Failure, true>> BerytusAccountMetadata::PopulateMetadata() {
@@ -153,19 +216,10 @@ RefPtr<MozPromise<void*, berytus::Failure, true>> BerytusAccountMetadata::Popula
   return agent.Login_GetRecordMetadata(ctx)
     ->Then(GetCurrentSerialEventTarget(), __func__,
            [this](const berytus::RecordMetadata& aMetadata) -> RefPtr<MozPromiseType> {
-            mCategory.Assign(aMetadata.mCategory);
-            if (NS_WARN_IF(aMetadata.mStatus.mVal > static_cast<uint8_t>(MaxContiguousEnumValue<dom::BerytusAccountStatus>::value))) {
-              return MozPromiseType::CreateAndReject(berytus::Failure(NS_ERROR_INVALID_ARG), __func__);
+            nsresult rv = ApplyRecordMetadata(aMetadata);
+            if (NS_WARN_IF(NS_FAILED(rv))) {
+              return MozPromiseType::CreateAndReject(berytus::Failure(rv), __func__);
             }
-            mStatus = static_cast<BerytusAccountStatus>(aMetadata.mStatus.mVal);
-            if (NS_WARN_IF(aMetadata.mVersion < 0)) {
-              return MozPromiseType::CreateAndReject(berytus::Failure(NS_ERROR_INVALID_ARG), __func__);
-            }
-            if (NS_WARN_IF(aMetadata.mVersion != std::floor(aMetadata.mVersion))) {
-              return MozPromiseType::CreateAndReject(berytus::Failure(NS_ERROR_INVALID_ARG), __func__);
-            }
-            mVersion = static_cast<uint8_t>(aMetadata.mVersion);
-            mChangePassUrl.Assign(aMetadata.mChangePassUrl);
             void* d = nullptr;
             return MozPromiseType::CreateAndResolve(d, __func__);
            },
@@ -174,4 +228,23 @@ RefPtr<MozPromise<void*, berytus::Failure, true>> BerytusAccountMetadata::Popula
            });
 }
 
+nsresult BerytusAccountMetadata::ApplyRecordMetadata(
+  const berytus::RecordMetadata& aMetadata
+) {
+  if (NS_WARN_IF(aMetadata.mStatus.mVal > static_cast<uint8_t>(MaxContiguousEnumValue<dom::BerytusAccountStatus>::value))) {
+    return NS_ERROR_INVALID_ARG;
+  }
+  if (NS_WARN_IF(aMetadata.mVersion < 0)) {
+    return NS_ERROR_INVALID_ARG;
+  }
+  if (NS_WARN_IF(aMetadata.mVersion != std::floor(aMetadata.mVersion))) {
+    return NS_ERROR_INVALID_ARG;
+  }
+  mCategory.Assign(aMetadata.mCategory);
+  mStatus = static_cast<BerytusAccountStatus>(aMetadata.mStatus.mVal);
+  mVersion = static_cast<uint64_t>(aMetadata.mVersion);
+  mChangePassUrl.Assign(aMetadata.mChangePassUrl);
+  return NS_OK;
+}
+
 }  // namespace mozilla::dom
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define DOM_BERYTUSACCOUNTMETADATA_H_
 
 #include "mozilla/ErrorResult.h"
+#include "mozilla/Maybe.h"
 #include "mozilla/dom/BerytusAccountBinding.h" // for BerytusAccountStatus
 #include "nsVariant.h"
 #include "nsIGlobalObject.h"
@@ -52,6 +53,24 @@ protected:
     nsString mCategory;
     nsString mChangePassUrl;
 
+    /**
+     * Setter calls made within the same task (including its
+     * microtasks) are coalesced into a single UpdateMetadata request;
+     * the fields that were not set keep their current value. Every
+     * setter promise is settled from the result of that request.
+     */
+    struct PendingMetadataUpdate {
+      Maybe<uint64_t> mVersion;
+      Maybe<BerytusAccountStatus> mStatus;
+      Maybe<nsString> mCategory;
+      Maybe<nsString> mChangePassUrl;
+      nsTArray<RefPtr<Promise>> mPromises;
+    };
+    Maybe<PendingMetadataUpdate> mPendingUpdate;
+
+    already_AddRefed<Promise> EnqueueMetadataUpdate(ErrorResult& aRv);
+    void FlushMetadataUpdate();
+
     RefPtr<berytus::LoginUpdateMetadataResult>
     UpdateMetadata(
         const uint64_t& aVersion,
@@ -61,15 +80,8 @@ protected:
         ErrorResult& aRv
     );
 
-    already_AddRefed<Promise> UpdateMetadataPromise(
-        const uint64_t& aVersion,
-        const BerytusAccountStatus& aStatus,
-        const nsAString& aCategory,
-        const nsAString& aChangePassUrl,
-        ErrorResult& aRv
-    );
-
     RefPtr<MozPromise<void*, berytus::Failure, true>> PopulateMetadata();
+    nsresult ApplyRecordMetadata(const berytus::RecordMetadata& aMetadata);
 };
 
 }
@@ -0,0 +1,211 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/dom/BerytusAdmissionControl.h"
+#include "mozilla/ClearOnShutdown.h"
+#include "mozilla/ErrorResult.h"
+#include "mozilla/Logging.h"
+#include "mozilla/Preferences.h"
+#include "mozilla/StaticPtr.h"
+#include "mozilla/dom/BrowsingContext.h"
+#include "nsIGlobalObject.h"
+#include "nsIPrincipal.h"
+#include "nsPIDOMWindow.h"
+#include "nsPrintfCString.h"
+#include "nsTHashMap.h"
+
+namespace mozilla::dom {
+
+static mozilla::LazyLogModule sLogger("berytus_admission");
+
+BerytusTokenBucket::BerytusTokenBucket(const TimeStamp& aNow)
+    : mTokens(-1), mLastRefill(aNow) {}
+
+double BerytusTokenBucket::TokensAt(const TimeStamp& aNow,
+                                    uint32_t aCapacity,
+                                    uint32_t aRefillPerMinute) const {
+  if (mTokens < 0) {
+    // Not consumed yet.
+    return aCapacity;
+  }
+  double elapsed = (aNow - mLastRefill).ToSeconds();
+  double tokens = mTokens + elapsed * aRefillPerMinute / 60.0;
+  return tokens < aCapacity ? tokens : aCapacity;
+}
+
+bool BerytusTokenBucket::CanConsume(const TimeStamp& aNow,
+                                    uint32_t aCapacity,
+                                    uint32_t aRefillPerMinute,
+                                    uint32_t aCount) {
+  mTokens = TokensAt(aNow, aCapacity, aRefillPerMinute);
+  mLastRefill = aNow;
+  return mTokens >= aCount;
+}
+
+void BerytusTokenBucket::Consume(uint32_t aCount) {
+  MOZ_ASSERT(mTokens >= aCount);
+  mTokens -= aCount;
+}
+
+bool BerytusTokenBucket::IsFull(const TimeStamp& aNow,
+                                uint32_t aCapacity,
+                                uint32_t aRefillPerMinute) const {
+  return TokensAt(aNow, aCapacity, aRefillPerMinute) >= aCapacity;
+}
+
+namespace {
+
+struct BucketLimits {
+  uint32_t mBurst;
+  uint32_t mRefillPerMinute;
+};
+
+struct KindLimits {
+  const char* mPrefName;
+  BucketLimits mOrigin;
+  BucketLimits mContext;
+};
+
+// Defaults; an origin is allowed a larger burst than any one of its
+// browsing contexts.
+constexpr KindLimits kDefaultLimits[] = {
+  // BerytusAdmissionControl::Kind::ChannelCreation
+  {"channel", {10, 20}, {5, 10}},
+  // BerytusAdmissionControl::Kind::Login
+  {"login", {20, 60}, {10, 30}},
+  // BerytusAdmissionControl::Kind::ChallengeMessage
+  {"challenge", {120, 600}, {60, 300}},
+};
+static_assert(std::size(kDefaultLimits) ==
+              size_t(BerytusAdmissionControl::Kind::EndGuard_));
+
+// Dropping full buckets is only worth it past this many buckets.
+constexpr uint32_t kSweepThreshold = 64;
+
+BucketLimits ReadLimits(const char* aKind, const char* aScope,
+                        const BucketLimits& aDefaults) {
+  BucketLimits limits;
+  limits.mBurst = Preferences::GetUint(
+    nsPrintfCString("dom.berytus.admission.%s.%s.burst", aKind, aScope).get(),
+    aDefaults.mBurst);
+  limits.mRefillPerMinute = Preferences::GetUint(
+    nsPrintfCString("dom.berytus.admission.%s.%s.refill_per_minute",
+                    aKind, aScope).get(),
+    aDefaults.mRefillPerMinute);
+  return limits;
+}
+
+/**
+ * Drops the full buckets, as they are equivalent to new ones. An
+ * emptied bucket takes a whole refill interval (burst over refill
+ * rate) to be full again, hence the buckets are swept at most once
+ * per interval.
+ */
+template <typename K>
+void SweepFullBuckets(nsTHashMap<K, BerytusTokenBucket>& aBuckets,
+                      TimeStamp& aLastSweep,
+                      const TimeStamp& aNow,
+                      const BucketLimits& aLimits) {
+  if (aBuckets.Count() < kSweepThreshold || !aLimits.mRefillPerMinute) {
+    return;
+  }
+  const TimeDuration interval = TimeDuration::FromSeconds(
+    60.0 * aLimits.mBurst / aLimits.mRefillPerMinute);
+  if (!aLastSweep.IsNull() && aNow - aLastSweep < interval) {
+    return;
+  }
+  aLastSweep = aNow;
+  for (auto iter = aBuckets.Iter(); !iter.Done(); iter.Next()) {
+    if (iter.Data().IsFull(aNow, aLimits.mBurst, aLimits.mRefillPerMinute)) {
+      iter.Remove();
+    }
+  }
+}
+
+struct KindBuckets {
+  nsTHashMap<nsCStringHashKey, BerytusTokenBucket> mOrigin;
+  nsTHashMap<nsUint64HashKey, BerytusTokenBucket> mContext;
+  // When the full buckets of each scope were last dropped.
+  TimeStamp mOriginSweep;
+  TimeStamp mContextSweep;
+};
+
+// Allocated on the first request of each kind, freed on shutdown.
+StaticAutoPtr<KindBuckets>
+  sBuckets[size_t(BerytusAdmissionControl::Kind::EndGuard_)];
+
+} // namespace
+
+bool BerytusAdmissionControl::Admit(nsIGlobalObject* aGlobal,
+                                    Kind aKind,
+                                    ErrorResult& aRv,
+                                    uint32_t aCount) {
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(aKind < Kind::EndGuard_);
+  if (!Preferences::GetBool("dom.berytus.admission.enabled", true)) {
+    return true;
+  }
+  nsPIDOMWindowInner* inner = aGlobal->GetAsInnerWindow();
+  nsIPrincipal* principal = aGlobal->PrincipalOrNull();
+  if (NS_WARN_IF(!inner) || NS_WARN_IF(!principal)) {
+    aRv.Throw(NS_ERROR_FAILURE);
+    return false;
+  }
+  BrowsingContext* bc = inner->GetBrowsingContext();
+  if (NS_WARN_IF(!bc)) {
+    aRv.Throw(NS_ERROR_FAILURE);
+    return false;
+  }
+  nsAutoCString origin;
+  nsresult rv = principal->GetOrigin(origin);
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    aRv.Throw(rv);
+    return false;
+  }
+
+  const size_t idx = size_t(aKind);
+  const KindLimits& defaults = kDefaultLimits[idx];
+  const BucketLimits originLimits =
+    ReadLimits(defaults.mPrefName, "origin", defaults.mOrigin);
+  const BucketLimits contextLimits =
+    ReadLimits(defaults.mPrefName, "context", defaults.mContext);
+  const TimeStamp now = TimeStamp::Now();
+
+  if (!sBuckets[idx]) {
+    sBuckets[idx] = new KindBuckets();
+    ClearOnShutdown(&sBuckets[idx]);
+  }
+  KindBuckets& buckets = *sBuckets[idx];
+  SweepFullBuckets(buckets.mOrigin, buckets.mOriginSweep, now, originLimits);
+  SweepFullBuckets(buckets.mContext, buckets.mContextSweep, now,
+                   contextLimits);
+  BerytusTokenBucket& originBucket = buckets.mOrigin.LookupOrInsertWith(
+    origin, [&] { return BerytusTokenBucket(now); });
+  BerytusTokenBucket& contextBucket = buckets.mContext.LookupOrInsertWith(
+    bc->Id(), [&] { return BerytusTokenBucket(now); });
+
+  // Both buckets are checked before either is consumed so that a
+  // refused request does not count against the other scope.
+  const bool originAdmits = originBucket.CanConsume(
+    now, originLimits.mBurst, originLimits.mRefillPerMinute, aCount);
+  const bool contextAdmits = contextBucket.CanConsume(
+    now, contextLimits.mBurst, contextLimits.mRefillPerMinute, aCount);
+  if (!originAdmits || !contextAdmits) {
+    MOZ_LOG(sLogger, LogLevel::Info,
+            ("Refused %s request from %s (%s)", defaults.mPrefName,
+             origin.get(), originAdmits ? "context" : "origin"));
+    aRv.ThrowQuotaExceededError(nsPrintfCString(
+      "Too many %s requests from this %s; try again later.",
+      defaults.mPrefName,
+      originAdmits ? "browsing context" : "origin"));
+    return false;
+  }
+  originBucket.Consume(aCount);
+  contextBucket.Consume(aCount);
+  return true;
+}
+
+} // namespace mozilla::dom
@@ -0,0 +1,94 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef DOM_BERYTUSADMISSIONCONTROL_H_
+#define DOM_BERYTUSADMISSIONCONTROL_H_
+
+#include "mozilla/TimeStamp.h"
+
+class nsIGlobalObject;
+
+namespace mozilla {
+class ErrorResult;
+}
+
+namespace mozilla::dom {
+
+/**
+ * A token bucket holding up to aCapacity tokens, refilled at
+ * aRefillPerMinute tokens per minute. The capacity and refill rate
+ * are passed on each call so that pref changes apply right away.
+ */
+class BerytusTokenBucket final {
+public:
+  explicit BerytusTokenBucket(const TimeStamp& aNow);
+
+  /**
+   * Whether aCount tokens are available, without consuming them.
+   */
+  bool CanConsume(const TimeStamp& aNow,
+                  uint32_t aCapacity,
+                  uint32_t aRefillPerMinute,
+                  uint32_t aCount = 1);
+  void Consume(uint32_t aCount = 1);
+  /**
+   * Whether the bucket refilled to its capacity, i.e. whether it
+   * is equivalent to a new bucket and can be dropped.
+   */
+  bool IsFull(const TimeStamp& aNow,
+              uint32_t aCapacity,
+              uint32_t aRefillPerMinute) const;
+
+private:
+  double TokensAt(const TimeStamp& aNow,
+                  uint32_t aCapacity,
+                  uint32_t aRefillPerMinute) const;
+
+  double mTokens;
+  TimeStamp mLastRefill;
+};
+
+/**
+ * Rate limits the requests a page sends to the secret manager, so
+ * that a misbehaving page, e.g. one looping over channel creation,
+ * cannot flood the prompt service and the agent shared with the
+ * other tabs.
+ *
+ * Each kind of request is admitted against two token buckets: one
+ * per origin and one per browsing context. A request is admitted
+ * only if both buckets hold a token. The limits are read from the
+ * dom.berytus.admission.<kind>.<origin|context>.burst and
+ * dom.berytus.admission.<kind>.<origin|context>.refill_per_minute
+ * prefs, where kind is one of channel, login or challenge. Setting
+ * dom.berytus.admission.enabled to false disables the limiter.
+ *
+ * NOTE(berytus): Like the per-window channel count, the buckets are
+ * kept per content process.
+ */
+class BerytusAdmissionControl final {
+public:
+  enum class Kind : uint8_t {
+    ChannelCreation,
+    Login,
+    ChallengeMessage,
+    EndGuard_
+  };
+
+  /**
+   * Consumes aCount tokens for aKind, e.g. one per message of a
+   * batch. Throws a QuotaExceededError and returns false, without
+   * consuming any token, if the origin or the browsing context of
+   * aGlobal does not have aCount tokens left.
+   */
+  static bool Admit(nsIGlobalObject* aGlobal, Kind aKind, ErrorResult& aRv,
+                    uint32_t aCount = 1);
+
+  BerytusAdmissionControl() = delete;
+};
+
+} // namespace mozilla::dom
+
+#endif // DOM_BERYTUSADMISSIONCONTROL_H_
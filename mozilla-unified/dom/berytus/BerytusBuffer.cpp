@@ -38,6 +38,20 @@ BerytusBuffer::BerytusBuffer(
 
 BerytusBuffer::~BerytusBuffer() { mozilla::DropJSObjects(this); };
 
+nsIGlobalObject* BerytusBuffer::GetTrackedGlobal() const {
+  return mAsPacket ? mAsPacket->GetParentObject() : nullptr;
+}
+
+void BerytusBuffer::AddSizeOfIncludingThis(MallocSizeOf aMallocSizeOf,
+                                           BerytusMemorySizes& aSizes) const {
+  // The packet, if any, is tracked on its own.
+  aSizes.mHeap[BerytusMemoryKind::Buffer] +=
+    aMallocSizeOf(this) + mAsBuffer.ShallowSizeOfExcludingThis(aMallocSizeOf);
+  aSizes.mHeldJS[BerytusMemoryKind::Buffer] +=
+    SizeOfHeldJSObject(mCachedBuffer, aMallocSizeOf);
+  aSizes.mCount[BerytusMemoryKind::Buffer]++;
+}
+
 already_AddRefed<BerytusBuffer> BerytusBuffer::FromArrayBuffer(
   const ArrayBuffer& aValue,
   nsresult& aRv
@@ -14,6 +14,7 @@
 #include "mozilla/dom/TypedArray.h"
 #include "nsCycleCollectionParticipant.h"
 #include "mozilla/dom/BerytusEncryptedPacket.h"
+#include "mozilla/dom/BerytusMemoryReporter.h"
 #include "nsDebug.h"
 #include "nsISupports.h"
 
@@ -22,7 +23,8 @@ namespace mozilla {
 namespace dom {
 
 class BerytusBuffer final : public nsISupports /* or NonRefcountedDOMObject if this is a
-                            non-refcounted object */
+                            non-refcounted object */,
+                            public BerytusMemoryTracked
 {
 public:
   NS_DECL_CYCLE_COLLECTING_ISUPPORTS
@@ -64,6 +66,20 @@ protected:
 
 
   already_AddRefed<BerytusBuffer> Clone(nsresult* aRv) const;
+
+  /**
+   * Null if the buffer holds plaintext, see AsBuffer().
+   */
+  BerytusEncryptedPacket* AsPacket() const { return mAsPacket; }
+  const CryptoBuffer& AsBuffer() const { return mAsBuffer; }
+
+  /**
+   * Plaintext buffers are not bound to a global, and are reported
+   * process-wide.
+   */
+  nsIGlobalObject* GetTrackedGlobal() const override;
+  void AddSizeOfIncludingThis(MallocSizeOf aMallocSizeOf,
+                              BerytusMemorySizes& aSizes) const override;
   
 public:
 
@@ -6,14 +6,19 @@
 
 #include "mozilla/dom/BerytusChallenge.h"
 #include "ErrorList.h"
+#include "js/Array.h" // JS::NewArrayObject
+#include "js/Object.h" // JS::GetCompartment
 #include "js/RootingAPI.h"
 #include "js/TypeDecls.h"
 #include "js/Value.h"
+#include "jsapi.h" // JS_DeepFreezeObject, JS_WrapValue
+#include "jsfriendapi.h" // js::GetContextCompartment
 #include "mozilla/AlreadyAddRefed.h"
 #include "mozilla/ErrorResult.h"
 #include "mozilla/HoldDropJSObjects.h"
 #include "mozilla/berytus/AgentProxy.h"
 #include "mozilla/berytus/AgentProxyUtils.h"
+#include "mozilla/dom/BerytusAdmissionControl.h"
 #include "mozilla/dom/BerytusChallengeBinding.h"
 #include "mozilla/dom/BerytusChannel.h"
 #include "mozilla/dom/BindingDeclarations.h"
@@ -25,7 +30,7 @@ namespace mozilla::dom {
 
 
 // Only needed for refcounted objects.
-NS_IMPL_CYCLE_COLLECTION_WRAPPERCACHE_WITH_JS_MEMBERS(BerytusChallenge, (mGlobal, mChannel, mOperation), (mCachedParameters))
+NS_IMPL_CYCLE_COLLECTION_WRAPPERCACHE_WITH_JS_MEMBERS(BerytusChallenge, (mGlobal, mChannel, mOperation), (mCachedParameters, mCachedInfo))
 NS_IMPL_CYCLE_COLLECTING_ADDREF(BerytusChallenge)
 NS_IMPL_CYCLE_COLLECTING_RELEASE(BerytusChallenge)
 NS_INTERFACE_MAP_BEGIN_CYCLE_COLLECTION(BerytusChallenge)
@@ -42,7 +47,8 @@ BerytusChallenge::BerytusChallenge(nsIGlobalObject* aGlobal,
                                    mType(aType),
                                    mID(aID),
                                    mActive(false),
-                                   mCachedParameters(nullptr)
+                                   mCachedParameters(nullptr),
+                                   mCachedInfo(nullptr)
 {
   mozilla::HoldJSObjects(this);
     // Add |MOZ_COUNT_CTOR(BerytusChallenge);| for a non-refcounted object.
@@ -79,7 +85,7 @@ BerytusLoginOperation* BerytusChallenge::Operation() {
 
 bool BerytusChallenge::Active() { return mActive; }
 
-void BerytusChallenge::GetId(nsAString& aRetVal) {
+void BerytusChallenge::GetId(nsAString& aRetVal) const {
   aRetVal.Assign(mID);
 }
 
@@ -87,6 +93,16 @@ BerytusChallengeType BerytusChallenge::Type() const {
   return mType;
 }
 
+void BerytusChallenge::InitInfo() {
+  MOZ_ASSERT(!mInfo.Inited());
+  berytus::utils::ToProxy::BerytusChallengeInfoUnion(*this, mInfo);
+}
+
+const BerytusChallenge::InfoType& BerytusChallenge::Info() const {
+  MOZ_ASSERT(mInfo.Inited());
+  return mInfo;
+}
+
 void BerytusChallenge::GetParameters(JSContext* aCx,
                               JS::MutableHandle<JSObject*> aRetVal,
                               ErrorResult& aRv) {
@@ -110,6 +126,12 @@ already_AddRefed<Promise> BerytusChallenge::SendMessageRaw(
     aRv.ThrowInvalidStateError("Channel no longer active");
     return nullptr;
   }
+  // Seal() and Abort() are not rate limited so that a page can
+  // always wind down its challenges.
+  if (!BerytusAdmissionControl::Admit(
+        mGlobal, BerytusAdmissionControl::Kind::ChallengeMessage, aRv)) {
+    return nullptr;
+  }
   berytus::AgentProxy& agent = Channel()->Agent();
   MOZ_ASSERT(!agent.IsDisabled());
   berytus::RequestContextWithLoginOperation reqCtx;
@@ -207,7 +229,7 @@ already_AddRefed<Promise> BerytusChallenge::Seal(JSContext* aCx, ErrorResult& aR
   }
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
   JS::Rooted<JS::Value> info(aCx);
-  BuildChallengeInfo(aCx, &info, aRv);
+  GetInfo(aCx, &info, aRv);
   if (NS_WARN_IF(aRv.Failed())) {
     return nullptr;
   }
@@ -253,7 +275,7 @@ already_AddRefed<Promise> BerytusChallenge::Abort(
   }
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
   JS::Rooted<JS::Value> info(aCx);
-  BuildChallengeInfo(aCx, &info, aRv);
+  GetInfo(aCx, &info, aRv);
   if (NS_WARN_IF(aRv.Failed())) {
     return nullptr;
   }
@@ -306,47 +328,30 @@ already_AddRefed<Promise> BerytusChallenge::AbortWithGenericWebAppFailureError(
   return Abort(aCx, BerytusChallengeAbortionCode::GenericWebAppFailure, aRv);
 }
 
-void BerytusChallenge::BuildChallengeInfo(JSContext* aCx, JS::MutableHandle<JS::Value> aRetVal, ErrorResult& aRv) {
-  CacheParameters(aCx, aRv);
-  if (NS_WARN_IF(aRv.Failed())) {
-    return;
-  }
-  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
-  JS::Rooted<JS::Value> id(aCx);
-  if (NS_WARN_IF(!berytus::ToJSVal<nsString>(aCx, mID, &id))) {
-    aRv.Throw(NS_ERROR_FAILURE);
-    return;
-  }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "id", id))) {
-    aRv.Throw(NS_ERROR_FAILURE);
-    return;
-  }
-  size_t types = sizeof(binding_detail::EnumStrings<BerytusChallengeType>::Values) / sizeof(nsLiteralCString);
-  if (NS_WARN_IF(static_cast<uint8_t>(mType) >= types)) {
-    aRv.Throw(NS_ERROR_FAILURE);
-    return;
-  }
-  const auto& typeStr = binding_detail::EnumStrings<BerytusChallengeType>::Values[static_cast<uint8_t>(mType)];
-  JSString* typeJsStr = JS_NewStringCopyN(
-      aCx,
-      typeStr.BeginReading(),
-      typeStr.Length());
-  // TODO(berytus): In AgentProxy.h, check whether JSString* allocs are ok
-  if (NS_WARN_IF(!typeJsStr)) {
-    aRv.Throw(NS_ERROR_OUT_OF_MEMORY);
-    return;
-  }
-  JS::Rooted<JS::Value> type(aCx, JS::StringValue(typeJsStr));
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "type", type))) {
-    aRv.Throw(NS_ERROR_FAILURE);
+void BerytusChallenge::GetInfo(JSContext* aCx, JS::MutableHandle<JS::Value> aRetVal, ErrorResult& aRv) {
+  if (!mCachedInfo) {
+    JS::Rooted<JS::Value> info(aCx);
+    if (NS_WARN_IF(!berytus::ToJSVal(aCx, Info(), &info))) {
+      aRv.Throw(NS_ERROR_FAILURE);
+      return;
+    }
+    MOZ_ASSERT(info.isObject());
+    JS::Rooted<JSObject*> infoObj(aCx, &info.toObject());
+    // The object is shared by all the requests of this challenge.
+    if (NS_WARN_IF(!JS_DeepFreezeObject(aCx, infoObj))) {
+      aRv.Throw(NS_ERROR_FAILURE);
+      return;
+    }
+    mCachedInfo = infoObj;
+    aRetVal.setObject(*infoObj);
     return;
   }
-  JS::Rooted<JS::Value> params(aCx, JS::ObjectOrNullValue(mCachedParameters));
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "parameters", params))) {
+  aRetVal.setObject(*mCachedInfo);
+  if (JS::GetCompartment(mCachedInfo) != js::GetContextCompartment(aCx) &&
+      NS_WARN_IF(!JS_WrapValue(aCx, aRetVal))) {
     aRv.Throw(NS_ERROR_FAILURE);
     return;
   }
-  aRetVal.set(JS::ObjectValue(*obj));
 }
 
 already_AddRefed<Promise> BerytusChallenge::Send(
@@ -357,6 +362,64 @@ already_AddRefed<Promise> BerytusChallenge::Send(
   return SendMessageRaw(aCx, aInput.mName, JS::HandleValue(payload), aRv);
 }
 
+already_AddRefed<Promise> BerytusChallenge::SendSequence(
+    JSContext* aCx,
+    const Sequence<BerytusChallengeMessageRequestDefinition>& aMessageDefs,
+    ErrorResult& aRv) {
+  if (!Connected()) {
+    aRv.ThrowInvalidStateError("Challenge is not connected to a secret manager.");
+    return nullptr;
+  }
+  if (NS_WARN_IF(!Channel()->Active())) {
+    aRv.ThrowInvalidStateError("Channel no longer active");
+    return nullptr;
+  }
+  if (aMessageDefs.IsEmpty()) {
+    aRv.ThrowTypeError("At least one message must be passed.");
+    return nullptr;
+  }
+  // Each message counts against the limit as if it was sent alone;
+  // the sequence is admitted as a whole or not at all.
+  if (!BerytusAdmissionControl::Admit(
+        mGlobal, BerytusAdmissionControl::Kind::ChallengeMessage, aRv,
+        aMessageDefs.Length())) {
+    return nullptr;
+  }
+  berytus::AgentProxy& agent = Channel()->Agent();
+  MOZ_ASSERT(!agent.IsDisabled());
+  berytus::RequestContextWithLoginOperation reqCtx;
+  nsresult rv = berytus::Utils_RequestContextWithLoginOperationMetadata(mGlobal, Channel(), Operation(), nullptr, reqCtx);
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    aRv.Throw(rv);
+    return nullptr;
+  }
+  JS::Rooted<JSObject*> msgs(aCx, JS::NewArrayObject(aCx, aMessageDefs.Length()));
+  if (NS_WARN_IF(!msgs)) {
+    aRv.Throw(NS_ERROR_OUT_OF_MEMORY);
+    return nullptr;
+  }
+  for (size_t i = 0; i < aMessageDefs.Length(); i++) {
+    const auto& def = aMessageDefs[i];
+    JS::Rooted<JS::Value> payload(aCx, def.mRequest);
+    JS::Rooted<JS::Value> msg(aCx);
+    BuildChallengeMessage(aCx, def.mName, payload, &msg, aRv);
+    if (NS_WARN_IF(aRv.Failed())) {
+      return nullptr;
+    }
+    if (NS_WARN_IF(!JS_DefineElement(aCx, msgs, i, msg, JSPROP_ENUMERATE))) {
+      aRv.Throw(NS_ERROR_FAILURE);
+      return nullptr;
+    }
+  }
+  JS::Rooted<JS::Value> args(aCx, JS::ObjectValue(*msgs));
+  RefPtr<Promise> prom = agent.CallSendQuery(aCx, u"accountAuthentication"_ns,
+                             u"respondToChallengeMessages"_ns, reqCtx, args, aRv);
+  if (NS_WARN_IF(aRv.Failed())) {
+    return nullptr;
+  }
+  return MaybeCatchBerytusFailure(prom, aRv);
+}
+
 void BerytusChallenge::BuildChallengeMessage(
     JSContext* aCx,
     const nsString& aMessageName,
@@ -365,7 +428,7 @@ void BerytusChallenge::BuildChallengeMessage(
     ErrorResult& aRv) {
   JS::Rooted<JSObject*> msg(aCx, JS_NewPlainObject(aCx));
   JS::Rooted<JS::Value> info(aCx);
-  BuildChallengeInfo(aCx, &info, aRv);
+  GetInfo(aCx, &info, aRv);
   if (NS_WARN_IF(aRv.Failed())) {
     return;
   }
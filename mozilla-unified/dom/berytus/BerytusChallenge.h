@@ -40,6 +40,8 @@ public:
   template <typename T>
   using SendMessageResult = MozPromise<T, berytus::Failure, true>;
 
+  using InfoType = decltype(berytus::ApproveChallengeRequestArgs::mChallenge);
+
 public:
   BerytusChallenge(nsIGlobalObject* aGlobal,
                    const BerytusChallengeType& aType,
@@ -64,6 +66,17 @@ protected:
   nsString mID;
   bool mActive;
   JS::Heap<JSObject*> mCachedParameters;
+  /**
+   * The challenge info sent along every request concerning this
+   * challenge. Built once by the concrete challenge's constructor
+   * (see InitInfo) and never modified afterwards.
+   */
+  InfoType mInfo;
+  /**
+   * mInfo converted to JS, frozen. Created by the first request
+   * that needs it, in the compartment of that request.
+   */
+  JS::Heap<JSObject*> mCachedInfo;
 
   BerytusChannel* Channel();
   BerytusLoginOperation* Operation();
@@ -75,7 +88,9 @@ public:
   // returning an actual global works.
   nsIGlobalObject* GetParentObject() const;
 
-  void GetId(nsAString& aRetVal);
+  void GetId(nsAString& aRetVal) const;
+
+  const InfoType& Info() const;
 
   BerytusChallengeType Type() const;
 
@@ -89,6 +104,11 @@ public:
                                  const BerytusChallengeMessageRequestDefinition& aInput,
                                  ErrorResult& aRv);
 
+  already_AddRefed<Promise> SendSequence(
+      JSContext* aCx,
+      const Sequence<BerytusChallengeMessageRequestDefinition>& aMessageDefs,
+      ErrorResult& aRv);
+
   already_AddRefed<Promise> SendMessageRaw(JSContext* aCx,
                                         const nsString& aMessageName,
                                         JS::Handle<JS::Value> aMessagePayload,
@@ -129,7 +149,17 @@ public:
 protected:
   virtual void CacheParameters(JSContext* aCx, ErrorResult& aRv) = 0;
 
-  void BuildChallengeInfo(JSContext* aCx, JS::MutableHandle<JS::Value> aRetVal, ErrorResult& aRv);
+  /**
+   * Builds mInfo. Must be called once by the constructor of the
+   * concrete challenge, after its parameters are initialised.
+   */
+  void InitInfo();
+  /**
+   * Sets aRetVal to mInfo converted to JS. The conversion happens
+   * once; subsequent calls return the same (frozen) object, wrapped
+   * into the current compartment if needed.
+   */
+  void GetInfo(JSContext* aCx, JS::MutableHandle<JS::Value> aRetVal, ErrorResult& aRv);
   void BuildChallengeMessage(
       JSContext* aCx,
       const nsString& aMessageName,
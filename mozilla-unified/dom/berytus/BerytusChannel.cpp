@@ -14,14 +14,18 @@
 #include "mozilla/Components.h"
 #include "mozilla/ErrorResult.h"
 #include "mozilla/HoldDropJSObjects.h"
+#include "mozilla/Preferences.h"
 #include "mozilla/RefPtr.h"
 #include "mozilla/berytus/AgentProxy.h"
+#include "mozilla/dom/BerytusAbortFollower.h"
+#include "mozilla/dom/BerytusAdmissionControl.h"
 #include "mozilla/dom/BerytusChannelBinding.h"
 #include "mozilla/dom/BerytusKeyAgreementParameters.h"
 #include "mozilla/dom/BerytusLoginOperation.h"
 #include "mozilla/dom/BerytusWebAppActor.h"
 #include "mozilla/dom/BerytusX509Extension.h"
 #include "mozilla/dom/BindingUtils.h"
+#include "mozilla/dom/CryptoBuffer.h"
 #include "mozilla/dom/Promise.h"
 #include "mozilla/dom/Promise-inl.h" /* Needed for AddCallbacksWithCycleCollectedArgs */
 #include "mozilla/dom/RootedDictionary.h"
@@ -42,7 +46,25 @@
 
 namespace mozilla::dom {
 
-NS_IMPL_CYCLE_COLLECTION_WRAPPERCACHE_WITH_JS_MEMBERS(BerytusChannel, (mGlobal, mWebAppActor, mSecretManagerActor, mKeyAgreementParams, mAgent), (mCachedConstraints))
+NS_IMPL_CYCLE_COLLECTION_CLASS(BerytusChannel)
+
+NS_IMPL_CYCLE_COLLECTION_UNLINK_BEGIN(BerytusChannel)
+  // The idle timer's callback holds a raw pointer to the channel.
+  tmp->StopIdleTimer();
+  NS_IMPL_CYCLE_COLLECTION_UNLINK(mGlobal, mWebAppActor, mSecretManagerActor, mKeyAgreementParams, mAgent)
+  NS_IMPL_CYCLE_COLLECTION_UNLINK_PRESERVED_WRAPPER
+  tmp->mCachedConstraints = nullptr;
+NS_IMPL_CYCLE_COLLECTION_UNLINK_END
+
+NS_IMPL_CYCLE_COLLECTION_TRAVERSE_BEGIN(BerytusChannel)
+  NS_IMPL_CYCLE_COLLECTION_TRAVERSE(mGlobal, mWebAppActor, mSecretManagerActor, mKeyAgreementParams, mAgent)
+NS_IMPL_CYCLE_COLLECTION_TRAVERSE_END
+
+NS_IMPL_CYCLE_COLLECTION_TRACE_BEGIN(BerytusChannel)
+  NS_IMPL_CYCLE_COLLECTION_TRACE_PRESERVED_WRAPPER
+  NS_IMPL_CYCLE_COLLECTION_TRACE_JS_MEMBER_CALLBACK(mCachedConstraints)
+NS_IMPL_CYCLE_COLLECTION_TRACE_END
+
 NS_IMPL_CYCLE_COLLECTING_ADDREF(BerytusChannel)
 NS_IMPL_CYCLE_COLLECTING_RELEASE(BerytusChannel)
 NS_INTERFACE_MAP_BEGIN_CYCLE_COLLECTION(BerytusChannel)
@@ -51,21 +73,41 @@ NS_INTERFACE_MAP_BEGIN_CYCLE_COLLECTION(BerytusChannel)
 NS_INTERFACE_MAP_END
 
 /**
- * A few notes regarding the "at most one channel
- * is active under a browsing context/window" implementation:
+ * A few notes regarding the "at most N channels
+ * are active under a browsing context/window" implementation:
  * AFAIK, present Firefox design enables a child process to
  * manage multiple browsing contexts. Thus, within each child process,
- * we maintain a set of inner window ids where channels are active
- * or in the process of being created. If one process manages one
- * browsing context/window, there would not be a need for a set.
+ * we maintain, per inner window id, the number of channels that are
+ * active or in the process of being created. N is read from the
+ * dom.berytus.channel.max_per_window pref.
  *
  * Also, NOTE(berytus): We assume that in the case when an
  * inner window is destroyed, any BerytusChannel instance should
  * have been deconstructed a priori. Otherwise, an observer for
  * destruction of deleted inner windows should be setup to 
- * clean up entries from the set. TODO(berytus): Verify the above.
+ * clean up entries from the map. TODO(berytus): Verify the above.
  */
-nsTHashSet<uint64_t> BerytusChannel::mRegisteredWindows = nsTHashSet<uint64_t>();
+nsTHashMap<uint64_t, uint32_t> BerytusChannel::mRegisteredWindows = nsTHashMap<uint64_t, uint32_t>();
+
+static bool GetStringProperty(JSContext* aCx,
+                              JS::Handle<JSObject*> aObj,
+                              const char* aName,
+                              nsString& aRv) {
+  JS::Rooted<JS::Value> propVal(aCx);
+  return JS_GetProperty(aCx, aObj, aName, &propVal) &&
+         mozilla::berytus::FromJSVal(aCx, propVal, aRv);
+}
+
+static uint32_t MaxChannelsPerWindow() {
+  int32_t max = Preferences::GetInt("dom.berytus.channel.max_per_window", 4);
+  return max > 0 ? static_cast<uint32_t>(max) : 1;
+}
+
+static uint32_t ChannelIdleTimeoutSeconds() {
+  int32_t timeout =
+    Preferences::GetInt("dom.berytus.channel.idle_timeout_seconds", 1800);
+  return timeout > 0 ? static_cast<uint32_t>(timeout) : 0;
+}
 
 BerytusChannel::BerytusChannel(
   nsIGlobalObject* aGlobal,
@@ -91,14 +133,111 @@ BerytusChannel::BerytusChannel(
   MOZ_ASSERT(aGlobal);
   nsPIDOMWindowInner* inner = aGlobal->GetAsInnerWindow();
   MOZ_ASSERT(inner);
-  MOZ_ASSERT(!CanRegisterInWindow(inner));
+  // The window slot reserved in CreateGuard is only taken over once
+  // the channel is handed to the web app, see HandOver().
   mInnerWindowId = inner->WindowID();
+  mResumptionToken.SetIsVoid(true);
+  StartIdleTimer();
 }
 
 BerytusChannel::~BerytusChannel()
 {
   mozilla::DropJSObjects(this);
-  UnregisterInWindow(mInnerWindowId);
+  StopIdleTimer();
+  ReleaseWindowSlot();
+}
+
+void BerytusChannel::StartIdleTimer() {
+  const uint32_t timeout = ChannelIdleTimeoutSeconds();
+  if (timeout == 0) {
+    return;
+  }
+  // The agent is polled a few times per timeout period, so a channel
+  // is closed at most a quarter of the timeout late.
+  const uint32_t period = std::max(timeout * 1000 / 4, 1000u);
+  // NOTE(berytus): The timer does not keep the channel alive; it is
+  // cancelled upon unlink and destruction.
+  nsresult rv = NS_NewTimerWithCallback(
+    getter_AddRefs(mIdleTimer),
+    [this](nsITimer*) { CloseIfIdle(); },
+    period,
+    nsITimer::TYPE_REPEATING_SLACK,
+    "BerytusChannel::IdleTimer");
+  NS_WARNING_ASSERTION(NS_SUCCEEDED(rv), "Unable to start the idle timer.");
+}
+
+void BerytusChannel::StopIdleTimer() {
+  if (mIdleTimer) {
+    mIdleTimer->Cancel();
+    mIdleTimer = nullptr;
+  }
+}
+
+void BerytusChannel::CloseIfIdle() {
+  if (!Active() || !mAgent || mAgent->IsDisabled() ||
+      mAgent->HasPendingQueries()) {
+    return;
+  }
+  const TimeDuration idle = TimeStamp::Now() - mAgent->LastActivity();
+  if (idle < TimeDuration::FromSeconds(ChannelIdleTimeoutSeconds())) {
+    return;
+  }
+  StopIdleTimer();
+  berytus::RequestContext reqCtx;
+  if (NS_WARN_IF(NS_FAILED(berytus::Utils_RequestContext(mGlobal, this, reqCtx)))) {
+    return;
+  }
+  mAgent->Channel_CloseChannel(reqCtx)->Then(
+    GetCurrentSerialEventTarget(), __func__,
+    [self = RefPtr{this}](void* aIgnore) {
+      self->MarkClosed();
+    },
+    [](const berytus::Failure& aFr) {
+      NS_WARNING("Unable to close the idle channel.");
+    });
+}
+
+void BerytusChannel::HandOver(const RefPtr<Promise>& aOutPromise) {
+  if (aOutPromise->State() != Promise::PromiseState::Pending) {
+    // The creation was aborted while the channel was being created
+    // on the secret manager's end. CreateGuard has released the
+    // window slot already.
+    Abandon();
+    return;
+  }
+  MOZ_ASSERT(mRegisteredWindows.Get(mInnerWindowId) > 0);
+  // From now on, the slot is released on Close() or destruction,
+  // whichever comes first.
+  mHoldsWindowSlot = true;
+  aOutPromise->MaybeResolve(this);
+}
+
+void BerytusChannel::Abandon() {
+  StopIdleTimer();
+  berytus::RequestContext reqCtx;
+  if (NS_WARN_IF(NS_FAILED(berytus::Utils_RequestContext(mGlobal, this, reqCtx)))) {
+    MarkClosed();
+    return;
+  }
+  mAgent->Channel_CloseChannel(reqCtx)->Then(
+    GetCurrentSerialEventTarget(), __func__,
+    [self = RefPtr{this}](void* aIgnore) {
+      self->MarkClosed();
+    },
+    [self = RefPtr{this}](const berytus::Failure& aFr) {
+      NS_WARNING("Unable to close the abandoned channel.");
+      self->MarkClosed();
+    });
+}
+
+void BerytusChannel::MarkClosed() {
+  mActive = false;
+  mPendingX25519Key = nullptr;
+  mX25519Key.reset();
+  StopIdleTimer();
+  RevokeResumption();
+  ReleaseWindowSlot();
+  mAgent->Disable();
 }
 
 JSObject*
@@ -109,6 +248,22 @@ BerytusChannel::WrapObject(JSContext* aCx, JS::Handle<JSObject*> aGivenProto)
 
 nsIGlobalObject* BerytusChannel::GetParentObject() const { return mGlobal; }
 
+void BerytusChannel::AddSizeOfIncludingThis(MallocSizeOf aMallocSizeOf,
+                                            BerytusMemorySizes& aSizes) const {
+  aSizes.mHeap[BerytusMemoryKind::Channel] +=
+    aMallocSizeOf(this) + mId.SizeOfExcludingThisIfUnshared(aMallocSizeOf) +
+    mResumptionToken.SizeOfExcludingThisIfUnshared(aMallocSizeOf);
+  aSizes.mHeldJS[BerytusMemoryKind::Channel] +=
+    SizeOfHeldJSObject(mCachedConstraints, aMallocSizeOf);
+  aSizes.mCount[BerytusMemoryKind::Channel]++;
+  if (mAgent) {
+    aSizes.mHeap[BerytusMemoryKind::AgentProxy] +=
+      mAgent->SizeOfIncludingThis(aMallocSizeOf);
+    aSizes.mCount[BerytusMemoryKind::AgentProxy]++;
+    aSizes.mPendingQueries += mAgent->PendingQueryCount();
+  }
+}
+
 const nsString& BerytusChannel::ID() const {
   return mId;
 }
@@ -183,20 +338,35 @@ berytus::AgentProxy& BerytusChannel::Agent() const {
 
 bool BerytusChannel::RegisterInWindow(nsPIDOMWindowInner* aInner) {
   MOZ_ASSERT(aInner);
-  if (mRegisteredWindows.Contains(aInner->WindowID())) {
+  if (!CanRegisterInWindow(aInner)) {
     return false;
   }
-  mRegisteredWindows.Insert(aInner->WindowID());
+  mRegisteredWindows.LookupOrInsert(aInner->WindowID(), 0)++;
   return true;
 }
 
 void BerytusChannel::UnregisterInWindow(const uint64_t& aInnerWindowId) {
-  mRegisteredWindows.Remove(aInnerWindowId);
+  auto entry = mRegisteredWindows.Lookup(aInnerWindowId);
+  if (NS_WARN_IF(!entry)) {
+    return;
+  }
+  MOZ_ASSERT(entry.Data() > 0);
+  if (--entry.Data() == 0) {
+    entry.Remove();
+  }
 }
 
 bool BerytusChannel::CanRegisterInWindow(nsPIDOMWindowInner* aInner) {
   // NOTE(berytus): Assuming only the main thread can construct objects.
-  return !mRegisteredWindows.Contains(aInner->WindowID());
+  return mRegisteredWindows.Get(aInner->WindowID()) < MaxChannelsPerWindow();
+}
+
+void BerytusChannel::ReleaseWindowSlot() {
+  if (!mHoldsWindowSlot) {
+    return;
+  }
+  mHoldsWindowSlot = false;
+  UnregisterInWindow(mInnerWindowId);
 }
 
 already_AddRefed<Promise> BerytusChannel::Create(
@@ -224,11 +394,15 @@ already_AddRefed<Promise> BerytusChannel::CreateGuard(
     return nullptr;
   }
   if (!CanRegisterInWindow(innerWindow)) {
-    aRv.ThrowInvalidStateError("Channel cannot be created as another one is active in the same window.");
+    aRv.ThrowInvalidStateError("Channel cannot be created as the maximum number of active channels in the same window has been reached.");
+    return nullptr;
+  }
+  if (!BerytusAdmissionControl::Admit(
+        nsGlobal, BerytusAdmissionControl::Kind::ChannelCreation, aRv)) {
     return nullptr;
   }
   uint64_t innWinId = innerWindow->WindowID();
-  MOZ_ASSERT(RegisterInWindow(innerWindow));
+  MOZ_ALWAYS_TRUE(RegisterInWindow(innerWindow));
   RefPtr<Promise> res = CreateInner(nsGlobal, aCx, aOptions, aRv);
   if (NS_WARN_IF(aRv.Failed())) {
     UnregisterInWindow(innWinId);
@@ -251,6 +425,19 @@ already_AddRefed<Promise> BerytusChannel::CreateInner(
   if (NS_WARN_IF(aRv.Failed())) {
     return nullptr;
   }
+  RefPtr<BerytusAbortFollower> abortFollower =
+    BerytusAbortFollower::Create(aOptions.mSignal, outPromise);
+  if (abortFollower && abortFollower->Aborted()) {
+    return outPromise.forget();
+  }
+  berytus::RequestTimeouts timeouts;
+  if (aOptions.mRequestTimeout.WasPassed()) {
+    timeouts.mRequestTimeoutMs.emplace(aOptions.mRequestTimeout.Value());
+  }
+  if (aOptions.mInteractiveRequestTimeout.WasPassed()) {
+    timeouts.mInteractiveRequestTimeoutMs.emplace(
+      aOptions.mInteractiveRequestTimeout.Value());
+  }
   nsCOMPtr<mozIBerytusPromptService> ps =
     mozilla::components::BerytusPromptServiceProxy::Create(&rv);
 
@@ -305,6 +492,84 @@ already_AddRefed<Promise> BerytusChannel::CreateInner(
       scmKeys.AppendElement(key);
     }
   }
+
+  // NOTE(berytus): Have I thought of manually copying aOptions.mConstraints
+  // 's members to a new locally constructed BerytusChannelConstraints?
+  // This could be moved into the lambda perhaps, but lambda needs to copy it...
+  // Is RootedDictionary<...> copyable?
+  JS::PersistentRooted<JS::Value> constraintsJs(aCx);
+  constraintsJs.setNull();
+  if (aOptions.mConstraints.WasPassed()
+      && NS_WARN_IF(!aOptions.mConstraints.Value().ToObjectInternal(aCx, &constraintsJs))) {
+    aRv.Throw(NS_ERROR_FAILURE);
+    return nullptr;
+  }
+
+  auto onReject = [outPromise](JSContext* aCx, JS::Handle<JS::Value> aValue,
+                     ErrorResult& aRv,
+                     const nsCOMPtr<nsIGlobalObject>& aGlobal) {
+    berytus::Failure fr;
+    FromJSVal(aCx, aValue, fr);
+    outPromise->MaybeReject(fr.ToErrorResult());
+  };
+
+  if (aOptions.mResumptionToken.WasPassed()) {
+    Promise* resumePromise;
+    rv = ps->ResumeChannelSession(inner,
+                                  aOptions.mResumptionToken.Value(),
+                                  webAppEd25519Key,
+                                  scmKeys,
+                                  &resumePromise);
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      aRv.Throw(rv);
+      return nullptr;
+    }
+    auto onResumed = [outPromise,
+                      webAppActor = RefPtr<BerytusWebAppActor>(aOptions.mWebApp),
+                      certExt,
+                      constraintsJs,
+                      timeouts](JSContext* aCx,
+                                     JS::Handle<JS::Value> aValue,
+                                     ErrorResult& aRv,
+                                     const nsCOMPtr<nsIGlobalObject>& aGlobal) {
+      if (aValue.isNull()) {
+        outPromise->MaybeRejectWithNotAllowedError(
+          "Channel cannot be resumed; the resumption token is invalid or has expired.");
+        return;
+      }
+      nsString managerId, channelId, scmEd25519Key, resumptionToken;
+      if (NS_WARN_IF(!aValue.isObject())) {
+        outPromise->MaybeReject(NS_ERROR_FAILURE);
+        return;
+      }
+      JS::Rooted<JSObject*> session(aCx, &aValue.toObject());
+      if (NS_WARN_IF(!GetStringProperty(aCx, session, "managerId", managerId)) ||
+          NS_WARN_IF(!GetStringProperty(aCx, session, "channelId", channelId)) ||
+          NS_WARN_IF(!GetStringProperty(aCx, session, "scmEd25519Key", scmEd25519Key)) ||
+          NS_WARN_IF(!GetStringProperty(aCx, session, "resumptionToken", resumptionToken))) {
+        outPromise->MaybeReject(NS_ERROR_FAILURE);
+        return;
+      }
+      RefPtr<BerytusChannel> ch = CreateResumed(aGlobal,
+                                                aCx,
+                                                managerId,
+                                                channelId,
+                                                scmEd25519Key,
+                                                resumptionToken,
+                                                webAppActor,
+                                                constraintsJs,
+                                                certExt,
+                                                timeouts);
+      if (NS_WARN_IF(!ch)) {
+        outPromise->MaybeReject(NS_ERROR_FAILURE);
+        return;
+      }
+      ch->HandOver(outPromise);
+    };
+    resumePromise->AddCallbacksWithCycleCollectedArgs(std::move(onResumed), std::move(onReject), aGlobal);
+    return outPromise.forget();
+  }
+
   rv = ps->PromptUsingPopupNotification(
     inner,
     webAppEd25519Key,
@@ -326,51 +591,69 @@ already_AddRefed<Promise> BerytusChannel::CreateInner(
     return nullptr;
   }
 
-  // NOTE(berytus): Have I thought of manually copying aOptions.mConstraints
-  // 's members to a new locally constructed BerytusChannelConstraints?
-  // This could be moved into the lambda perhaps, but lambda needs to copy it...
-  // Is RootedDictionary<...> copyable?
-  JS::PersistentRooted<JS::Value> constraintsJs(aCx);
-  constraintsJs.setNull();
-  if (aOptions.mConstraints.WasPassed()
-      && NS_WARN_IF(!aOptions.mConstraints.Value().ToObjectInternal(aCx, &constraintsJs))) {
-    aRv.Throw(NS_ERROR_FAILURE);
-    return nullptr;
-  }
-
   auto onResolve = [outPromise,
                               webAppActor = RefPtr<BerytusWebAppActor>(aOptions.mWebApp),
                               certExt,
-                              constraintsJs](JSContext* aCx,
+                              constraintsJs,
+                              resumable = aOptions.mResumable,
+                              timeouts,
+                              abortFollower](JSContext* aCx,
                                              JS::Handle<JS::Value> aValue,
                                              ErrorResult& aRv,
                                              const nsCOMPtr<nsIGlobalObject>& aGlobal)  {
+    if (abortFollower && abortFollower->Aborted()) {
+      // The web app no longer awaits the channel.
+      return;
+    }
+    // The prompt resolves with { id, signingKey? }, where signingKey
+    // is the selected manager's signing key when it was prefetched
+    // while the user was prompted.
     nsString selectedId;
-    if (NS_WARN_IF(!mozilla::berytus::FromJSVal(aCx, aValue, selectedId))) {
+    Maybe<nsString> scmEd25519Key;
+    if (NS_WARN_IF(!aValue.isObject())) {
+      outPromise->MaybeReject(NS_ERROR_FAILURE);
+      return;
+    }
+    JS::Rooted<JSObject*> selection(aCx, &aValue.toObject());
+    JS::Rooted<JS::Value> propVal(aCx);
+    if (NS_WARN_IF(!JS_GetProperty(aCx, selection, "id", &propVal)) ||
+        NS_WARN_IF(!mozilla::berytus::FromJSVal(aCx, propVal, selectedId))) {
+      outPromise->MaybeReject(NS_ERROR_FAILURE);
+      return;
+    }
+    if (NS_WARN_IF(!JS_GetProperty(aCx, selection, "signingKey", &propVal))) {
       outPromise->MaybeReject(NS_ERROR_FAILURE);
       return;
     }
+    if (!propVal.isUndefined()) {
+      scmEd25519Key.emplace();
+      if (NS_WARN_IF(!mozilla::berytus::FromJSVal(aCx, propVal, *scmEd25519Key))) {
+        outPromise->MaybeReject(NS_ERROR_FAILURE);
+        return;
+      }
+    }
     RefPtr<CreationPromise> prom = CreateForScm(aGlobal,
                                                 aCx,
                                                 selectedId,
+                                                scmEd25519Key,
                                                 webAppActor,
                                                 constraintsJs,
-                                                certExt);
+                                                certExt,
+                                                timeouts,
+                                                abortFollower);
     prom->Then(
       GetCurrentSerialEventTarget(), __func__,
-      [outPromise](const RefPtr<BerytusChannel>& aChannel) {
-        outPromise->MaybeResolve(aChannel);
+      [outPromise, resumable, selectedId](const RefPtr<BerytusChannel>& aChannel) {
+        if (resumable &&
+            outPromise->State() == Promise::PromiseState::Pending) {
+          aChannel->StoreForResumption(selectedId, outPromise);
+          return;
+        }
+        aChannel->HandOver(outPromise);
       }, [outPromise](const berytus::Failure& aRs) {
         outPromise->MaybeReject(aRs.ToErrorResult());
       });
   };
-  auto onReject = [outPromise](JSContext* aCx, JS::Handle<JS::Value> aValue,
-                     ErrorResult& aRv,
-                     const nsCOMPtr<nsIGlobalObject>& aGlobal) {
-    berytus::Failure fr;
-    FromJSVal(aCx, aValue, fr);
-    outPromise->MaybeReject(fr.ToErrorResult());
-  };
   selectPromise->AddCallbacksWithCycleCollectedArgs(std::move(onResolve), std::move(onReject), aGlobal);
   return outPromise.forget();
 }
@@ -378,9 +661,12 @@ RefPtr<BerytusChannel::CreationPromise> BerytusChannel::CreateForScm(
   nsIGlobalObject* aGlobal,
   JSContext* aCx,
   const nsString& aSecretManagerId,
+  const Maybe<nsString>& aScmEd25519Key,
   const RefPtr<BerytusWebAppActor>& aWebAppActor,
   JS::PersistentRooted<JS::Value> aConstraints,
-  const RefPtr<BerytusX509Extension>& aCertExt
+  const RefPtr<BerytusX509Extension>& aCertExt,
+  const berytus::RequestTimeouts& aTimeouts,
+  BerytusAbortFollower* aAbortFollower
 ) {
   nsresult rv;
   nsIDToCString uuidString(nsID::GenerateUUID());
@@ -388,6 +674,11 @@ RefPtr<BerytusChannel::CreationPromise> BerytusChannel::CreateForScm(
   RefPtr<mozilla::berytus::OwnedAgentProxy> proxy =
     new mozilla::berytus::OwnedAgentProxy(aGlobal,
                                           aSecretManagerId);
+  proxy->SetRequestTimeouts(aTimeouts);
+  // The queries sent below are cancelled should the creation be
+  // aborted.
+  nsTArray<nsString> requestIds;
+  berytus::AgentProxy::AutoRecordQueries recordQueries(*proxy, requestIds);
   berytus::PreliminaryRequestContext reqCx;
   rv = berytus::Utils_PreliminaryRequestContext(aGlobal, reqCx);
   if (NS_WARN_IF(NS_FAILED(rv))) {
@@ -395,73 +686,200 @@ RefPtr<BerytusChannel::CreationPromise> BerytusChannel::CreateForScm(
         berytus::Failure(rv),
         __func__);
   }
-  berytus::GetSigningKeyArgs reqArgs;
-  rv = berytus::Utils_WebAppActorToVariant(aWebAppActor,
-                                           reqArgs.mWebAppActor);
-  if (NS_WARN_IF(NS_FAILED(rv))) {
-    return CreationPromise::CreateAndReject(
-      berytus::Failure(rv),
-      __func__);
+  RootedDictionary<BerytusChannelConstraints> ct(aCx);
+  {
+    JSAutoRealm ar(aCx, aGlobal->GetGlobalJSObject());
+    if (NS_WARN_IF(!ct.Init(aCx, aConstraints))) {
+      return CreationPromise::CreateAndReject(berytus::Failure(), __func__);
+    }
   }
-  RefPtr<berytus::ManagerGetSigningKeyResult> prom =
-    proxy->Manager_GetSigningKey(reqCx, reqArgs);
-  //JS::PersistentRooted<JS::Value> persistentCt(aCx, aConstraints);
-  return prom->Then(
+  // Resolves with the secret manager's signing key once the channel
+  // is created on its end. When the key was prefetched during the
+  // prompt, creating the channel is all that is left; otherwise, the
+  // key is requested along with the channel creation. Either way,
+  // it is a single round trip.
+  RefPtr<berytus::ChannelBootstrapChannelResult> keyProm;
+  if (aScmEd25519Key.isSome()) {
+    RefPtr<BerytusSecretManagerActor> scmActor =
+      new BerytusSecretManagerActor(aGlobal, *aScmEd25519Key);
+    berytus::CreateChannelArgs args;
+    rv = berytus::Utils_ChannelMetadata(aGlobal,
+                                        channelId,
+                                        ct,
+                                        aWebAppActor,
+                                        scmActor,
+                                        args.mChannel);
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      return CreationPromise::CreateAndReject(berytus::Failure(rv), __func__);
+    }
+    keyProm = proxy->Channel_CreateChannel(reqCx, args)
+      ->Then(
+        GetCurrentSerialEventTarget(), __func__,
+        [scmEd25519Key = *aScmEd25519Key](void*) {
+          return berytus::ChannelBootstrapChannelResult::CreateAndResolve(
+            scmEd25519Key, __func__);
+        },
+        [](berytus::Failure&& aFr) {
+          return berytus::ChannelBootstrapChannelResult::CreateAndReject(
+            std::move(aFr), __func__);
+        });
+  } else {
+    berytus::BootstrapChannelArgs args;
+    rv = berytus::Utils_BootstrapChannelArgs(channelId,
+                                             ct,
+                                             aWebAppActor,
+                                             args);
+    if (NS_WARN_IF(NS_FAILED(rv))) {
+      return CreationPromise::CreateAndReject(berytus::Failure(rv), __func__);
+    }
+    keyProm = proxy->Channel_BootstrapChannel(reqCx, args);
+  }
+  if (aAbortFollower) {
+    aAbortFollower->FollowQueries(proxy, requestIds);
+  }
+  return keyProm->Then(
     GetCurrentSerialEventTarget(), __func__,
-    [channelId, reqCx = std::move(reqCx), aGlobal, aCx, aWebAppActor, aCertExt, proxy, persistentCt = aConstraints](const nsString& scmEd25519Key) -> RefPtr<CreationPromise> {
+    [aCx, channelId, aGlobal, aWebAppActor, aCertExt, proxy, persistentCt = aConstraints](const nsString& scmEd25519Key) -> RefPtr<CreationPromise> {
       RootedDictionary<BerytusChannelConstraints> ct(aCx);
       {
+        // TODO(berytus): Find a way to improve passing of constraints into the lambda.
         JSAutoRealm ar(aCx, aGlobal->GetGlobalJSObject());
         if (NS_WARN_IF(!ct.Init(aCx, persistentCt))) {
           return CreationPromise::CreateAndReject(berytus::Failure(), __func__);
         }
       }
       RefPtr<BerytusSecretManagerActor> scmActor = new BerytusSecretManagerActor(aGlobal, scmEd25519Key);
-      berytus::CreateChannelArgs args;
-      nsresult rv;
-      rv = berytus::Utils_ChannelMetadata(aGlobal,
-                                          channelId,
-                                          ct,
-                                          aWebAppActor,
-                                          scmActor,
-                                          args.mChannel);
-      if (NS_WARN_IF(NS_FAILED(rv))) {
-        return CreationPromise::CreateAndReject(berytus::Failure(rv), __func__);
-      }
-      return proxy->Channel_CreateChannel(reqCx, args)
-        ->Then(
-          GetCurrentSerialEventTarget(), __func__,
-          [aCx, channelId, aGlobal, aWebAppActor, aCertExt, scmActor, proxy, persistentCt](void*) -> RefPtr<CreationPromise> {
-            RootedDictionary<BerytusChannelConstraints> ct(aCx);
-            {
-              // TODO(berytus): Find a way to improve passing of constraints into the lambda.
-              JSAutoRealm ar(aCx, aGlobal->GetGlobalJSObject());
-              if (NS_WARN_IF(!ct.Init(aCx, persistentCt))) {
-                return CreationPromise::CreateAndReject(berytus::Failure(), __func__);
-              }
-            }
-            RefPtr<BerytusChannel> ch = new BerytusChannel(
-              aGlobal,
-              channelId,
-              std::move(ct),
-              aWebAppActor,
-              scmActor,
-              aCertExt,
-              nullptr,
-              proxy
-            );
-            return CreationPromise::CreateAndResolve(ch, __func__);
-          },
-          [](berytus::Failure&& aFr) -> RefPtr<CreationPromise> {
-            return CreationPromise::CreateAndReject(std::move(aFr), __func__);
-          }
-        );
+      RefPtr<BerytusChannel> ch = new BerytusChannel(
+        aGlobal,
+        channelId,
+        std::move(ct),
+        aWebAppActor,
+        scmActor,
+        aCertExt,
+        nullptr,
+        proxy
+      );
+      ch->PrefetchX25519Key();
+      return CreationPromise::CreateAndResolve(ch, __func__);
     },
     [](berytus::Failure&& aFr) -> RefPtr<CreationPromise> {
       return CreationPromise::CreateAndReject(std::move(aFr), __func__);
     });
 }
 
+already_AddRefed<BerytusChannel> BerytusChannel::CreateResumed(
+  nsIGlobalObject* aGlobal,
+  JSContext* aCx,
+  const nsString& aSecretManagerId,
+  const nsString& aChannelId,
+  const nsString& aScmEd25519Key,
+  const nsString& aResumptionToken,
+  const RefPtr<BerytusWebAppActor>& aWebAppActor,
+  JS::Handle<JS::Value> aConstraints,
+  const RefPtr<BerytusX509Extension>& aCertExt,
+  const berytus::RequestTimeouts& aTimeouts
+) {
+  RootedDictionary<BerytusChannelConstraints> ct(aCx);
+  {
+    JSAutoRealm ar(aCx, aGlobal->GetGlobalJSObject());
+    if (NS_WARN_IF(!ct.Init(aCx, aConstraints))) {
+      return nullptr;
+    }
+  }
+  RefPtr<mozilla::berytus::OwnedAgentProxy> proxy =
+    new mozilla::berytus::OwnedAgentProxy(aGlobal, aSecretManagerId);
+  proxy->SetRequestTimeouts(aTimeouts);
+  RefPtr<BerytusSecretManagerActor> scmActor =
+    new BerytusSecretManagerActor(aGlobal, aScmEd25519Key);
+  // NOTE(berytus): The key agreement parameters are not carried
+  // over; the session key, if any, is held by the secret manager
+  // under the same channel id. Neither is the X25519 key prefetched.
+  RefPtr<BerytusChannel> ch = new BerytusChannel(
+    aGlobal,
+    aChannelId,
+    std::move(ct),
+    aWebAppActor,
+    scmActor,
+    aCertExt,
+    nullptr,
+    proxy
+  );
+  ch->mResumptionToken.Assign(aResumptionToken);
+  return ch.forget();
+}
+
+void BerytusChannel::StoreForResumption(const nsString& aSecretManagerId,
+                                        const RefPtr<Promise>& aOutPromise) {
+  nsresult rv;
+  nsCOMPtr<mozIBerytusPromptService> ps =
+    mozilla::components::BerytusPromptServiceProxy::Create(&rv);
+  nsPIDOMWindowInner* inner = mGlobal->GetAsInnerWindow();
+  if (NS_WARN_IF(NS_FAILED(rv)) || NS_WARN_IF(!inner)) {
+    HandOver(aOutPromise);
+    return;
+  }
+  nsString webAppEd25519Key;
+  if (mWebAppActor->Type() == BerytusWebAppActorType::CryptoActor) {
+    static_cast<BerytusCryptoWebAppActor*>(mWebAppActor.get())->GetEd25519Key(webAppEd25519Key);
+  }
+  nsString scmEd25519Key;
+  mSecretManagerActor->GetEd25519Key(scmEd25519Key);
+  Promise* storePromise;
+  rv = ps->StoreChannelSession(inner,
+                               aSecretManagerId,
+                               mId,
+                               scmEd25519Key,
+                               webAppEd25519Key,
+                               &storePromise);
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    HandOver(aOutPromise);
+    return;
+  }
+  storePromise->AddCallbacksWithCycleCollectedArgs(
+    [](JSContext* aCx, JS::Handle<JS::Value> aValue, ErrorResult& aRv,
+       const RefPtr<BerytusChannel>& aSelf,
+       const RefPtr<Promise>& aOutPromise) {
+      nsString token;
+      if (NS_WARN_IF(!mozilla::berytus::FromJSVal(aCx, aValue, token))) {
+        aSelf->HandOver(aOutPromise);
+        return;
+      }
+      if (aSelf->mActive) {
+        aSelf->mResumptionToken.Assign(token);
+      }
+      aSelf->HandOver(aOutPromise);
+    },
+    [](JSContext* aCx, JS::Handle<JS::Value> aValue, ErrorResult& aRv,
+       const RefPtr<BerytusChannel>& aSelf,
+       const RefPtr<Promise>& aOutPromise) {
+      NS_WARNING("Unable to store the channel for resumption.");
+      aSelf->HandOver(aOutPromise);
+    },
+    RefPtr{this}, aOutPromise);
+}
+
+void BerytusChannel::RevokeResumption() {
+  if (mResumptionToken.IsVoid()) {
+    return;
+  }
+  nsString token(mResumptionToken);
+  mResumptionToken.SetIsVoid(true);
+  nsresult rv;
+  nsCOMPtr<mozIBerytusPromptService> ps =
+    mozilla::components::BerytusPromptServiceProxy::Create(&rv);
+  nsPIDOMWindowInner* inner = mGlobal->GetAsInnerWindow();
+  if (NS_WARN_IF(NS_FAILED(rv)) || NS_WARN_IF(!inner)) {
+    return;
+  }
+  // NOTE(berytus): Fire and forget; should revocation fail, the
+  // session expires on its own and cannot be resumed anyway once the
+  // agent-side channel is closed.
+  Promise* revokePromise;
+  rv = ps->RevokeChannelSession(inner, token, &revokePromise);
+  NS_WARNING_ASSERTION(NS_SUCCEEDED(rv),
+                       "Unable to revoke the channel session.");
+}
+
 already_AddRefed<Promise> BerytusChannel::Close(ErrorResult& aRv)
 {
   if (!mActive) {
@@ -484,9 +902,7 @@ already_AddRefed<Promise> BerytusChannel::Close(ErrorResult& aRv)
   prom->Then(
     GetCurrentSerialEventTarget(), __func__,
     [outPromise, this](void* aIgnore) {
-      mActive = false;
-      UnregisterInWindow(mInnerWindowId);
-      mAgent->Disable();
+      MarkClosed();
       outPromise->MaybeResolveWithUndefined();
     }, [outPromise](const berytus::Failure& aRs) {
       outPromise->MaybeReject(aRs.ToErrorResult());
@@ -499,13 +915,31 @@ already_AddRefed<Promise> BerytusChannel::Login(JSContext* aCx, const BerytusOnb
     aRv.ThrowInvalidStateError("Channel already closed.");
     return nullptr;
   }
+  if (!BerytusAdmissionControl::Admit(
+        mGlobal, BerytusAdmissionControl::Kind::Login, aRv)) {
+    return nullptr;
+  }
   RefPtr<Promise> outPromise = Promise::Create(mGlobal, aRv);
   if (NS_WARN_IF(aRv.Failed())) {
     return nullptr;
   }
+  RefPtr<BerytusAbortFollower> abortFollower =
+    BerytusAbortFollower::Create(aOptions.mSignal, outPromise);
+  if (abortFollower && abortFollower->Aborted()) {
+    return outPromise.forget();
+  }
   RefPtr<BerytusChannel> ch = this;
-  RefPtr<BerytusLoginOperation::CreationPromise> prom =
-    BerytusLoginOperation::Create(aCx, mGlobal, ch, aOptions);
+  // Other operations may have queries pending with the same agent;
+  // only those of this one are cancelled upon abortion.
+  nsTArray<nsString> requestIds;
+  RefPtr<BerytusLoginOperation::CreationPromise> prom;
+  {
+    berytus::AgentProxy::AutoRecordQueries recordQueries(*mAgent, requestIds);
+    prom = BerytusLoginOperation::Create(aCx, mGlobal, ch, aOptions);
+  }
+  if (abortFollower) {
+    abortFollower->FollowQueries(mAgent, requestIds);
+  }
   prom->Then(
     GetCurrentSerialEventTarget(), __func__,
     [outPromise](const RefPtr<BerytusLoginOperation>& aOperation) {
@@ -518,6 +952,66 @@ already_AddRefed<Promise> BerytusChannel::Login(JSContext* aCx, const BerytusOnb
   return outPromise.forget();
 }
 
+void BerytusChannel::PrefetchX25519Key() {
+  MOZ_ASSERT(!mPendingX25519Key && mX25519Key.isNothing());
+  if (!mConstraints.mEnableEndToEndEncryption.WasPassed() ||
+      !mConstraints.mEnableEndToEndEncryption.Value()) {
+    return;
+  }
+  if (!Preferences::GetBool(
+          "dom.berytus.key_agreement.prefetch_x25519_key", true)) {
+    return;
+  }
+  berytus::RequestContext reqCx;
+  if (NS_WARN_IF(NS_FAILED(berytus::Utils_RequestContext(mGlobal, this, reqCx)))) {
+    return;
+  }
+  mPendingX25519Key = mAgent->Channel_GenerateX25519Key(reqCx);
+}
+
+RefPtr<berytus::ChannelGenerateX25519KeyResult> BerytusChannel::TakeX25519Key(
+    berytus::RequestContext&& aContext) {
+  if (mX25519Key.isSome()) {
+    return berytus::ChannelGenerateX25519KeyResult::CreateAndResolve(
+      berytus::GenerateX25519KeyResult(nsString(*mX25519Key)), __func__);
+  }
+  RefPtr<berytus::ChannelGenerateX25519KeyResult> prom;
+  if (mPendingX25519Key) {
+    // NOTE(berytus): Should the prefetch have failed, a new key is
+    // requested; a failed background request should not surface here.
+    RefPtr<berytus::ChannelGenerateX25519KeyResult> pending =
+      mPendingX25519Key.forget();
+    prom = pending->Then(
+      GetCurrentSerialEventTarget(), __func__,
+      [](berytus::GenerateX25519KeyResult&& aGen) {
+        return berytus::ChannelGenerateX25519KeyResult::CreateAndResolve(std::move(aGen), __func__);
+      },
+      [self = RefPtr{this}, reqCx = std::move(aContext)](berytus::Failure&& aFr) {
+        if (!self->mActive) {
+          return berytus::ChannelGenerateX25519KeyResult::CreateAndReject(std::move(aFr), __func__);
+        }
+        return self->mAgent->Channel_GenerateX25519Key(reqCx);
+      }
+    );
+  } else {
+    prom = mAgent->Channel_GenerateX25519Key(aContext);
+  }
+  // Keep the key for later calls, e.g. when the page retries after
+  // PrepareKeyAgreementParameters failed.
+  return prom->Then(
+    GetCurrentSerialEventTarget(), __func__,
+    [self = RefPtr{this}](berytus::GenerateX25519KeyResult&& aGen) {
+      if (self->mActive) {
+        self->mX25519Key = Some(aGen.mPublic);
+      }
+      return berytus::ChannelGenerateX25519KeyResult::CreateAndResolve(std::move(aGen), __func__);
+    },
+    [](berytus::Failure&& aFr) {
+      return berytus::ChannelGenerateX25519KeyResult::CreateAndReject(std::move(aFr), __func__);
+    }
+  );
+}
+
 already_AddRefed<Promise> BerytusChannel::PrepareKeyAgreementParameters(
     const nsAString& aWebAppX25519PublicKey,
     ErrorResult& aRv) {
@@ -537,7 +1031,7 @@ already_AddRefed<Promise> BerytusChannel::PrepareKeyAgreementParameters(
     return nullptr;
   }
   RefPtr<berytus::ChannelGenerateX25519KeyResult> prom =
-    mAgent->Channel_GenerateX25519Key(reqCx);
+    TakeX25519Key(std::move(reqCx));
   prom->Then(
     GetCurrentSerialEventTarget(), __func__,
     [this, outPromise, webAppX25519Spki = nsString(aWebAppX25519PublicKey)](const berytus::GenerateX25519KeyResult& aGen) {
@@ -576,31 +1070,111 @@ already_AddRefed<Promise> BerytusChannel::ExchangeKeyAgreementSignatures(
     return nullptr;
   }
   berytus::RequestContext reqCx;
-  berytus::VerifySignedKeyExchangeParametersArgs verifyArgs;
   berytus::SignKeyAgreementParametersArgs signArgs;
   if (NS_WARN_IF(NS_FAILED(berytus::Utils_RequestContext(mGlobal, this, reqCx)))) {
     aRv.Throw(NS_ERROR_FAILURE);
     return nullptr;
   }
-  verifyArgs.mWebAppSignature.Init(aKeyAgreementSignature.Obj());
-  mKeyAgreementParams->ToCanonicalJSON(verifyArgs.mCanonicalJson, aRv);
+  // NOTE(berytus): The web app's signature is verified natively;
+  // this leaves a single round trip to the secret manager (signing).
+  // Secret managers may still be asked to verify the signature, see
+  // dom.berytus.key_agreement.agent_verification.
+  VerifyKeyAgreementSignature(aKeyAgreementSignature,
+                              signArgs.mCanonicalJson,
+                              aRv);
   NS_ENSURE_TRUE(!aRv.Failed(), nullptr);
-  signArgs.mCanonicalJson.Assign(verifyArgs.mCanonicalJson);
   RefPtr<Promise> outPromise = Promise::Create(mGlobal, aRv);
   NS_ENSURE_TRUE(!aRv.Failed(), nullptr);
-  RefPtr<berytus::ChannelVerifySignedKeyExchangeParametersResult> res =
-    mAgent->Channel_VerifySignedKeyExchangeParameters(reqCx,
-                                                      verifyArgs);
+  RefPtr<berytus::ChannelSignKeyExchangeParametersResult> res;
+  if (Preferences::GetBool(
+          "dom.berytus.key_agreement.agent_verification", false)) {
+    berytus::VerifySignedKeyExchangeParametersArgs verifyArgs;
+    verifyArgs.mWebAppSignature.Init(aKeyAgreementSignature.Obj());
+    verifyArgs.mCanonicalJson.Assign(signArgs.mCanonicalJson);
+    JS::PersistentRooted<JSObject*> signature(aCx, aKeyAgreementSignature.Obj());
+    res = mAgent->Channel_VerifySignedKeyExchangeParameters(reqCx,
+                                                            verifyArgs)
+      ->Then(
+        GetCurrentSerialEventTarget(), __func__,
+        [this, reqCx = std::move(reqCx), signArgs = std::move(signArgs), signature](void*) mutable {
+          signArgs.mWebAppSignature.Init(signature);
+          return mAgent->Channel_SignKeyExchangeParameters(reqCx,
+                                                           signArgs);
+        },
+        [](berytus::Failure&& aFr) {
+          return berytus::ChannelSignKeyExchangeParametersResult::CreateAndReject(std::move(aFr), __func__);
+        }
+      );
+  } else {
+    signArgs.mWebAppSignature.Init(aKeyAgreementSignature.Obj());
+    res = mAgent->Channel_SignKeyExchangeParameters(reqCx, signArgs);
+  }
   res->Then(
     GetCurrentSerialEventTarget(), __func__,
-    [this, reqCx = std::move(reqCx), signArgs = std::move(signArgs)](void*) {
-      return mAgent->Channel_SignKeyExchangeParameters(reqCx,
-                                                       signArgs);
+    [aCx, this, outPromise](const berytus::SignKeyAgreementParametersResult& aSigned) {
+      JSAutoRealm ar(aCx, mGlobal->GetGlobalJSObject());
+      JS::Rooted<JS::Value> ab(aCx, JS::ObjectOrNullValue(aSigned.mScmSignature.Obj()));
+      outPromise->MaybeResolveWithClone(aCx, ab);
     },
-    [](berytus::Failure&& aFr) {
-      return berytus::ChannelSignKeyExchangeParametersResult::CreateAndReject(std::move(aFr), __func__);
+    [outPromise](const berytus::Failure& aFr) {
+      outPromise->MaybeReject(aFr.ToErrorResult());
     }
-  )->Then(
+  );
+  return outPromise.forget();
+}
+
+void BerytusChannel::VerifyKeyAgreementSignature(
+    const ArrayBuffer& aKeyAgreementSignature,
+    nsString& aCanonicalJson,
+    ErrorResult& aRv) {
+  MOZ_ASSERT(mKeyAgreementParams);
+  mKeyAgreementParams->ToCanonicalJSON(aCanonicalJson, aRv);
+  NS_ENSURE_TRUE_VOID(!aRv.Failed());
+  CryptoBuffer webAppSignature;
+  if (NS_WARN_IF(!webAppSignature.Assign(aKeyAgreementSignature))) {
+    aRv.Throw(NS_ERROR_OUT_OF_MEMORY);
+    return;
+  }
+  bool valid = false;
+  mKeyAgreementParams->VerifyWebAppSignature(aCanonicalJson, webAppSignature,
+                                             valid, aRv);
+  NS_ENSURE_TRUE_VOID(!aRv.Failed());
+  if (!valid) {
+    aRv.ThrowNotAllowedError("Invalid key agreement signature.");
+  }
+}
+
+/**
+ * JSContext needed to clone ArrayBuffer.
+ */
+already_AddRefed<Promise> BerytusChannel::EstablishEndToEndEncryption(
+    JSContext* aCx,
+    const ArrayBuffer& aKeyAgreementSignature,
+    ErrorResult& aRv) {
+  if (!mActive) {
+    aRv.ThrowInvalidStateError("Channel already closed.");
+    return nullptr;
+  }
+  if (!mKeyAgreementParams) {
+    aRv.ThrowInvalidStateError("Key agreement parameters have not been prepared yet.");
+    return nullptr;
+  }
+  berytus::RequestContext reqCx;
+  berytus::SignKeyAgreementParametersArgs args;
+  if (NS_WARN_IF(NS_FAILED(berytus::Utils_RequestContext(mGlobal, this, reqCx)))) {
+    aRv.Throw(NS_ERROR_FAILURE);
+    return nullptr;
+  }
+  VerifyKeyAgreementSignature(aKeyAgreementSignature,
+                              args.mCanonicalJson,
+                              aRv);
+  NS_ENSURE_TRUE(!aRv.Failed(), nullptr);
+  args.mWebAppSignature.Init(aKeyAgreementSignature.Obj());
+  RefPtr<Promise> outPromise = Promise::Create(mGlobal, aRv);
+  NS_ENSURE_TRUE(!aRv.Failed(), nullptr);
+  RefPtr<berytus::ChannelEstablishEndToEndEncryptionResult> res =
+    mAgent->Channel_EstablishEndToEndEncryption(reqCx, args);
+  res->Then(
     GetCurrentSerialEventTarget(), __func__,
     [aCx, this, outPromise](const berytus::SignKeyAgreementParametersResult& aSigned) {
       JSAutoRealm ar(aCx, mGlobal->GetGlobalJSObject());
@@ -644,4 +1218,12 @@ void BerytusChannel::GetID(nsString& aRv) const {
   aRv.Assign(mId);
 }
 
+void BerytusChannel::GetResumptionToken(nsString& aRv) const {
+  if (mResumptionToken.IsVoid()) {
+    aRv.SetIsVoid(true);
+    return;
+  }
+  aRv.Assign(mResumptionToken);
+}
+
 } // namespace mozilla::dom
@@ -10,14 +10,19 @@
 #include "js/TypeDecls.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/ErrorResult.h"
+#include "mozilla/Maybe.h"
 #include "mozilla/ExtensionPolicyService.h"
+#include "mozilla/dom/BerytusAbortFollower.h"
 #include "mozilla/dom/BerytusChannelBinding.h"
 #include "mozilla/dom/BerytusLoginOperation.h"
+#include "mozilla/dom/BerytusMemoryReporter.h"
 #include "mozilla/dom/BindingDeclarations.h"
 #include "mozilla/dom/RootedDictionary.h"
 #include "nsCycleCollectionParticipant.h"
+#include "nsTHashMap.h"
 #include "nsWrapperCache.h"
 #include "nsIGlobalObject.h"
+#include "nsITimer.h"
 #include "mozilla/dom/TypedArray.h" // ArrayBuffer
 #include "mozilla/berytus/AgentProxy.h" // AgentProxy
 #include "mozilla/dom/BerytusKeyAgreementParameters.h"
@@ -38,7 +43,8 @@ class Promise;
 namespace mozilla::dom {
 
 class BerytusChannel final : public nsISupports /* or NonRefcountedDOMObject if this is a non-refcounted object */,
-                             public nsWrapperCache /* Change wrapperCache in the binding configuration if you don't want this */
+                             public nsWrapperCache /* Change wrapperCache in the binding configuration if you don't want this */,
+                             public BerytusMemoryTracked
 {
 public:
   using CreationPromise = MozPromise<RefPtr<BerytusChannel>, berytus::Failure, true>;
@@ -73,11 +79,71 @@ protected:
   bool mActive = true;
 private:
   uint64_t mInnerWindowId;
+  /**
+   * Set once the channel takes over the window slot reserved by
+   * CreateGuard; the slot is then released exactly once, by
+   * ReleaseWindowSlot(). Until then, CreateGuard releases it should
+   * the creation fail or be aborted.
+   */
+  bool mHoldsWindowSlot = false;
+
+  /**
+   * Void unless the channel is resumable, see
+   * BerytusChannelOptions.resumable.
+   */
+  nsString mResumptionToken;
+
+  /**
+   * Registers the channel for resumption and resolves aOutPromise
+   * with the channel. Should registration fail, the channel is
+   * resolved as a non-resumable channel.
+   */
+  void StoreForResumption(const nsString& aSecretManagerId,
+                          const RefPtr<Promise>& aOutPromise);
+  void RevokeResumption();
+
+  /**
+   * Closes the channel once no request has been sent to the secret
+   * manager for dom.berytus.channel.idle_timeout_seconds (0 disables
+   * the timeout). Requests still awaiting a response keep the channel
+   * alive.
+   */
+  nsCOMPtr<nsITimer> mIdleTimer;
+  void StartIdleTimer();
+  void StopIdleTimer();
+  void CloseIfIdle();
+  void MarkClosed();
+
+  /**
+   * The secret manager's ephemeral X25519 public key. It is requested
+   * in the background once an E2E-enabled channel is created (see
+   * dom.berytus.key_agreement.prefetch_x25519_key), so that
+   * PrepareKeyAgreementParameters does not have to wait for key
+   * generation. At most one key is kept per channel: once received,
+   * it is reused by every PrepareKeyAgreementParameters call, as the
+   * secret manager refuses to generate a second one for the channel.
+   * The private key never leaves the secret manager.
+   */
+  RefPtr<berytus::ChannelGenerateX25519KeyResult> mPendingX25519Key;
+  Maybe<nsString> mX25519Key;
+
+  void PrefetchX25519Key();
+  RefPtr<berytus::ChannelGenerateX25519KeyResult> TakeX25519Key(
+      berytus::RequestContext&& aContext);
+
+  /**
+   * Resolves aOutPromise, the promise returned by Create(), with the
+   * channel. If the creation was aborted in the meantime, the channel
+   * is closed on the secret manager's end instead (see Abandon()).
+   */
+  void HandOver(const RefPtr<Promise>& aOutPromise);
+  void Abandon();
 
   static bool RegisterInWindow(nsPIDOMWindowInner* aInner);
   static bool CanRegisterInWindow(nsPIDOMWindowInner* aInner);
   static void UnregisterInWindow(const uint64_t& aInnerWindowId);
-  static nsTHashSet<uint64_t> mRegisteredWindows;
+  void ReleaseWindowSlot();
+  static nsTHashMap<uint64_t, uint32_t> mRegisteredWindows;
 
   static // Return a raw pointer here to avoid refcounting, but make sure it's safe (the object should be kept alive by the callee).
   already_AddRefed<Promise> CreateInner(const nsCOMPtr<nsIGlobalObject>& aGlobal, JSContext* aCx, const BerytusChannelOptions& options, ErrorResult& aRv);
@@ -92,6 +158,13 @@ public:
 
   JSObject* WrapObject(JSContext* aCx, JS::Handle<JSObject*> aGivenProto) override;
 
+  nsIGlobalObject* GetTrackedGlobal() const override { return mGlobal; }
+  /**
+   * Adds the channel's agent proxy, along with its pending queries.
+   */
+  void AddSizeOfIncludingThis(MallocSizeOf aMallocSizeOf,
+                              BerytusMemorySizes& aSizes) const override;
+
   bool Active() const;
 
   const nsString& ID() const;
@@ -111,6 +184,8 @@ public:
 
   void GetID(nsString& aRv) const;
 
+  void GetResumptionToken(nsString& aRv) const;
+
   // Return a raw pointer here to avoid refcounting, but make sure it's safe (the object should be kept alive by the callee).
   already_AddRefed<BerytusWebAppActor> WebApp() const;
 
@@ -140,14 +215,49 @@ public:
 
   // Return a raw pointer here to avoid refcounting, but make sure it's safe (the object should be kept alive by the callee).
   already_AddRefed<Promise> EnableEndToEndEncryption(ErrorResult& aRv);
+
+  already_AddRefed<Promise> EstablishEndToEndEncryption(
+      JSContext* aCx,
+      const ArrayBuffer& aKeyAgreementSignature,
+      ErrorResult& aRv);
 private:
+  /**
+   * Verifies the web app's key agreement signature natively and
+   * retrieves the canonical JSON of the key agreement parameters.
+   */
+  void VerifyKeyAgreementSignature(
+      const ArrayBuffer& aKeyAgreementSignature,
+      nsString& aCanonicalJson,
+      ErrorResult& aRv);
+
   static RefPtr<CreationPromise> CreateForScm(
     nsIGlobalObject* aGlobal,
     JSContext* aCx,
     const nsString& aSecretManagerId,
+    const Maybe<nsString>& aScmEd25519Key,
     const RefPtr<BerytusWebAppActor>& aWebAppActor,
     JS::PersistentRooted<JS::Value> aConstraints,
-    const RefPtr<BerytusX509Extension>& aCertExt
+    const RefPtr<BerytusX509Extension>& aCertExt,
+    const berytus::RequestTimeouts& aTimeouts,
+    BerytusAbortFollower* aAbortFollower
+  );
+
+  /**
+   * Re-attaches to a channel previously created by a document of
+   * the same origin, see mozIBerytusPromptService::resumeChannelSession.
+   * No request is sent to the secret manager.
+   */
+  static already_AddRefed<BerytusChannel> CreateResumed(
+    nsIGlobalObject* aGlobal,
+    JSContext* aCx,
+    const nsString& aSecretManagerId,
+    const nsString& aChannelId,
+    const nsString& aScmEd25519Key,
+    const nsString& aResumptionToken,
+    const RefPtr<BerytusWebAppActor>& aWebAppActor,
+    JS::Handle<JS::Value> aConstraints,
+    const RefPtr<BerytusX509Extension>& aCertExt,
+    const berytus::RequestTimeouts& aTimeouts
   );
 };
 
@@ -21,7 +21,9 @@ BerytusDigitalSignatureChallenge::BerytusDigitalSignatureChallenge(
     nsIGlobalObject* aGlobal,
     const nsAString& aID) : BerytusChallenge(aGlobal,
                                              BerytusChallengeType::DigitalSignature,
-                                             aID) {}
+                                             aID) {
+  InitInfo();
+}
 
 BerytusDigitalSignatureChallenge::~BerytusDigitalSignatureChallenge() {}
 
@@ -11,6 +11,7 @@
 #include "mozilla/Base64.h"
 #include "mozilla/dom/WebCryptoCommon.h" //WEBCRYPTO_ALG_AES_GCM
 #include "js/PropertyAndElement.h"
+#include "mozilla/UniquePtr.h"
 
 namespace mozilla::dom {
 
@@ -164,6 +165,162 @@ BerytusEncryptionParams_Impl* BerytusAesGcmParams_Impl::Clone(nsresult* aRv) {
                                       mTagLen);
 }
 
+size_t BerytusAesGcmParams_Impl::SizeOfIncludingThis(
+    MallocSizeOf aMallocSizeOf) const {
+  return aMallocSizeOf(this) + SizeOfExcludingThis(aMallocSizeOf);
+}
+
+size_t BerytusAesGcmParams_Impl::SizeOfExcludingThis(
+    MallocSizeOf aMallocSizeOf) const {
+  return mIv.ShallowSizeOfExcludingThis(aMallocSizeOf) +
+         mAdditionalData.ShallowSizeOfExcludingThis(aMallocSizeOf);
+}
+
+BerytusChunkedAesGcmParams_Impl::BerytusChunkedAesGcmParams_Impl(
+  CryptoBuffer&& aIv,
+  CryptoBuffer&& aAdditionalData,
+  const uint8_t& aTagLen,
+  const uint32_t& aChunkSize) : mAesGcm(std::move(aIv),
+                                        std::move(aAdditionalData),
+                                        aTagLen),
+                                mChunkSize(aChunkSize) {
+  MOZ_ASSERT(mChunkSize > 0 && mChunkSize <= kMaxChunkSize);
+}
+
+BerytusChunkedAesGcmParams_Impl::BerytusChunkedAesGcmParams_Impl(
+  BerytusAesGcmParams_Impl&& aAesGcm,
+  const uint32_t& aChunkSize) : mAesGcm(std::move(aAesGcm)),
+                                mChunkSize(aChunkSize) {
+  MOZ_ASSERT(mChunkSize > 0 && mChunkSize <= kMaxChunkSize);
+}
+
+BerytusChunkedAesGcmParams_Impl::~BerytusChunkedAesGcmParams_Impl() {
+
+}
+
+BerytusChunkedAesGcmParams_Impl*
+BerytusChunkedAesGcmParams_Impl::FromDictionary(
+    const BerytusEncryptionParams& aDict, nsresult& aRv) {
+  if (!aDict.mChunkSize.WasPassed()) {
+    aRv = NS_ERROR_DOM_DATA_ERR;
+    return nullptr;
+  }
+  UniquePtr<BerytusAesGcmParams_Impl> aesGcm(
+    BerytusAesGcmParams_Impl::FromDictionary(aDict, aRv));
+  if (NS_FAILED(aRv)) {
+    return nullptr;
+  }
+  return Create(std::move(*aesGcm), aDict.mChunkSize.Value(), aRv);
+}
+
+BerytusChunkedAesGcmParams_Impl*
+BerytusChunkedAesGcmParams_Impl::Create(BerytusAesGcmParams_Impl&& aAesGcm,
+                                        const uint32_t& aChunkSize,
+                                        nsresult& aRv) {
+  if (aChunkSize == 0 || aChunkSize > kMaxChunkSize ||
+      aAesGcm.Iv().Length() != kIvLength) {
+    aRv = NS_ERROR_DOM_DATA_ERR;
+    return nullptr;
+  }
+  aRv = NS_OK;
+  return new BerytusChunkedAesGcmParams_Impl(std::move(aAesGcm), aChunkSize);
+}
+
+void BerytusChunkedAesGcmParams_Impl::GetAlgorithm(nsString& aRv) {
+  aRv.AssignASCII(kAlgorithm);
+}
+
+void BerytusChunkedAesGcmParams_Impl::AsDictionary(JSContext* aCx,
+                              JS::Heap<JSObject*>& aObj,
+                              JS::MutableHandle<JSObject*> aRetVal,
+                              ErrorResult& aErr) {
+  mAesGcm.AsDictionary(aCx, aObj, aRetVal, aErr);
+  if (NS_WARN_IF(aErr.Failed())) {
+    return;
+  }
+  JS::Rooted<JSObject*> obj(aCx, aObj.get());
+  JS::Rooted<JS::Value> name(aCx, JS::StringValue(JS_NewStringCopyZ(aCx, kAlgorithm)));
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "name", name))) {
+    aErr.Throw(NS_ERROR_FAILURE);
+    return;
+  }
+  JS::Rooted<JS::Value> chunkSize(aCx, JS::NumberValue(mChunkSize));
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "chunkSize", chunkSize))) {
+    aErr.Throw(NS_ERROR_FAILURE);
+    return;
+  }
+}
+
+nsresult BerytusChunkedAesGcmParams_Impl::ToJSON(BerytusEncryptionParamsJSON& aRv) {
+  nsresult res = mAesGcm.ToJSON(aRv);
+  if (NS_WARN_IF(NS_FAILED(res))) {
+    return res;
+  }
+  aRv.mName.AssignASCII(kAlgorithm);
+  aRv.mChunkSize.Construct(mChunkSize);
+  return NS_OK;
+}
+
+BerytusEncryptionParams_Impl* BerytusChunkedAesGcmParams_Impl::Clone(nsresult* aRv) {
+  CryptoBuffer copiedIv;
+  CryptoBuffer copiedAddData;
+  if (!copiedIv.Assign(Iv())) {
+    *aRv = NS_ERROR_OUT_OF_MEMORY;
+    return nullptr;
+  }
+  if (!copiedAddData.Assign(AdditionalData())) {
+    *aRv = NS_ERROR_OUT_OF_MEMORY;
+    return nullptr;
+  }
+  *aRv = NS_OK;
+  return new BerytusChunkedAesGcmParams_Impl(std::move(copiedIv),
+                                             std::move(copiedAddData),
+                                             TagLength(),
+                                             mChunkSize);
+}
+
+size_t BerytusChunkedAesGcmParams_Impl::SizeOfIncludingThis(
+    MallocSizeOf aMallocSizeOf) const {
+  return aMallocSizeOf(this) + mAesGcm.SizeOfExcludingThis(aMallocSizeOf);
+}
+
+uint32_t BerytusChunkedAesGcmParams_Impl::PlaintextChunkCount(size_t aLength) const {
+  const uint64_t count = aLength == 0
+    ? 1 : (uint64_t(aLength) + mChunkSize - 1) / mChunkSize;
+  return count > UINT32_MAX ? 0 : uint32_t(count);
+}
+
+uint32_t BerytusChunkedAesGcmParams_Impl::CiphertextChunkCount(size_t aLength) const {
+  const uint32_t tagBytes = TagLength() / 8;
+  const uint64_t chunkLength = uint64_t(mChunkSize) + tagBytes;
+  if (aLength < tagBytes) {
+    return 0;
+  }
+  const uint64_t count = aLength <= chunkLength
+    ? 1 : (uint64_t(aLength) + chunkLength - 1) / chunkLength;
+  // Only a lone last chunk may be empty.
+  const uint64_t lastLength = aLength - (count - 1) * chunkLength;
+  if (count > UINT32_MAX || (count > 1 && lastLength <= tagBytes)) {
+    return 0;
+  }
+  return uint32_t(count);
+}
+
+nsresult BerytusChunkedAesGcmParams_Impl::ChunkNonce(uint32_t aIndex,
+                                                     bool aLast,
+                                                     CryptoBuffer& aRv) const {
+  MOZ_ASSERT(Iv().Length() == kIvLength);
+  if (NS_WARN_IF(!aRv.Assign(Iv()))) {
+    return NS_ERROR_OUT_OF_MEMORY;
+  }
+  aRv[7] ^= uint8_t(aIndex >> 24);
+  aRv[8] ^= uint8_t(aIndex >> 16);
+  aRv[9] ^= uint8_t(aIndex >> 8);
+  aRv[10] ^= uint8_t(aIndex);
+  aRv[11] ^= aLast ? 1 : 0;
+  return NS_OK;
+}
+
 BerytusEncryptedPacket::BerytusEncryptedPacket(
   nsIGlobalObject* aGlobal,
   BerytusEncryptionParams_Impl* aParams,
@@ -211,10 +368,18 @@ already_AddRefed<BerytusEncryptedPacket> BerytusEncryptedPacket::Constructor(
     return nullptr;
   }
 
-  BerytusEncryptionParams_Impl* encParams = BerytusAesGcmParams_Impl::FromDictionary(
-    aParamsDict,
-    res
-  );
+  BerytusEncryptionParams_Impl* encParams;
+  if (aParamsDict.mName.EqualsASCII(BerytusChunkedAesGcmParams_Impl::kAlgorithm)) {
+    encParams = BerytusChunkedAesGcmParams_Impl::FromDictionary(
+      aParamsDict,
+      res
+    );
+  } else {
+    encParams = BerytusAesGcmParams_Impl::FromDictionary(
+      aParamsDict,
+      res
+    );
+  }
   if (NS_WARN_IF(NS_FAILED(res))) {
     aErr.Throw(res);
     return nullptr;
@@ -280,6 +445,20 @@ void BerytusEncryptedPacket::ToJSON(BerytusEncryptedPacketJSON& aRetVal, ErrorRe
 
 nsIGlobalObject* BerytusEncryptedPacket::GetParentObject() const { return mGlobal; }
 
+void BerytusEncryptedPacket::AddSizeOfIncludingThis(
+  MallocSizeOf aMallocSizeOf,
+  BerytusMemorySizes& aSizes) const
+{
+  aSizes.mHeap[BerytusMemoryKind::EncryptedPacket] +=
+    aMallocSizeOf(this) +
+    (mParams ? mParams->SizeOfIncludingThis(aMallocSizeOf) : 0) +
+    mCiphertext.ShallowSizeOfExcludingThis(aMallocSizeOf);
+  aSizes.mHeldJS[BerytusMemoryKind::EncryptedPacket] +=
+    SizeOfHeldJSObject(mCachedParams, aMallocSizeOf) +
+    SizeOfHeldJSObject(mCachedCiphertextArrayBuffer, aMallocSizeOf);
+  aSizes.mCount[BerytusMemoryKind::EncryptedPacket]++;
+}
+
 JSObject*
 BerytusEncryptedPacket::WrapObject(JSContext* aCx, JS::Handle<JSObject*> aGivenProto)
 {
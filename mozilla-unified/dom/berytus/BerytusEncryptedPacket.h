@@ -10,6 +10,7 @@
 #include "js/TypeDecls.h"
 #include "mozilla/AlreadyAddRefed.h"
 #include "mozilla/ErrorResult.h"
+#include "mozilla/dom/BerytusMemoryReporter.h"
 #include "mozilla/dom/BindingDeclarations.h"
 #include "mozilla/dom/SubtleCryptoBinding.h"
 #include "mozilla/dom/UnionTypes.h" // ArrayBufferViewOrArrayBuffer
@@ -22,10 +23,11 @@ namespace mozilla::dom {
 
 struct AesGcmParamsJSON;
 struct BerytusEncryptedPacketJSON;
-// typedefs in WebIDL, for one member, are not translated in C++
-// once there's a union, remove these.
-using BerytusEncryptionParams = AesGcmParams;
-using BerytusEncryptionParamsJSON = AesGcmParamsJSON;
+struct BerytusEncryptionParams;
+struct BerytusEncryptionParamsJSON;
+
+class BerytusAesGcmParams_Impl;
+class BerytusChunkedAesGcmParams_Impl;
 
 class BerytusEncryptionParams_Impl {
 public:
@@ -37,6 +39,13 @@ public:
                             ErrorResult& aErr) = 0;
   virtual nsresult ToJSON(BerytusEncryptionParamsJSON& aRv) = 0;
   virtual BerytusEncryptionParams_Impl* Clone(nsresult* aRv) = 0;
+  virtual size_t SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const = 0;
+  virtual const BerytusAesGcmParams_Impl* AsAesGcmParams() const {
+    return nullptr;
+  }
+  virtual const BerytusChunkedAesGcmParams_Impl* AsChunkedAesGcmParams() const {
+    return nullptr;
+  }
 };
 
 class BerytusAesGcmParams_Impl final : public BerytusEncryptionParams_Impl {
@@ -56,17 +65,101 @@ public:
                                                   nsresult& aRv);
 
   BerytusEncryptionParams_Impl* Clone(nsresult* aRv) override;
+  size_t SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const override;
+  size_t SizeOfExcludingThis(MallocSizeOf aMallocSizeOf) const;
+  const BerytusAesGcmParams_Impl* AsAesGcmParams() const override {
+    return this;
+  }
+
+  const CryptoBuffer& Iv() const { return mIv; }
+  const CryptoBuffer& AdditionalData() const { return mAdditionalData; }
+  const uint8_t& TagLength() const { return mTagLen; }
 protected:
   CryptoBuffer mIv;
   CryptoBuffer mAdditionalData;
   uint8_t mTagLen;
 };
 
+/**
+ * AES-GCM-CHUNKED: the plaintext is split into chunks of ChunkSize()
+ * bytes, each encrypted using AES-GCM with the same additional data;
+ * the ciphertext is the concatenation of the encrypted chunks, tags
+ * included. The last chunk may be shorter, and is empty only if the
+ * plaintext is.
+ *
+ * The nonce of chunk i is the IV XOR-ed with i (big-endian) in bytes
+ * 7 to 10 and, for the last chunk, with 1 in byte 11. A chunk that is
+ * moved, or a ciphertext that is truncated or extended, therefore
+ * fails to authenticate. Since nonces do not depend on other chunks,
+ * chunks can be encrypted and decrypted independently.
+ */
+class BerytusChunkedAesGcmParams_Impl final : public BerytusEncryptionParams_Impl {
+public:
+  constexpr static char kAlgorithm[] = "AES-GCM-CHUNKED";
+  constexpr static uint8_t kIvLength = 12;                  // bytes
+  constexpr static uint32_t kMaxChunkSize = 16 * 1024 * 1024; // bytes
+
+  BerytusChunkedAesGcmParams_Impl(CryptoBuffer&& aIv,
+                                  CryptoBuffer&& aAdditionalData,
+                                  const uint8_t& aTagLen,
+                                  const uint32_t& aChunkSize);
+  BerytusChunkedAesGcmParams_Impl(BerytusAesGcmParams_Impl&& aAesGcm,
+                                  const uint32_t& aChunkSize);
+  ~BerytusChunkedAesGcmParams_Impl();
+  void GetAlgorithm(nsString& aRv) override;
+  void AsDictionary(JSContext* aCx,
+                    JS::Heap<JSObject*>& aObj,
+                    JS::MutableHandle<JSObject*> aRetVal,
+                    ErrorResult& aErr) override;
+  nsresult ToJSON(BerytusEncryptionParamsJSON& aRv) override;
+  /**
+   * Fails with NS_ERROR_DOM_DATA_ERR if chunkSize is missing or out of
+   * range, or if the IV is not kIvLength bytes long.
+   */
+  static BerytusChunkedAesGcmParams_Impl* FromDictionary(
+      const BerytusEncryptionParams& aDict, nsresult& aRv);
+  /**
+   * Same as FromDictionary, for parameters that did not come from a
+   * dictionary, e.g. those of a packet returned by the secret manager.
+   */
+  static BerytusChunkedAesGcmParams_Impl* Create(
+      BerytusAesGcmParams_Impl&& aAesGcm, const uint32_t& aChunkSize,
+      nsresult& aRv);
+
+  BerytusEncryptionParams_Impl* Clone(nsresult* aRv) override;
+  size_t SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const override;
+  const BerytusChunkedAesGcmParams_Impl* AsChunkedAesGcmParams() const override {
+    return this;
+  }
+
+  const CryptoBuffer& Iv() const { return mAesGcm.Iv(); }
+  const CryptoBuffer& AdditionalData() const { return mAesGcm.AdditionalData(); }
+  const uint8_t& TagLength() const { return mAesGcm.TagLength(); }
+  const uint32_t& ChunkSize() const { return mChunkSize; }
+  const BerytusAesGcmParams_Impl& AesGcm() const { return mAesGcm; }
+
+  /**
+   * The number of chunks of a plaintext of aLength bytes, or 0 if it
+   * has too many chunks.
+   */
+  uint32_t PlaintextChunkCount(size_t aLength) const;
+  /**
+   * The number of chunks of a ciphertext of aLength bytes, or 0 if no
+   * ciphertext has this length.
+   */
+  uint32_t CiphertextChunkCount(size_t aLength) const;
+  nsresult ChunkNonce(uint32_t aIndex, bool aLast, CryptoBuffer& aRv) const;
+protected:
+  BerytusAesGcmParams_Impl mAesGcm;
+  uint32_t mChunkSize;
+};
+
 // let x, p, v;
 // x = (new Uint8Array([1])).buffer; p = { name: "AES-GCM", iv: (new Uint8Array([1,2])).buffer, tagLength: 128 }; v = new BerytusEncryptedPacket(p, x);
 
 class BerytusEncryptedPacket final : public nsISupports /* or NonRefcountedDOMObject if this is a non-refcounted object */,
-                                     public nsWrapperCache /* Change wrapperCache in the binding configuration if you don't want this */
+                                     public nsWrapperCache /* Change wrapperCache in the binding configuration if you don't want this */,
+                                     public BerytusMemoryTracked
 {
 public:
   NS_DECL_CYCLE_COLLECTING_ISUPPORTS
@@ -118,6 +211,15 @@ public:
   void ToJSON(BerytusEncryptedPacketJSON& aRetVal, ErrorResult& aErr);
 
   already_AddRefed<BerytusEncryptedPacket> Clone(nsresult* aRv);
+
+  const BerytusEncryptionParams_Impl* GetEncryptionParams() const {
+    return mParams;
+  }
+  const CryptoBuffer& GetCiphertextBuffer() const { return mCiphertext; }
+
+  nsIGlobalObject* GetTrackedGlobal() const override { return mGlobal; }
+  void AddSizeOfIncludingThis(MallocSizeOf aMallocSizeOf,
+                              BerytusMemorySizes& aSizes) const override;
 };
 
 } // namespace mozilla::dom
@@ -15,6 +15,7 @@
 #include "mozilla/dom/BerytusEncryptedPacketBinding.h"
 #include "mozilla/dom/BerytusEncryptedPacket.h"
 #include "mozilla/dom/BerytusFieldBinding.h"
+#include "mozilla/dom/BerytusFieldSchema.h"
 #include "mozilla/dom/RootedDictionary.h"
 #include "mozilla/dom/BerytusFieldValueDictionary.h"
 
@@ -52,6 +53,22 @@ BerytusField::~BerytusField() {
 
 nsIGlobalObject* BerytusField::GetParentObject() const { return mGlobal; }
 
+void BerytusField::AddSizeOfIncludingThis(MallocSizeOf aMallocSizeOf,
+                                          BerytusMemorySizes& aSizes) const {
+  size_t size = aMallocSizeOf(this) +
+    mFieldId.SizeOfExcludingThisIfUnshared(aMallocSizeOf);
+  // Encrypted packet values are tracked on their own.
+  if (!mFieldValue.IsNull() && mFieldValue.Value().IsString()) {
+    size += mFieldValue.Value().GetAsString()
+      .SizeOfExcludingThisIfUnshared(aMallocSizeOf);
+  }
+  aSizes.mHeap[BerytusMemoryKind::Field] += size;
+  aSizes.mHeldJS[BerytusMemoryKind::Field] +=
+    SizeOfHeldJSObject(mCachedOptions, aMallocSizeOf) +
+    SizeOfHeldJSObject(mCachedJson, aMallocSizeOf);
+  aSizes.mCount[BerytusMemoryKind::Field]++;
+}
+
 void BerytusField::GetId(nsString& aRetVal) const
 {
   aRetVal.Assign(mFieldId);
@@ -125,6 +142,53 @@ void BerytusField::ToJSON(JSContext* aCx,
   aRetVal.set(mCachedJson);
 }
 
+void BerytusField::FromSchema(
+  const GlobalObject& aGlobal,
+  const Sequence<BerytusFieldSchemaEntry>& aSchema,
+  const Optional<BerytusFieldSchemaKey>& aKey,
+  nsTArray<RefPtr<BerytusField>>& aRetVal,
+  ErrorResult& aRv) {
+  nsCOMPtr<nsIGlobalObject> global = do_QueryInterface(aGlobal.GetAsSupports());
+  if (!global) {
+    aRv.Throw(NS_ERROR_FAILURE);
+    return;
+  }
+  RefPtr<BerytusFieldSchema> schema =
+    BerytusFieldSchema::Compile(aGlobal.Context(), aSchema, aRv);
+  if (aRv.Failed()) {
+    return;
+  }
+  if (aKey.WasPassed()) {
+    BerytusFieldSchema::UpdateCache(global, aKey.Value(), schema, aRv);
+    if (NS_WARN_IF(aRv.Failed())) {
+      return;
+    }
+  }
+  schema->CreateFields(global, aRetVal);
+}
+
+void BerytusField::FromCachedSchema(
+  const GlobalObject& aGlobal,
+  const BerytusFieldSchemaKey& aKey,
+  Nullable<nsTArray<RefPtr<BerytusField>>>& aRetVal,
+  ErrorResult& aRv) {
+  nsCOMPtr<nsIGlobalObject> global = do_QueryInterface(aGlobal.GetAsSupports());
+  if (!global) {
+    aRv.Throw(NS_ERROR_FAILURE);
+    return;
+  }
+  RefPtr<BerytusFieldSchema> schema =
+    BerytusFieldSchema::LookupCache(global, aKey, aRv);
+  if (NS_WARN_IF(aRv.Failed())) {
+    return;
+  }
+  if (!schema) {
+    aRetVal.SetNull();
+    return;
+  }
+  schema->CreateFields(global, aRetVal.SetValue());
+}
+
 void BerytusField::AddFieldMetadataToCachedJSON(JSContext* aCx, ErrorResult& aRv) {
   MOZ_ASSERT(mCachedJson);
   JS::Rooted<JSObject*> obj(aCx, mCachedJson);
@@ -9,6 +9,7 @@
 
 #include "js/TypeDecls.h"
 #include "mozilla/ErrorResult.h"
+#include "mozilla/dom/BerytusMemoryReporter.h"
 #include "mozilla/dom/BindingDeclarations.h"
 #include "nsCycleCollectionParticipant.h"
 #include "nsWrapperCache.h"
@@ -21,7 +22,8 @@ namespace mozilla::dom {
 class BerytusDataVariant;
 
 class BerytusField : public nsISupports /* or NonRefcountedDOMObject if this is a non-refcounted object */,
-                     public nsWrapperCache /* Change wrapperCache in the binding configuration if you don't want this */
+                     public nsWrapperCache /* Change wrapperCache in the binding configuration if you don't want this */,
+                     public BerytusMemoryTracked
 {
 public:
   using ValueUnion = OwningStringOrBerytusEncryptedPacketOrBerytusFieldValueDictionary;
@@ -58,6 +60,22 @@ public:
   void ToJSON(JSContext* aCx,
               JS::MutableHandle<JSObject*> aRetVal,
               ErrorResult& aRv);
+
+  nsIGlobalObject* GetTrackedGlobal() const override { return mGlobal; }
+  void AddSizeOfIncludingThis(MallocSizeOf aMallocSizeOf,
+                              BerytusMemorySizes& aSizes) const override;
+
+  static void FromSchema(const GlobalObject& aGlobal,
+                         const Sequence<BerytusFieldSchemaEntry>& aSchema,
+                         const Optional<BerytusFieldSchemaKey>& aKey,
+                         nsTArray<RefPtr<BerytusField>>& aRetVal,
+                         ErrorResult& aRv);
+
+  static void FromCachedSchema(
+    const GlobalObject& aGlobal,
+    const BerytusFieldSchemaKey& aKey,
+    Nullable<nsTArray<RefPtr<BerytusField>>>& aRetVal,
+    ErrorResult& aRv);
  protected:
   BerytusField(
     nsIGlobalObject* aGlobal,
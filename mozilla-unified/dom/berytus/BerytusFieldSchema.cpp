@@ -0,0 +1,244 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/dom/BerytusFieldSchema.h"
+#include "mozilla/ClearOnShutdown.h"
+#include "mozilla/StaticPtr.h"
+#include "mozilla/TextUtils.h"
+#include "mozilla/dom/BerytusField.h"
+#include "mozilla/dom/BerytusForeignIdentityField.h"
+#include "mozilla/dom/BerytusIdentityField.h"
+#include "mozilla/dom/BerytusKeyField.h"
+#include "mozilla/dom/BerytusPasswordField.h"
+#include "mozilla/dom/BerytusSecurePasswordField.h"
+#include "mozilla/dom/BerytusSharedKeyField.h"
+#include "nsIGlobalObject.h"
+#include "nsIPrincipal.h"
+#include "nsPrintfCString.h"
+#include "nsTHashMap.h"
+
+namespace mozilla::dom {
+
+namespace {
+
+// ^[a-zA-Z][a-zA-Z0-9_\-]*$, as documented in BerytusField.webidl.
+bool IsValidFieldId(const nsAString& aId) {
+  if (aId.IsEmpty() || !IsAsciiAlpha(aId.First())) {
+    return false;
+  }
+  for (const char16_t c : aId) {
+    if (!IsAsciiAlphanumeric(c) && c != u'_' && c != u'-') {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename FieldT, typename OptionsT>
+RefPtr<BerytusField> CreateField(nsIGlobalObject* aGlobal,
+                                 const nsString& aId,
+                                 const OptionsT& aOptions) {
+  OptionsT options;
+  options = aOptions;
+  return MakeRefPtr<FieldT>(aGlobal, aId, std::move(options));
+}
+
+} // namespace
+
+BerytusFieldSchema::BerytusFieldSchema(nsTArray<Entry>&& aEntries)
+    : mEntries(std::move(aEntries)) {}
+
+template <typename T>
+bool BerytusFieldSchema::InitOptions(JSContext* aCx,
+                                     const BerytusFieldSchemaEntry& aEntry,
+                                     nsTArray<Entry>& aEntries,
+                                     ErrorResult& aRv) {
+  JS::Rooted<JS::Value> value(aCx, aEntry.mOptions);
+  T options;
+  if (!options.Init(aCx, value, "BerytusFieldSchemaEntry.options")) {
+    aRv.StealExceptionFromJSContext(aCx);
+    return false;
+  }
+  aEntries.AppendElement(
+    Entry{aEntry.mId, Options(VariantType<T>(), std::move(options))});
+  return true;
+}
+
+already_AddRefed<BerytusFieldSchema> BerytusFieldSchema::Compile(
+  JSContext* aCx,
+  const Sequence<BerytusFieldSchemaEntry>& aSchema,
+  ErrorResult& aRv) {
+  MOZ_ASSERT(NS_IsMainThread());
+  nsTArray<Entry> entries(aSchema.Length());
+  nsTHashMap<nsStringHashKey, BerytusFieldType> types(aSchema.Length());
+  for (uint32_t i = 0; i < aSchema.Length(); i++) {
+    const BerytusFieldSchemaEntry& entry = aSchema[i];
+    if (!IsValidFieldId(entry.mId)) {
+      aRv.ThrowTypeError(nsPrintfCString(
+        "Invalid field id at schema entry %u.", i));
+      return nullptr;
+    }
+    if (types.Contains(entry.mId)) {
+      aRv.ThrowTypeError(nsPrintfCString(
+        "Duplicate field id at schema entry %u.", i));
+      return nullptr;
+    }
+    types.InsertOrUpdate(entry.mId, entry.mType);
+    bool initialised;
+    switch (entry.mType) {
+      case BerytusFieldType::Identity:
+        initialised = InitOptions<BerytusIdentityFieldOptions>(
+          aCx, entry, entries, aRv);
+        break;
+      case BerytusFieldType::ForeignIdentity:
+        initialised = InitOptions<BerytusForeignIdentityFieldOptions>(
+          aCx, entry, entries, aRv);
+        break;
+      case BerytusFieldType::Password:
+        initialised = InitOptions<BerytusPasswordFieldOptions>(
+          aCx, entry, entries, aRv);
+        break;
+      case BerytusFieldType::SecurePassword:
+        initialised = InitOptions<BerytusSecurePasswordFieldOptions>(
+          aCx, entry, entries, aRv);
+        break;
+      case BerytusFieldType::Key:
+        initialised = InitOptions<BerytusKeyFieldOptions>(
+          aCx, entry, entries, aRv);
+        break;
+      case BerytusFieldType::SharedKey:
+        initialised = InitOptions<BerytusSharedKeyFieldOptions>(
+          aCx, entry, entries, aRv);
+        break;
+      default:
+        // There is no interface for ConsumablePassword and Custom
+        // fields yet.
+        aRv.ThrowNotSupportedError(nsPrintfCString(
+          "Unsupported field type at schema entry %u.", i));
+        return nullptr;
+    }
+    if (!initialised) {
+      return nullptr;
+    }
+  }
+  // A SecurePassword field may refer to an identity field of the
+  // account that is not part of the schema; if it is part of it, it
+  // must be an identity field.
+  for (uint32_t i = 0; i < entries.Length(); i++) {
+    if (!entries[i].mOptions.is<BerytusSecurePasswordFieldOptions>()) {
+      continue;
+    }
+    const nsString& identityFieldId = entries[i]
+      .mOptions.as<BerytusSecurePasswordFieldOptions>().mIdentityFieldId;
+    const Maybe<BerytusFieldType> type = types.MaybeGet(identityFieldId);
+    if (type && *type != BerytusFieldType::Identity &&
+        *type != BerytusFieldType::ForeignIdentity) {
+      aRv.ThrowTypeError(nsPrintfCString(
+        "The identityFieldId of schema entry %u does not refer to an "
+        "identity field.", i));
+      return nullptr;
+    }
+  }
+  return do_AddRef(new BerytusFieldSchema(std::move(entries)));
+}
+
+void BerytusFieldSchema::CreateFields(
+  nsIGlobalObject* aGlobal,
+  nsTArray<RefPtr<BerytusField>>& aRetVal) const {
+  aRetVal.SetCapacity(mEntries.Length());
+  for (const Entry& entry : mEntries) {
+    aRetVal.AppendElement(entry.mOptions.match(
+      [&](const BerytusIdentityFieldOptions& aOptions) {
+        return CreateField<BerytusIdentityField>(aGlobal, entry.mId, aOptions);
+      },
+      [&](const BerytusForeignIdentityFieldOptions& aOptions) {
+        return CreateField<BerytusForeignIdentityField>(aGlobal, entry.mId,
+                                                        aOptions);
+      },
+      [&](const BerytusPasswordFieldOptions& aOptions) {
+        return CreateField<BerytusPasswordField>(aGlobal, entry.mId, aOptions);
+      },
+      [&](const BerytusSecurePasswordFieldOptions& aOptions) {
+        return CreateField<BerytusSecurePasswordField>(aGlobal, entry.mId,
+                                                       aOptions);
+      },
+      [&](const BerytusKeyFieldOptions& aOptions) {
+        return CreateField<BerytusKeyField>(aGlobal, entry.mId, aOptions);
+      },
+      [&](const BerytusSharedKeyFieldOptions& aOptions) {
+        return CreateField<BerytusSharedKeyField>(aGlobal, entry.mId,
+                                                  aOptions);
+      }));
+  }
+}
+
+static const uint32_t sMaxCachedSchemas = 64;
+
+static StaticAutoPtr<nsTHashMap<nsCStringHashKey, RefPtr<BerytusFieldSchema>>>
+    sCachedSchemas;
+
+/**
+ * The origin, the schema version and the category; the category is
+ * last as it is the only part that can contain spaces.
+ */
+static bool GetCacheKey(nsIGlobalObject* aGlobal,
+                        const BerytusFieldSchemaKey& aKey,
+                        nsACString& aRetVal,
+                        ErrorResult& aRv) {
+  nsIPrincipal* principal = aGlobal->PrincipalOrNull();
+  if (NS_WARN_IF(!principal)) {
+    aRv.Throw(NS_ERROR_FAILURE);
+    return false;
+  }
+  nsAutoCString origin;
+  nsresult rv = principal->GetOrigin(origin);
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    aRv.Throw(rv);
+    return false;
+  }
+  aRetVal.Assign(nsPrintfCString(
+    "%s %" PRIu64 " %s", origin.get(), aKey.mSchemaVersion,
+    NS_ConvertUTF16toUTF8(aKey.mCategory).get()));
+  return true;
+}
+
+already_AddRefed<BerytusFieldSchema> BerytusFieldSchema::LookupCache(
+  nsIGlobalObject* aGlobal,
+  const BerytusFieldSchemaKey& aKey,
+  ErrorResult& aRv) {
+  MOZ_ASSERT(NS_IsMainThread());
+  if (!sCachedSchemas) {
+    return nullptr;
+  }
+  nsAutoCString key;
+  if (!GetCacheKey(aGlobal, aKey, key, aRv)) {
+    return nullptr;
+  }
+  RefPtr<BerytusFieldSchema> schema = sCachedSchemas->Get(key);
+  return schema.forget();
+}
+
+void BerytusFieldSchema::UpdateCache(nsIGlobalObject* aGlobal,
+                                     const BerytusFieldSchemaKey& aKey,
+                                     BerytusFieldSchema* aSchema,
+                                     ErrorResult& aRv) {
+  MOZ_ASSERT(NS_IsMainThread());
+  nsAutoCString key;
+  if (!GetCacheKey(aGlobal, aKey, key, aRv)) {
+    return;
+  }
+  if (!sCachedSchemas) {
+    sCachedSchemas =
+      new nsTHashMap<nsCStringHashKey, RefPtr<BerytusFieldSchema>>();
+    ClearOnShutdown(&sCachedSchemas);
+  }
+  if (sCachedSchemas->Count() >= sMaxCachedSchemas) {
+    sCachedSchemas->Clear();
+  }
+  sCachedSchemas->InsertOrUpdate(key, RefPtr{aSchema});
+}
+
+} // namespace mozilla::dom
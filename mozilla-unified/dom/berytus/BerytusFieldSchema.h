@@ -0,0 +1,85 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef DOM_BERYTUSFIELDSCHEMA_H_
+#define DOM_BERYTUSFIELDSCHEMA_H_
+
+#include "js/TypeDecls.h"
+#include "mozilla/ErrorResult.h"
+#include "mozilla/Variant.h"
+#include "mozilla/dom/BerytusFieldBinding.h" // BerytusFieldSchemaEntry
+#include "mozilla/dom/BerytusFieldOptionsBinding.h"
+#include "nsISupportsImpl.h"
+#include "nsTArray.h"
+
+class nsIGlobalObject;
+
+namespace mozilla::dom {
+
+class BerytusField;
+
+/**
+ * A validated field schema, i.e. the entries passed to
+ * BerytusField.fromSchema with the options of each entry converted
+ * to the options dictionary of its field type. Constructing the
+ * fields of a compiled schema does not touch JS.
+ *
+ * Compiled schemas are cached per origin under the
+ * BerytusFieldSchemaKey passed by the web application. Objects are
+ * only constructed on the main thread.
+ */
+class BerytusFieldSchema final {
+public:
+  NS_INLINE_DECL_REFCOUNTING(BerytusFieldSchema)
+
+  static already_AddRefed<BerytusFieldSchema> Compile(
+    JSContext* aCx,
+    const Sequence<BerytusFieldSchemaEntry>& aSchema,
+    ErrorResult& aRv);
+
+  void CreateFields(nsIGlobalObject* aGlobal,
+                    nsTArray<RefPtr<BerytusField>>& aRetVal) const;
+
+  /**
+   * Returns nullptr if no schema is cached under aKey for the origin
+   * of aGlobal.
+   */
+  static already_AddRefed<BerytusFieldSchema> LookupCache(
+    nsIGlobalObject* aGlobal,
+    const BerytusFieldSchemaKey& aKey,
+    ErrorResult& aRv);
+  static void UpdateCache(nsIGlobalObject* aGlobal,
+                          const BerytusFieldSchemaKey& aKey,
+                          BerytusFieldSchema* aSchema,
+                          ErrorResult& aRv);
+
+private:
+  using Options = Variant<BerytusIdentityFieldOptions,
+                          BerytusForeignIdentityFieldOptions,
+                          BerytusPasswordFieldOptions,
+                          BerytusSecurePasswordFieldOptions,
+                          BerytusKeyFieldOptions,
+                          BerytusSharedKeyFieldOptions>;
+  struct Entry {
+    nsString mId;
+    Options mOptions;
+  };
+
+  explicit BerytusFieldSchema(nsTArray<Entry>&& aEntries);
+  ~BerytusFieldSchema() = default;
+
+  template <typename T>
+  static bool InitOptions(JSContext* aCx,
+                          const BerytusFieldSchemaEntry& aEntry,
+                          nsTArray<Entry>& aEntries,
+                          ErrorResult& aRv);
+
+  const nsTArray<Entry> mEntries;
+};
+
+} // namespace mozilla::dom
+
+#endif // DOM_BERYTUSFIELDSCHEMA_H_
@@ -18,7 +18,9 @@ BerytusIdentificationChallenge::BerytusIdentificationChallenge(
     nsIGlobalObject* aGlobal,
     const nsAString& aID) : BerytusChallenge(aGlobal,
                                              BerytusChallengeType::Identification,
-                                             aID) {}
+                                             aID) {
+  InitInfo();
+}
 
 BerytusIdentificationChallenge::~BerytusIdentificationChallenge() {}
 
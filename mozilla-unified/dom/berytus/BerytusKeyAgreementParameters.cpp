@@ -19,6 +19,7 @@
 #include "mozilla/dom/BerytusKeyAgreementParametersBinding.h"
 #include "mozilla/dom/BerytusSecretManagerActor.h"
 #include "mozilla/dom/BerytusWebAppActor.h"
+#include "mozilla/dom/BerytusX509Extension.h" // VerifyEd25519Signature
 #include "mozilla/dom/CryptoBuffer.h"
 #include "mozilla/dom/RootedDictionary.h"
 #include "mozilla/dom/TypedArray.h"
@@ -518,6 +519,29 @@ void BerytusKeyAgreementParameters::ToCanonicalJSON(nsString& aJson, ErrorResult
   NS_ENSURE_TRUE_VOID(writer.End());
 }
 
+void BerytusKeyAgreementParameters::VerifyWebAppSignature(
+    const nsAString& aCanonicalJson,
+    const CryptoBuffer& aSignature,
+    bool& aValid,
+    ErrorResult& aRv) const {
+  NS_ConvertUTF16toUTF8 data(aCanonicalJson);
+  SECItem dataItem = {siBuffer,
+                      reinterpret_cast<unsigned char*>(data.BeginWriting()),
+                      data.Length()};
+  SECItem sigItem = {siBuffer,
+                     const_cast<uint8_t*>(aSignature.Elements()),
+                     static_cast<unsigned int>(aSignature.Length())};
+  nsresult rv = berytus::VerifyEd25519Signature(
+      NS_ConvertUTF16toUTF8(mAuthentication->GetWebApp()),
+      sigItem, dataItem, aValid);
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    aRv.Throw(rv);
+    return;
+  }
+  MOZ_LOG(sLogger, LogLevel::Info,
+          ("VerifyWebAppSignature(): %s\n", aValid ? "Verified" : "Rejected"));
+}
+
 NS_IMPL_CYCLE_COLLECTION_WITH_JS_MEMBERS(SupportsToDictionary, (mGlobal), (mCachedDictionary))
 NS_IMPL_CYCLE_COLLECTING_ADDREF(SupportsToDictionary)
 NS_IMPL_CYCLE_COLLECTING_RELEASE(SupportsToDictionary)
@@ -244,6 +244,18 @@ public:
                      ErrorResult& aRv);
 
   void ToCanonicalJSON(nsString& aJson, ErrorResult& aRv) const;
+
+  /**
+   * Verifies the web app's Ed25519 signature over the UTF-8 encoded
+   * aCanonicalJson, as returned by ToCanonicalJSON, using the web
+   * app's authentication key. aValid is set to false if the signature
+   * does not verify; aRv is only set when the verification could
+   * not be carried out.
+   */
+  void VerifyWebAppSignature(const nsAString& aCanonicalJson,
+                             const CryptoBuffer& aSignature,
+                             bool& aValid,
+                             ErrorResult& aRv) const;
 };
 
 class JSONStructWriter {
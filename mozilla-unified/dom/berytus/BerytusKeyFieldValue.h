@@ -47,6 +47,7 @@ public:
     OwningArrayBufferOrBerytusEncryptedPacket& aRetVal,
     ErrorResult& aRv
   ) const;
+  const BerytusBuffer& PublicKey() const { return *mBuffer; }
 
   void ToJSON(JSContext* aCx,
               JS::MutableHandle<JS::Value> aRetVal,
@@ -15,6 +15,7 @@
 #include "nsIGlobalObject.h"
 #include "mozilla/dom/BerytusAccountAuthenticationOperation.h"
 #include "mozilla/dom/BerytusAccountCreationOperation.h"
+#include "mozilla/Preferences.h"
 
 namespace mozilla::dom {
 
@@ -37,15 +38,95 @@ BerytusLoginOperation::BerytusLoginOperation(
   : mGlobal(aGlobal), mChannel(aChannel), mId(aOperationId), mIntent(aIntent), mActive(true)
 {
     // Add |MOZ_COUNT_CTOR(BerytusLoginOperation);| for a non-refcounted object.
+    StartIdleTimer();
 }
 
 BerytusLoginOperation::~BerytusLoginOperation()
 {
     // Add |MOZ_COUNT_DTOR(BerytusLoginOperation);| for a non-refcounted object.
+    StopIdleTimer();
+}
+
+static uint32_t OperationIdleTimeoutSeconds() {
+  int32_t timeout =
+    Preferences::GetInt("dom.berytus.operation.idle_timeout_seconds", 600);
+  return timeout > 0 ? static_cast<uint32_t>(timeout) : 0;
+}
+
+void BerytusLoginOperation::StartIdleTimer() {
+  const uint32_t timeout = OperationIdleTimeoutSeconds();
+  if (timeout == 0) {
+    return;
+  }
+  const uint32_t period = std::max(timeout * 1000 / 4, 1000u);
+  // NOTE(berytus): The timer does not keep the operation alive; it is
+  // cancelled upon destruction.
+  nsresult rv = NS_NewTimerWithCallback(
+    getter_AddRefs(mIdleTimer),
+    [this](nsITimer*) { CloseIfIdle(); },
+    period,
+    nsITimer::TYPE_REPEATING_SLACK,
+    "BerytusLoginOperation::IdleTimer");
+  NS_WARNING_ASSERTION(NS_SUCCEEDED(rv), "Unable to start the idle timer.");
+}
+
+void BerytusLoginOperation::StopIdleTimer() {
+  if (mIdleTimer) {
+    mIdleTimer->Cancel();
+    mIdleTimer = nullptr;
+  }
+}
+
+// NOTE(berytus): Operations share their channel's agent, hence the
+// channel's activity is used as a proxy for the operation's; in
+// practice, a channel carries one operation at a time.
+void BerytusLoginOperation::CloseIfIdle() {
+  if (!mActive) {
+    StopIdleTimer();
+    return;
+  }
+  if (!mChannel->Active()) {
+    // The agent-side operation went away with the channel.
+    mActive = false;
+    StopIdleTimer();
+    return;
+  }
+  berytus::AgentProxy& agent = mChannel->Agent();
+  if (agent.HasPendingQueries()) {
+    return;
+  }
+  const TimeDuration idle = TimeStamp::Now() - agent.LastActivity();
+  if (idle < TimeDuration::FromSeconds(OperationIdleTimeoutSeconds())) {
+    return;
+  }
+  StopIdleTimer();
+  berytus::RequestContextWithOperation ctx;
+  if (NS_WARN_IF(NS_FAILED(berytus::Utils_RequestContextWithOperationMetadata(
+          mGlobal, mChannel, this, ctx)))) {
+    return;
+  }
+  agent.Login_CloseOperation(ctx)->Then(
+    GetCurrentSerialEventTarget(), __func__,
+    [self = RefPtr{this}]() {
+      self->mActive = false;
+    },
+    [](const berytus::Failure& aFr) {
+      NS_WARNING("Unable to close the idle operation.");
+    });
 }
 
 nsIGlobalObject* BerytusLoginOperation::GetParentObject() const { return mGlobal; }
 
+void BerytusLoginOperation::AddSizeOfIncludingThis(
+  MallocSizeOf aMallocSizeOf,
+  BerytusMemorySizes& aSizes) const
+{
+  // The fields of the operation are tracked on their own.
+  aSizes.mHeap[BerytusMemoryKind::Operation] +=
+    aMallocSizeOf(this) + mId.SizeOfExcludingThisIfUnshared(aMallocSizeOf);
+  aSizes.mCount[BerytusMemoryKind::Operation]++;
+}
+
 BerytusOnboardingIntent BerytusLoginOperation::Intent() const
 {
   return mIntent;
@@ -76,7 +157,9 @@ already_AddRefed<Promise> BerytusLoginOperation::Close(ErrorResult& aRv) {
   RefPtr<berytus::LoginCloseOperationResult> res = mChannel->Agent().Login_CloseOperation(ctx);
   res->Then(
     GetCurrentSerialEventTarget(), __func__,
-    [outPromise]() {
+    [outPromise, self = RefPtr{this}]() {
+      self->mActive = false;
+      self->StopIdleTimer();
       outPromise->MaybeResolve(JS::UndefinedValue());
     },
     [outPromise](const berytus::Failure& aFr) {
@@ -97,7 +180,7 @@ RefPtr<BerytusLoginOperation::CreationPromise> BerytusLoginOperation::Create(
   if (NS_WARN_IF(NS_FAILED(rv))) {
     return CreationPromise::CreateAndReject(berytus::Failure(rv), __func__);
   }
-  berytus::ApproveOperationArgs args;
+  berytus::ApproveOperationAndSnapshotArgs args;
   nsIDToCString oUuidString(nsID::GenerateUUID());
   nsString oId = NS_ConvertUTF8toUTF16(oUuidString.get());
 
@@ -127,15 +210,20 @@ RefPtr<BerytusLoginOperation::CreationPromise> BerytusLoginOperation::Create(
               bool(attr.mValue)));
     }
   }
+  if (aOptions.mUserAttributeProjection.WasPassed()) {
+    args.mUserAttributeProjection.emplace();
+    args.mUserAttributeProjection->AppendElements(
+        aOptions.mUserAttributeProjection.Value());
+  }
 
-  RefPtr<berytus::LoginApproveOperationResult> prom =
-    aChannel->Agent().Login_ApproveOperation(reqCtx, args);
+  // NOTE(berytus): The approval and the initial state of the operation
+  // (record metadata or user attributes) are retrieved in one request.
+  RefPtr<berytus::LoginApproveOperationAndSnapshotResult> prom =
+    aChannel->Agent().Login_ApproveOperationAndSnapshot(reqCtx, args);
   return prom->Then(GetCurrentSerialEventTarget(), __func__,
-    [aCx, aGlobal, aChannel, oId](const berytus::ELoginUserIntent& aIntent) -> RefPtr<BerytusLoginOperation::CreationPromise> {
-      RefPtr<MozPromise<RefPtr<BerytusLoginOperation>, nsresult, false>::Private> nextProm;
-      RefPtr<dom::BerytusLoginOperation> operation;
-      if (aIntent.IsAuthenticate()) {
-        return BerytusAccountAuthenticationOperation::CreateApproved(aGlobal, aChannel, oId)
+    [aCx, aGlobal, aChannel, oId](const berytus::OperationSnapshot& aSnapshot) -> RefPtr<BerytusLoginOperation::CreationPromise> {
+      if (aSnapshot.mIntent.IsAuthenticate()) {
+        return BerytusAccountAuthenticationOperation::CreateApproved(aGlobal, aChannel, oId, aSnapshot)
           ->Then(GetCurrentSerialEventTarget(), __func__,
             [](const RefPtr<BerytusAccountAuthenticationOperation>& op) -> RefPtr<CreationPromise> {
               return CreationPromise::CreateAndResolve(static_cast<RefPtr<BerytusLoginOperation>>(op), __func__);
@@ -144,7 +232,7 @@ RefPtr<BerytusLoginOperation::CreationPromise> BerytusLoginOperation::Create(
             });
       }
       JSAutoRealm ar(aCx, aGlobal->GetGlobalJSObject());
-      return BerytusAccountCreationOperation::CreateApproved(aCx, aGlobal, aChannel, oId)
+      return BerytusAccountCreationOperation::CreateApproved(aCx, aGlobal, aChannel, oId, aSnapshot)
         ->Then(GetCurrentSerialEventTarget(), __func__,
           [](const RefPtr<BerytusAccountCreationOperation>& op) -> RefPtr<CreationPromise> {
             return CreationPromise::CreateAndResolve(static_cast<RefPtr<BerytusLoginOperation>>(op), __func__);
@@ -11,10 +11,12 @@
 #include "mozilla/Attributes.h"
 #include "mozilla/ErrorResult.h"
 #include "mozilla/berytus/AgentProxy.h"
+#include "mozilla/dom/BerytusMemoryReporter.h"
 #include "mozilla/dom/BindingDeclarations.h"
 #include "nsCycleCollectionParticipant.h"
 #include "nsWrapperCache.h"
 #include "nsIGlobalObject.h"
+#include "nsITimer.h"
 #include "mozilla/dom/BerytusChannelBinding.h" // BerytusOnboardingIntent
 
 namespace mozilla::dom {
@@ -22,7 +24,8 @@ namespace mozilla::dom {
 class BerytusChannel;
 
 class BerytusLoginOperation : public nsISupports /* or NonRefcountedDOMObject if this is a non-refcounted object */,
-                              public nsWrapperCache /* Change wrapperCache in the binding configuration if you don't want this */
+                              public nsWrapperCache /* Change wrapperCache in the binding configuration if you don't want this */,
+                              public BerytusMemoryTracked
 {
 public:
   NS_DECL_CYCLE_COLLECTING_ISUPPORTS
@@ -43,6 +46,17 @@ protected:
   const BerytusOnboardingIntent mIntent;
   bool mActive;
 
+  /**
+   * Closes the operation once no request has been sent over the
+   * channel for dom.berytus.operation.idle_timeout_seconds (0 disables
+   * the timeout). Requests still awaiting a response keep the
+   * operation alive.
+   */
+  nsCOMPtr<nsITimer> mIdleTimer;
+  void StartIdleTimer();
+  void StopIdleTimer();
+  void CloseIfIdle();
+
 public:
   // This should return something that eventually allows finding a
   // path to the global this object is associated with.  Most simply,
@@ -57,6 +71,10 @@ public:
 
   void GetID(nsString& aRv) const;
 
+  nsIGlobalObject* GetTrackedGlobal() const override { return mGlobal; }
+  void AddSizeOfIncludingThis(MallocSizeOf aMallocSizeOf,
+                              BerytusMemorySizes& aSizes) const override;
+
   static RefPtr<CreationPromise> Create(
       JSContext* aCx, 
       nsIGlobalObject* aGlobal,
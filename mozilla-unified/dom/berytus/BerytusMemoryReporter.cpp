@@ -0,0 +1,189 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/dom/BerytusMemoryReporter.h"
+#include "js/UbiNode.h"
+#include "mozilla/EnumeratedRange.h"
+#include "nsIGlobalObject.h"
+#include "nsIURI.h"
+#include "nsPIDOMWindow.h"
+#include "nsPrintfCString.h"
+#include "nsTHashMap.h"
+#include "nsThreadUtils.h"
+
+namespace mozilla::dom {
+
+namespace {
+
+// Allocated when the first object is tracked and freed once the
+// last one is destroyed, so that no list outlives its elements.
+LinkedList<BerytusMemoryTracked>* sTracked = nullptr;
+bool sReporterRegistered = false;
+
+MOZ_DEFINE_MALLOC_SIZE_OF(BerytusMallocSizeOf)
+
+const char* KindPath(BerytusMemoryKind aKind) {
+  switch (aKind) {
+    case BerytusMemoryKind::Channel:
+      return "channels";
+    case BerytusMemoryKind::AgentProxy:
+      return "agent-proxies";
+    case BerytusMemoryKind::Operation:
+      return "operations";
+    case BerytusMemoryKind::Field:
+      return "fields";
+    case BerytusMemoryKind::Buffer:
+      return "buffers";
+    case BerytusMemoryKind::EncryptedPacket:
+      return "encrypted-packets";
+    case BerytusMemoryKind::X509Extension:
+      return "x509-allowlists";
+    default:
+      MOZ_ASSERT_UNREACHABLE("Unknown BerytusMemoryKind");
+      return "other";
+  }
+}
+
+nsCString WindowPath(nsPIDOMWindowInner* aInner, bool aAnonymize) {
+  if (!aInner) {
+    return "no-window"_ns;
+  }
+  nsAutoCString url;
+  if (aAnonymize) {
+    url.AppendPrintf("<anonymized-%" PRIu64 ">", aInner->WindowID());
+  } else if (nsIURI* uri = aInner->GetDocumentURI()) {
+    uri->GetSpec(url);
+    // Slashes would split the path in about:memory.
+    url.ReplaceChar('/', '\\');
+  }
+  return nsPrintfCString("window(%s, id=%" PRIu64 ")", url.get(),
+                         aInner->WindowID());
+}
+
+struct WindowEntry {
+  nsCString mPath;
+  BerytusMemorySizes mSizes;
+};
+
+} // namespace
+
+void BerytusMemorySizes::Add(const BerytusMemorySizes& aOther) {
+  for (BerytusMemoryKind kind :
+       MakeEnumeratedRange(BerytusMemoryKind::EndGuard_)) {
+    mHeap[kind] += aOther.mHeap[kind];
+    mHeldJS[kind] += aOther.mHeldJS[kind];
+    mCount[kind] += aOther.mCount[kind];
+  }
+  mPendingQueries += aOther.mPendingQueries;
+}
+
+BerytusMemoryTracked::BerytusMemoryTracked() {
+  MOZ_ASSERT(NS_IsMainThread());
+  if (!sReporterRegistered) {
+    sReporterRegistered = true;
+    RegisterStrongMemoryReporter(new BerytusMemoryReporter());
+  }
+  if (!sTracked) {
+    sTracked = new LinkedList<BerytusMemoryTracked>();
+  }
+  sTracked->insertBack(this);
+}
+
+BerytusMemoryTracked::~BerytusMemoryTracked() {
+  MOZ_ASSERT(NS_IsMainThread());
+  MOZ_ASSERT(isInList());
+  remove();
+  if (sTracked->isEmpty()) {
+    delete sTracked;
+    sTracked = nullptr;
+  }
+}
+
+/* static */
+size_t BerytusMemoryTracked::SizeOfHeldJSObject(
+    const JS::Heap<JSObject*>& aObject, MallocSizeOf aMallocSizeOf) {
+  // Measuring must not expose gray objects to the active JS, hence
+  // the unbarriered read.
+  JSObject* object = aObject.unbarrieredGet();
+  if (!object) {
+    return 0;
+  }
+  return size_t(JS::ubi::Node(object).size(aMallocSizeOf));
+}
+
+NS_IMPL_ISUPPORTS(BerytusMemoryReporter, nsIMemoryReporter)
+
+NS_IMETHODIMP
+BerytusMemoryReporter::CollectReports(nsIHandleReportCallback* aHandleReport,
+                                      nsISupports* aData, bool aAnonymize) {
+  MOZ_ASSERT(NS_IsMainThread());
+  // Keyed by inner window id; 0 for the objects without a window.
+  nsTHashMap<uint64_t, WindowEntry> windows;
+  if (sTracked) {
+    for (BerytusMemoryTracked* object : *sTracked) {
+      nsIGlobalObject* global = object->GetTrackedGlobal();
+      nsPIDOMWindowInner* inner = global ? global->GetAsInnerWindow()
+                                         : nullptr;
+      WindowEntry& entry = windows.LookupOrInsertWith(
+        inner ? inner->WindowID() : 0, [&] {
+          return WindowEntry{WindowPath(inner, aAnonymize), {}};
+        });
+      object->AddSizeOfIncludingThis(BerytusMallocSizeOf, entry.mSizes);
+    }
+  }
+
+  BerytusMemorySizes total;
+  for (const WindowEntry& entry : windows.Values()) {
+    for (BerytusMemoryKind kind :
+         MakeEnumeratedRange(BerytusMemoryKind::EndGuard_)) {
+      if (entry.mSizes.mHeap[kind]) {
+        aHandleReport->Callback(
+          ""_ns,
+          nsPrintfCString("explicit/berytus/%s/%s", entry.mPath.get(),
+                          KindPath(kind)),
+          KIND_HEAP, UNITS_BYTES, int64_t(entry.mSizes.mHeap[kind]),
+          "Memory used by the Berytus objects of a window."_ns, aData);
+      }
+      if (entry.mSizes.mHeldJS[kind]) {
+        aHandleReport->Callback(
+          ""_ns,
+          nsPrintfCString("berytus-held-js/%s/%s", entry.mPath.get(),
+                          KindPath(kind)),
+          KIND_OTHER, UNITS_BYTES, int64_t(entry.mSizes.mHeldJS[kind]),
+          "JS objects kept alive by the Berytus objects of a window, e.g. "
+          "cached options and JSON objects. These are also counted in the "
+          "window's JS zone."_ns,
+          aData);
+      }
+    }
+    total.Add(entry.mSizes);
+  }
+
+  for (BerytusMemoryKind kind :
+       MakeEnumeratedRange(BerytusMemoryKind::EndGuard_)) {
+    aHandleReport->Callback(
+      ""_ns, nsPrintfCString("berytus-heap-by-kind/%s", KindPath(kind)),
+      KIND_OTHER, UNITS_BYTES, int64_t(total.mHeap[kind]),
+      "Memory used by Berytus objects across all windows."_ns, aData);
+    aHandleReport->Callback(
+      ""_ns, nsPrintfCString("berytus-held-js-by-kind/%s", KindPath(kind)),
+      KIND_OTHER, UNITS_BYTES, int64_t(total.mHeldJS[kind]),
+      "JS objects kept alive by Berytus objects across all windows."_ns,
+      aData);
+    aHandleReport->Callback(
+      ""_ns, nsPrintfCString("berytus-objects/%s", KindPath(kind)),
+      KIND_OTHER, UNITS_COUNT, int64_t(total.mCount[kind]),
+      "Live Berytus objects across all windows."_ns, aData);
+  }
+  MOZ_COLLECT_REPORT(
+    "berytus-pending-agent-queries", KIND_OTHER, UNITS_COUNT,
+    total.mPendingQueries,
+    "Agent queries awaiting a response from the secret manager, each "
+    "holding a MozPromise.");
+  return NS_OK;
+}
+
+} // namespace mozilla::dom
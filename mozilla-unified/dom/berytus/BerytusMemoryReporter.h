@@ -0,0 +1,92 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef DOM_BERYTUSMEMORYREPORTER_H_
+#define DOM_BERYTUSMEMORYREPORTER_H_
+
+#include "js/RootingAPI.h"
+#include "mozilla/EnumeratedArray.h"
+#include "mozilla/LinkedList.h"
+#include "mozilla/MemoryReporting.h"
+#include "nsIMemoryReporter.h"
+
+class nsIGlobalObject;
+
+namespace mozilla::dom {
+
+enum class BerytusMemoryKind : uint8_t {
+  Channel,
+  AgentProxy,
+  Operation,
+  Field,
+  Buffer,
+  EncryptedPacket,
+  X509Extension,
+  EndGuard_
+};
+
+/**
+ * The memory held by a tracked object, added up per window by the
+ * reporter. An object may add to several kinds, e.g. a channel adds
+ * its agent proxy.
+ */
+struct BerytusMemorySizes {
+  // malloc'd memory, reported under explicit/berytus.
+  EnumeratedArray<BerytusMemoryKind, size_t,
+                  size_t(BerytusMemoryKind::EndGuard_)> mHeap{};
+  // The JS objects kept alive with HoldJSObjects. These are already
+  // part of the JS zone reports, so they are reported outside of the
+  // explicit tree.
+  EnumeratedArray<BerytusMemoryKind, size_t,
+                  size_t(BerytusMemoryKind::EndGuard_)> mHeldJS{};
+  EnumeratedArray<BerytusMemoryKind, uint32_t,
+                  size_t(BerytusMemoryKind::EndGuard_)> mCount{};
+  // The agent queries awaiting a response from the secret manager.
+  uint32_t mPendingQueries = 0;
+
+  void Add(const BerytusMemorySizes& aOther);
+};
+
+/**
+ * Base of the Berytus objects reported in about:memory. Objects are
+ * tracked from construction to destruction, on the main thread.
+ */
+class BerytusMemoryTracked
+    : public LinkedListElement<BerytusMemoryTracked> {
+public:
+  /**
+   * Null for objects shared across windows, e.g. the cached X.509
+   * allowlists, which are reported process-wide.
+   */
+  virtual nsIGlobalObject* GetTrackedGlobal() const = 0;
+  virtual void AddSizeOfIncludingThis(MallocSizeOf aMallocSizeOf,
+                                      BerytusMemorySizes& aSizes) const = 0;
+
+protected:
+  BerytusMemoryTracked();
+  ~BerytusMemoryTracked();
+
+  static size_t SizeOfHeldJSObject(const JS::Heap<JSObject*>& aObject,
+                                   MallocSizeOf aMallocSizeOf);
+};
+
+/**
+ * Reports the tracked objects under explicit/berytus/window(<url>),
+ * or explicit/berytus/no-window, by kind, along with process-wide
+ * totals by kind, object counts and the pending agent queries.
+ */
+class BerytusMemoryReporter final : public nsIMemoryReporter {
+public:
+  NS_DECL_ISUPPORTS
+  NS_DECL_NSIMEMORYREPORTER
+
+private:
+  ~BerytusMemoryReporter() = default;
+};
+
+} // namespace mozilla::dom
+
+#endif // DOM_BERYTUSMEMORYREPORTER_H_
@@ -18,7 +18,9 @@ BerytusOffChannelOtpChallenge::BerytusOffChannelOtpChallenge(
     nsIGlobalObject* aGlobal,
     const nsAString& aID) : BerytusChallenge(aGlobal,
                                              BerytusChallengeType::OffChannelOtp,
-                                             aID) {}
+                                             aID) {
+  InitInfo();
+}
 
 BerytusOffChannelOtpChallenge::~BerytusOffChannelOtpChallenge() {}
 
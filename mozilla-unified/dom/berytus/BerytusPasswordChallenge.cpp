@@ -18,7 +18,9 @@ BerytusPasswordChallenge::BerytusPasswordChallenge(
     nsIGlobalObject* aGlobal,
     const nsAString& aID) : BerytusChallenge(aGlobal,
                                              BerytusChallengeType::Password,
-                                             aID) {}
+                                             aID) {
+  InitInfo();
+}
 
 BerytusPasswordChallenge::~BerytusPasswordChallenge() {}
 
@@ -58,6 +58,8 @@ public:
   void GetSalt(JSContext* aCx,
                OwningArrayBufferOrBerytusEncryptedPacket& aRetVal,
                ErrorResult& aRv) const;
+  const BerytusBuffer& Salt() const { return *mSalt; }
+  const BerytusBuffer& Verifier() const { return *mVerifier; }
 
   void GetVerifier(JSContext* aCx,
                    OwningArrayBufferOrBerytusEncryptedPacket& aRetVal,
@@ -25,7 +25,9 @@ BerytusSecureRemotePasswordChallenge::BerytusSecureRemotePasswordChallenge(
     BerytusSecureRemotePasswordChallengeParameters&& aParameters) : BerytusChallenge(aGlobal,
                                              BerytusChallengeType::SecureRemotePassword,
                                              aID),
-                            mParameters(std::move(aParameters)) {}
+                            mParameters(std::move(aParameters)) {
+  InitInfo();
+}
 
 BerytusSecureRemotePasswordChallenge::~BerytusSecureRemotePasswordChallenge() {}
 
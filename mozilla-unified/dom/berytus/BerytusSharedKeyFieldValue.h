@@ -42,6 +42,7 @@ public:
     OwningArrayBufferOrBerytusEncryptedPacket& aRetVal,
     ErrorResult& aRv
   );
+  const BerytusBuffer& PrivateKey() const { return *mBuffer; }
 
   void ToJSON(JSContext* aCx,
               JS::MutableHandle<JS::Value> aRetVal,
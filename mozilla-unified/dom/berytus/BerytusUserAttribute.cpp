@@ -11,6 +11,7 @@
 #include "mozilla/dom/BerytusUserAttributeBinding.h"
 #include "nsCycleCollectionParticipant.h"
 #include "mozilla/Base64.h"
+#include "nsPrintfCString.h"
 #include "nsStringFwd.h"
 #include "nsWrapperCache.h"
 
@@ -63,6 +64,11 @@ void BerytusUserAttribute::GetInfo(nsString& aRetVal) const
   aRetVal.Assign(mInfo);
 }
 
+bool BerytusUserAttribute::Loaded() const
+{
+  return true;
+}
+
 bool BerytusUserAttributeImpl<nsString>::CanSetValue(const SourceValueType& aVal) const {
   return aVal.IsString();
 }
@@ -71,6 +77,10 @@ bool BerytusUserAttributeImpl<ArrayBuffer>::CanSetValue(const SourceValueType& a
   return aVal.IsArrayBuffer() || aVal.IsArrayBufferView();
 }
 
+bool BerytusUserAttributeImpl<Blob>::CanSetValue(const SourceValueType& aVal) const {
+  return aVal.IsBlob();
+}
+
 bool BerytusUserAttributeImpl<BerytusEncryptedPacket>::CanSetValue(const SourceValueType& aVal) const {
   return aVal.IsBerytusEncryptedPacket();
 }
@@ -109,6 +119,14 @@ bool BerytusUserAttributeImpl<ArrayBuffer>::SetValue(JSContext* aCx, const Sourc
   return true;
 }
 
+bool BerytusUserAttributeImpl<Blob>::SetValue(JSContext* aCx, const SourceValueType& aVal) {
+  if (NS_WARN_IF(!aVal.IsBlob())) {
+    return false;
+  }
+  mValue.SetAsBlob() = aVal.GetAsBlob();
+  return true;
+}
+
 bool BerytusUserAttributeImpl<BerytusEncryptedPacket>::SetValue(JSContext* aCx, const SourceValueType& aVal) {
   if (NS_WARN_IF(!aVal.IsBerytusEncryptedPacket())) {
     return false;
@@ -157,6 +175,13 @@ already_AddRefed<BerytusUserAttribute> BerytusUserAttribute::Create(
       aMimeType,
       aInfo
     );
+  } else if (aValue.IsBlob()) {
+    attr = new BerytusUserAttributeImpl<Blob>(
+      aGlobal,
+      aId,
+      aMimeType,
+      aInfo
+    );
   } else if (aValue.IsBerytusEncryptedPacket()) {
     attr = new BerytusUserAttributeImpl<BerytusEncryptedPacket>(
       aGlobal,
@@ -176,6 +201,21 @@ already_AddRefed<BerytusUserAttribute> BerytusUserAttribute::Create(
   return attr.forget();
 }
 
+already_AddRefed<BerytusUserAttribute> BerytusUserAttribute::CreateUnloaded(
+    nsIGlobalObject* aGlobal,
+    const nsAString& aId,
+    const nsAString& aMimeType,
+    const nsAString& aInfo
+) {
+  RefPtr<BerytusUserAttribute> attr = new BerytusUserAttributeImpl<Nothing>(
+    aGlobal,
+    aId,
+    aMimeType,
+    aInfo
+  );
+  return attr.forget();
+}
+
 NS_IMPL_ISUPPORTS_CYCLE_COLLECTION_INHERITED_0(BerytusUserAttributeImpl<nsString>, BerytusUserAttribute)
 
 BerytusUserAttributeImpl<nsString>::BerytusUserAttributeImpl(
@@ -260,6 +300,39 @@ void BerytusUserAttributeImpl<ArrayBuffer>::PopulateValueInJSON(JSONValueType& a
   aRetVal.SetAsString().Assign(NS_ConvertASCIItoUTF16(base64Url));
 }
 
+NS_IMPL_ISUPPORTS_CYCLE_COLLECTION_INHERITED_0(BerytusUserAttributeImpl<Blob>, BerytusUserAttribute)
+
+BerytusUserAttributeImpl<Blob>::BerytusUserAttributeImpl(
+  nsIGlobalObject* aGlobal,
+  const nsAString& aId,
+  const nsAString& aMimeType,
+  const nsAString& aInfo
+) : BerytusUserAttribute(aGlobal, aId, aMimeType, aInfo)
+{
+}
+
+BerytusUserAttributeImpl<Blob>::~BerytusUserAttributeImpl() {}
+
+void BerytusUserAttributeImpl<Blob>::GetValue(JSContext* aCx,
+                                              ValueType& aRetVal,
+                                              ErrorResult& aRv) const {
+  MOZ_ASSERT(mValue.IsBlob());
+  aRetVal.SetAsBlob() = mValue.GetAsBlob();
+}
+
+BerytusUserAttributeValueEncodingType BerytusUserAttributeImpl<Blob>::ValueEncodingType() const {
+  MOZ_ASSERT(mValue.IsBlob());
+  return BerytusUserAttributeValueEncodingType::None;
+}
+
+void BerytusUserAttributeImpl<Blob>::PopulateValueInJSON(JSONValueType& aRetVal,
+                                                         ErrorResult& aErr) const {
+  aErr.ThrowNotSupportedError(nsPrintfCString(
+    "The value of user attribute '%s' is a Blob and cannot be "
+    "serialised to JSON; read it with value.stream() instead.",
+    NS_ConvertUTF16toUTF8(mId).get()));
+}
+
 NS_IMPL_ISUPPORTS_CYCLE_COLLECTION_INHERITED_0(BerytusUserAttributeImpl<BerytusEncryptedPacket>, BerytusUserAttribute)
 
 BerytusUserAttributeImpl<BerytusEncryptedPacket>::BerytusUserAttributeImpl(
@@ -296,4 +369,50 @@ void BerytusUserAttributeImpl<BerytusEncryptedPacket>::PopulateValueInJSON(JSONV
   mValue.GetAsBerytusEncryptedPacket()->ToJSON(aRetVal.SetAsBerytusEncryptedPacketJSON(), aErr);
 }
 
+NS_IMPL_ISUPPORTS_CYCLE_COLLECTION_INHERITED_0(BerytusUserAttributeImpl<Nothing>, BerytusUserAttribute)
+
+BerytusUserAttributeImpl<Nothing>::BerytusUserAttributeImpl(
+  nsIGlobalObject* aGlobal,
+  const nsAString& aId,
+  const nsAString& aMimeType,
+  const nsAString& aInfo
+) : BerytusUserAttribute(aGlobal, aId, aMimeType, aInfo)
+{
+}
+
+BerytusUserAttributeImpl<Nothing>::~BerytusUserAttributeImpl() {}
+
+bool BerytusUserAttributeImpl<Nothing>::Loaded() const {
+  return false;
+}
+
+bool BerytusUserAttributeImpl<Nothing>::CanSetValue(const SourceValueType& aVal) const {
+  return false;
+}
+
+bool BerytusUserAttributeImpl<Nothing>::SetValue(JSContext* aCx, const SourceValueType& aVal) {
+  return false;
+}
+
+void BerytusUserAttributeImpl<Nothing>::GetValue(JSContext* aCx,
+                                                 ValueType& aRetVal,
+                                                 ErrorResult& aRv) const {
+  aRv.ThrowInvalidStateError(nsPrintfCString(
+    "The value of user attribute '%s' is not loaded; "
+    "call loadUserAttributes() first.",
+    NS_ConvertUTF16toUTF8(mId).get()));
+}
+
+BerytusUserAttributeValueEncodingType BerytusUserAttributeImpl<Nothing>::ValueEncodingType() const {
+  return BerytusUserAttributeValueEncodingType::None;
+}
+
+void BerytusUserAttributeImpl<Nothing>::PopulateValueInJSON(JSONValueType& aRetVal,
+                                                            ErrorResult& aErr) const {
+  aErr.ThrowInvalidStateError(nsPrintfCString(
+    "The value of user attribute '%s' is not loaded; "
+    "call loadUserAttributes() first.",
+    NS_ConvertUTF16toUTF8(mId).get()));
+}
+
 } // namespace mozilla::dom
@@ -10,7 +10,9 @@
 #include "BerytusEncryptedPacket.h"
 #include "js/TypeDecls.h"
 #include "mozilla/ErrorResult.h"
+#include "mozilla/Maybe.h"
 #include "mozilla/dom/BindingDeclarations.h"
+#include "mozilla/dom/Blob.h"
 #include "nsCycleCollectionParticipant.h"
 #include "nsISupports.h"
 #include "nsWrapperCache.h"
@@ -23,8 +25,8 @@ class BerytusUserAttribute : public nsISupports /* or NonRefcountedDOMObject if
                              public nsWrapperCache /* Change wrapperCache in the binding configuration if you don't want this */
 {
 public:
-  using ValueType = OwningStringOrArrayBufferOrBerytusEncryptedPacket;
-  using SourceValueType = OwningStringOrArrayBufferViewOrArrayBufferOrBerytusEncryptedPacket;
+  using ValueType = OwningStringOrArrayBufferOrBlobOrBerytusEncryptedPacket;
+  using SourceValueType = OwningStringOrArrayBufferViewOrArrayBufferOrBlobOrBerytusEncryptedPacket;
   using JSONValueType = OwningStringOrBerytusEncryptedPacketJSON;
 
   NS_DECL_CYCLE_COLLECTING_ISUPPORTS
@@ -57,6 +59,8 @@ public:
 
   void GetInfo(nsString& aRetVal) const;
 
+  virtual bool Loaded() const;
+
   virtual void GetValue(
     JSContext* aCx,
     ValueType& aRetVal,
@@ -80,6 +84,17 @@ public:
       const SourceValueType& aValue,
       nsresult& aRv
   );
+
+  /**
+   * Creates an attribute whose value has not been retrieved;
+   * see BerytusAccount::LoadUserAttributes.
+   */
+  static already_AddRefed<BerytusUserAttribute> CreateUnloaded(
+      nsIGlobalObject* aGlobal,
+      const nsAString& aId,
+      const nsAString& aMimeType,
+      const nsAString& aInfo
+  );
 protected:
   virtual void PopulateValueInJSON(JSONValueType& aRetVal,
                                    ErrorResult& aErr) const = 0;
@@ -142,6 +157,37 @@ protected:
                            ErrorResult& aErr) const override;
 };
 
+/**
+ * A binary value held by reference. The Blob is handed to and from the
+ * agent as is, so its contents are never read into memory here; the
+ * page reads them in chunks through Blob.stream().
+ */
+template<>
+class BerytusUserAttributeImpl<Blob> final : public BerytusUserAttribute {
+public:
+  NS_DECL_ISUPPORTS_INHERITED
+protected:
+  ~BerytusUserAttributeImpl();
+public:
+  BerytusUserAttributeImpl(
+    nsIGlobalObject* aGlobal,
+    const nsAString& aId,
+    const nsAString& aMimeType,
+    const nsAString& aInfo
+  );
+  bool CanSetValue(const SourceValueType& aVal) const override;
+  bool SetValue(JSContext* aCx, const SourceValueType& aVal) override;
+  void GetValue(
+    JSContext* aCx,
+    ValueType& aRetVal,
+    ErrorResult& aRv
+  ) const override;
+  BerytusUserAttributeValueEncodingType ValueEncodingType() const override;
+protected:
+  void PopulateValueInJSON(JSONValueType& aRetVal,
+                           ErrorResult& aErr) const override;
+};
+
 template<>
 class BerytusUserAttributeImpl<BerytusEncryptedPacket> final : public BerytusUserAttribute {
 public:
@@ -169,6 +215,32 @@ protected:
                            ErrorResult& aErr) const override;
 };
 
+template<>
+class BerytusUserAttributeImpl<Nothing> final : public BerytusUserAttribute {
+public:
+  NS_DECL_ISUPPORTS_INHERITED
+protected:
+  ~BerytusUserAttributeImpl();
+public:
+  BerytusUserAttributeImpl(
+    nsIGlobalObject* aGlobal,
+    const nsAString& aId,
+    const nsAString& aMimeType,
+    const nsAString& aInfo
+  );
+  bool Loaded() const override;
+  bool CanSetValue(const SourceValueType& aVal) const override;
+  bool SetValue(JSContext* aCx, const SourceValueType& aVal) override;
+  void GetValue(
+    JSContext* aCx,
+    ValueType& aRetVal,
+    ErrorResult& aRv
+  ) const override;
+  BerytusUserAttributeValueEncodingType ValueEncodingType() const override;
+protected:
+  void PopulateValueInJSON(JSONValueType& aRetVal,
+                           ErrorResult& aErr) const override;
+};
 
 } // namespace mozilla::dom
 
@@ -73,6 +73,15 @@ for (const auto& attr : mAttributes) {
   return nullptr;
 }
 
+void BerytusUserAttributeMap::GetUnloadedAttributeIds(nsTArray<nsString>& aRetVal) const {
+  for (const auto& attr : mAttributes) {
+    if (attr->Loaded()) {
+      continue;
+    }
+    attr->GetId(*aRetVal.AppendElement());
+  }
+}
+
 void BerytusUserAttributeMap::RemoveAttribute(const nsString& aId, ErrorResult& aRv) {
   for (size_t i = 0; i < mAttributes.Length(); i++) {
     const auto& attr = mAttributes.ElementAt(i);
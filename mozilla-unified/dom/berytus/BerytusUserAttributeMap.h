@@ -37,6 +37,7 @@ public:
   void RemoveAttribute(const nsString& aId, ErrorResult& aRv);
   bool HasAttribute(const nsString& aId);
   RefPtr<BerytusUserAttribute> GetAttribute(const nsString& aId);
+  void GetUnloadedAttributeIds(nsTArray<nsString>& aRetVal) const;
   // This should return something that eventually allows finding a
   // path to the global this object is associated with.  Most simply,
   // returning an actual global works.
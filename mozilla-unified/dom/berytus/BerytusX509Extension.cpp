@@ -8,8 +8,16 @@
 #include "ErrorList.h"
 #include "cert.h"
 #include "certt.h"
+#include "keyhi.h"
 #include "mozilla/Assertions.h"
+#include "mozilla/Base64.h"
+#include "mozilla/ClearOnShutdown.h"
 #include "mozilla/Components.h"
+#include "mozilla/StaticPtr.h"
+#include "nsTHashMap.h"
+#include "pk11pub.h"
+#include "ScopedNSSTypes.h"
+#include "secasn1.h"
 #include "nsCOMPtr.h"
 #include "nsCycleCollectionParticipant.h"
 #include "nsDebug.h"
@@ -205,6 +213,65 @@ nsresult CompareParts(const nsCString& aSearchString,
   aRv = true;
   return NS_OK;
 }
+
+nsresult VerifyEd25519Signature(const nsCString& aSpki,
+                                const SECItem& aSignature,
+                                const SECItem& aData,
+                                bool& aRv) {
+  nsAutoCString spkiDer;
+  if (NS_FAILED(Base64Decode(aSpki, spkiDer))) {
+    MOZ_LOG(sLogger, LogLevel::Warning,
+            ("VerifyEd25519Signature(): Rejected; Reason: Bad base64 encoding.\n"));
+    aRv = false;
+    return NS_OK;
+  }
+  SECItem spkiItem = {siBuffer,
+                      reinterpret_cast<unsigned char*>(spkiDer.BeginWriting()),
+                      spkiDer.Length()};
+  UniqueCERTSubjectPublicKeyInfo spki(
+      SECKEY_DecodeDERSubjectPublicKeyInfo(&spkiItem));
+  if (!spki) {
+    MOZ_LOG(sLogger, LogLevel::Warning,
+            ("VerifyEd25519Signature(): Rejected; Reason: Bad SPKI.\n"));
+    aRv = false;
+    return NS_OK;
+  }
+  UniqueSECKEYPublicKey pubKey(SECKEY_ExtractPublicKey(spki.get()));
+  if (!pubKey || pubKey->keyType != edKey) {
+    MOZ_LOG(sLogger, LogLevel::Warning,
+            ("VerifyEd25519Signature(): Rejected; Reason: Not an Ed25519 key.\n"));
+    aRv = false;
+    return NS_OK;
+  }
+  SECStatus status = PK11_VerifyWithMechanism(pubKey.get(), CKM_EDDSA,
+                                              nullptr, &aSignature,
+                                              &aData, nullptr);
+  aRv = status == SECSuccess;
+  return NS_OK;
+}
+
+nsresult VerifySkSig(const nsCString& aSpki,
+                     const nsCString& aSkSig,
+                     const SECItem& aSubjectSpki,
+                     bool& aRv) {
+  nsAutoCString skSig;
+  if (NS_FAILED(Base64Decode(aSkSig, skSig))) {
+    MOZ_LOG(sLogger, LogLevel::Warning,
+            ("VerifySkSig(): Rejected; Reason: Bad base64 encoding.\n"));
+    aRv = false;
+    return NS_OK;
+  }
+  SECItem sigItem = {siBuffer,
+                     reinterpret_cast<unsigned char*>(skSig.BeginWriting()),
+                     skSig.Length()};
+  nsresult rv = VerifyEd25519Signature(aSpki, sigItem, aSubjectSpki, aRv);
+  NS_ENSURE_SUCCESS(rv, rv);
+  MOZ_LOG(sLogger, LogLevel::Info,
+          ("VerifySkSig(): %s (%.*s)\n",
+           aRv ? "Verified" : "Rejected",
+           (int) aSpki.Length(), aSpki.Data()));
+  return NS_OK;
+}
 }
 
 namespace mozilla::dom {
@@ -258,6 +325,57 @@ CERTCertExtension* FindBerytusExtension(CERTCertificate* aCert) {
   return nullptr;
 }
 
+/**
+ * Parsed allowlists are cached per certificate. The certificate is
+ * immutable, so is the parse (and sksig verification) outcome; both
+ * successfully parsed allowlists and parse failures are cached.
+ * Objects are only constructed on the main thread.
+ */
+struct CachedAllowlist {
+  RefPtr<BerytusX509Extension> mExtension; // nullptr on failure
+  nsresult mResult;
+};
+
+static const uint32_t sMaxCachedAllowlists = 64;
+
+static StaticAutoPtr<nsTHashMap<nsCStringHashKey, CachedAllowlist>>
+    sCachedAllowlists;
+
+bool BerytusX509Extension::LookupCache(const nsCString& aFingerprint,
+                                       RefPtr<BerytusX509Extension>& aExtRv,
+                                       nsresult& aRv) {
+  MOZ_ASSERT(NS_IsMainThread());
+  if (!sCachedAllowlists) {
+    return false;
+  }
+  auto entry = sCachedAllowlists->Lookup(aFingerprint);
+  if (!entry) {
+    return false;
+  }
+  aExtRv = entry->mExtension;
+  aRv = entry->mResult;
+  return true;
+}
+
+void BerytusX509Extension::UpdateCache(const nsCString& aFingerprint,
+                                       BerytusX509Extension* aExt,
+                                       const nsresult& aRv) {
+  MOZ_ASSERT(NS_IsMainThread());
+  if (aRv == NS_ERROR_OUT_OF_MEMORY) {
+    // transient; do not cache.
+    return;
+  }
+  if (!sCachedAllowlists) {
+    sCachedAllowlists = new nsTHashMap<nsCStringHashKey, CachedAllowlist>();
+    ClearOnShutdown(&sCachedAllowlists);
+  }
+  if (sCachedAllowlists->Count() >= sMaxCachedAllowlists) {
+    sCachedAllowlists->Clear();
+  }
+  sCachedAllowlists->InsertOrUpdate(aFingerprint,
+                                    CachedAllowlist{aExt, aRv});
+}
+
 NS_IMPL_CYCLE_COLLECTION(BerytusX509Extension, mAllowlist)
 NS_IMPL_CYCLE_COLLECTING_ADDREF(BerytusX509Extension)
 NS_IMPL_CYCLE_COLLECTING_RELEASE(BerytusX509Extension)
@@ -275,6 +393,17 @@ BerytusX509Extension::GetAllowlist() const {
   return mAllowlist;
 }
 
+void BerytusX509Extension::AddSizeOfIncludingThis(
+    MallocSizeOf aMallocSizeOf, BerytusMemorySizes& aSizes) const {
+  size_t size = aMallocSizeOf(this) +
+                mAllowlist.ShallowSizeOfExcludingThis(aMallocSizeOf);
+  for (const RefPtr<SigningKeyEntry>& entry : mAllowlist) {
+    size += entry->SizeOfIncludingThis(aMallocSizeOf);
+  }
+  aSizes.mHeap[BerytusMemoryKind::X509Extension] += size;
+  aSizes.mCount[BerytusMemoryKind::X509Extension]++;
+}
+
 nsresult BerytusX509Extension::IsAllowed(const nsCString& aSpki, nsIURI* aUrl,
                                          bool& aRv) const {
   auto logUrl = aUrl->GetSpecOrDefault();
@@ -311,19 +440,48 @@ already_AddRefed<BerytusX509Extension> BerytusX509Extension::Create(
     nsPIDOMWindowInner* aInner, nsresult& aRv) {
   MOZ_ASSERT(aInner);
   nsCOMPtr<nsIChannel> nsCh = aInner->GetDoc()->GetChannel();
-  nsITransportSecurityInfo* securityInfo;
-  nsresult rv = nsCh->GetSecurityInfo(&securityInfo);
+  nsCOMPtr<nsITransportSecurityInfo> securityInfo;
+  nsresult rv = nsCh->GetSecurityInfo(getter_AddRefs(securityInfo));
   if (NS_WARN_IF(NS_FAILED(rv))) {
     aRv = rv;
     return nullptr;
   }
-  nsIX509Cert* x509Cert;
-  rv = securityInfo->GetServerCert(&x509Cert);
+  if (NS_WARN_IF(!securityInfo)) {
+    aRv = NS_ERROR_FAILURE;
+    return nullptr;
+  }
+  nsCOMPtr<nsIX509Cert> x509Cert;
+  rv = securityInfo->GetServerCert(getter_AddRefs(x509Cert));
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    aRv = rv;
+    return nullptr;
+  }
+  if (NS_WARN_IF(!x509Cert)) {
+    aRv = NS_ERROR_FAILURE;
+    return nullptr;
+  }
+  nsAutoString fingerprint;
+  rv = x509Cert->GetSha256Fingerprint(fingerprint);
   if (NS_WARN_IF(NS_FAILED(rv))) {
     aRv = rv;
     return nullptr;
   }
-  return Create(x509Cert->GetCert(), aRv);
+  NS_ConvertUTF16toUTF8 cacheKey(fingerprint);
+  RefPtr<BerytusX509Extension> ext;
+  if (LookupCache(cacheKey, ext, aRv)) {
+    MOZ_LOG(sLogger, LogLevel::Info,
+            ("BerytusX509Extension::Create(): Using cached allowlist "
+             "for certificate %s\n", cacheKey.get()));
+    return ext.forget();
+  }
+  UniqueCERTCertificate cert(x509Cert->GetCert());
+  if (NS_WARN_IF(!cert)) {
+    aRv = NS_ERROR_FAILURE;
+    return nullptr;
+  }
+  ext = Create(cert.get(), aRv);
+  UpdateCache(cacheKey, ext, aRv);
+  return ext.forget();
 }
 
 already_AddRefed<BerytusX509Extension> BerytusX509Extension::Create(
@@ -336,6 +494,7 @@ already_AddRefed<BerytusX509Extension> BerytusX509Extension::Create(
   PLArenaPool* arena = nullptr;
   RawAllowlist* allowlist = nullptr;
   RawEntry **entries, *entry;
+  SECItem* subjectSpki = nullptr;
   nsTArray<RefPtr<SigningKeyEntry>> outEntries;
 
   extension = FindBerytusExtension(aCert);
@@ -374,6 +533,15 @@ already_AddRefed<BerytusX509Extension> BerytusX509Extension::Create(
     goto cleanup;
   }
 
+  // sksig entries are signed over the DER-encoded subject public key info
+  subjectSpki = SEC_ASN1EncodeItem(arena, nullptr,
+                                   &aCert->subjectPublicKeyInfo,
+                                   SEC_ASN1_GET(CERT_SubjectPublicKeyInfoTemplate));
+  if (NS_WARN_IF(subjectSpki == nullptr)) {
+    aRv = NS_ERROR_FAILURE;
+    goto cleanup;
+  }
+
   entries = allowlist->mEntries;
   while (entries != nullptr && *entries != nullptr) {
     entry = *entries;
@@ -397,11 +565,26 @@ already_AddRefed<BerytusX509Extension> BerytusX509Extension::Create(
       goto cleanup;
     }
     MOZ_ASSERT(url);
+    nsCString spki((char*)entry->mKey.data, entry->mKey.len);
+    nsCString skSig((char*)entry->mSksig.data, entry->mSksig.len);
+    bool verified;
+    aRv = berytus::VerifySkSig(spki, skSig, *subjectSpki, verified);
+    if (NS_WARN_IF(NS_FAILED(aRv))) {
+      goto cleanup;
+    }
+    if (!verified) {
+      MOZ_LOG(sLogger, LogLevel::Warning,
+             ("BerytusX509Extension::Create(): Entry (%.*s) rejected; "
+              "Reason: Bad sksig.", (int) spki.Length(), spki.Data()));
+    }
     RefPtr<BerytusX509Extension::SigningKeyEntry> newEntry =
         new BerytusX509Extension::SigningKeyEntry(
-            nsCString((char*)entry->mKey.data, entry->mKey.len),
-            nsCString((char*)entry->mSksig.data, entry->mSksig.len),
-            url);
+            std::move(spki),
+            std::move(skSig),
+            url,
+            verified
+              ? SigningKeyEntry::SkSigStatus::Verified
+              : SigningKeyEntry::SkSigStatus::Rejected);
     outEntries.AppendElement(newEntry);
     entries++;
   }
@@ -430,8 +613,12 @@ NS_INTERFACE_MAP_END
 
 BerytusX509Extension::SigningKeyEntry::SigningKeyEntry(nsCString&& aSpki,
                                                        nsCString&& aSkSig,
-                                                       RefPtr<Url>& aUrl)
-    : mSpki(std::move(aSpki)), mSkSig(std::move(aSkSig)), mUrl(aUrl) {}
+                                                       RefPtr<Url>& aUrl,
+                                                       SkSigStatus aSkSigStatus)
+    : mSpki(std::move(aSpki)),
+      mSkSig(std::move(aSkSig)),
+      mUrl(aUrl),
+      mSkSigStatus(aSkSigStatus) {}
 
 BerytusX509Extension::SigningKeyEntry::~SigningKeyEntry() {}
 
@@ -452,6 +639,14 @@ nsresult BerytusX509Extension::SigningKeyEntry::SigningKeyEntry::Matches(
            "aSPKI (%.*s) against mSPKI (%.*s)\n",
            (int) aSpki.Length(), aSpki.Data(),
            (int) mSpki.Length(), mSpki.Data()));
+  if (!IsSkSigVerified()) {
+    MOZ_LOG(sLogger, LogLevel::Info,
+            ("SigningKeyEntry::Matches(): NoMatch[SkSig(Rejected)] "
+             "mSPKI (%.*s)\n",
+             (int) mSpki.Length(), mSpki.Data()));
+    aRv = false;
+    return NS_OK;
+  }
   return mUrl->Matches(aUrl, aRv);
 }
 
@@ -465,6 +660,22 @@ RefPtr<const BerytusX509Extension::SigningKeyEntry::Url>
 BerytusX509Extension::SigningKeyEntry::GetUrl() {
   return mUrl;
 }
+BerytusX509Extension::SigningKeyEntry::SkSigStatus
+BerytusX509Extension::SigningKeyEntry::GetSkSigStatus() const {
+  return mSkSigStatus;
+}
+bool BerytusX509Extension::SigningKeyEntry::IsSkSigVerified() const {
+  return mSkSigStatus == SkSigStatus::Verified;
+}
+
+size_t BerytusX509Extension::SigningKeyEntry::SizeOfIncludingThis(
+    MallocSizeOf aMallocSizeOf) const {
+  // Entries do not share their Url.
+  return aMallocSizeOf(this) +
+         mSpki.SizeOfExcludingThisIfUnshared(aMallocSizeOf) +
+         mSkSig.SizeOfExcludingThisIfUnshared(aMallocSizeOf) +
+         (mUrl ? mUrl->SizeOfIncludingThis(aMallocSizeOf) : 0);
+}
 
 NS_IMPL_ISUPPORTS0(BerytusX509Extension::SigningKeyEntry::Url)
 
@@ -474,6 +685,13 @@ BerytusX509Extension::SigningKeyEntry::SigningKeyEntry::Url::Url(
 
 BerytusX509Extension::SigningKeyEntry::SigningKeyEntry::Url::~Url() {}
 
+size_t BerytusX509Extension::SigningKeyEntry::Url::SizeOfIncludingThis(
+    MallocSizeOf aMallocSizeOf) const {
+  return aMallocSizeOf(this) +
+         mHostname.SizeOfExcludingThisIfUnshared(aMallocSizeOf) +
+         mFilePath.SizeOfExcludingThisIfUnshared(aMallocSizeOf);
+}
+
 nsresult BerytusX509Extension::SigningKeyEntry::Url::Matches(nsIURI* aUrl,
                                                              bool& aRv) const {
   MOZ_ASSERT(aUrl);
@@ -8,7 +8,9 @@
 #define DOM_BERYTUSX509EXTENSION_H_
 
 #include "certt.h"
+#include "seccomon.h"
 #include "mozilla/StaticString.h"
+#include "mozilla/dom/BerytusMemoryReporter.h"
 #include "nsIURI.h"
 #include "nsPIDOMWindow.h"
 #include "mozilla/AlreadyAddRefed.h"
@@ -61,11 +63,39 @@ protected:
                     nsTDependentSubstring<char>& aSubRv,
                     uint32_t& aNextPosRv) const;
 };
+
+/**
+ * Verifies the Ed25519 signature aSignature over aData using the
+ * public key aSpki (base64-encoded DER).
+ *
+ * aRv is set to false when the signature, or the encoded key, is
+ * invalid. A failure code is only returned when the verification
+ * could not be carried out.
+ */
+nsresult VerifyEd25519Signature(const nsCString& aSpki,
+                                const SECItem& aSignature,
+                                const SECItem& aData,
+                                bool& aRv);
+
+/**
+ * Verifies an allowlist entry's sksig, i.e. the Ed25519 signature
+ * produced by the entry's signing key (aSpki, base64-encoded DER) over
+ * the certificate's subject public key info (aSubjectSpki, DER).
+ *
+ * aRv is set to false when the signature, or the encoded
+ * key/signature, is invalid. A failure code is only returned
+ * when the verification could not be carried out.
+ */
+nsresult VerifySkSig(const nsCString& aSpki,
+                     const nsCString& aSkSig,
+                     const SECItem& aSubjectSpki,
+                     bool& aRv);
 }
 
 namespace dom {
 
-class BerytusX509Extension final : public nsISupports {
+class BerytusX509Extension final : public nsISupports,
+                                   public BerytusMemoryTracked {
 public:
   NS_DECL_CYCLE_COLLECTING_ISUPPORTS
   NS_DECL_CYCLE_COLLECTION_CLASS(BerytusX509Extension)
@@ -83,6 +113,7 @@ public:
 
       static already_AddRefed<Url> Create(const nsCString& aUrl, nsresult& aRv);
       nsresult Matches(nsIURI* aUrl, bool& aRv) const;
+      size_t SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const;
 
       explicit operator nsCString() const {
         if (mPort == -1 &&
@@ -113,18 +144,33 @@ public:
       ~Url();
     };
 
+    /**
+     * The outcome of verifying the entry's sksig against
+     * the certificate's subject public key. The verification
+     * happens once, when the allowlist is parsed.
+     */
+    enum class SkSigStatus : uint8_t {
+      Verified,
+      Rejected
+    };
+
     SigningKeyEntry(nsCString&& aSpki,
                     nsCString&& aSkSig,
-                    RefPtr<Url>& aUrl);
+                    RefPtr<Url>& aUrl,
+                    SkSigStatus aSkSigStatus);
 
     const nsCString& GetSpki();
     const nsCString& GetSkSig();
     RefPtr<const Url> GetUrl();
+    SkSigStatus GetSkSigStatus() const;
+    bool IsSkSigVerified() const;
+    size_t SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const;
 
   protected:
     const nsCString mSpki;
     const nsCString mSkSig;
     RefPtr<Url> mUrl;
+    const SkSigStatus mSkSigStatus;
     ~SigningKeyEntry();
   };
 
@@ -133,6 +179,21 @@ public:
   nsresult IsAllowed(const nsCString& aSpki,
                      nsIURI* aUrl, bool& aRv) const;
 
+  /**
+   * Allowlists are cached per certificate and shared across windows,
+   * hence reported process-wide.
+   */
+  nsIGlobalObject* GetTrackedGlobal() const override { return nullptr; }
+  void AddSizeOfIncludingThis(MallocSizeOf aMallocSizeOf,
+                              BerytusMemorySizes& aSizes) const override;
+
+  /**
+   * Retrieves the allowlist of the certificate the document was
+   * served with. Parsed allowlists, along with the sksig verification
+   * outcome of their entries, are cached per certificate (SHA-256
+   * fingerprint); subsequent calls for the same certificate do not
+   * parse the extension nor verify any signature again.
+   */
   static already_AddRefed<BerytusX509Extension> Create(
       nsPIDOMWindowInner* aInner, nsresult& aRv);
   static already_AddRefed<BerytusX509Extension> Create(
@@ -142,6 +203,12 @@ protected:
   ~BerytusX509Extension();
   nsTArray<RefPtr<SigningKeyEntry>> mAllowlist;
 
+  static bool LookupCache(const nsCString& aFingerprint,
+                          RefPtr<BerytusX509Extension>& aExtRv,
+                          nsresult& aRv);
+  static void UpdateCache(const nsCString& aFingerprint,
+                          BerytusX509Extension* aExt,
+                          const nsresult& aRv);
 };
 }
 }
@@ -0,0 +1,75 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "mozilla/dom/BerytusBuffer.h"
+#include "mozilla/dom/BerytusEncryptedPacket.h"
+#include "mozilla/dom/BerytusMemoryReporter.h"
+#include "nsTHashMap.h"
+
+using namespace mozilla;
+using namespace mozilla::dom;
+
+class BerytusReportCollector final : public nsIHandleReportCallback {
+public:
+  NS_DECL_ISUPPORTS
+
+  NS_IMETHOD Callback(const nsACString& aProcess, const nsACString& aPath,
+                      int32_t aKind, int32_t aUnits, int64_t aAmount,
+                      const nsACString& aDescription,
+                      nsISupports* aData) override {
+    mAmounts.InsertOrUpdate(aPath, aAmount);
+    return NS_OK;
+  }
+
+  int64_t Amount(const char* aPath) const {
+    return mAmounts.MaybeGet(nsDependentCString(aPath)).valueOr(0);
+  }
+
+private:
+  ~BerytusReportCollector() = default;
+
+  nsTHashMap<nsCStringHashKey, int64_t> mAmounts;
+};
+
+NS_IMPL_ISUPPORTS(BerytusReportCollector, nsIHandleReportCallback)
+
+static RefPtr<BerytusReportCollector> CollectReports() {
+  RefPtr<BerytusMemoryReporter> reporter = new BerytusMemoryReporter();
+  RefPtr<BerytusReportCollector> collector = new BerytusReportCollector();
+  EXPECT_TRUE(NS_SUCCEEDED(reporter->CollectReports(collector, nullptr,
+                                                    false)));
+  return collector;
+}
+
+static CryptoBuffer Zeros(size_t aLength) {
+  CryptoBuffer buf;
+  buf.AppendElements(aLength, mozilla::fallible);
+  memset(buf.Elements(), 0, aLength);
+  return buf;
+}
+
+TEST(BerytusMemoryReporter, TestReportsTrackedObjects)
+{
+  RefPtr<BerytusReportCollector> before = CollectReports();
+  RefPtr<BerytusEncryptedPacket> packet = new BerytusEncryptedPacket(
+    nullptr, new BerytusAesGcmParams_Impl(Zeros(12), CryptoBuffer(), 128),
+    Zeros(4096));
+  RefPtr<BerytusBuffer> buffer = new BerytusBuffer(Zeros(1024));
+  RefPtr<BerytusReportCollector> during = CollectReports();
+
+  ASSERT_EQ(during->Amount("berytus-objects/encrypted-packets"),
+            before->Amount("berytus-objects/encrypted-packets") + 1);
+  ASSERT_EQ(during->Amount("berytus-objects/buffers"),
+            before->Amount("berytus-objects/buffers") + 1);
+  // Neither is bound to a window, so the per-window and the
+  // process-wide reports agree.
+  ASSERT_EQ(during->Amount("berytus-heap-by-kind/encrypted-packets"),
+            during->Amount("explicit/berytus/no-window/encrypted-packets"));
+  ASSERT_EQ(during->Amount("berytus-heap-by-kind/buffers"),
+            during->Amount("explicit/berytus/no-window/buffers"));
+  ASSERT_EQ(during->Amount("berytus-pending-agent-queries"),
+            before->Amount("berytus-pending-agent-queries"));
+}
@@ -0,0 +1,75 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "mozilla/dom/BerytusAdmissionControl.h"
+
+using namespace mozilla;
+using namespace mozilla::dom;
+
+static bool TryConsume(BerytusTokenBucket& aBucket, const TimeStamp& aNow,
+                       uint32_t aCapacity, uint32_t aRefillPerMinute,
+                       uint32_t aCount = 1) {
+  if (!aBucket.CanConsume(aNow, aCapacity, aRefillPerMinute, aCount)) {
+    return false;
+  }
+  aBucket.Consume(aCount);
+  return true;
+}
+
+TEST(BerytusTokenBucket, TestBurst)
+{
+  TimeStamp now = TimeStamp::Now();
+  BerytusTokenBucket bucket(now);
+  ASSERT_TRUE(bucket.IsFull(now, 3, 60));
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(TryConsume(bucket, now, 3, 60));
+  }
+  ASSERT_FALSE(TryConsume(bucket, now, 3, 60));
+  ASSERT_FALSE(bucket.IsFull(now, 3, 60));
+}
+
+TEST(BerytusTokenBucket, TestRefill)
+{
+  TimeStamp now = TimeStamp::Now();
+  BerytusTokenBucket bucket(now);
+  ASSERT_TRUE(TryConsume(bucket, now, 2, 60));
+  ASSERT_TRUE(TryConsume(bucket, now, 2, 60));
+  ASSERT_FALSE(TryConsume(bucket, now, 2, 60));
+  // One token per second.
+  now += TimeDuration::FromMilliseconds(500);
+  ASSERT_FALSE(TryConsume(bucket, now, 2, 60));
+  now += TimeDuration::FromMilliseconds(500);
+  ASSERT_TRUE(TryConsume(bucket, now, 2, 60));
+  ASSERT_FALSE(TryConsume(bucket, now, 2, 60));
+  // Refills up to the capacity only.
+  now += TimeDuration::FromSeconds(60);
+  ASSERT_TRUE(bucket.IsFull(now, 2, 60));
+  ASSERT_TRUE(TryConsume(bucket, now, 2, 60));
+  ASSERT_TRUE(TryConsume(bucket, now, 2, 60));
+  ASSERT_FALSE(TryConsume(bucket, now, 2, 60));
+}
+
+TEST(BerytusTokenBucket, TestZeroCapacityRefuses)
+{
+  TimeStamp now = TimeStamp::Now();
+  BerytusTokenBucket bucket(now);
+  ASSERT_FALSE(TryConsume(bucket, now, 0, 60));
+}
+
+TEST(BerytusTokenBucket, TestConsumeMany)
+{
+  TimeStamp now = TimeStamp::Now();
+  BerytusTokenBucket bucket(now);
+  ASSERT_TRUE(TryConsume(bucket, now, 5, 60, 3));
+  // Two tokens are left; a batch of three is refused as a whole.
+  ASSERT_FALSE(TryConsume(bucket, now, 5, 60, 3));
+  ASSERT_TRUE(TryConsume(bucket, now, 5, 60, 2));
+  ASSERT_FALSE(TryConsume(bucket, now, 5, 60));
+  // A batch larger than the capacity is never admitted.
+  now += TimeDuration::FromSeconds(60);
+  ASSERT_FALSE(TryConsume(bucket, now, 5, 60, 6));
+  ASSERT_TRUE(bucket.IsFull(now, 5, 60));
+}
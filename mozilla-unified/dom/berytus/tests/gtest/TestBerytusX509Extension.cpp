@@ -10,6 +10,8 @@
 #include "nsError.h"
 #include <iostream>
 #include "nss.h"
+#include "secasn1.h"
+#include "secitem.h"
 
 using namespace mozilla::dom;
 
@@ -827,4 +829,52 @@ TEST(BerytusX509Extension, TestFromCertificate)
       "MCowBQYDK2VwAyEAgz0GKn8PrHDQRRj/AGVJKMXLMhrNsaG71SYBPgxjVXs="));
   ASSERT_TRUE(entry->GetSkSig().EqualsASCII(
       "onDJhaR2JzTgUiWgnDeAGAolOOPJrdgunhwEgP81Z5zoqxRtz4/QRBGziebJu/yH/vt72OeMxQbQE5xhH+yADw=="));
+  ASSERT_TRUE(entry->IsSkSigVerified());
+}
+
+TEST(BerytusX509Extension, TestVerifySkSig)
+{
+  ASSERT_TRUE(NSS_NoDB_Init(nullptr) == SECSuccess);
+
+  std::ifstream file("berytus/example.tls.crt");
+  ASSERT_TRUE(!!file);
+  std::ostringstream buffer;
+  buffer << file.rdbuf();
+  std::string pem = buffer.str();
+
+  CERTCertificate* cert =
+      CERT_DecodeCertFromPackage(pem.data(), (int)pem.length());
+  ASSERT_TRUE(cert != nullptr);
+  SECItem* subjectSpki = SEC_ASN1EncodeItem(
+      nullptr, nullptr, &cert->subjectPublicKeyInfo,
+      SEC_ASN1_GET(CERT_SubjectPublicKeyInfoTemplate));
+  ASSERT_TRUE(subjectSpki != nullptr);
+
+  const nsCString spki =
+      "MCowBQYDK2VwAyEAgz0GKn8PrHDQRRj/AGVJKMXLMhrNsaG71SYBPgxjVXs="_ns;
+  nsresult rv;
+  bool verified;
+  rv = mozilla::berytus::VerifySkSig(
+      spki,
+      "onDJhaR2JzTgUiWgnDeAGAolOOPJrdgunhwEgP81Z5zoqxRtz4/QRBGziebJu/yH/vt72OeMxQbQE5xhH+yADw=="_ns,
+      *subjectSpki,
+      verified);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+  ASSERT_TRUE(verified);
+  // tampered signature (first byte altered)
+  rv = mozilla::berytus::VerifySkSig(
+      spki,
+      "pnDJhaR2JzTgUiWgnDeAGAolOOPJrdgunhwEgP81Z5zoqxRtz4/QRBGziebJu/yH/vt72OeMxQbQE5xhH+yADw=="_ns,
+      *subjectSpki,
+      verified);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+  ASSERT_FALSE(verified);
+  // malformed signature encoding
+  rv = mozilla::berytus::VerifySkSig(spki, "%%%"_ns, *subjectSpki, verified);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+  ASSERT_FALSE(verified);
+
+  SECITEM_FreeItem(subjectSpki, PR_TRUE);
+  CERT_DestroyCertificate(cert);
+  NSS_Shutdown();
 }
\ No newline at end of file
@@ -40,4 +40,25 @@ promise_test(async (t) => {
         'challenge() should have returned an already-rejected promise.');
 
     await channel.close();
-}, "BerytusAccountAuthenticationOperation disables creation of challenges after closure.");
\ No newline at end of file
+}, "BerytusAccountAuthenticationOperation disables creation of challenges after closure.");
+
+promise_test(async (t) => {
+    const channel = await BerytusChannel.create({
+        webApp: new BerytusAnonymousWebAppActor()
+    });
+    const controller = new AbortController();
+    const pendingProm = channel.login({
+        intent: "Authenticate"
+    });
+    const abortedProm = channel.login({
+        intent: "Authenticate",
+        signal: controller.signal
+    });
+    controller.abort();
+    await promise_rejects_dom(t, 'AbortError', abortedProm);
+    // The query of the other operation is still pending; it must
+    // not have been cancelled along with the aborted one.
+    const pendingOperation = await pendingProm;
+    await pendingOperation.finish();
+    await channel.close();
+}, "Aborting a login operation does not cancel the requests of another operation");
\ No newline at end of file
@@ -23,6 +23,101 @@ const operationCtx = async () => {
     return { channel, operation };
 }
 
+// The password of the native manager's account
+// (dom.berytus.native_manager.password).
+const NATIVE_MANAGER_PASSWORD = "pass123";
+
+// RFC 5054, Appendix A.
+const SRP_N = BigInt("0x" +
+    "AC6BDB41324A9A9BF166DE5E1389582FAF72B6651987EE07FC3192943DB56050" +
+    "A37329CBB4A099ED8193E0757767A13DD52312AB4B03310DCD7F48A9DA04FD50" +
+    "E8083969EDB767B0CF6095179A163AB3661A05FBD5FAAAE82918A9962F0B93B8" +
+    "55F97993EC975EEAA80D740ADBF4FF747359D041D5C33EA71D281E446B14773B" +
+    "CA97B43A23FB801676BD207A436C6481F1D2B9078717461A5B9D32E688F87748" +
+    "544523B524B0D57D5EA77A2775D2ECFA032CFBDBF52FB3786160279004E57AE6" +
+    "AF874E7303CE53299CCC041C7BC308D82A5698F3A8D0C38271AE35F8E9DBFBB6" +
+    "94B5C803D89F7AE435DE236D525F54759B65E372FCD68EF20FA7111F9E4AFF73");
+const SRP_G = 2n;
+const SRP_BYTES = 256;
+
+const sha256 = async (...parts) => {
+    const data = new Uint8Array(
+        parts.reduce((length, part) => length + part.length, 0)
+    );
+    let offset = 0;
+    for (const part of parts) {
+        data.set(part, offset);
+        offset += part.length;
+    }
+    return new Uint8Array(await crypto.subtle.digest("SHA-256", data));
+};
+
+const toBigInt = (bytes) => {
+    let value = 0n;
+    for (const byte of bytes) {
+        value = (value << 8n) | BigInt(byte);
+    }
+    return value;
+};
+
+const toBytes = (value) => {
+    const bytes = new Uint8Array(SRP_BYTES);
+    for (let i = SRP_BYTES - 1; i >= 0 && value > 0n; i--) {
+        bytes[i] = Number(value & 0xffn);
+        value >>= 8n;
+    }
+    return bytes;
+};
+
+const modPow = (base, exponent, modulus) => {
+    let result = 1n;
+    base %= modulus;
+    while (exponent > 0n) {
+        if (exponent & 1n) {
+            result = (result * base) % modulus;
+        }
+        base = (base * base) % modulus;
+        exponent >>= 1n;
+    }
+    return result;
+};
+
+const toHex = (bytes) => Array.from(bytes)
+    .map(b => b.toString(16).padStart(2, "0")).join("");
+
+const fromHex = (hex) => new Uint8Array(
+    hex.match(/[\da-f]{2}/gi).map(h => parseInt(h, 16))
+);
+
+/**
+ * The web app side of an SRP-6a exchange over the 2048-bit group of
+ * RFC 5054, for an account registered with the given credentials.
+ */
+const createSrpServer = async (identity, password) => {
+    const utf8 = (str) => new TextEncoder().encode(str);
+    const salt = crypto.getRandomValues(new Uint8Array(16));
+    const k = toBigInt(await sha256(toBytes(SRP_N), toBytes(SRP_G)));
+    const x = toBigInt(await sha256(
+        salt,
+        await sha256(utf8(identity), utf8(":"), utf8(password))
+    ));
+    const v = modPow(SRP_G, x, SRP_N);
+    const b = toBigInt(crypto.getRandomValues(new Uint8Array(32)));
+    const B = (k * v + modPow(SRP_G, b, SRP_N)) % SRP_N;
+    return {
+        salt,
+        publicKey: toBytes(B),
+        async finish(clientPublicKey) {
+            const A = toBigInt(clientPublicKey);
+            const u = toBigInt(await sha256(toBytes(A), toBytes(B)));
+            const S = modPow(A * modPow(v, u, SRP_N), b, SRP_N);
+            const K = await sha256(toBytes(S));
+            const M1 = await sha256(toBytes(A), toBytes(B), K);
+            return { M1, M2: await sha256(toBytes(A), M1, K) };
+        }
+    };
+};
+
 promise_test(async () => {
     const { operation, channel } = await operationCtx();
     const challenge = new BerytusIdentificationChallenge('identification');
@@ -105,18 +200,21 @@ promise_test(async () => {
 
     var { response } = await challenge.selectSecurePassword("securePassword");
     assert_equals(typeof response, 'string');
+    const server = await createSrpServer(response, NATIVE_MANAGER_PASSWORD);
 
-    var { response } = await challenge.exchangePublicKeys(new Uint8Array([55, 56, 57]).buffer);
+    var { response } = await challenge.exchangePublicKeys(server.publicKey.buffer);
     assert_equals(typeof response, 'object');
     assert_not_equals(response, null);
     assert_true(response instanceof ArrayBuffer);
+    const { M1, M2 } = await server.finish(new Uint8Array(response));
 
-    var { response } = await challenge.computeClientProof(new Uint8Array([65, 66, 67]).buffer);
+    var { response } = await challenge.computeClientProof(server.salt.buffer);
     assert_equals(typeof response, 'object');
     assert_not_equals(response, null);
     assert_true(response instanceof ArrayBuffer);
+    assert_array_equals(new Uint8Array(response), M1);
 
-    var { response } = await challenge.verifyServerProof(new Uint8Array([75, 76, 77]).buffer);
+    var { response } = await challenge.verifyServerProof(M2.buffer);
     assert_equals(typeof response, 'undefined');
 
     await challenge.seal();
@@ -131,18 +229,21 @@ promise_test(async () => {
 
     var { response } = await challenge.selectSecurePassword("securePassword");
     assert_equals(typeof response, 'string');
+    const server = await createSrpServer(response, NATIVE_MANAGER_PASSWORD);
 
-    var { response } = await challenge.exchangePublicKeys(new Uint8Array([55, 56, 57]).buffer);
+    var { response } = await challenge.exchangePublicKeys(server.publicKey.buffer);
     assert_equals(typeof response, 'object');
     assert_not_equals(response, null);
     assert_true(response instanceof ArrayBuffer);
+    const { M1, M2 } = await server.finish(new Uint8Array(response));
 
-    var { response } = await challenge.computeClientProof(new Uint8Array([65, 66, 67]).buffer);
+    var { response } = await challenge.computeClientProof(server.salt.buffer);
     assert_equals(typeof response, 'object');
     assert_not_equals(response, null);
     assert_true(response instanceof ArrayBuffer);
+    assert_array_equals(new Uint8Array(response), M1);
 
-    var { response } = await challenge.verifyServerProof(new Uint8Array([75, 76, 77]).buffer);
+    var { response } = await challenge.verifyServerProof(M2.buffer);
     assert_equals(typeof response, 'undefined');
 
     await challenge.seal();
@@ -158,18 +259,21 @@ promise_test(async () => {
 
     var { response } = await challenge.selectSecurePassword("securePassword");
     assert_equals(typeof response, 'string');
+    const server = await createSrpServer(response, NATIVE_MANAGER_PASSWORD);
 
-    var { response } = await challenge.exchangePublicKeys(new Uint8Array([55, 56, 57]).buffer);
+    var { response } = await challenge.exchangePublicKeys(server.publicKey.buffer);
     assert_equals(typeof response, 'object');
     assert_not_equals(response, null);
     assert_true(response instanceof ArrayBuffer);
+    const { M1, M2 } = await server.finish(new Uint8Array(response));
 
-    var { response } = await challenge.computeClientProof(new Uint8Array([65, 66, 67]).buffer);
+    var { response } = await challenge.computeClientProof(server.salt.buffer);
     assert_equals(typeof response, 'object');
     assert_not_equals(response, null);
     assert_true(response instanceof ArrayBuffer);
+    assert_array_equals(new Uint8Array(response), M1);
 
-    var { response } = await challenge.verifyServerProof(new Uint8Array([75, 76, 77]).buffer);
+    var { response } = await challenge.verifyServerProof(M2.buffer);
     assert_equals(typeof response, 'undefined');
 
     await challenge.seal();
@@ -189,22 +293,48 @@ promise_test(async () => {
 
     var { response } = await challenge.selectSecurePassword("securePassword");
     assert_equals(typeof response, 'string');
+    const server = await createSrpServer(response, NATIVE_MANAGER_PASSWORD);
 
-    var { response } = await challenge.exchangePublicKeys("0A0B0C05");
+    var { response } = await challenge.exchangePublicKeys(toHex(server.publicKey));
     assert_equals(typeof response, 'string');
     assert_is_hex(response);
+    const { M1, M2 } = await server.finish(fromHex(response));
 
-    var { response } = await challenge.computeClientProof("0A0B0C05");
+    var { response } = await challenge.computeClientProof(toHex(server.salt));
     assert_equals(typeof response, 'string');
     assert_is_hex(response)
+    assert_equals(response, toHex(M1));
 
-    var { response } = await challenge.verifyServerProof("0A0B0C05");
+    var { response } = await challenge.verifyServerProof(toHex(M2));
     assert_equals(typeof response, 'undefined');
 
     await challenge.seal();
     await channel.close();
 }, "BerytusSecureRemotePasswordChallenge (Hex encodig) messaging");
 
+promise_test(async (t) => {
+    const { operation, channel } = await operationCtx();
+    const challenge = new BerytusSecureRemotePasswordChallenge('srp');
+    await operation.challenge(challenge);
+
+    var { response } = await challenge.selectSecurePassword("securePassword");
+    const server = await createSrpServer(response, "not the password");
+
+    var { response } = await challenge.exchangePublicKeys(server.publicKey.buffer);
+    const { M1, M2 } = await server.finish(new Uint8Array(response));
+
+    var { response } = await challenge.computeClientProof(server.salt.buffer);
+    assert_not_equals(toHex(new Uint8Array(response)), toHex(M1));
+
+    await promise_rejects_dom(
+        t,
+        'InvalidStateError',
+        challenge.verifyServerProof(M2.buffer)
+    );
+
+    await channel.close();
+}, "BerytusSecureRemotePasswordChallenge rejects a server proof that does not match");
+
 // TODO(berytus): Test sending ArrayBufferViews instead
 // of ArrayBuffer
 
@@ -85,4 +85,41 @@ promise_test(async (t) => {
     await BerytusChannel.create({
         webApp: actor
     });
-}, "BerytusChannel rejects creation request when an existing channel is active");
\ No newline at end of file
+}, "BerytusChannel rejects creation request when an existing channel is active");
+
+promise_test(async (t) => {
+    // Channels of different windows share the secret manager's
+    // request handler; their requests are queued, not refused.
+    const iframe = document.createElement("iframe");
+    document.body.appendChild(iframe);
+    t.add_cleanup(() => iframe.remove());
+    const frameWindow = iframe.contentWindow;
+    const [channel, frameChannel] = await Promise.all([
+        BerytusChannel.create({
+            webApp: new BerytusAnonymousWebAppActor()
+        }),
+        frameWindow.BerytusChannel.create({
+            webApp: new frameWindow.BerytusAnonymousWebAppActor()
+        })
+    ]);
+    assert_equals(channel.active, true);
+    assert_equals(frameChannel.active, true);
+    await Promise.all([channel.close(), frameChannel.close()]);
+    assert_equals(channel.active, false);
+    assert_equals(frameChannel.active, false);
+}, "BerytusChannel can be created concurrently from two windows");
+
+promise_test(async (t) => {
+    const controller = new AbortController();
+    const channelProm = BerytusChannel.create({
+        webApp: new BerytusAnonymousWebAppActor(),
+        signal: controller.signal
+    });
+    controller.abort();
+    await promise_rejects_dom(t, 'AbortError', channelProm);
+    // The window slot of the aborted channel is released.
+    const channel = await BerytusChannel.create({
+        webApp: new BerytusAnonymousWebAppActor()
+    });
+    await channel.close();
+}, "BerytusChannel releases the window slot of an aborted creation");
\ No newline at end of file
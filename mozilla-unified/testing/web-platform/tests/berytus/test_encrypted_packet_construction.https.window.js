@@ -72,4 +72,45 @@ test(() => {
             ciphertext: "CQoLDA"
         }
     );
-}, "BerytusEncryptedPacket correctly produces JSON");
\ No newline at end of file
+}, "BerytusEncryptedPacket correctly produces JSON");
+
+test(() => {
+    const params = {
+        name: "AES-GCM-CHUNKED",
+        iv: new Uint8Array([1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12]),
+        additionalData: new Uint8Array([5, 6, 7, 8]),
+        tagLength: 128,
+        chunkSize: 16
+    };
+    const ciphertext = new Uint8Array(20);
+    const packet = new BerytusEncryptedPacket(
+        params,
+        ciphertext
+    );
+    assert_deep_equals(packet.parameters.name, params.name);
+    assert_deep_equals(new Uint8Array(packet.parameters.iv), params.iv);
+    assert_deep_equals(packet.parameters.chunkSize, params.chunkSize);
+    assert_deep_equals(
+        packet.toJSON().parameters,
+        {
+            ...params,
+            iv: "AQIDBAUGBwgJCgsM",
+            additionalData: "BQYHCA"
+        }
+    );
+}, "BerytusEncryptedPacket correctly stores chunked AES-GCM parameters");
+
+test(() => {
+    const ciphertext = new Uint8Array(20);
+    assert_throws_dom("DataError", () => new BerytusEncryptedPacket({
+        name: "AES-GCM-CHUNKED",
+        iv: new Uint8Array(12),
+        tagLength: 128
+    }, ciphertext));
+    assert_throws_dom("DataError", () => new BerytusEncryptedPacket({
+        name: "AES-GCM-CHUNKED",
+        iv: new Uint8Array(4),
+        tagLength: 128,
+        chunkSize: 16
+    }, ciphertext));
+}, "BerytusEncryptedPacket rejects invalid chunked AES-GCM parameters");
\ No newline at end of file
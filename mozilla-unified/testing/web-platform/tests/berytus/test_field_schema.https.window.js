@@ -0,0 +1,116 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+setup(() => {
+    // Making sure we are in a secure context, as expected.
+    assert_true(window.isSecureContext);
+});
+
+const registrationSchema = () => [
+    {
+        type: "Identity",
+        id: "username",
+        options: {
+            private: false,
+            humanReadable: true,
+            maxLength: 16
+        }
+    },
+    {
+        type: "Password",
+        id: "password",
+        options: {
+            passwordRules: "minlength: 8; maxlength: 16;"
+        }
+    },
+    {
+        type: "SecurePassword",
+        id: "securePassword",
+        options: {
+            identityFieldId: "username"
+        }
+    },
+    {
+        type: "Key",
+        id: "key",
+        options: {
+            alg: -8
+        }
+    }
+];
+
+test(() => {
+    const fields = BerytusField.fromSchema(registrationSchema());
+    assert_equals(fields.length, 4);
+    assert_true(fields[0] instanceof BerytusIdentityField);
+    assert_true(fields[1] instanceof BerytusPasswordField);
+    assert_true(fields[2] instanceof BerytusSecurePasswordField);
+    assert_true(fields[3] instanceof BerytusKeyField);
+    assert_array_equals(
+        fields.map(f => f.id),
+        ["username", "password", "securePassword", "key"]
+    );
+    assert_equals(fields[0].options.maxLength, 16);
+    assert_equals(
+        fields[1].options.passwordRules,
+        "minlength: 8; maxlength: 16;"
+    );
+    assert_equals(fields[2].options.identityFieldId, "username");
+    assert_equals(fields[3].options.alg, -8);
+    for (const field of fields) {
+        assert_equals(field.value, null);
+    }
+}, "BerytusField.fromSchema constructs the fields of the schema");
+
+test(() => {
+    const schema = registrationSchema();
+    schema[1].id = "username";
+    assert_throws_js(TypeError, () => BerytusField.fromSchema(schema));
+}, "BerytusField.fromSchema rejects duplicate field ids");
+
+test(() => {
+    const schema = registrationSchema();
+    schema[0].id = "0username";
+    assert_throws_js(TypeError, () => BerytusField.fromSchema(schema));
+}, "BerytusField.fromSchema rejects invalid field ids");
+
+test(() => {
+    const schema = registrationSchema();
+    delete schema[0].options.maxLength;
+    assert_throws_js(TypeError, () => BerytusField.fromSchema(schema));
+}, "BerytusField.fromSchema validates the options of each entry");
+
+test(() => {
+    const schema = registrationSchema();
+    schema[2].options.identityFieldId = "password";
+    assert_throws_js(TypeError, () => BerytusField.fromSchema(schema));
+}, "BerytusField.fromSchema rejects SecurePassword fields bound to a non-identity field");
+
+test(() => {
+    assert_throws_dom("NotSupportedError", () => BerytusField.fromSchema([
+        { type: "Custom", id: "custom", options: {} }
+    ]));
+}, "BerytusField.fromSchema rejects unsupported field types");
+
+test(() => {
+    const key = { category: "Admin", schemaVersion: 3 };
+    assert_equals(BerytusField.fromCachedSchema(key), null);
+    const fields = BerytusField.fromSchema(registrationSchema(), key);
+    const cachedFields = BerytusField.fromCachedSchema(key);
+    assert_equals(cachedFields.length, fields.length);
+    for (let i = 0; i < fields.length; i++) {
+        assert_not_equals(cachedFields[i], fields[i]);
+        assert_equals(cachedFields[i].constructor, fields[i].constructor);
+        assert_equals(cachedFields[i].id, fields[i].id);
+        assert_equals(
+            JSON.stringify(cachedFields[i].options),
+            JSON.stringify(fields[i].options)
+        );
+    }
+    assert_equals(
+        BerytusField.fromCachedSchema({ category: "Admin", schemaVersion: 4 }),
+        null
+    );
+    assert_equals(BerytusField.fromCachedSchema({ schemaVersion: 3 }), null);
+}, "BerytusField.fromCachedSchema reuses a schema by category and schemaVersion");
\ No newline at end of file
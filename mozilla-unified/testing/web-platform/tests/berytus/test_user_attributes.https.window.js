@@ -7,7 +7,7 @@ setup(() => {
     assert_true(window.isSecureContext);
 });
 
-const operationCtx = async () => {
+const operationCtx = async (options = {}) => {
     const actor = new BerytusAnonymousWebAppActor();
     const constraints = {
         secretManagerPublicKey: [],
@@ -18,7 +18,8 @@ const operationCtx = async () => {
         constraints
     });
     const operation = await channel.login({
-        intent: "Register"
+        intent: "Register",
+        ...options
     });
     return { channel, operation };
 }
@@ -59,4 +60,72 @@ promise_test(async () => {
     )
     assert_equals(operation.userAttributes.get("dummy"), undefined);
     await channel.close();
-}, "BerytusAccountCreationOperation rejects id-invalid user attribute definition ");
\ No newline at end of file
+}, "BerytusAccountCreationOperation rejects id-invalid user attribute definition ");
+
+promise_test(async () => {
+    const { operation, channel } = await operationCtx({
+        userAttributeProjection: ["name"]
+    });
+    const name = operation.userAttributes.get("name");
+    assert_true(name.loaded);
+    assert_equals(name.value, "Ali");
+    const familyName = operation.userAttributes.get("familyName");
+    assert_false(familyName.loaded);
+    assert_equals(familyName.mimeType, "text/plain");
+    assert_throws_dom("InvalidStateError", () => familyName.value);
+    await operation.loadUserAttributes(["familyName"]);
+    assert_true(operation.userAttributes.get("familyName").loaded);
+    assert_equals(operation.userAttributes.get("familyName").value, "Cherry");
+    assert_equals(operation.userAttributes.get("name"), name);
+    await channel.close();
+}, "BerytusAccountCreationOperation loads the user attributes left out by the projection on demand");
+
+promise_test(async () => {
+    const { operation, channel } = await operationCtx({
+        userAttributeProjection: []
+    });
+    assert_false(operation.userAttributes.get("name").loaded);
+    assert_false(operation.userAttributes.get("familyName").loaded);
+    await promise_rejects_js(
+        TypeError,
+        operation.loadUserAttributes(["nickname"])
+    );
+    await operation.loadUserAttributes();
+    assert_equals(operation.userAttributes.get("name").value, "Ali");
+    assert_equals(operation.userAttributes.get("familyName").value, "Cherry");
+    await channel.close();
+}, "BerytusAccountCreationOperation loads every unloaded user attribute when no ids are passed");
+
+promise_test(async () => {
+    const { operation, channel } = await operationCtx();
+    const picture = new Blob(["\x89PNG"], { type: "image/png" });
+    await operation.setUserAttributes([
+        {
+            id: "picture",
+            mimeType: "image/png",
+            value: picture
+        }
+    ]);
+    const attr = operation.userAttributes.get("picture");
+    assert_true(attr.value instanceof Blob);
+    assert_equals(attr.value.size, picture.size);
+    assert_equals(await attr.value.text(), await picture.text());
+    assert_throws_dom("NotSupportedError", () => attr.toJSON());
+    await channel.close();
+}, "BerytusAccountCreationOperation accepts Blob user attribute values");
+
+promise_test(async () => {
+    const { operation, channel } = await operationCtx({
+        userAttributeProjection: []
+    });
+    assert_false(operation.userAttributes.get("picture").loaded);
+    await operation.loadUserAttributes(["picture"]);
+    const attr = operation.userAttributes.get("picture");
+    assert_true(attr.loaded);
+    assert_equals(attr.mimeType, "image/png");
+    // The Blob is bound to this window, not to the agent's global.
+    assert_true(attr.value instanceof Blob);
+    assert_equals(attr.value.type, "image/png");
+    assert_equals(await attr.value.text(), "\x89PNG");
+    await channel.close();
+}, "BerytusAccountCreationOperation loads Blob user attribute values from the secret manager");
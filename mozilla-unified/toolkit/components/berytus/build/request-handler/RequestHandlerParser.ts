@@ -20,11 +20,11 @@ interface Method {
 export class RequestHandlerParser {
     intf: InterfaceDeclaration;
 
-    constructor() {
+    constructor(interfaceName: string = 'RequestHandler') {
         const typesFile = project.getSourceFileOrThrow(
             './src/types.ts'
         );
-        this.intf =  typesFile.getInterfaceOrThrow('RequestHandler');
+        this.intf =  typesFile.getInterfaceOrThrow(interfaceName);
     }
 
     getGroups(): string[] {
@@ -1658,6 +1658,97 @@ bool ${functionName}(JSContext* aCx, const ${this.symbol}& aValue, JS::MutableHa
     }
 }
 
+class BlobType extends TypeSymbol implements IType {
+
+    constructor() {
+        super('RefPtr<Blob>');
+    }
+
+    get id() {
+        return this.symbol;
+    }
+
+    movableThroughAssignment = true;
+
+    get definition() {
+        return `${this.isJsValValidFunction().functionDef}
+${this.importFromJsValFunction().functionDef}
+${this.exportToJsValFunction().functionDef}`;
+    }
+
+    get implementation() {
+        return `${this.isJsValValidFunction().functionImpl}
+${this.importFromJsValFunction().functionImpl}
+${this.exportToJsValFunction().functionImpl}`;
+    }
+
+    atArgument(): string {
+        return `${this.symbol}&`;
+    }
+    atReturn(): string {
+        return `${this.symbol}`;
+    }
+    atDefinition(): string {
+        return `${this.symbol}`;
+    }
+    atStruct(): string {
+        return `${this.symbol}`;
+    }
+
+    isJsValValidFunction(): GeneratedFunction {
+        const functionName = `JSValIs<${this.symbol}>`;
+        const funcDef = `template<>
+bool ${functionName}(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv)`;
+        return {
+            functionName,
+            functionDef: `${funcDef};`,
+            functionImpl: `${funcDef} {
+  if (!aValue.isObject()) {
+    aRv = false;
+    return true;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  aRv = IS_INSTANCE_OF(Blob, obj);
+  return true;
+}`
+        }
+    }
+
+    importFromJsValFunction(): GeneratedFunction {
+        const functionName = `FromJSVal<${this.symbol}>`;
+        const funcDef = `template<>
+bool ${functionName}(JSContext* aCx, JS::Handle<JS::Value> aValue, ${this.symbol}& aRv)`;
+        return {
+            functionName,
+            functionDef: `${funcDef};`,
+            functionImpl: `${funcDef} {
+  if (NS_WARN_IF(!aValue.isObject())) {
+    return false;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  if (NS_WARN_IF(NS_FAILED(UNWRAP_OBJECT(Blob, &obj, aRv)))) {
+    return false;
+  }
+  return true;
+}`
+        }
+    }
+
+    exportToJsValFunction(): GeneratedFunction {
+        const functionName = `ToJSVal<${this.symbol}>`
+        const funcDef = `template<>
+bool ${functionName}(JSContext* aCx, const ${this.symbol}& aValue, JS::MutableHandle<JS::Value> aRv)`;
+        return {
+            functionName,
+            functionDef: `${funcDef};`,
+            functionImpl: `${funcDef} {
+  MOZ_ASSERT(aValue);
+  return dom::ToJSValue(aCx, aValue, aRv);
+}`
+        }
+    }
+}
+
 abstract class TypedMember {
     type: IType;
     member: MemberSymbol;
@@ -2100,7 +2191,7 @@ struct ${this.symbol} {
   RefPtr<mozilla::dom::Exception> mException;
 
   ${this.symbol}() : ${this.symbol}(NS_ERROR_FAILURE) {}
-  ${this.symbol}(nsresult res) : mException(new mozilla::dom::Exception(BERYTUS_AGENT_DEFAULT_EXCEPTION_MESSAGE, NS_ERROR_FAILURE, BERYTUS_AGENT_DEFAULT_EXCEPTION_NAME)) {}
+  ${this.symbol}(nsresult res) : mException(new mozilla::dom::Exception(BERYTUS_AGENT_DEFAULT_EXCEPTION_MESSAGE, res, BERYTUS_AGENT_DEFAULT_EXCEPTION_NAME)) {}
 
   ${this.toErrorResultFunction().functionDef}
 };
@@ -2126,12 +2217,24 @@ ${this.importFromJsValFunction().functionImpl}`;
   nsresult result = mException->GetResult();
     const nsCString& msg = mException->GetMessageMoz();
 
-  if (result == NS_ERROR_ABORT) {
+  if (result == NS_ERROR_ABORT || result == NS_BINDING_ABORTED) {
     rv.ThrowAbortError(
       msg.Length() == 0
         ? "Request aborted"_ns
         : msg
     );
+  } else if (result == NS_ERROR_NET_TIMEOUT) {
+    rv.ThrowTimeoutError(
+      msg.Length() == 0
+        ? "Request timed out"_ns
+        : msg
+    );
+  } else if (result == NS_ERROR_DOM_QUOTA_EXCEEDED_ERR) {
+    rv.ThrowQuotaExceededError(
+      msg.Length() == 0
+        ? "Too many pending requests"_ns
+        : msg
+    );
   } else {
     rv.ThrowInvalidStateError(
       msg.Length() == 0
@@ -2366,6 +2469,9 @@ class AgentProxyGenerator {
         if (parsedType.type === "ArrayBufferView") {
             return this.defineArrayBufferView(parsedType);
         }
+        if (parsedType.type === "Blob") {
+            return this.defineBlob(parsedType);
+        }
         if (parsedType.type === "boolean") {
             return this.defineBoolean(parsedType);
         }
@@ -2418,6 +2524,22 @@ class AgentProxyGenerator {
         return abType;
     }
 
+    defineBlob(parsedType: ParsedType): IType {
+        if (parsedType.type !== "Blob") {
+            throw new Error(
+                "Wrong type passed to defineBlob"
+            );
+        }
+        const blobType = new BlobType();
+        this.defs.push(blobType);
+        if (parsedType.optional) {
+            const maybeType = new MaybeType(blobType);
+            this.defs.push(maybeType);
+            return maybeType;
+        }
+        return blobType;
+    }
+
     defineArray(parsedType: ParsedType): IType {
         if (parsedType.type !== "Array") {
             throw new Error(
@@ -2679,13 +2801,18 @@ class AgentProxyGenerator {
 #include "js/PropertyAndElement.h"
 #include "js/String.h"
 #include "js/Value.h"
+#include "mozilla/dom/BindingUtils.h"
+#include "mozilla/dom/BlobBinding.h"
 #include "mozilla/dom/JSActorService.h"
 #include "mozilla/dom/WindowGlobalChild.h"
 #include "mozilla/ErrorResult.h"
 #include "mozilla/dom/JSWindowActorChild.h"
 #include "mozilla/dom/Promise.h"
 #include "mozilla/dom/Promise-inl.h"
+#include "mozilla/dom/ToJSValue.h"
 #include "mozilla/dom/PromiseNativeHandler.h"
+#include "mozilla/Preferences.h"
+#include "nsID.h"
 
 static mozilla::LazyLogModule sLogger("berytus_agent");
 
@@ -2700,7 +2827,52 @@ NS_INTERFACE_MAP_END
 
 ${AgentProxyGenerator.className}::${AgentProxyGenerator.className}(
     nsIGlobalObject* aGlobal, const nsAString& aManagerId)
-    : mGlobal(aGlobal), mManagerId(aManagerId), mDisabled(false) {}
+    : mGlobal(aGlobal), mManagerId(aManagerId), mDisabled(false),
+      mQueryRecorder(nullptr), mLastActivity(TimeStamp::Now()) {}
+
+${AgentProxyGenerator.className}::AutoRecordQueries::AutoRecordQueries(
+    ${AgentProxyGenerator.className}& aAgent, nsTArray<nsString>& aRequestIds)
+    : mAgent(aAgent) {
+  MOZ_ASSERT(!mAgent.mQueryRecorder);
+  mAgent.mQueryRecorder = &aRequestIds;
+}
+
+${AgentProxyGenerator.className}::AutoRecordQueries::~AutoRecordQueries() {
+  mAgent.mQueryRecorder = nullptr;
+}
+
+void ${AgentProxyGenerator.className}::SetRequestTimeouts(const RequestTimeouts& aTimeouts) {
+  mRequestTimeouts = aTimeouts;
+}
+
+uint32_t ${AgentProxyGenerator.className}::RequestTimeoutMs(const nsAString& aGroup,
+                                      const nsAString& aMethod) const {
+  // Requests that usually wait on the user are given longer.
+  static constexpr std::pair<const char16_t*, const char16_t*>
+      kInteractiveMethods[] = {
+    {u"login", u"approveOperation"},
+    {u"login", u"approveOperationAndSnapshot"},
+    {u"accountCreation", u"approveTransitionToAuthOp"},
+    {u"accountCreation", u"getUserAttributes"},
+    {u"accountCreation", u"addField"},
+    {u"accountCreation", u"rejectFieldValue"},
+    {u"accountAuthentication", u"approveChallengeRequest"},
+    {u"accountAuthentication", u"respondToChallengeMessage"},
+    {u"accountAuthentication", u"respondToChallengeMessages"},
+  };
+  for (const auto& [group, method] : kInteractiveMethods) {
+    if (aGroup.EqualsASCII(group) && aMethod.EqualsASCII(method)) {
+      return mRequestTimeouts.mInteractiveRequestTimeoutMs.valueOrFrom([] {
+        return Preferences::GetUint(
+            "dom.berytus.agent.interactive_request_timeout_ms", 300000);
+      });
+    }
+  }
+  return mRequestTimeouts.mRequestTimeoutMs.valueOrFrom([] {
+    return Preferences::GetUint("dom.berytus.agent.request_timeout_ms",
+                                30000);
+  });
+}
 
 ${AgentProxyGenerator.className}::~${AgentProxyGenerator.className}() {}
 
@@ -2708,6 +2880,91 @@ bool ${AgentProxyGenerator.className}::IsDisabled() const {
   return mDisabled;
 }
 
+bool ${AgentProxyGenerator.className}::HasPendingQueries() const {
+  return !mPendingRequestIds.IsEmpty();
+}
+
+uint32_t ${AgentProxyGenerator.className}::PendingQueryCount() const {
+  return mPendingRequestIds.Length();
+}
+
+TimeStamp ${AgentProxyGenerator.className}::LastActivity() const {
+  return mLastActivity;
+}
+
+size_t ${AgentProxyGenerator.className}::SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const {
+  size_t size = aMallocSizeOf(this) +
+                mManagerId.SizeOfExcludingThisIfUnshared(aMallocSizeOf) +
+                mPendingRequestIds.ShallowSizeOfExcludingThis(aMallocSizeOf);
+  for (const nsString& requestId : mPendingRequestIds) {
+    size += requestId.SizeOfExcludingThisIfUnshared(aMallocSizeOf);
+  }
+  return size;
+}
+
+void ${AgentProxyGenerator.className}::QuerySettled(const nsAString& aRequestId) {
+  MOZ_ALWAYS_TRUE(mPendingRequestIds.RemoveElement(aRequestId));
+  mLastActivity = TimeStamp::Now();
+}
+
+void ${AgentProxyGenerator.className}::CancelPendingQueries() {
+  CancelQueries(mPendingRequestIds);
+}
+
+void ${AgentProxyGenerator.className}::CancelQueries(const nsTArray<nsString>& aRequestIds) {
+  bool anyPending = false;
+  for (const nsString& requestId : aRequestIds) {
+    if (mPendingRequestIds.Contains(requestId)) {
+      anyPending = true;
+      break;
+    }
+  }
+  if (!anyPending) {
+    return;
+  }
+  nsPIDOMWindowInner* inner = mGlobal->GetAsInnerWindow();
+  if (!inner) {
+    return;
+  }
+  mozilla::dom::WindowGlobalChild* wgc = inner->GetWindowGlobalChild();
+  if (!wgc) {
+    // NOTE(berytus): The window global is gone, the parent actor
+    // cancels the pending requests upon its destruction.
+    return;
+  }
+  dom::AutoEntryScript aes(mGlobal, "AgentProxy messaging interface");
+  JSContext* cx = aes.cx();
+  ErrorResult rv;
+  RefPtr<mozilla::dom::JSWindowActorChild> actor =
+    wgc->GetActor(cx, "BerytusAgentTarget"_ns, rv);
+  if (NS_WARN_IF(rv.Failed())) {
+    rv.SuppressException();
+    return;
+  }
+  for (const nsString& requestId : aRequestIds) {
+    if (!mPendingRequestIds.Contains(requestId)) {
+      // Settled already.
+      continue;
+    }
+    MOZ_LOG(sLogger, LogLevel::Info, ("CancelQuery %s", NS_ConvertUTF16toUTF8(requestId).get()));
+    JS::Rooted<JSObject*> msgData(cx, JS_NewPlainObject(cx));
+    if (NS_WARN_IF(!msgData)) {
+      return;
+    }
+    JS::Rooted<JS::Value> requestIdJS(cx, JS::StringValue(JS_NewUCStringCopyN(cx, requestId.get(), requestId.Length())));
+    if (NS_WARN_IF(!JS_SetProperty(cx, msgData, "requestId", requestIdJS))) {
+      return;
+    }
+    JS::Rooted<JS::Value> msgDataVal(cx, JS::ObjectValue(*msgData));
+    actor->SendAsyncMessage(cx, u"BerytusAgentTarget:cancelRequest"_ns,
+                            msgDataVal, rv);
+    if (NS_WARN_IF(rv.Failed())) {
+      rv.SuppressException();
+      return;
+    }
+  }
+}
+
 template <typename W1, typename W2>
 already_AddRefed<dom::Promise> ${AgentProxyGenerator.className}::CallSendQuery(JSContext *aCx,
                                                          const nsAString & aGroup,
@@ -2738,6 +2995,11 @@ already_AddRefed<dom::Promise> ${AgentProxyGenerator.className}::CallSendQuery(J
     aRv.ThrowInvalidStateError("Agent is disabled");
     return nullptr;
   }
+  if (mPendingRequestIds.Length() >=
+      Preferences::GetUint("dom.berytus.agent.max_pending_queries", 8)) {
+    aRv.Throw(NS_ERROR_DOM_QUOTA_EXCEEDED_ERR);
+    return nullptr;
+  }
   nsPIDOMWindowInner* inner = mGlobal->GetAsInnerWindow();
   if (NS_WARN_IF(!inner)) {
     aRv.Throw(NS_ERROR_FAILURE);
@@ -2792,6 +3054,23 @@ already_AddRefed<dom::Promise> ${AgentProxyGenerator.className}::CallSendQuery(J
     aRv.Throw(NS_ERROR_FAILURE);
     return nullptr;
   }
+  // The request id lets the parent cancel the request on behalf
+  // of this proxy, see CancelPendingQueries().
+  nsIDToCString requestIdStr(nsID::GenerateUUID());
+  nsString requestId = NS_ConvertUTF8toUTF16(requestIdStr.get());
+  JS::Rooted<JS::Value> requestIdJS(aCx, JS::StringValue(JS_NewUCStringCopyN(aCx, requestId.get(), requestId.Length())));
+  if (NS_WARN_IF(!JS_SetProperty(aCx, msgData, "requestId", requestIdJS))) {
+    aRv.Throw(NS_ERROR_FAILURE);
+    return nullptr;
+  }
+  // The parent rejects the request with NS_ERROR_NET_TIMEOUT if the
+  // secret manager does not settle it in time; 0 disables the timeout.
+  JS::Rooted<JS::Value> requestTimeout(
+    aCx, JS::NumberValue(RequestTimeoutMs(aGroup, aMethod)));
+  if (NS_WARN_IF(!JS_SetProperty(aCx, msgData, "requestTimeout", requestTimeout))) {
+    aRv.Throw(NS_ERROR_FAILURE);
+    return nullptr;
+  }
   const char16_t* groupBuf;
   aGroup.GetData(&groupBuf);
   JS::Rooted<JS::Value> group(
@@ -2847,6 +3126,17 @@ already_AddRefed<dom::Promise> ${AgentProxyGenerator.className}::CallSendQuery(J
     return nullptr;
   }
   promise->MaybeResolve(promiseVal);
+  mPendingRequestIds.AppendElement(requestId);
+  if (mQueryRecorder) {
+    mQueryRecorder->AppendElement(requestId);
+  }
+  mLastActivity = TimeStamp::Now();
+  auto onSettled = [requestId](JSContext* aCx, JS::Handle<JS::Value> aValue,
+                               ErrorResult& aRv, const RefPtr<${AgentProxyGenerator.className}>& aSelf) {
+    aSelf->QuerySettled(requestId);
+  };
+  promise->AddCallbacksWithCycleCollectedArgs(onSettled, onSettled,
+                                              RefPtr{this});
   return promise.forget();
 }
 
@@ -2863,6 +3153,7 @@ Owned${AgentProxyGenerator.className}::~Owned${AgentProxyGenerator.className}()
 
 void Owned${AgentProxyGenerator.className}::Disable() {
   mDisabled = true;
+  CancelPendingQueries();
 }
 
 ${this.defs.filter(d => !(d instanceof MethodDef)).map(d => d.implementation).join("\n")}
@@ -2881,9 +3172,13 @@ ${this.defs.filter(d => d instanceof MethodDef).map((m) => `${m.implementation}`
 #include "nsCycleCollectionParticipant.h"
 #include "nsIGlobalObject.h"
 #include "mozilla/dom/TypedArray.h" // ArrayBuffer
+#include "mozilla/dom/Blob.h"
+#include "mozilla/Maybe.h"
 #include "mozilla/Variant.h"
 #include "mozilla/dom/DOMException.h" // for Failure's Exception
 #include "mozilla/Logging.h"
+#include "mozilla/MemoryReporting.h"
+#include "mozilla/TimeStamp.h"
 #include "mozilla/dom/Record.h"
 #include "mozilla/dom/PromiseNativeHandler.h"
 
@@ -2893,6 +3188,7 @@ namespace mozilla::berytus {
 
 using ArrayBuffer = mozilla::dom::ArrayBuffer;
 using ArrayBufferView = mozilla::dom::ArrayBufferView;
+using Blob = mozilla::dom::Blob;
 template <typename K, typename V>
 using Record = mozilla::dom::Record<K, V>;
 
@@ -2932,6 +3228,15 @@ bool ToJSVal(JSContext* aCx, const T& aValue, JS::MutableHandle<JS::Value> aRv)
 
 ${this.defs.filter(d => !(d instanceof MethodDef)).map(def => def.definition).join("\n")}
 
+/**
+ * Per-agent overrides of the request timeouts, in milliseconds;
+ * 0 disables the timeout.
+ */
+struct RequestTimeouts {
+  Maybe<uint32_t> mRequestTimeoutMs;
+  Maybe<uint32_t> mInteractiveRequestTimeoutMs;
+};
+
 class ${AgentProxyGenerator.className} : public nsISupports {
   NS_DECL_CYCLE_COLLECTING_ISUPPORTS
   NS_DECL_CYCLE_COLLECTION_CLASS(${AgentProxyGenerator.className})
@@ -2939,6 +3244,52 @@ class ${AgentProxyGenerator.className} : public nsISupports {
 public:
   ${AgentProxyGenerator.className}(nsIGlobalObject* aGlobal, const nsAString& aManagerId);
   bool IsDisabled() const;
+  /**
+   * Whether a query was sent and has not settled yet.
+   */
+  bool HasPendingQueries() const;
+  /**
+   * The number of queries that were sent and have not settled yet.
+   */
+  uint32_t PendingQueryCount() const;
+  /**
+   * When a query was last sent or settled.
+   */
+  TimeStamp LastActivity() const;
+  /**
+   * Asks the parent to cancel the pending queries; the secret
+   * manager is notified and the queries are rejected with
+   * NS_BINDING_ABORTED.
+   */
+  void CancelPendingQueries();
+  /**
+   * Same as CancelPendingQueries(), for the passed queries only;
+   * those that have settled already are skipped.
+   */
+  void CancelQueries(const nsTArray<nsString>& aRequestIds);
+  /**
+   * Appends the ids of the queries sent while in scope to
+   * aRequestIds, so that an operation sharing the agent with
+   * others can cancel its own queries, see CancelQueries().
+   */
+  class MOZ_RAII AutoRecordQueries final {
+  public:
+    AutoRecordQueries(${AgentProxyGenerator.className}& aAgent, nsTArray<nsString>& aRequestIds);
+    ~AutoRecordQueries();
+
+  private:
+    ${AgentProxyGenerator.className}& mAgent;
+  };
+  /**
+   * Overrides the dom.berytus.agent.request_timeout_ms and
+   * dom.berytus.agent.interactive_request_timeout_ms defaults.
+   */
+  void SetRequestTimeouts(const RequestTimeouts& aTimeouts);
+  /**
+   * The pending queries' MozPromises are held by their JS promise
+   * handlers and are not measured; see PendingQueryCount().
+   */
+  size_t SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const;
 
   template <typename W1, typename W2>
   already_AddRefed<dom::Promise> CallSendQuery(JSContext *aCx,
@@ -2960,6 +3311,24 @@ protected:
   nsCOMPtr<nsIGlobalObject> mGlobal;
   nsString mManagerId;
   bool mDisabled;
+  /**
+   * The ids of the queries that were sent and have not settled yet.
+   */
+  nsTArray<nsString> mPendingRequestIds;
+  /**
+   * Set while an AutoRecordQueries is in scope.
+   */
+  nsTArray<nsString>* mQueryRecorder;
+  TimeStamp mLastActivity;
+  RequestTimeouts mRequestTimeouts;
+
+  void QuerySettled(const nsAString& aRequestId);
+  /**
+   * The time the secret manager is given to settle the query,
+   * in milliseconds; 0 if unbounded.
+   */
+  uint32_t RequestTimeoutMs(const nsAString& aGroup,
+                            const nsAString& aMethod) const;
 
 public:
 ${this.defs.filter(d => d instanceof MethodDef).map(def => def.definition).join("\n").replace(/^(.*)$/gm, "  $1")}
@@ -3006,40 +3375,45 @@ class MozPromiseRejectWithBerytusFailureOnDestruction final
 }
 
 export const generateDomProxy = async () => {
-    const h = new RequestHandlerParser();
-    const groups = h.getGroups();
     const generator = new AgentProxyGenerator();
-
-    const typeIterator = h.typeIterator();
-    let item = typeIterator.next();
-    let parameters: Array<ArgumentMember> = [];
-    while (! item.done) {
-        const {
-            parsedType,
-            source,
-            method,
-            group,
-            paramName
-        } = item.value;
-        const type = generator.defineType(parsedType);
-        if (source === "parameter") {
-            const typedMember = new ArgumentMember(
-                type,
-                new MemberSymbol(paramName),
-                true
-            );
-            parameters.push(typedMember);
-        }
-        if (source === "returnType") {
-            generator.addMethod(
+    // The Agent's own requests (AgentRequestHandler) are proxied
+    // the same way as the secret manager's requests.
+    const parsers = [
+        new RequestHandlerParser(),
+        new RequestHandlerParser('AgentRequestHandler')
+    ];
+    for (const h of parsers) {
+        const typeIterator = h.typeIterator();
+        let item = typeIterator.next();
+        let parameters: Array<ArgumentMember> = [];
+        while (! item.done) {
+            const {
+                parsedType,
+                source,
+                method,
                 group,
-                method.name,
-                parameters,
-                type
-            );
-            parameters.splice(0, parameters.length);
+                paramName
+            } = item.value;
+            const type = generator.defineType(parsedType);
+            if (source === "parameter") {
+                const typedMember = new ArgumentMember(
+                    type,
+                    new MemberSymbol(paramName),
+                    true
+                );
+                parameters.push(typedMember);
+            }
+            if (source === "returnType") {
+                generator.addMethod(
+                    group,
+                    method.name,
+                    parameters,
+                    type
+                );
+                parameters.splice(0, parameters.length);
+            }
+            item = typeIterator.next();
         }
-        item = typeIterator.next();
     }
 
     return {
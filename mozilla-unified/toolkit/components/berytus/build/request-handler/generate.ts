@@ -20,7 +20,10 @@ const run = async () => {
         code: validatedRequestHandlerCode,
         typesToImport: typesToImport2
     } = generateValidatedHandler();
-    const sequentialRequestHandlerCode = generateSequentialdHandler();
+    const {
+        code: sequentialRequestHandlerCode,
+        typesToImport: typesToImportSeq
+    } = generateSequentialdHandler();
 
     const {
         classCode: publicRequestHandlerCode,
@@ -32,7 +35,7 @@ const run = async () => {
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 // This file is automatically generated; do not edit.
-import type { ${Object.keys({ ...typesToImport, ...typesToImport2, ...typesToImport3 }).join(', ')} } from './types';`
+import type { ${Object.keys({ ...typesToImport, ...typesToImport2, ...typesToImportSeq, ...typesToImport3 }).join(', ')} } from './types';`
         + baseRequestHandlerCode
         + "\n"
         + validatedRequestHandlerCode
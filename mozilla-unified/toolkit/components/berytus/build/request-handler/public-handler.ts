@@ -11,6 +11,7 @@ export const generatePublicHandler = () => {
     const typesToImport: Record<string, true> = {
         "IPublicRequestHandler": true,
         "IUnderlyingRequestHandler": true,
+        "PublicRequestContext": true,
         "ResponseContext": true,
         "RequestHandler": true
     }
@@ -69,7 +70,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                 }
                 typesToImport[p.type.alias] = true;
                 return `${p.name}: `
-                    + (i === 0 ? `Omit<${p.type.alias}, "request">` : p.type.alias);
+                    + (i === 0 ? `PublicRequestContext<${p.type.alias}>` : p.type.alias);
             }).join(', ');
             code += `): Promise<${returnType}> {
                 return new Promise<${returnType}>((_resolve, _reject) => {
@@ -86,6 +87,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...${ctxVar}.request,
                             type: "${capitlise(group)}_${capitlise(name)}" as const
                         }
                     };
@@ -3,40 +3,232 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
  export const generateSequentialdHandler = () => {
-    let code = `export class SequentialRequestHandler extends ValidatedRequestHandler {
+    const typesToImport: Record<string, true> = {
+        "ICancellableRequestHandler": true,
+        "IUnderlyingRequestHandler": true
+    };
+    let code = `interface PendingRequest {
+    group: string;
+    method: string;
+    context: PreliminaryRequestContext & {
+        response: { reject(val: unknown): void }
+    };
+    /**
+     * Set if the request has a deadline.
+     */
+    deadlineTimer?: number;
+}
+
+interface QueuedRequest {
+    requestId: string;
+    proceed(): void;
+    fail(reason: unknown): void;
+    /**
+     * Set if the request has a deadline.
+     */
+    deadlineTimer?: number;
+}
+
+export class SequentialRequestHandler extends ValidatedRequestHandler {
 
     protected busy: boolean = false;
+    #impl: IUnderlyingRequestHandler & Partial<ICancellableRequestHandler>;
+    /**
+     * The request sent to the secret manager and not yet settled.
+     * Cleared when the request is settled or cancelled; late
+     * settlements of a cancelled request are refused.
+     */
+    #pending?: PendingRequest;
+    /**
+     * Requests waiting for the pending one to settle, in arrival
+     * order. The handler of a secret manager is shared by the
+     * channels of all windows, so their requests are queued rather
+     * than refused.
+     */
+    #queue: QueuedRequest[] = [];
 
-    protected async preCall(group: string, method: string, input: PreCallInput) {
-        if (this.busy) {
+    constructor(impl: IUnderlyingRequestHandler & Partial<ICancellableRequestHandler>) {
+        super(impl);
+        this.#impl = impl;
+    }
+
+    #isPending(input: PreCallInput) {
+        return this.#pending !== undefined
+            && this.#pending.context === input.context;
+    }
+
+    #clearPending() {
+        if (this.#pending?.deadlineTimer !== undefined) {
+            // @ts-ignore: TS did not catch assertion for "lazy"
+            lazy.clearTimeout(this.#pending.deadlineTimer);
+        }
+        this.#pending = undefined;
+        this.#proceedWithNext();
+    }
+
+    /**
+     * Hands the turn to the oldest queued request, if any; the
+     * handler stays busy in that case.
+     */
+    #proceedWithNext() {
+        const next = this.#queue.shift();
+        if (! next) {
+            this.busy = false;
+            return;
+        }
+        if (next.deadlineTimer !== undefined) {
+            // @ts-ignore: TS did not catch assertion for "lazy"
+            lazy.clearTimeout(next.deadlineTimer);
+        }
+        next.proceed();
+    }
+
+    #dequeue(queued: QueuedRequest, reason: unknown) {
+        const index = this.#queue.indexOf(queued);
+        if (index === -1) {
+            return;
+        }
+        this.#queue.splice(index, 1);
+        if (queued.deadlineTimer !== undefined) {
+            // @ts-ignore: TS did not catch assertion for "lazy"
+            lazy.clearTimeout(queued.deadlineTimer);
+        }
+        queued.fail(reason);
+    }
+
+    /**
+     * Resolves once the requests ahead are settled. Rejects if the
+     * request is cancelled, or its deadline is passed, while queued.
+     */
+    #waitForTurn(input: PreCallInput) {
+        return new Promise<void>((resolve, reject) => {
+            const queued: QueuedRequest = {
+                requestId: input.context.request.id,
+                proceed: resolve,
+                fail: reject
+            };
+            const { deadline } = input.context.request;
+            if (deadline !== undefined) {
+                // @ts-ignore: TS did not catch assertion for "lazy"
+                queued.deadlineTimer = lazy.setTimeout(() => {
+                    this.#dequeue(queued, new Components.Exception(
+                        \`Request \${queued.requestId} timed out.\`,
+                        Cr.NS_ERROR_NET_TIMEOUT
+                    ));
+                }, Math.max(deadline - Date.now(), 0));
+            }
+            this.#queue.push(queued);
+        });
+    }
+
+    #refuseStaleSettlement(input: PreCallInput) {
+        if (! this.#isPending(input)) {
             throw new Components.Exception(
-                'Refusing to send request to secret manager, '
-                + 'an existing request is still pending. '
-                + 'make sure to send one request at a time '
-                + 'to the secret manager.',
-                Cr.NS_ERROR_FAILURE
+                \`Request \${input.context.request.id} is no longer \`
+                + 'pending; it was either cancelled or already settled.',
+                Cr.NS_BINDING_ABORTED
             );
         }
+        this.#clearPending();
+    }
+
+    /**
+     * Rejects the pending request with the passed reason, rolls back
+     * the validators and notifies the secret manager so that it can
+     * stop processing the request.
+     */
+    #abort(pending: PendingRequest, reason: unknown) {
+        const requestId = pending.context.request.id;
+        this.#clearPending();
+        super.preReject(
+            pending.group,
+            pending.method,
+            { context: pending.context },
+            reason
+        ).catch(e => {
+            console.warn(\`Unable to roll back aborted request \${requestId}\`, e);
+        });
+        pending.context.response.reject(reason);
+        try {
+            this.#impl.cancelRequest?.(requestId);
+        } catch (e) {
+            console.warn(\`Secret manager failed to cancel request \${requestId}\`, e);
+        }
+    }
+
+    protected async preCall(group: string, method: string, input: PreCallInput) {
+        if (this.busy) {
+            // The turn is handed over with the handler still busy.
+            await this.#waitForTurn(input);
+        }
         this.busy = true;
+        const pending: PendingRequest = {
+            group,
+            method,
+            context: input.context as PendingRequest["context"]
+        };
+        const { deadline } = input.context.request;
+        if (deadline !== undefined) {
+            // @ts-ignore: TS did not catch assertion for "lazy"
+            pending.deadlineTimer = lazy.setTimeout(() => {
+                if (this.#pending !== pending) {
+                    return;
+                }
+                this.#abort(pending, new Components.Exception(
+                    \`Request \${pending.context.request.id} timed out.\`,
+                    Cr.NS_ERROR_NET_TIMEOUT
+                ));
+            }, Math.max(deadline - Date.now(), 0));
+        }
+        this.#pending = pending;
         try {
             await super.preCall(group, method, input);
         } catch (e) {
-            this.busy = false;
+            this.#clearPending();
             throw e;
         }
     }
     protected async preResolve(group: string, method: string, input: PreCallInput, value: unknown) {
-        this.busy = false;
+        this.#refuseStaleSettlement(input);
         await super.preResolve(group, method, input, value);
     }
     protected async preReject(group: string, method: string, input: PreCallInput, value: unknown) {
-        this.busy = false;
+        this.#refuseStaleSettlement(input);
         await super.preReject(group, method, input, value);
     }
     protected handleUnexpectedException<G extends keyof RequestHandler, M extends keyof RequestHandler[G]>(group: G, method: M, response: ResponseContext<G, M>["response"], excp: unknown) {
-        this.busy = false;
+        if (this.#pending?.context.response !== response) {
+            // The request was cancelled; its response is settled.
+            return;
+        }
+        this.#clearPending();
         super.handleUnexpectedException(group, method, response, excp);
     }
+
+    /**
+     * Cancels the pending or a queued request if its id matches; the
+     * request is rejected with NS_BINDING_ABORTED. A queued request
+     * is dropped before reaching the secret manager. Requests with a
+     * deadline are likewise aborted with NS_ERROR_NET_TIMEOUT once
+     * the deadline is passed. Returns whether a request was cancelled.
+     */
+    cancel(requestId: string): boolean {
+        const reason = new Components.Exception(
+            \`Request \${requestId} was cancelled.\`,
+            Cr.NS_BINDING_ABORTED
+        );
+        const pending = this.#pending;
+        if (pending?.context.request.id === requestId) {
+            this.#abort(pending, reason);
+            return true;
+        }
+        const queued = this.#queue.find(q => q.requestId === requestId);
+        if (! queued) {
+            return false;
+        }
+        this.#dequeue(queued, reason);
+        return true;
+    }
 }`;
-    return code;
-}
\ No newline at end of file
+    return { code, typesToImport };
+}
@@ -6,7 +6,7 @@ import { project } from './Project.js';
 import { Type, EnumMember, ts } from 'ts-morph';
 
 type Atom = "any" | "string" | "number" | "boolean" | "undefined"
-    | "null" | "ArrayBuffer" | "ArrayBufferView";
+    | "null" | "ArrayBuffer" | "ArrayBufferView" | "Blob";
 
 export type ParsedType = {
     type: Atom;
@@ -162,6 +162,9 @@ export const parseType = (int: Type, opts: ParseOptions = {}): ParsedType => {
     if (int.getText() === 'ArrayBufferView') {
         return { type: 'ArrayBufferView' }
     }
+    if (int.getText() === 'Blob') {
+        return { type: 'Blob' }
+    }
     if (int.getTargetType()?.getSymbol()?.getName() === 'Promise') {
         throw new Error('Promises are not supported in type parser');
     }
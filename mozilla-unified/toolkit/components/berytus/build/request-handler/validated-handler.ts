@@ -10,7 +10,7 @@ const generateFieldIdValidator = () => {
 class FieldIdValidator implements ILogicalValidator {
     /**
      * op id -> field id -> true
-     * TODO(berytus): There should be a cleanup mechanism.
+     * Entries are dropped through release() once the operation ends.
      */
     #fields: Record<string, Record<string, true>>;
 
@@ -69,6 +69,10 @@ class FieldIdValidator implements ILogicalValidator {
 
     async digest(group: string, method: string, input: PreCallInput, output: unknown): Promise<void> {}
 
+    release(operationId: string): void {
+        delete this.#fields[operationId];
+    }
+
     async rollback(group: string, method: string, input: PreCallInput): Promise<void> {
         if (inputIs("AccountCreation_AddField", input)) {
             const { operation } = input.context as RequestContextWithOperation;
@@ -104,7 +108,7 @@ const generateChallangeSequenceValidator = () => {
 class ChallangeMessagingSequenceValidator implements ILogicalValidator {
     /**
      * op id -> ch id -> nb of messages sent
-     * TODO(berytus): There should be a cleanup mechanism.
+     * Entries are dropped through release() once the operation ends.
      */
     #counter: Record<string, Record<string, number>>;
 
@@ -165,6 +169,10 @@ class ChallangeMessagingSequenceValidator implements ILogicalValidator {
 
     async digest(group: string, method: string, input: PreCallInput, output: unknown): Promise<void> {}
 
+    release(operationId: string): void {
+        delete this.#counter[operationId];
+    }
+
     async rollback(group: string, method: string, input: PreCallInput): Promise<void> {
         if (!inputIs("AccountAuthentication_RespondToChallengeMessage", input)) {
             return;
@@ -193,6 +201,8 @@ class FieldCreationHandler implements ILogicalValidator {
 
     async rollback(group: string, method: string, input: PreCallInput): Promise<void> {}
 
+    release(operationId: string): void {}
+
     async digest(group: string, method: string, input: PreCallInput, output: unknown): Promise<void> {
         const errorPrefix = \`Malformed output passed from the request handler's \`
             + \`\${group}:\${method} method.\`;
@@ -240,7 +250,9 @@ export const generateValidatedHandler = () => {
 }
 const lazy = {};
 ChromeUtils.defineESModuleGetters(lazy, {
-    Schemas: "resource://gre/modules/Schemas.sys.mjs"
+    Schemas: "resource://gre/modules/Schemas.sys.mjs",
+    setTimeout: "resource://gre/modules/Timer.sys.mjs",
+    clearTimeout: "resource://gre/modules/Timer.sys.mjs"
 });
 
 const requestIs = <RT extends RequestType>(requestType: RT, d: { context: PreliminaryRequestContext; args?: unknown; output: unknown}): d is { context: PreliminaryRequestContext; args: RequestHandlerFunctionParameters<RT>[1]; output: RequestHandlerFunctionReturnType<RT> } => {
@@ -366,10 +378,19 @@ class ResolutionError extends Error {
     }
 }
 
+interface OperationScope {
+    channelId: string;
+    documentId: number;
+}
+
 interface ILogicalValidator {
     consume(group: string, method: string, input: PreCallInput): Promise<void>;
     rollback(group: string, method: string, input: PreCallInput): Promise<void>;
     digest(group: string, method: string, input: PreCallInput, output: unknown): Promise<void>;
+    /**
+     * Drops any state held for the operation.
+     */
+    release(operationId: string): void;
 }
 
 ${generateFieldIdValidator()}
@@ -379,10 +400,17 @@ ${generateFieldCreationValidator()}
 export class ValidatedRequestHandler extends IsolatedRequestHandler {
     #schema: any;
     #validators: ILogicalValidator[];
+    /**
+     * op id -> the channel and the document (inner window id) the
+     * operation belongs to. Used to release the validators' state of
+     * operations whose channel was closed or whose document is gone.
+     */
+    #operations: Map<string, OperationScope>;
 
     constructor(impl: IUnderlyingRequestHandler) {
         // TODO(berytus): ensure impl is conformant
         super(impl);
+        this.#operations = new Map();
         this.#validators = [];
         this.#validators.push(
             new FieldIdValidator(),
@@ -445,6 +473,7 @@ export class ValidatedRequestHandler extends IsolatedRequestHandler {
             );
         }
         await this.#consumeValidators(group, method, input);
+        this.#trackOperation(input);
         try {
             await super.preCall(group, method, input);
         } catch (e) {
@@ -481,6 +510,52 @@ export class ValidatedRequestHandler extends IsolatedRequestHandler {
             }
         }
         await super.preResolve(group, method, input, output);
+        this.#releaseEndedOperations(input);
+    }
+
+    /**
+     * Releases the validators' state of the operations that took
+     * place in the document, e.g. once the document is destroyed.
+     */
+    releaseDocument(documentId: number) {
+        this.#releaseOperations(scope => scope.documentId === documentId);
+    }
+
+    #trackOperation(input: PreCallInput) {
+        const { operation, channel } = input.context as Partial<RequestContextWithOperation>;
+        if (! operation || ! channel || this.#operations.has(operation.id)) {
+            return;
+        }
+        this.#operations.set(operation.id, {
+            channelId: channel.id,
+            documentId: input.context.document.id
+        });
+    }
+
+    #releaseEndedOperations(input: PreCallInput) {
+        if (inputIs("Login_CloseOperation", input)
+            || inputIs("AccountCreation_ApproveTransitionToAuthOp", input)) {
+            const { operation } = input.context as RequestContextWithOperation;
+            this.#releaseOperation(operation.id);
+            return;
+        }
+        if (inputIs("Channel_CloseChannel", input)) {
+            const { channel } = input.context as RequestContext;
+            this.#releaseOperations(scope => scope.channelId === channel.id);
+        }
+    }
+
+    #releaseOperations(predicate: (scope: OperationScope) => boolean) {
+        for (const [operationId, scope] of this.#operations) {
+            if (predicate(scope)) {
+                this.#releaseOperation(operationId);
+            }
+        }
+    }
+
+    #releaseOperation(operationId: string) {
+        this.#operations.delete(operationId);
+        this.#validators.forEach(val => val.release(operationId));
     }
 
     protected async preReject(group: string, method: string, input: PreCallInput, value: unknown) {
@@ -117,6 +117,35 @@ export const generateWebExtsSchema = async () => {
         [],
         true
     );
+    apiGenerator.addApiMethod(
+        'signingKeyRotated',
+        [],
+        true
+    );
+    apiGenerator.addApiMethod(
+        'generatePassword',
+        [
+            {
+                name: "passwordRules",
+                type: "string"
+            }
+        ],
+        true
+    );
+    apiGenerator.addApiMethod(
+        'generatePasswords',
+        [
+            {
+                name: "passwordRules",
+                type: "string"
+            },
+            {
+                name: "count",
+                type: "integer"
+            }
+        ],
+        true
+    );
     apiGenerator.addApiMethod(
         'resolveRequest',
         [
@@ -206,6 +235,13 @@ export interface ArrayBufferViewSchemaEntry {
     optional?: true;
 }
 
+export interface BlobSchemaEntry {
+    type: "object";
+    isInstanceOf: "Blob";
+    additionalProperties: true;
+    optional?: true;
+}
+
 export type ObjectAttributeSchemaEntry = LiteralValueSchemaEntry
     | RefSchemaEntry
     | EnumSchemaEntry
@@ -247,6 +283,7 @@ export type SchemaDef =
     TypeSchemaEntry
     | ArrayBufferSchemaEntry
     | ArrayBufferViewSchemaEntry
+    | BlobSchemaEntry
     | RefSchemaEntry
     | ObjectFunctionSchemaEntry
     | ObjectSchemaEntry
@@ -505,6 +542,9 @@ class WebExtsApiSchemaGenerator {
         if (parsedType.type === "ArrayBufferView") {
             return this.getArrayBufferViewEntry(parsedType);
         }
+        if (parsedType.type === "Blob") {
+            return this.getBlobEntry(parsedType);
+        }
         if (
             parsedType.type === "boolean" ||
             parsedType.type === "number" ||
@@ -754,6 +794,22 @@ class WebExtsApiSchemaGenerator {
         }
     }
 
+    getBlobEntry(parsedType: ParsedType): BlobSchemaEntry {
+        if (parsedType.optional === undefined) {
+            return {
+                type: "object",
+                isInstanceOf: "Blob",
+                additionalProperties: true
+            };
+        }
+        return {
+            type: "object",
+            isInstanceOf: "Blob",
+            additionalProperties: true,
+            optional: parsedType.optional
+        }
+    }
+
     get schema() {
         return {
             namespace: "berytus",
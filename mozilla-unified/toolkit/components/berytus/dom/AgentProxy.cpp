@@ -7,13 +7,18 @@
 #include "js/PropertyAndElement.h"
 #include "js/String.h"
 #include "js/Value.h"
+#include "mozilla/dom/BindingUtils.h"
+#include "mozilla/dom/BlobBinding.h"
 #include "mozilla/dom/JSActorService.h"
 #include "mozilla/dom/WindowGlobalChild.h"
 #include "mozilla/ErrorResult.h"
 #include "mozilla/dom/JSWindowActorChild.h"
 #include "mozilla/dom/Promise.h"
 #include "mozilla/dom/Promise-inl.h"
+#include "mozilla/dom/ToJSValue.h"
 #include "mozilla/dom/PromiseNativeHandler.h"
+#include "mozilla/Preferences.h"
+#include "nsID.h"
 
 static mozilla::LazyLogModule sLogger("berytus_agent");
 
@@ -28,7 +33,52 @@ NS_INTERFACE_MAP_END
 
 AgentProxy::AgentProxy(
     nsIGlobalObject* aGlobal, const nsAString& aManagerId)
-    : mGlobal(aGlobal), mManagerId(aManagerId), mDisabled(false) {}
+    : mGlobal(aGlobal), mManagerId(aManagerId), mDisabled(false),
+      mQueryRecorder(nullptr), mLastActivity(TimeStamp::Now()) {}
+
+AgentProxy::AutoRecordQueries::AutoRecordQueries(
+    AgentProxy& aAgent, nsTArray<nsString>& aRequestIds)
+    : mAgent(aAgent) {
+  MOZ_ASSERT(!mAgent.mQueryRecorder);
+  mAgent.mQueryRecorder = &aRequestIds;
+}
+
+AgentProxy::AutoRecordQueries::~AutoRecordQueries() {
+  mAgent.mQueryRecorder = nullptr;
+}
+
+void AgentProxy::SetRequestTimeouts(const RequestTimeouts& aTimeouts) {
+  mRequestTimeouts = aTimeouts;
+}
+
+uint32_t AgentProxy::RequestTimeoutMs(const nsAString& aGroup,
+                                      const nsAString& aMethod) const {
+  // Requests that usually wait on the user are given longer.
+  static constexpr std::pair<const char16_t*, const char16_t*>
+      kInteractiveMethods[] = {
+    {u"login", u"approveOperation"},
+    {u"login", u"approveOperationAndSnapshot"},
+    {u"accountCreation", u"approveTransitionToAuthOp"},
+    {u"accountCreation", u"getUserAttributes"},
+    {u"accountCreation", u"addField"},
+    {u"accountCreation", u"rejectFieldValue"},
+    {u"accountAuthentication", u"approveChallengeRequest"},
+    {u"accountAuthentication", u"respondToChallengeMessage"},
+    {u"accountAuthentication", u"respondToChallengeMessages"},
+  };
+  for (const auto& [group, method] : kInteractiveMethods) {
+    if (aGroup.EqualsASCII(group) && aMethod.EqualsASCII(method)) {
+      return mRequestTimeouts.mInteractiveRequestTimeoutMs.valueOrFrom([] {
+        return Preferences::GetUint(
+            "dom.berytus.agent.interactive_request_timeout_ms", 300000);
+      });
+    }
+  }
+  return mRequestTimeouts.mRequestTimeoutMs.valueOrFrom([] {
+    return Preferences::GetUint("dom.berytus.agent.request_timeout_ms",
+                                30000);
+  });
+}
 
 AgentProxy::~AgentProxy() {}
 
@@ -36,6 +86,91 @@ bool AgentProxy::IsDisabled() const {
   return mDisabled;
 }
 
+bool AgentProxy::HasPendingQueries() const {
+  return !mPendingRequestIds.IsEmpty();
+}
+
+uint32_t AgentProxy::PendingQueryCount() const {
+  return mPendingRequestIds.Length();
+}
+
+TimeStamp AgentProxy::LastActivity() const {
+  return mLastActivity;
+}
+
+size_t AgentProxy::SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const {
+  size_t size = aMallocSizeOf(this) +
+                mManagerId.SizeOfExcludingThisIfUnshared(aMallocSizeOf) +
+                mPendingRequestIds.ShallowSizeOfExcludingThis(aMallocSizeOf);
+  for (const nsString& requestId : mPendingRequestIds) {
+    size += requestId.SizeOfExcludingThisIfUnshared(aMallocSizeOf);
+  }
+  return size;
+}
+
+void AgentProxy::QuerySettled(const nsAString& aRequestId) {
+  MOZ_ALWAYS_TRUE(mPendingRequestIds.RemoveElement(aRequestId));
+  mLastActivity = TimeStamp::Now();
+}
+
+void AgentProxy::CancelPendingQueries() {
+  CancelQueries(mPendingRequestIds);
+}
+
+void AgentProxy::CancelQueries(const nsTArray<nsString>& aRequestIds) {
+  bool anyPending = false;
+  for (const nsString& requestId : aRequestIds) {
+    if (mPendingRequestIds.Contains(requestId)) {
+      anyPending = true;
+      break;
+    }
+  }
+  if (!anyPending) {
+    return;
+  }
+  nsPIDOMWindowInner* inner = mGlobal->GetAsInnerWindow();
+  if (!inner) {
+    return;
+  }
+  mozilla::dom::WindowGlobalChild* wgc = inner->GetWindowGlobalChild();
+  if (!wgc) {
+    // NOTE(berytus): The window global is gone, the parent actor
+    // cancels the pending requests upon its destruction.
+    return;
+  }
+  dom::AutoEntryScript aes(mGlobal, "AgentProxy messaging interface");
+  JSContext* cx = aes.cx();
+  ErrorResult rv;
+  RefPtr<mozilla::dom::JSWindowActorChild> actor =
+    wgc->GetActor(cx, "BerytusAgentTarget"_ns, rv);
+  if (NS_WARN_IF(rv.Failed())) {
+    rv.SuppressException();
+    return;
+  }
+  for (const nsString& requestId : aRequestIds) {
+    if (!mPendingRequestIds.Contains(requestId)) {
+      // Settled already.
+      continue;
+    }
+    MOZ_LOG(sLogger, LogLevel::Info, ("CancelQuery %s", NS_ConvertUTF16toUTF8(requestId).get()));
+    JS::Rooted<JSObject*> msgData(cx, JS_NewPlainObject(cx));
+    if (NS_WARN_IF(!msgData)) {
+      return;
+    }
+    JS::Rooted<JS::Value> requestIdJS(cx, JS::StringValue(JS_NewUCStringCopyN(cx, requestId.get(), requestId.Length())));
+    if (NS_WARN_IF(!JS_SetProperty(cx, msgData, "requestId", requestIdJS))) {
+      return;
+    }
+    JS::Rooted<JS::Value> msgDataVal(cx, JS::ObjectValue(*msgData));
+    actor->SendAsyncMessage(cx, u"BerytusAgentTarget:cancelRequest"_ns,
+                            msgDataVal, rv);
+    if (NS_WARN_IF(rv.Failed())) {
+      rv.SuppressException();
+      return;
+    }
+  }
+}
+
 template <typename W1, typename W2>
 already_AddRefed<dom::Promise> AgentProxy::CallSendQuery(JSContext *aCx,
                                                          const nsAString & aGroup,
@@ -66,6 +201,11 @@ already_AddRefed<dom::Promise> AgentProxy::CallSendQuery(JSContext *aCx,
     aRv.ThrowInvalidStateError("Agent is disabled");
     return nullptr;
   }
+  if (mPendingRequestIds.Length() >=
+      Preferences::GetUint("dom.berytus.agent.max_pending_queries", 8)) {
+    aRv.Throw(NS_ERROR_DOM_QUOTA_EXCEEDED_ERR);
+    return nullptr;
+  }
   nsPIDOMWindowInner* inner = mGlobal->GetAsInnerWindow();
   if (NS_WARN_IF(!inner)) {
     aRv.Throw(NS_ERROR_FAILURE);
@@ -120,6 +260,23 @@ already_AddRefed<dom::Promise> AgentProxy::CallSendQuery(JSContext *aCx,
     aRv.Throw(NS_ERROR_FAILURE);
     return nullptr;
   }
+  // The request id lets the parent cancel the request on behalf
+  // of this proxy, see CancelPendingQueries().
+  nsIDToCString requestIdStr(nsID::GenerateUUID());
+  nsString requestId = NS_ConvertUTF8toUTF16(requestIdStr.get());
+  JS::Rooted<JS::Value> requestIdJS(aCx, JS::StringValue(JS_NewUCStringCopyN(aCx, requestId.get(), requestId.Length())));
+  if (NS_WARN_IF(!JS_SetProperty(aCx, msgData, "requestId", requestIdJS))) {
+    aRv.Throw(NS_ERROR_FAILURE);
+    return nullptr;
+  }
+  // The parent rejects the request with NS_ERROR_NET_TIMEOUT if the
+  // secret manager does not settle it in time; 0 disables the timeout.
+  JS::Rooted<JS::Value> requestTimeout(
+    aCx, JS::NumberValue(RequestTimeoutMs(aGroup, aMethod)));
+  if (NS_WARN_IF(!JS_SetProperty(aCx, msgData, "requestTimeout", requestTimeout))) {
+    aRv.Throw(NS_ERROR_FAILURE);
+    return nullptr;
+  }
   const char16_t* groupBuf;
   aGroup.GetData(&groupBuf);
   JS::Rooted<JS::Value> group(
@@ -175,6 +332,17 @@ already_AddRefed<dom::Promise> AgentProxy::CallSendQuery(JSContext *aCx,
     return nullptr;
   }
   promise->MaybeResolve(promiseVal);
+  mPendingRequestIds.AppendElement(requestId);
+  if (mQueryRecorder) {
+    mQueryRecorder->AppendElement(requestId);
+  }
+  mLastActivity = TimeStamp::Now();
+  auto onSettled = [requestId](JSContext* aCx, JS::Handle<JS::Value> aValue,
+                               ErrorResult& aRv, const RefPtr<AgentProxy>& aSelf) {
+    aSelf->QuerySettled(requestId);
+  };
+  promise->AddCallbacksWithCycleCollectedArgs(onSettled, onSettled,
+                                              RefPtr{this});
   return promise.forget();
 }
 
@@ -191,6 +359,7 @@ OwnedAgentProxy::~OwnedAgentProxy() {}
 
 void OwnedAgentProxy::Disable() {
   mDisabled = true;
+  CancelPendingQueries();
 }
 
 template<>
@@ -888,12 +1057,24 @@ ErrorResult Failure::ToErrorResult() const {
   nsresult result = mException->GetResult();
     const nsCString& msg = mException->GetMessageMoz();
 
-  if (result == NS_ERROR_ABORT) {
+  if (result == NS_ERROR_ABORT || result == NS_BINDING_ABORTED) {
     rv.ThrowAbortError(
       msg.Length() == 0
         ? "Request aborted"_ns
         : msg
     );
+  } else if (result == NS_ERROR_NET_TIMEOUT) {
+    rv.ThrowTimeoutError(
+      msg.Length() == 0
+        ? "Request timed out"_ns
+        : msg
+    );
+  } else if (result == NS_ERROR_DOM_QUOTA_EXCEEDED_ERR) {
+    rv.ThrowQuotaExceededError(
+      msg.Length() == 0
+        ? "Too many pending requests"_ns
+        : msg
+    );
   } else {
     rv.ThrowInvalidStateError(
       msg.Length() == 0
@@ -1844,7 +2025,7 @@ bool ToJSVal<ChannelMetadata>(JSContext* aCx, const ChannelMetadata& aValue, JS:
 }
 
 template<>
-bool JSValIs<CreateChannelArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<BootstrapChannelArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -1853,10 +2034,34 @@ bool JSValIs<CreateChannelArgs>(JSContext *aCx, const JS::Handle<JS::Value> aVal
   bool isValid = false;
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "channel", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "channelId", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<ChannelMetadata>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<nsString>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "constraints", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<ChannelConstraints>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "webAppActor", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<CryptoActor, OriginActor>>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -1870,17 +2075,33 @@ bool JSValIs<CreateChannelArgs>(JSContext *aCx, const JS::Handle<JS::Value> aVal
 
 }
 template<>
-bool FromJSVal<CreateChannelArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, CreateChannelArgs& aRv) {
+bool FromJSVal<BootstrapChannelArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, BootstrapChannelArgs& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "channel", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "channelId", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<ChannelMetadata>(aCx, propVal, aRv.mChannel)))) {
+  if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, propVal, aRv.mChannelId)))) {
+    return false;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "constraints", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<ChannelConstraints>(aCx, propVal, aRv.mConstraints)))) {
+    return false;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "webAppActor", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<CryptoActor, OriginActor>>(aCx, propVal, aRv.mWebAppActor)))) {
     return false;
   }
   
@@ -1888,16 +2109,38 @@ bool FromJSVal<CreateChannelArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue,
 }
             
 template<>
-bool ToJSVal<CreateChannelArgs>(JSContext* aCx, const CreateChannelArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<BootstrapChannelArgs>(JSContext* aCx, const BootstrapChannelArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
   JS::Rooted<JS::Value> memberVal0(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<ChannelMetadata>(aCx, aValue.mChannel, &memberVal0)))) {
+  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mChannelId, &memberVal0)))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "channel", memberVal0))) {
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "channelId", memberVal0))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal1(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<ChannelConstraints>(aCx, aValue.mConstraints, &memberVal1)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "constraints", memberVal1))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal2(aCx);
+  if (NS_WARN_IF(!aValue.mWebAppActor.Inited())) {
+    return false;
+  }
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<CryptoActor, OriginActor>>(aCx, aValue.mWebAppActor, &memberVal2)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "webAppActor", memberVal2))) {
     return false;
   }
   
@@ -1905,9 +2148,8 @@ bool ToJSVal<CreateChannelArgs>(JSContext* aCx, const CreateChannelArgs& aValue,
   return true;
 }
 
-
 template<>
-bool JSValIs<RequestContext>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<CreateChannelArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -1927,25 +2169,13 @@ bool JSValIs<RequestContext>(JSContext *aCx, const JS::Handle<JS::Value> aValue,
     return true;
   }
   
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "document", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(JSValIs<DocumentMetadata>(aCx, propVal, isValid)))) {
-    return false;
-  }
-  if (!isValid) {
-    aRv = false;
-    return true;
-  }
-  
   aRv = true;
   return true;
 
 
 }
 template<>
-bool FromJSVal<RequestContext>(JSContext* aCx, JS::Handle<JS::Value> aValue, RequestContext& aRv) {
+bool FromJSVal<CreateChannelArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, CreateChannelArgs& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
@@ -1959,19 +2189,11 @@ bool FromJSVal<RequestContext>(JSContext* aCx, JS::Handle<JS::Value> aValue, Req
     return false;
   }
   
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "document", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(FromJSVal<DocumentMetadata>(aCx, propVal, aRv.mDocument)))) {
-    return false;
-  }
-  
   return true;
 }
             
 template<>
-bool ToJSVal<RequestContext>(JSContext* aCx, const RequestContext& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<CreateChannelArgs>(JSContext* aCx, const CreateChannelArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
@@ -1984,22 +2206,13 @@ bool ToJSVal<RequestContext>(JSContext* aCx, const RequestContext& aValue, JS::M
     return false;
   }
   
-
-  JS::Rooted<JS::Value> memberVal1(aCx);
-  
-  if (NS_WARN_IF(!(ToJSVal<DocumentMetadata>(aCx, aValue.mDocument, &memberVal1)))) {
-    return false;
-  }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "document", memberVal1))) {
-    return false;
-  }
-  
   aRv.setObject(*obj);
   return true;
 }
 
+
 template<>
-bool JSValIs<GenerateX25519KeyResult>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<RequestContext>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -2008,10 +2221,22 @@ bool JSValIs<GenerateX25519KeyResult>(JSContext *aCx, const JS::Handle<JS::Value
   bool isValid = false;
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "public", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "channel", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<nsString>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<ChannelMetadata>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "document", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<DocumentMetadata>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -2025,17 +2250,25 @@ bool JSValIs<GenerateX25519KeyResult>(JSContext *aCx, const JS::Handle<JS::Value
 
 }
 template<>
-bool FromJSVal<GenerateX25519KeyResult>(JSContext* aCx, JS::Handle<JS::Value> aValue, GenerateX25519KeyResult& aRv) {
+bool FromJSVal<RequestContext>(JSContext* aCx, JS::Handle<JS::Value> aValue, RequestContext& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "public", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "channel", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, propVal, aRv.mPublic)))) {
+  if (NS_WARN_IF(!(FromJSVal<ChannelMetadata>(aCx, propVal, aRv.mChannel)))) {
+    return false;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "document", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<DocumentMetadata>(aCx, propVal, aRv.mDocument)))) {
     return false;
   }
   
@@ -2043,16 +2276,26 @@ bool FromJSVal<GenerateX25519KeyResult>(JSContext* aCx, JS::Handle<JS::Value> aV
 }
             
 template<>
-bool ToJSVal<GenerateX25519KeyResult>(JSContext* aCx, const GenerateX25519KeyResult& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<RequestContext>(JSContext* aCx, const RequestContext& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
   JS::Rooted<JS::Value> memberVal0(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mPublic, &memberVal0)))) {
+  if (NS_WARN_IF(!(ToJSVal<ChannelMetadata>(aCx, aValue.mChannel, &memberVal0)))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "public", memberVal0))) {
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "channel", memberVal0))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal1(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<DocumentMetadata>(aCx, aValue.mDocument, &memberVal1)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "document", memberVal1))) {
     return false;
   }
   
@@ -2060,9 +2303,8 @@ bool ToJSVal<GenerateX25519KeyResult>(JSContext* aCx, const GenerateX25519KeyRes
   return true;
 }
 
-
 template<>
-bool JSValIs<SignKeyAgreementParametersArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<GenerateX25519KeyResult>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -2071,7 +2313,7 @@ bool JSValIs<SignKeyAgreementParametersArgs>(JSContext *aCx, const JS::Handle<JS
   bool isValid = false;
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "canonicalJson", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "public", &propVal))) {
     return false;
   }
   if (NS_WARN_IF(!(JSValIs<nsString>(aCx, propVal, isValid)))) {
@@ -2088,17 +2330,17 @@ bool JSValIs<SignKeyAgreementParametersArgs>(JSContext *aCx, const JS::Handle<JS
 
 }
 template<>
-bool FromJSVal<SignKeyAgreementParametersArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, SignKeyAgreementParametersArgs& aRv) {
+bool FromJSVal<GenerateX25519KeyResult>(JSContext* aCx, JS::Handle<JS::Value> aValue, GenerateX25519KeyResult& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "canonicalJson", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "public", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, propVal, aRv.mCanonicalJson)))) {
+  if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, propVal, aRv.mPublic)))) {
     return false;
   }
   
@@ -2106,16 +2348,16 @@ bool FromJSVal<SignKeyAgreementParametersArgs>(JSContext* aCx, JS::Handle<JS::Va
 }
             
 template<>
-bool ToJSVal<SignKeyAgreementParametersArgs>(JSContext* aCx, const SignKeyAgreementParametersArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<GenerateX25519KeyResult>(JSContext* aCx, const GenerateX25519KeyResult& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
   JS::Rooted<JS::Value> memberVal0(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mCanonicalJson, &memberVal0)))) {
+  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mPublic, &memberVal0)))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "canonicalJson", memberVal0))) {
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "public", memberVal0))) {
     return false;
   }
   
@@ -2123,6 +2365,7 @@ bool ToJSVal<SignKeyAgreementParametersArgs>(JSContext* aCx, const SignKeyAgreem
   return true;
 }
 
+
 template<>
 bool JSValIs<ArrayBuffer>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
@@ -2164,7 +2407,7 @@ bool ToJSVal<ArrayBuffer>(JSContext* aCx, const ArrayBuffer& aValue, JS::Mutable
   return true;
 }
 template<>
-bool JSValIs<SignKeyAgreementParametersResult>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<SignKeyAgreementParametersArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -2173,7 +2416,19 @@ bool JSValIs<SignKeyAgreementParametersResult>(JSContext *aCx, const JS::Handle<
   bool isValid = false;
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "scmSignature", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "canonicalJson", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<nsString>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "webAppSignature", &propVal))) {
     return false;
   }
   if (NS_WARN_IF(!(JSValIs<ArrayBuffer>(aCx, propVal, isValid)))) {
@@ -2190,23 +2445,103 @@ bool JSValIs<SignKeyAgreementParametersResult>(JSContext *aCx, const JS::Handle<
 
 }
 template<>
-bool FromJSVal<SignKeyAgreementParametersResult>(JSContext* aCx, JS::Handle<JS::Value> aValue, SignKeyAgreementParametersResult& aRv) {
+bool FromJSVal<SignKeyAgreementParametersArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, SignKeyAgreementParametersArgs& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "scmSignature", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "canonicalJson", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<ArrayBuffer>(aCx, propVal, aRv.mScmSignature)))) {
+  if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, propVal, aRv.mCanonicalJson)))) {
     return false;
   }
   
-  return true;
-}
-            
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "webAppSignature", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<ArrayBuffer>(aCx, propVal, aRv.mWebAppSignature)))) {
+    return false;
+  }
+  
+  return true;
+}
+            
+template<>
+bool ToJSVal<SignKeyAgreementParametersArgs>(JSContext* aCx, const SignKeyAgreementParametersArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
+
+  
+  JS::Rooted<JS::Value> memberVal0(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mCanonicalJson, &memberVal0)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "canonicalJson", memberVal0))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal1(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<ArrayBuffer>(aCx, aValue.mWebAppSignature, &memberVal1)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "webAppSignature", memberVal1))) {
+    return false;
+  }
+  
+  aRv.setObject(*obj);
+  return true;
+}
+
+template<>
+bool JSValIs<SignKeyAgreementParametersResult>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
+    aRv = false;
+    return true;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isValid = false;
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "scmSignature", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<ArrayBuffer>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+  aRv = true;
+  return true;
+
+
+}
+template<>
+bool FromJSVal<SignKeyAgreementParametersResult>(JSContext* aCx, JS::Handle<JS::Value> aValue, SignKeyAgreementParametersResult& aRv) {
+  if (NS_WARN_IF(!aValue.isObject())) {
+    return false;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "scmSignature", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<ArrayBuffer>(aCx, propVal, aRv.mScmSignature)))) {
+    return false;
+  }
+  
+  return true;
+}
+            
 template<>
 bool ToJSVal<SignKeyAgreementParametersResult>(JSContext* aCx, const SignKeyAgreementParametersResult& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
@@ -7765,7 +8100,7 @@ bool ToJSVal<SafeVariant<ArrayBuffer, ArrayBufferView, Nothing>>(JSContext* aCx,
   return aValue.InternalValue()->match(Matcher(aCx, aRv));
 }
 template<>
-bool JSValIs<AesGcmParams>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<BerytusEncryptionParams>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -7774,6 +8109,18 @@ bool JSValIs<AesGcmParams>(JSContext *aCx, const JS::Handle<JS::Value> aValue, b
   bool isValid = false;
   JS::Rooted<JS::Value> propVal(aCx);
   
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "chunkSize", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<Maybe<double>>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "iv", &propVal))) {
     return false;
   }
@@ -7827,13 +8174,21 @@ bool JSValIs<AesGcmParams>(JSContext *aCx, const JS::Handle<JS::Value> aValue, b
 
 }
 template<>
-bool FromJSVal<AesGcmParams>(JSContext* aCx, JS::Handle<JS::Value> aValue, AesGcmParams& aRv) {
+bool FromJSVal<BerytusEncryptionParams>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusEncryptionParams& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
   JS::Rooted<JS::Value> propVal(aCx);
   
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "chunkSize", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<Maybe<double>>(aCx, propVal, aRv.mChunkSize)))) {
+    return false;
+  }
+  
+
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "iv", &propVal))) {
     return false;
   }
@@ -7869,50 +8224,60 @@ bool FromJSVal<AesGcmParams>(JSContext* aCx, JS::Handle<JS::Value> aValue, AesGc
 }
             
 template<>
-bool ToJSVal<AesGcmParams>(JSContext* aCx, const AesGcmParams& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<BerytusEncryptionParams>(JSContext* aCx, const BerytusEncryptionParams& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
   JS::Rooted<JS::Value> memberVal0(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<Maybe<double>>(aCx, aValue.mChunkSize, &memberVal0)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "chunkSize", memberVal0))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal1(aCx);
   if (NS_WARN_IF(!aValue.mIv.Inited())) {
     return false;
   }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<ArrayBuffer, ArrayBufferView>>(aCx, aValue.mIv, &memberVal0)))) {
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<ArrayBuffer, ArrayBufferView>>(aCx, aValue.mIv, &memberVal1)))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "iv", memberVal0))) {
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "iv", memberVal1))) {
     return false;
   }
   
 
-  JS::Rooted<JS::Value> memberVal1(aCx);
+  JS::Rooted<JS::Value> memberVal2(aCx);
   if (NS_WARN_IF(!aValue.mAdditionalData.Inited())) {
     return false;
   }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<ArrayBuffer, ArrayBufferView, Nothing>>(aCx, aValue.mAdditionalData, &memberVal1)))) {
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<ArrayBuffer, ArrayBufferView, Nothing>>(aCx, aValue.mAdditionalData, &memberVal2)))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "additionalData", memberVal1))) {
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "additionalData", memberVal2))) {
     return false;
   }
   
 
-  JS::Rooted<JS::Value> memberVal2(aCx);
+  JS::Rooted<JS::Value> memberVal3(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<Maybe<double>>(aCx, aValue.mTagLength, &memberVal2)))) {
+  if (NS_WARN_IF(!(ToJSVal<Maybe<double>>(aCx, aValue.mTagLength, &memberVal3)))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "tagLength", memberVal2))) {
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "tagLength", memberVal3))) {
     return false;
   }
   
 
-  JS::Rooted<JS::Value> memberVal3(aCx);
+  JS::Rooted<JS::Value> memberVal4(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mName, &memberVal3)))) {
+  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mName, &memberVal4)))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "name", memberVal3))) {
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "name", memberVal4))) {
     return false;
   }
   
@@ -7933,7 +8298,7 @@ bool JSValIs<BerytusEncryptedPacket>(JSContext *aCx, const JS::Handle<JS::Value>
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "parameters", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<AesGcmParams>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<BerytusEncryptionParams>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -7969,7 +8334,7 @@ bool FromJSVal<BerytusEncryptedPacket>(JSContext* aCx, JS::Handle<JS::Value> aVa
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "parameters", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<AesGcmParams>(aCx, propVal, aRv.mParameters)))) {
+  if (NS_WARN_IF(!(FromJSVal<BerytusEncryptionParams>(aCx, propVal, aRv.mParameters)))) {
     return false;
   }
   
@@ -7991,7 +8356,7 @@ bool ToJSVal<BerytusEncryptedPacket>(JSContext* aCx, const BerytusEncryptedPacke
   
   JS::Rooted<JS::Value> memberVal0(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<AesGcmParams>(aCx, aValue.mParameters, &memberVal0)))) {
+  if (NS_WARN_IF(!(ToJSVal<BerytusEncryptionParams>(aCx, aValue.mParameters, &memberVal0)))) {
     return false;
   }
   if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "parameters", memberVal0))) {
@@ -8157,326 +8522,61 @@ bool ToJSVal<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, BerytusEncrypte
   return aValue.InternalValue()->match(Matcher(aCx, aRv));
 }
 template<>
-bool JSValIs<UserAttribute>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<RefPtr<Blob>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
-  bool isValid = false;
-  JS::Rooted<JS::Value> propVal(aCx);
-  
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "id", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(JSValIs<SafeVariant<StaticString0, StaticString1, StaticString2, StaticString3, StaticString4, StaticString5, StaticString6, StaticString7, StaticString8, StaticString9, StaticString10, StaticString11, StaticString12, nsString>>(aCx, propVal, isValid)))) {
-    return false;
-  }
-  if (!isValid) {
-    aRv = false;
-    return true;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "info", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(JSValIs<Maybe<nsString>>(aCx, propVal, isValid)))) {
-    return false;
-  }
-  if (!isValid) {
-    aRv = false;
-    return true;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "mimeType", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(JSValIs<Maybe<nsString>>(aCx, propVal, isValid)))) {
-    return false;
-  }
-  if (!isValid) {
-    aRv = false;
-    return true;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(JSValIs<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, BerytusEncryptedPacket>>(aCx, propVal, isValid)))) {
-    return false;
-  }
-  if (!isValid) {
-    aRv = false;
-    return true;
-  }
-  
-  aRv = true;
+  aRv = IS_INSTANCE_OF(Blob, obj);
   return true;
-
-
 }
 template<>
-bool FromJSVal<UserAttribute>(JSContext* aCx, JS::Handle<JS::Value> aValue, UserAttribute& aRv) {
+bool FromJSVal<RefPtr<Blob>>(JSContext* aCx, JS::Handle<JS::Value> aValue, RefPtr<Blob>& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
-  JS::Rooted<JS::Value> propVal(aCx);
-  
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "id", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(FromJSVal<SafeVariant<StaticString0, StaticString1, StaticString2, StaticString3, StaticString4, StaticString5, StaticString6, StaticString7, StaticString8, StaticString9, StaticString10, StaticString11, StaticString12, nsString>>(aCx, propVal, aRv.mId)))) {
-    return false;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "info", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(FromJSVal<Maybe<nsString>>(aCx, propVal, aRv.mInfo)))) {
-    return false;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "mimeType", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(FromJSVal<Maybe<nsString>>(aCx, propVal, aRv.mMimeType)))) {
-    return false;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
+  if (NS_WARN_IF(NS_FAILED(UNWRAP_OBJECT(Blob, &obj, aRv)))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, BerytusEncryptedPacket>>(aCx, propVal, aRv.mValue)))) {
-    return false;
-  }
-  
   return true;
 }
-            
 template<>
-bool ToJSVal<UserAttribute>(JSContext* aCx, const UserAttribute& aValue, JS::MutableHandle<JS::Value> aRv) {
-  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
-
-  
-  JS::Rooted<JS::Value> memberVal0(aCx);
-  if (NS_WARN_IF(!aValue.mId.Inited())) {
-    return false;
-  }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<StaticString0, StaticString1, StaticString2, StaticString3, StaticString4, StaticString5, StaticString6, StaticString7, StaticString8, StaticString9, StaticString10, StaticString11, StaticString12, nsString>>(aCx, aValue.mId, &memberVal0)))) {
-    return false;
-  }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "id", memberVal0))) {
-    return false;
-  }
+bool ToJSVal<RefPtr<Blob>>(JSContext* aCx, const RefPtr<Blob>& aValue, JS::MutableHandle<JS::Value> aRv) {
+  MOZ_ASSERT(aValue);
+  return dom::ToJSValue(aCx, aValue, aRv);
+}
+template<>
+bool JSValIs<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
 
-  JS::Rooted<JS::Value> memberVal1(aCx);
-  
-  if (NS_WARN_IF(!(ToJSVal<Maybe<nsString>>(aCx, aValue.mInfo, &memberVal1)))) {
-    return false;
-  }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "info", memberVal1))) {
-    return false;
-  }
-  
 
-  JS::Rooted<JS::Value> memberVal2(aCx);
-  
-  if (NS_WARN_IF(!(ToJSVal<Maybe<nsString>>(aCx, aValue.mMimeType, &memberVal2)))) {
-    return false;
-  }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "mimeType", memberVal2))) {
-    return false;
-  }
-  
-
-  JS::Rooted<JS::Value> memberVal3(aCx);
-  if (NS_WARN_IF(!aValue.mValue.Inited())) {
-    return false;
-  }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, BerytusEncryptedPacket>>(aCx, aValue.mValue, &memberVal3)))) {
-    return false;
-  }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "value", memberVal3))) {
-    return false;
-  }
-  
-  aRv.setObject(*obj);
-  return true;
-}
-
-template<>
-bool JSValIs<nsTArray<UserAttribute>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
-  if (!aValue.isObject()) {
-    return false;
-  }
-  if (NS_WARN_IF(!JS::IsArrayObject(aCx, aValue, &aRv))) {
-    return false;
-  }
-  // TODO(berytus): What about the values inside the array?
-  return true;
-}
-template<>
-bool FromJSVal<nsTArray<UserAttribute>>(JSContext* aCx, const JS::Handle<JS::Value> aValue, nsTArray<UserAttribute>& aRv) {
-  if (NS_WARN_IF(!aValue.isObject())) {
-    return false;
-  }
-  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
-  bool isArray;
-  if (NS_WARN_IF(!JS::IsArrayObject(aCx, obj, &isArray))) {
-    return false;
-  }
-  if (NS_WARN_IF(!isArray)) {
-    return false;
-  }
-  uint32_t length;
-  if (NS_WARN_IF(!JS::GetArrayLength(aCx, obj, &length))) {
-    return false;
-  }
-  for (uint32_t i = 0; i < length; i++) {
-    JS::Rooted<JS::Value> value(aCx);
-
-    if (NS_WARN_IF(!JS_GetElement(aCx, obj, i, &value))) {
-      return false;
-    }
-
-    UserAttribute item;
-    if (NS_WARN_IF(!(FromJSVal<UserAttribute>(aCx, value, item)))) {
-      return false;
-    }
-    aRv.AppendElement(std::move(item));
-  }
-  return true;
-}
-template<>
-bool ToJSVal<nsTArray<UserAttribute>>(JSContext* aCx, const nsTArray<UserAttribute>& aValue, JS::MutableHandle<JS::Value> aRv) {
-  JS::Rooted<JSObject*> array(aCx, JS::NewArrayObject(aCx, 0));
-
-  for (uint32_t i = 0; i < aValue.Length(); i++) {
-    const UserAttribute& item = aValue.ElementAt(i);
-
-    JS::Rooted<JS::Value> value(aCx);
-    if (NS_WARN_IF(!(ToJSVal<UserAttribute>(aCx, item, &value)))) {
-      return false;
-    }
-    if (NS_WARN_IF(!JS_DefineElement(aCx, array, i, value, JSPROP_ENUMERATE))) {
-      return false;
-    }
-  }
-  aRv.setObject(*array);
-  return true;
-}
-
-template<>
-bool JSValIs<UpdateUserAttributesArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
-  if (!aValue.isObject()) {
-    aRv = false;
-    return true;
-  }
-  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
-  bool isValid = false;
-  JS::Rooted<JS::Value> propVal(aCx);
-  
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "userAttributes", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(JSValIs<nsTArray<UserAttribute>>(aCx, propVal, isValid)))) {
-    return false;
-  }
-  if (!isValid) {
-    aRv = false;
-    return true;
-  }
-  
-  aRv = true;
-  return true;
-
-
-}
-template<>
-bool FromJSVal<UpdateUserAttributesArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, UpdateUserAttributesArgs& aRv) {
-  if (NS_WARN_IF(!aValue.isObject())) {
-    return false;
-  }
-  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
-  JS::Rooted<JS::Value> propVal(aCx);
-  
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "userAttributes", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(FromJSVal<nsTArray<UserAttribute>>(aCx, propVal, aRv.mUserAttributes)))) {
-    return false;
-  }
-  
-  return true;
-}
-            
-template<>
-bool ToJSVal<UpdateUserAttributesArgs>(JSContext* aCx, const UpdateUserAttributesArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
-  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
-
-  
-  JS::Rooted<JS::Value> memberVal0(aCx);
-  
-  if (NS_WARN_IF(!(ToJSVal<nsTArray<UserAttribute>>(aCx, aValue.mUserAttributes, &memberVal0)))) {
-    return false;
-  }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "userAttributes", memberVal0))) {
-    return false;
-  }
-  
-  aRv.setObject(*obj);
-  return true;
-}
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<ArrayBuffer>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
 
 
-template<>
-bool JSValIs<StaticString20>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
-  if (!aValue.isString()) {
-    aRv = false;
-    return true;
-  }
-  nsString val;
-  if (NS_WARN_IF((!FromJSVal<nsString>(aCx, aValue, val)))) {
-    return false;
-  }
-  if (!val.Equals(StaticString20::mLiteral)) {
-    aRv = false;
-    return true;
-  }
-  aRv = true;
-  return true;
-}
-template<>
-bool FromJSVal<StaticString20>(JSContext* aCx, JS::Handle<JS::Value> aValue, StaticString20& aRv) {
-  bool rv;
-  if (NS_WARN_IF(!(JSValIs<StaticString20>(aCx, aValue, rv)))) {
-    return false;
-  }
-  if (NS_WARN_IF(!rv)) {
-    return false;
-  }
-  return true;
-}
-template<>
-bool ToJSVal<StaticString20>(JSContext* aCx, const StaticString20& aValue, JS::MutableHandle<JS::Value> aRv) {
-  JS::Rooted<JSString*> rStr(aCx, JS_NewUCStringCopyN(aCx, aValue.GetString().BeginReading(), aValue.GetString().Length()));
-  aRv.setString(rStr);
-  return true;
-}
-template<>
-bool JSValIs<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
-  
   do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<JSNull>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<ArrayBufferView>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
@@ -8488,7 +8588,7 @@ bool JSValIs<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(JSContext *a
 
   do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<RefPtr<Blob>>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
@@ -8513,15 +8613,15 @@ bool JSValIs<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(JSContext *a
   return true;
 }
 template<>
-bool FromJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<JSNull, nsString, BerytusEncryptedPacket>& aRv) {
+bool FromJSVal<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>& aRv) {
   do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<JSNull>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      JSNull nv;
-      if (NS_WARN_IF(!(FromJSVal<JSNull>(aCx, aValue, nv)))) {
+      nsString nv;
+      if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, aValue, nv)))) {
         return false;
       }
       aRv.Init(VariantIndex<0>(), std::move(nv));
@@ -8531,15 +8631,45 @@ bool FromJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(JSContext*
   
 do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<ArrayBuffer>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      nsString nv;
-      if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, aValue, nv)))) {
+      aRv.Init(VariantIndex<1>(), ArrayBuffer());
+      if (NS_WARN_IF(!(FromJSVal<ArrayBuffer>(aCx, aValue, (aRv.InternalValue())->as<ArrayBuffer>())))) {
         return false;
       }
-      aRv.Init(VariantIndex<1>(), std::move(nv));
+      return true;
+      
+    }
+  } while (false);
+  
+do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<ArrayBufferView>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      ArrayBufferView nv;
+      if (NS_WARN_IF(!(FromJSVal<ArrayBufferView>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<2>(), std::move(nv));
+      return true;
+    }
+  } while (false);
+  
+do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<RefPtr<Blob>>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      RefPtr<Blob> nv;
+      if (NS_WARN_IF(!(FromJSVal<RefPtr<Blob>>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<3>(), std::move(nv));
       return true;
     }
   } while (false);
@@ -8554,7 +8684,7 @@ do {
       if (NS_WARN_IF(!(FromJSVal<BerytusEncryptedPacket>(aCx, aValue, nv)))) {
         return false;
       }
-      aRv.Init(VariantIndex<2>(), std::move(nv));
+      aRv.Init(VariantIndex<4>(), std::move(nv));
       return true;
     }
   } while (false);
@@ -8564,20 +8694,28 @@ do {
   return false;
 }
 template<>
-bool ToJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(JSContext* aCx, const SafeVariant<JSNull, nsString, BerytusEncryptedPacket>& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>>(JSContext* aCx, const SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>& aValue, JS::MutableHandle<JS::Value> aRv) {
   struct Matcher {
     JSContext* mCx;
     JS::MutableHandle<JS::Value> mRv;
     Matcher(JSContext* aCx, JS::MutableHandle<JS::Value> aRv) : mCx(aCx), mRv(aRv) {}
     
-    bool operator()(const JSNull& aVal) {
-      return ToJSVal<JSNull>(mCx, aVal, mRv);
-    }
-
     bool operator()(const nsString& aVal) {
       return ToJSVal<nsString>(mCx, aVal, mRv);
     }
 
+    bool operator()(const ArrayBuffer& aVal) {
+      return ToJSVal<ArrayBuffer>(mCx, aVal, mRv);
+    }
+
+    bool operator()(const ArrayBufferView& aVal) {
+      return ToJSVal<ArrayBufferView>(mCx, aVal, mRv);
+    }
+
+    bool operator()(const RefPtr<Blob>& aVal) {
+      return ToJSVal<RefPtr<Blob>>(mCx, aVal, mRv);
+    }
+
     bool operator()(const BerytusEncryptedPacket& aVal) {
       return ToJSVal<BerytusEncryptedPacket>(mCx, aVal, mRv);
     }
@@ -8585,7 +8723,7 @@ bool ToJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(JSContext* a
   return aValue.InternalValue()->match(Matcher(aCx, aRv));
 }
 template<>
-bool JSValIs<BerytusForeignIdentityField>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<UserAttribute>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -8594,10 +8732,10 @@ bool JSValIs<BerytusForeignIdentityField>(JSContext *aCx, const JS::Handle<JS::V
   bool isValid = false;
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "id", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<StaticString20>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<StaticString0, StaticString1, StaticString2, StaticString3, StaticString4, StaticString5, StaticString6, StaticString7, StaticString8, StaticString9, StaticString10, StaticString11, StaticString12, nsString>>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -8606,10 +8744,10 @@ bool JSValIs<BerytusForeignIdentityField>(JSContext *aCx, const JS::Handle<JS::V
   }
   
 
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "info", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<BerytusForeignIdentityFieldOptions>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<Maybe<nsString>>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -8618,10 +8756,10 @@ bool JSValIs<BerytusForeignIdentityField>(JSContext *aCx, const JS::Handle<JS::V
   }
   
 
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "mimeType", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<Maybe<nsString>>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -8630,10 +8768,10 @@ bool JSValIs<BerytusForeignIdentityField>(JSContext *aCx, const JS::Handle<JS::V
   }
   
 
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "id", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<nsString>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -8647,41 +8785,41 @@ bool JSValIs<BerytusForeignIdentityField>(JSContext *aCx, const JS::Handle<JS::V
 
 }
 template<>
-bool FromJSVal<BerytusForeignIdentityField>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusForeignIdentityField& aRv) {
+bool FromJSVal<UserAttribute>(JSContext* aCx, JS::Handle<JS::Value> aValue, UserAttribute& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "id", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<StaticString20>(aCx, propVal, aRv.mType)))) {
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<StaticString0, StaticString1, StaticString2, StaticString3, StaticString4, StaticString5, StaticString6, StaticString7, StaticString8, StaticString9, StaticString10, StaticString11, StaticString12, nsString>>(aCx, propVal, aRv.mId)))) {
     return false;
   }
   
 
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "info", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<BerytusForeignIdentityFieldOptions>(aCx, propVal, aRv.mOptions)))) {
+  if (NS_WARN_IF(!(FromJSVal<Maybe<nsString>>(aCx, propVal, aRv.mInfo)))) {
     return false;
   }
   
 
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "mimeType", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(aCx, propVal, aRv.mValue)))) {
+  if (NS_WARN_IF(!(FromJSVal<Maybe<nsString>>(aCx, propVal, aRv.mMimeType)))) {
     return false;
   }
   
 
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "id", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, propVal, aRv.mId)))) {
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>>(aCx, propVal, aRv.mValue)))) {
     return false;
   }
   
@@ -8689,48 +8827,50 @@ bool FromJSVal<BerytusForeignIdentityField>(JSContext* aCx, JS::Handle<JS::Value
 }
             
 template<>
-bool ToJSVal<BerytusForeignIdentityField>(JSContext* aCx, const BerytusForeignIdentityField& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<UserAttribute>(JSContext* aCx, const UserAttribute& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
   JS::Rooted<JS::Value> memberVal0(aCx);
-  
-  if (NS_WARN_IF(!(ToJSVal<StaticString20>(aCx, aValue.mType, &memberVal0)))) {
+  if (NS_WARN_IF(!aValue.mId.Inited())) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "type", memberVal0))) {
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<StaticString0, StaticString1, StaticString2, StaticString3, StaticString4, StaticString5, StaticString6, StaticString7, StaticString8, StaticString9, StaticString10, StaticString11, StaticString12, nsString>>(aCx, aValue.mId, &memberVal0)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "id", memberVal0))) {
     return false;
   }
   
 
   JS::Rooted<JS::Value> memberVal1(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<BerytusForeignIdentityFieldOptions>(aCx, aValue.mOptions, &memberVal1)))) {
+  if (NS_WARN_IF(!(ToJSVal<Maybe<nsString>>(aCx, aValue.mInfo, &memberVal1)))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "options", memberVal1))) {
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "info", memberVal1))) {
     return false;
   }
   
 
   JS::Rooted<JS::Value> memberVal2(aCx);
-  if (NS_WARN_IF(!aValue.mValue.Inited())) {
-    return false;
-  }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(aCx, aValue.mValue, &memberVal2)))) {
+  
+  if (NS_WARN_IF(!(ToJSVal<Maybe<nsString>>(aCx, aValue.mMimeType, &memberVal2)))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "value", memberVal2))) {
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "mimeType", memberVal2))) {
     return false;
   }
   
 
   JS::Rooted<JS::Value> memberVal3(aCx);
-  
-  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mId, &memberVal3)))) {
+  if (NS_WARN_IF(!aValue.mValue.Inited())) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "id", memberVal3))) {
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>>(aCx, aValue.mValue, &memberVal3)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "value", memberVal3))) {
     return false;
   }
   
@@ -8739,41 +8879,69 @@ bool ToJSVal<BerytusForeignIdentityField>(JSContext* aCx, const BerytusForeignId
 }
 
 template<>
-bool JSValIs<StaticString21>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
-  if (!aValue.isString()) {
-    aRv = false;
-    return true;
-  }
-  nsString val;
-  if (NS_WARN_IF((!FromJSVal<nsString>(aCx, aValue, val)))) {
+bool JSValIs<nsTArray<UserAttribute>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
     return false;
   }
-  if (!val.Equals(StaticString21::mLiteral)) {
-    aRv = false;
-    return true;
+  if (NS_WARN_IF(!JS::IsArrayObject(aCx, aValue, &aRv))) {
+    return false;
   }
-  aRv = true;
+  // TODO(berytus): What about the values inside the array?
   return true;
 }
 template<>
-bool FromJSVal<StaticString21>(JSContext* aCx, JS::Handle<JS::Value> aValue, StaticString21& aRv) {
-  bool rv;
-  if (NS_WARN_IF(!(JSValIs<StaticString21>(aCx, aValue, rv)))) {
+bool FromJSVal<nsTArray<UserAttribute>>(JSContext* aCx, const JS::Handle<JS::Value> aValue, nsTArray<UserAttribute>& aRv) {
+  if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
-  if (NS_WARN_IF(!rv)) {
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isArray;
+  if (NS_WARN_IF(!JS::IsArrayObject(aCx, obj, &isArray))) {
+    return false;
+  }
+  if (NS_WARN_IF(!isArray)) {
+    return false;
+  }
+  uint32_t length;
+  if (NS_WARN_IF(!JS::GetArrayLength(aCx, obj, &length))) {
     return false;
   }
+  for (uint32_t i = 0; i < length; i++) {
+    JS::Rooted<JS::Value> value(aCx);
+
+    if (NS_WARN_IF(!JS_GetElement(aCx, obj, i, &value))) {
+      return false;
+    }
+
+    UserAttribute item;
+    if (NS_WARN_IF(!(FromJSVal<UserAttribute>(aCx, value, item)))) {
+      return false;
+    }
+    aRv.AppendElement(std::move(item));
+  }
   return true;
 }
 template<>
-bool ToJSVal<StaticString21>(JSContext* aCx, const StaticString21& aValue, JS::MutableHandle<JS::Value> aRv) {
-  JS::Rooted<JSString*> rStr(aCx, JS_NewUCStringCopyN(aCx, aValue.GetString().BeginReading(), aValue.GetString().Length()));
-  aRv.setString(rStr);
+bool ToJSVal<nsTArray<UserAttribute>>(JSContext* aCx, const nsTArray<UserAttribute>& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSObject*> array(aCx, JS::NewArrayObject(aCx, 0));
+
+  for (uint32_t i = 0; i < aValue.Length(); i++) {
+    const UserAttribute& item = aValue.ElementAt(i);
+
+    JS::Rooted<JS::Value> value(aCx);
+    if (NS_WARN_IF(!(ToJSVal<UserAttribute>(aCx, item, &value)))) {
+      return false;
+    }
+    if (NS_WARN_IF(!JS_DefineElement(aCx, array, i, value, JSPROP_ENUMERATE))) {
+      return false;
+    }
+  }
+  aRv.setObject(*array);
   return true;
 }
+
 template<>
-bool JSValIs<BerytusIdentityField>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<UpdateUserAttributesArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -8782,46 +8950,10 @@ bool JSValIs<BerytusIdentityField>(JSContext *aCx, const JS::Handle<JS::Value> a
   bool isValid = false;
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(JSValIs<StaticString21>(aCx, propVal, isValid)))) {
-    return false;
-  }
-  if (!isValid) {
-    aRv = false;
-    return true;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(JSValIs<BerytusIdentityFieldOptions>(aCx, propVal, isValid)))) {
-    return false;
-  }
-  if (!isValid) {
-    aRv = false;
-    return true;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(JSValIs<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(aCx, propVal, isValid)))) {
-    return false;
-  }
-  if (!isValid) {
-    aRv = false;
-    return true;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "id", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "userAttributes", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<nsString>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<nsTArray<UserAttribute>>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -8835,41 +8967,17 @@ bool JSValIs<BerytusIdentityField>(JSContext *aCx, const JS::Handle<JS::Value> a
 
 }
 template<>
-bool FromJSVal<BerytusIdentityField>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusIdentityField& aRv) {
+bool FromJSVal<UpdateUserAttributesArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, UpdateUserAttributesArgs& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(FromJSVal<StaticString21>(aCx, propVal, aRv.mType)))) {
-    return false;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(FromJSVal<BerytusIdentityFieldOptions>(aCx, propVal, aRv.mOptions)))) {
-    return false;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(FromJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(aCx, propVal, aRv.mValue)))) {
-    return false;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "id", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "userAttributes", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, propVal, aRv.mId)))) {
+  if (NS_WARN_IF(!(FromJSVal<nsTArray<UserAttribute>>(aCx, propVal, aRv.mUserAttributes)))) {
     return false;
   }
   
@@ -8877,48 +8985,16 @@ bool FromJSVal<BerytusIdentityField>(JSContext* aCx, JS::Handle<JS::Value> aValu
 }
             
 template<>
-bool ToJSVal<BerytusIdentityField>(JSContext* aCx, const BerytusIdentityField& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<UpdateUserAttributesArgs>(JSContext* aCx, const UpdateUserAttributesArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
   JS::Rooted<JS::Value> memberVal0(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<StaticString21>(aCx, aValue.mType, &memberVal0)))) {
-    return false;
-  }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "type", memberVal0))) {
-    return false;
-  }
-  
-
-  JS::Rooted<JS::Value> memberVal1(aCx);
-  
-  if (NS_WARN_IF(!(ToJSVal<BerytusIdentityFieldOptions>(aCx, aValue.mOptions, &memberVal1)))) {
-    return false;
-  }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "options", memberVal1))) {
-    return false;
-  }
-  
-
-  JS::Rooted<JS::Value> memberVal2(aCx);
-  if (NS_WARN_IF(!aValue.mValue.Inited())) {
-    return false;
-  }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(aCx, aValue.mValue, &memberVal2)))) {
-    return false;
-  }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "value", memberVal2))) {
-    return false;
-  }
-  
-
-  JS::Rooted<JS::Value> memberVal3(aCx);
-  
-  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mId, &memberVal3)))) {
+  if (NS_WARN_IF(!(ToJSVal<nsTArray<UserAttribute>>(aCx, aValue.mUserAttributes, &memberVal0)))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "id", memberVal3))) {
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "userAttributes", memberVal0))) {
     return false;
   }
   
@@ -8926,8 +9002,9 @@ bool ToJSVal<BerytusIdentityField>(JSContext* aCx, const BerytusIdentityField& a
   return true;
 }
 
+
 template<>
-bool JSValIs<StaticString22>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<StaticString20>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isString()) {
     aRv = false;
     return true;
@@ -8936,7 +9013,7 @@ bool JSValIs<StaticString22>(JSContext *aCx, const JS::Handle<JS::Value> aValue,
   if (NS_WARN_IF((!FromJSVal<nsString>(aCx, aValue, val)))) {
     return false;
   }
-  if (!val.Equals(StaticString22::mLiteral)) {
+  if (!val.Equals(StaticString20::mLiteral)) {
     aRv = false;
     return true;
   }
@@ -8944,9 +9021,9 @@ bool JSValIs<StaticString22>(JSContext *aCx, const JS::Handle<JS::Value> aValue,
   return true;
 }
 template<>
-bool FromJSVal<StaticString22>(JSContext* aCx, JS::Handle<JS::Value> aValue, StaticString22& aRv) {
+bool FromJSVal<StaticString20>(JSContext* aCx, JS::Handle<JS::Value> aValue, StaticString20& aRv) {
   bool rv;
-  if (NS_WARN_IF(!(JSValIs<StaticString22>(aCx, aValue, rv)))) {
+  if (NS_WARN_IF(!(JSValIs<StaticString20>(aCx, aValue, rv)))) {
     return false;
   }
   if (NS_WARN_IF(!rv)) {
@@ -8955,17 +9032,29 @@ bool FromJSVal<StaticString22>(JSContext* aCx, JS::Handle<JS::Value> aValue, Sta
   return true;
 }
 template<>
-bool ToJSVal<StaticString22>(JSContext* aCx, const StaticString22& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<StaticString20>(JSContext* aCx, const StaticString20& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSString*> rStr(aCx, JS_NewUCStringCopyN(aCx, aValue.GetString().BeginReading(), aValue.GetString().Length()));
   aRv.setString(rStr);
   return true;
 }
 template<>
-bool JSValIs<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   
   do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<ArrayBuffer>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<JSNull>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
+
+
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
@@ -8990,30 +9079,30 @@ bool JSValIs<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(JSContext *aCx, c
   return true;
 }
 template<>
-bool FromJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<ArrayBuffer, BerytusEncryptedPacket>& aRv) {
+bool FromJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<JSNull, nsString, BerytusEncryptedPacket>& aRv) {
   do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<ArrayBuffer>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<JSNull>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      aRv.Init(VariantIndex<0>(), ArrayBuffer());
-      if (NS_WARN_IF(!(FromJSVal<ArrayBuffer>(aCx, aValue, (aRv.InternalValue())->as<ArrayBuffer>())))) {
+      JSNull nv;
+      if (NS_WARN_IF(!(FromJSVal<JSNull>(aCx, aValue, nv)))) {
         return false;
       }
+      aRv.Init(VariantIndex<0>(), std::move(nv));
       return true;
-      
     }
   } while (false);
   
 do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusEncryptedPacket>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      BerytusEncryptedPacket nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusEncryptedPacket>(aCx, aValue, nv)))) {
+      nsString nv;
+      if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, aValue, nv)))) {
         return false;
       }
       aRv.Init(VariantIndex<1>(), std::move(nv));
@@ -9021,148 +9110,17 @@ do {
     }
   } while (false);
   
-
-  NS_WARNING_ASSERTION(true, "None of the subtypes returned a truthful IsValid()");
-  return false;
-}
-template<>
-bool ToJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(JSContext* aCx, const SafeVariant<ArrayBuffer, BerytusEncryptedPacket>& aValue, JS::MutableHandle<JS::Value> aRv) {
-  struct Matcher {
-    JSContext* mCx;
-    JS::MutableHandle<JS::Value> mRv;
-    Matcher(JSContext* aCx, JS::MutableHandle<JS::Value> aRv) : mCx(aCx), mRv(aRv) {}
-    
-    bool operator()(const ArrayBuffer& aVal) {
-      return ToJSVal<ArrayBuffer>(mCx, aVal, mRv);
-    }
-
-    bool operator()(const BerytusEncryptedPacket& aVal) {
-      return ToJSVal<BerytusEncryptedPacket>(mCx, aVal, mRv);
-    }
-  };
-  return aValue.InternalValue()->match(Matcher(aCx, aRv));
-}
-template<>
-bool JSValIs<BerytusKeyFieldValue>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
-  if (!aValue.isObject()) {
-    aRv = false;
-    return true;
-  }
-  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
-  bool isValid = false;
-  JS::Rooted<JS::Value> propVal(aCx);
-  
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "publicKey", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(JSValIs<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, isValid)))) {
-    return false;
-  }
-  if (!isValid) {
-    aRv = false;
-    return true;
-  }
-  
-  aRv = true;
-  return true;
-
-
-}
-template<>
-bool FromJSVal<BerytusKeyFieldValue>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusKeyFieldValue& aRv) {
-  if (NS_WARN_IF(!aValue.isObject())) {
-    return false;
-  }
-  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
-  JS::Rooted<JS::Value> propVal(aCx);
-  
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "publicKey", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(FromJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, aRv.mPublicKey)))) {
-    return false;
-  }
-  
-  return true;
-}
-            
-template<>
-bool ToJSVal<BerytusKeyFieldValue>(JSContext* aCx, const BerytusKeyFieldValue& aValue, JS::MutableHandle<JS::Value> aRv) {
-  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
-
-  
-  JS::Rooted<JS::Value> memberVal0(aCx);
-  if (NS_WARN_IF(!aValue.mPublicKey.Inited())) {
-    return false;
-  }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, aValue.mPublicKey, &memberVal0)))) {
-    return false;
-  }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "publicKey", memberVal0))) {
-    return false;
-  }
-  
-  aRv.setObject(*obj);
-  return true;
-}
-
-template<>
-bool JSValIs<SafeVariant<JSNull, BerytusKeyFieldValue>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
-  
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<JSNull>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
-
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusKeyFieldValue>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
-  aRv = false;
-  return true;
-}
-template<>
-bool FromJSVal<SafeVariant<JSNull, BerytusKeyFieldValue>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<JSNull, BerytusKeyFieldValue>& aRv) {
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<JSNull>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      JSNull nv;
-      if (NS_WARN_IF(!(FromJSVal<JSNull>(aCx, aValue, nv)))) {
-        return false;
-      }
-      aRv.Init(VariantIndex<0>(), std::move(nv));
-      return true;
-    }
-  } while (false);
-  
 do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusKeyFieldValue>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusEncryptedPacket>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      BerytusKeyFieldValue nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusKeyFieldValue>(aCx, aValue, nv)))) {
+      BerytusEncryptedPacket nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusEncryptedPacket>(aCx, aValue, nv)))) {
         return false;
       }
-      aRv.Init(VariantIndex<1>(), std::move(nv));
+      aRv.Init(VariantIndex<2>(), std::move(nv));
       return true;
     }
   } while (false);
@@ -9172,7 +9130,7 @@ do {
   return false;
 }
 template<>
-bool ToJSVal<SafeVariant<JSNull, BerytusKeyFieldValue>>(JSContext* aCx, const SafeVariant<JSNull, BerytusKeyFieldValue>& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(JSContext* aCx, const SafeVariant<JSNull, nsString, BerytusEncryptedPacket>& aValue, JS::MutableHandle<JS::Value> aRv) {
   struct Matcher {
     JSContext* mCx;
     JS::MutableHandle<JS::Value> mRv;
@@ -9182,14 +9140,18 @@ bool ToJSVal<SafeVariant<JSNull, BerytusKeyFieldValue>>(JSContext* aCx, const Sa
       return ToJSVal<JSNull>(mCx, aVal, mRv);
     }
 
-    bool operator()(const BerytusKeyFieldValue& aVal) {
-      return ToJSVal<BerytusKeyFieldValue>(mCx, aVal, mRv);
+    bool operator()(const nsString& aVal) {
+      return ToJSVal<nsString>(mCx, aVal, mRv);
+    }
+
+    bool operator()(const BerytusEncryptedPacket& aVal) {
+      return ToJSVal<BerytusEncryptedPacket>(mCx, aVal, mRv);
     }
   };
   return aValue.InternalValue()->match(Matcher(aCx, aRv));
 }
 template<>
-bool JSValIs<BerytusKeyField>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<BerytusForeignIdentityField>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -9201,7 +9163,7 @@ bool JSValIs<BerytusKeyField>(JSContext *aCx, const JS::Handle<JS::Value> aValue
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<StaticString22>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<StaticString20>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -9213,7 +9175,7 @@ bool JSValIs<BerytusKeyField>(JSContext *aCx, const JS::Handle<JS::Value> aValue
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<BerytusKeyFieldOptions>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<BerytusForeignIdentityFieldOptions>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -9225,7 +9187,7 @@ bool JSValIs<BerytusKeyField>(JSContext *aCx, const JS::Handle<JS::Value> aValue
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<SafeVariant<JSNull, BerytusKeyFieldValue>>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -9251,7 +9213,7 @@ bool JSValIs<BerytusKeyField>(JSContext *aCx, const JS::Handle<JS::Value> aValue
 
 }
 template<>
-bool FromJSVal<BerytusKeyField>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusKeyField& aRv) {
+bool FromJSVal<BerytusForeignIdentityField>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusForeignIdentityField& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
@@ -9261,7 +9223,7 @@ bool FromJSVal<BerytusKeyField>(JSContext* aCx, JS::Handle<JS::Value> aValue, Be
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<StaticString22>(aCx, propVal, aRv.mType)))) {
+  if (NS_WARN_IF(!(FromJSVal<StaticString20>(aCx, propVal, aRv.mType)))) {
     return false;
   }
   
@@ -9269,7 +9231,7 @@ bool FromJSVal<BerytusKeyField>(JSContext* aCx, JS::Handle<JS::Value> aValue, Be
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<BerytusKeyFieldOptions>(aCx, propVal, aRv.mOptions)))) {
+  if (NS_WARN_IF(!(FromJSVal<BerytusForeignIdentityFieldOptions>(aCx, propVal, aRv.mOptions)))) {
     return false;
   }
   
@@ -9277,7 +9239,7 @@ bool FromJSVal<BerytusKeyField>(JSContext* aCx, JS::Handle<JS::Value> aValue, Be
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<SafeVariant<JSNull, BerytusKeyFieldValue>>(aCx, propVal, aRv.mValue)))) {
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(aCx, propVal, aRv.mValue)))) {
     return false;
   }
   
@@ -9293,13 +9255,13 @@ bool FromJSVal<BerytusKeyField>(JSContext* aCx, JS::Handle<JS::Value> aValue, Be
 }
             
 template<>
-bool ToJSVal<BerytusKeyField>(JSContext* aCx, const BerytusKeyField& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<BerytusForeignIdentityField>(JSContext* aCx, const BerytusForeignIdentityField& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
   JS::Rooted<JS::Value> memberVal0(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<StaticString22>(aCx, aValue.mType, &memberVal0)))) {
+  if (NS_WARN_IF(!(ToJSVal<StaticString20>(aCx, aValue.mType, &memberVal0)))) {
     return false;
   }
   if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "type", memberVal0))) {
@@ -9309,7 +9271,7 @@ bool ToJSVal<BerytusKeyField>(JSContext* aCx, const BerytusKeyField& aValue, JS:
 
   JS::Rooted<JS::Value> memberVal1(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<BerytusKeyFieldOptions>(aCx, aValue.mOptions, &memberVal1)))) {
+  if (NS_WARN_IF(!(ToJSVal<BerytusForeignIdentityFieldOptions>(aCx, aValue.mOptions, &memberVal1)))) {
     return false;
   }
   if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "options", memberVal1))) {
@@ -9321,7 +9283,7 @@ bool ToJSVal<BerytusKeyField>(JSContext* aCx, const BerytusKeyField& aValue, JS:
   if (NS_WARN_IF(!aValue.mValue.Inited())) {
     return false;
   }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<JSNull, BerytusKeyFieldValue>>(aCx, aValue.mValue, &memberVal2)))) {
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(aCx, aValue.mValue, &memberVal2)))) {
     return false;
   }
   if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "value", memberVal2))) {
@@ -9343,7 +9305,41 @@ bool ToJSVal<BerytusKeyField>(JSContext* aCx, const BerytusKeyField& aValue, JS:
 }
 
 template<>
-bool JSValIs<BerytusPasswordField>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<StaticString21>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isString()) {
+    aRv = false;
+    return true;
+  }
+  nsString val;
+  if (NS_WARN_IF((!FromJSVal<nsString>(aCx, aValue, val)))) {
+    return false;
+  }
+  if (!val.Equals(StaticString21::mLiteral)) {
+    aRv = false;
+    return true;
+  }
+  aRv = true;
+  return true;
+}
+template<>
+bool FromJSVal<StaticString21>(JSContext* aCx, JS::Handle<JS::Value> aValue, StaticString21& aRv) {
+  bool rv;
+  if (NS_WARN_IF(!(JSValIs<StaticString21>(aCx, aValue, rv)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!rv)) {
+    return false;
+  }
+  return true;
+}
+template<>
+bool ToJSVal<StaticString21>(JSContext* aCx, const StaticString21& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSString*> rStr(aCx, JS_NewUCStringCopyN(aCx, aValue.GetString().BeginReading(), aValue.GetString().Length()));
+  aRv.setString(rStr);
+  return true;
+}
+template<>
+bool JSValIs<BerytusIdentityField>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -9355,7 +9351,7 @@ bool JSValIs<BerytusPasswordField>(JSContext *aCx, const JS::Handle<JS::Value> a
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<StaticString14>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<StaticString21>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -9367,7 +9363,7 @@ bool JSValIs<BerytusPasswordField>(JSContext *aCx, const JS::Handle<JS::Value> a
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<BerytusPasswordFieldOptions>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<BerytusIdentityFieldOptions>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -9405,7 +9401,7 @@ bool JSValIs<BerytusPasswordField>(JSContext *aCx, const JS::Handle<JS::Value> a
 
 }
 template<>
-bool FromJSVal<BerytusPasswordField>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusPasswordField& aRv) {
+bool FromJSVal<BerytusIdentityField>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusIdentityField& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
@@ -9415,7 +9411,7 @@ bool FromJSVal<BerytusPasswordField>(JSContext* aCx, JS::Handle<JS::Value> aValu
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<StaticString14>(aCx, propVal, aRv.mType)))) {
+  if (NS_WARN_IF(!(FromJSVal<StaticString21>(aCx, propVal, aRv.mType)))) {
     return false;
   }
   
@@ -9423,7 +9419,7 @@ bool FromJSVal<BerytusPasswordField>(JSContext* aCx, JS::Handle<JS::Value> aValu
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<BerytusPasswordFieldOptions>(aCx, propVal, aRv.mOptions)))) {
+  if (NS_WARN_IF(!(FromJSVal<BerytusIdentityFieldOptions>(aCx, propVal, aRv.mOptions)))) {
     return false;
   }
   
@@ -9447,13 +9443,13 @@ bool FromJSVal<BerytusPasswordField>(JSContext* aCx, JS::Handle<JS::Value> aValu
 }
             
 template<>
-bool ToJSVal<BerytusPasswordField>(JSContext* aCx, const BerytusPasswordField& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<BerytusIdentityField>(JSContext* aCx, const BerytusIdentityField& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
   JS::Rooted<JS::Value> memberVal0(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<StaticString14>(aCx, aValue.mType, &memberVal0)))) {
+  if (NS_WARN_IF(!(ToJSVal<StaticString21>(aCx, aValue.mType, &memberVal0)))) {
     return false;
   }
   if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "type", memberVal0))) {
@@ -9463,7 +9459,7 @@ bool ToJSVal<BerytusPasswordField>(JSContext* aCx, const BerytusPasswordField& a
 
   JS::Rooted<JS::Value> memberVal1(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<BerytusPasswordFieldOptions>(aCx, aValue.mOptions, &memberVal1)))) {
+  if (NS_WARN_IF(!(ToJSVal<BerytusIdentityFieldOptions>(aCx, aValue.mOptions, &memberVal1)))) {
     return false;
   }
   if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "options", memberVal1))) {
@@ -9497,7 +9493,7 @@ bool ToJSVal<BerytusPasswordField>(JSContext* aCx, const BerytusPasswordField& a
 }
 
 template<>
-bool JSValIs<StaticString23>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<StaticString22>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isString()) {
     aRv = false;
     return true;
@@ -9506,7 +9502,7 @@ bool JSValIs<StaticString23>(JSContext *aCx, const JS::Handle<JS::Value> aValue,
   if (NS_WARN_IF((!FromJSVal<nsString>(aCx, aValue, val)))) {
     return false;
   }
-  if (!val.Equals(StaticString23::mLiteral)) {
+  if (!val.Equals(StaticString22::mLiteral)) {
     aRv = false;
     return true;
   }
@@ -9514,9 +9510,9 @@ bool JSValIs<StaticString23>(JSContext *aCx, const JS::Handle<JS::Value> aValue,
   return true;
 }
 template<>
-bool FromJSVal<StaticString23>(JSContext* aCx, JS::Handle<JS::Value> aValue, StaticString23& aRv) {
+bool FromJSVal<StaticString22>(JSContext* aCx, JS::Handle<JS::Value> aValue, StaticString22& aRv) {
   bool rv;
-  if (NS_WARN_IF(!(JSValIs<StaticString23>(aCx, aValue, rv)))) {
+  if (NS_WARN_IF(!(JSValIs<StaticString22>(aCx, aValue, rv)))) {
     return false;
   }
   if (NS_WARN_IF(!rv)) {
@@ -9525,34 +9521,104 @@ bool FromJSVal<StaticString23>(JSContext* aCx, JS::Handle<JS::Value> aValue, Sta
   return true;
 }
 template<>
-bool ToJSVal<StaticString23>(JSContext* aCx, const StaticString23& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<StaticString22>(JSContext* aCx, const StaticString22& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSString*> rStr(aCx, JS_NewUCStringCopyN(aCx, aValue.GetString().BeginReading(), aValue.GetString().Length()));
   aRv.setString(rStr);
   return true;
 }
 template<>
-bool JSValIs<BerytusSecurePasswordFieldValue>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
-  if (!aValue.isObject()) {
-    aRv = false;
-    return true;
-  }
-  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
-  bool isValid = false;
-  JS::Rooted<JS::Value> propVal(aCx);
+bool JSValIs<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "salt", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(JSValIs<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, isValid)))) {
-    return false;
-  }
-  if (!isValid) {
-    aRv = false;
-    return true;
-  }
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<ArrayBuffer>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
+
+
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusEncryptedPacket>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
+
+  aRv = false;
+  return true;
+}
+template<>
+bool FromJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<ArrayBuffer, BerytusEncryptedPacket>& aRv) {
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<ArrayBuffer>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv.Init(VariantIndex<0>(), ArrayBuffer());
+      if (NS_WARN_IF(!(FromJSVal<ArrayBuffer>(aCx, aValue, (aRv.InternalValue())->as<ArrayBuffer>())))) {
+        return false;
+      }
+      return true;
+      
+    }
+  } while (false);
+  
+do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusEncryptedPacket>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      BerytusEncryptedPacket nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusEncryptedPacket>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<1>(), std::move(nv));
+      return true;
+    }
+  } while (false);
   
 
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "verifier", &propVal))) {
+  NS_WARNING_ASSERTION(true, "None of the subtypes returned a truthful IsValid()");
+  return false;
+}
+template<>
+bool ToJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(JSContext* aCx, const SafeVariant<ArrayBuffer, BerytusEncryptedPacket>& aValue, JS::MutableHandle<JS::Value> aRv) {
+  struct Matcher {
+    JSContext* mCx;
+    JS::MutableHandle<JS::Value> mRv;
+    Matcher(JSContext* aCx, JS::MutableHandle<JS::Value> aRv) : mCx(aCx), mRv(aRv) {}
+    
+    bool operator()(const ArrayBuffer& aVal) {
+      return ToJSVal<ArrayBuffer>(mCx, aVal, mRv);
+    }
+
+    bool operator()(const BerytusEncryptedPacket& aVal) {
+      return ToJSVal<BerytusEncryptedPacket>(mCx, aVal, mRv);
+    }
+  };
+  return aValue.InternalValue()->match(Matcher(aCx, aRv));
+}
+template<>
+bool JSValIs<BerytusKeyFieldValue>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
+    aRv = false;
+    return true;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isValid = false;
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "publicKey", &propVal))) {
     return false;
   }
   if (NS_WARN_IF(!(JSValIs<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, isValid)))) {
@@ -9569,25 +9635,17 @@ bool JSValIs<BerytusSecurePasswordFieldValue>(JSContext *aCx, const JS::Handle<J
 
 }
 template<>
-bool FromJSVal<BerytusSecurePasswordFieldValue>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusSecurePasswordFieldValue& aRv) {
+bool FromJSVal<BerytusKeyFieldValue>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusKeyFieldValue& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "salt", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(FromJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, aRv.mSalt)))) {
-    return false;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "verifier", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "publicKey", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, aRv.mVerifier)))) {
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, aRv.mPublicKey)))) {
     return false;
   }
   
@@ -9595,30 +9653,18 @@ bool FromJSVal<BerytusSecurePasswordFieldValue>(JSContext* aCx, JS::Handle<JS::V
 }
             
 template<>
-bool ToJSVal<BerytusSecurePasswordFieldValue>(JSContext* aCx, const BerytusSecurePasswordFieldValue& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<BerytusKeyFieldValue>(JSContext* aCx, const BerytusKeyFieldValue& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
   JS::Rooted<JS::Value> memberVal0(aCx);
-  if (NS_WARN_IF(!aValue.mSalt.Inited())) {
-    return false;
-  }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, aValue.mSalt, &memberVal0)))) {
-    return false;
-  }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "salt", memberVal0))) {
-    return false;
-  }
-  
-
-  JS::Rooted<JS::Value> memberVal1(aCx);
-  if (NS_WARN_IF(!aValue.mVerifier.Inited())) {
+  if (NS_WARN_IF(!aValue.mPublicKey.Inited())) {
     return false;
   }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, aValue.mVerifier, &memberVal1)))) {
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, aValue.mPublicKey, &memberVal0)))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "verifier", memberVal1))) {
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "publicKey", memberVal0))) {
     return false;
   }
   
@@ -9627,7 +9673,7 @@ bool ToJSVal<BerytusSecurePasswordFieldValue>(JSContext* aCx, const BerytusSecur
 }
 
 template<>
-bool JSValIs<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<SafeVariant<JSNull, BerytusKeyFieldValue>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   
   do {
     bool isValid = false;
@@ -9643,7 +9689,7 @@ bool JSValIs<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(JSContext *aC
 
   do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordFieldValue>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusKeyFieldValue>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
@@ -9656,7 +9702,7 @@ bool JSValIs<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(JSContext *aC
   return true;
 }
 template<>
-bool FromJSVal<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<JSNull, BerytusSecurePasswordFieldValue>& aRv) {
+bool FromJSVal<SafeVariant<JSNull, BerytusKeyFieldValue>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<JSNull, BerytusKeyFieldValue>& aRv) {
   do {
     bool isValid = false;
     if (NS_WARN_IF(!(JSValIs<JSNull>(aCx, aValue, isValid)))) {
@@ -9674,12 +9720,12 @@ bool FromJSVal<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(JSContext*
   
 do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordFieldValue>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusKeyFieldValue>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      BerytusSecurePasswordFieldValue nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusSecurePasswordFieldValue>(aCx, aValue, nv)))) {
+      BerytusKeyFieldValue nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusKeyFieldValue>(aCx, aValue, nv)))) {
         return false;
       }
       aRv.Init(VariantIndex<1>(), std::move(nv));
@@ -9692,7 +9738,7 @@ do {
   return false;
 }
 template<>
-bool ToJSVal<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(JSContext* aCx, const SafeVariant<JSNull, BerytusSecurePasswordFieldValue>& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<SafeVariant<JSNull, BerytusKeyFieldValue>>(JSContext* aCx, const SafeVariant<JSNull, BerytusKeyFieldValue>& aValue, JS::MutableHandle<JS::Value> aRv) {
   struct Matcher {
     JSContext* mCx;
     JS::MutableHandle<JS::Value> mRv;
@@ -9702,14 +9748,14 @@ bool ToJSVal<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(JSContext* aC
       return ToJSVal<JSNull>(mCx, aVal, mRv);
     }
 
-    bool operator()(const BerytusSecurePasswordFieldValue& aVal) {
-      return ToJSVal<BerytusSecurePasswordFieldValue>(mCx, aVal, mRv);
+    bool operator()(const BerytusKeyFieldValue& aVal) {
+      return ToJSVal<BerytusKeyFieldValue>(mCx, aVal, mRv);
     }
   };
   return aValue.InternalValue()->match(Matcher(aCx, aRv));
 }
 template<>
-bool JSValIs<BerytusSecurePasswordField>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<BerytusKeyField>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -9721,7 +9767,7 @@ bool JSValIs<BerytusSecurePasswordField>(JSContext *aCx, const JS::Handle<JS::Va
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<StaticString23>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<StaticString22>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -9733,7 +9779,7 @@ bool JSValIs<BerytusSecurePasswordField>(JSContext *aCx, const JS::Handle<JS::Va
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordFieldOptions>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<BerytusKeyFieldOptions>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -9745,7 +9791,7 @@ bool JSValIs<BerytusSecurePasswordField>(JSContext *aCx, const JS::Handle<JS::Va
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<JSNull, BerytusKeyFieldValue>>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -9771,7 +9817,7 @@ bool JSValIs<BerytusSecurePasswordField>(JSContext *aCx, const JS::Handle<JS::Va
 
 }
 template<>
-bool FromJSVal<BerytusSecurePasswordField>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusSecurePasswordField& aRv) {
+bool FromJSVal<BerytusKeyField>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusKeyField& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
@@ -9781,7 +9827,7 @@ bool FromJSVal<BerytusSecurePasswordField>(JSContext* aCx, JS::Handle<JS::Value>
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<StaticString23>(aCx, propVal, aRv.mType)))) {
+  if (NS_WARN_IF(!(FromJSVal<StaticString22>(aCx, propVal, aRv.mType)))) {
     return false;
   }
   
@@ -9789,7 +9835,7 @@ bool FromJSVal<BerytusSecurePasswordField>(JSContext* aCx, JS::Handle<JS::Value>
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<BerytusSecurePasswordFieldOptions>(aCx, propVal, aRv.mOptions)))) {
+  if (NS_WARN_IF(!(FromJSVal<BerytusKeyFieldOptions>(aCx, propVal, aRv.mOptions)))) {
     return false;
   }
   
@@ -9797,7 +9843,7 @@ bool FromJSVal<BerytusSecurePasswordField>(JSContext* aCx, JS::Handle<JS::Value>
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(aCx, propVal, aRv.mValue)))) {
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<JSNull, BerytusKeyFieldValue>>(aCx, propVal, aRv.mValue)))) {
     return false;
   }
   
@@ -9813,13 +9859,13 @@ bool FromJSVal<BerytusSecurePasswordField>(JSContext* aCx, JS::Handle<JS::Value>
 }
             
 template<>
-bool ToJSVal<BerytusSecurePasswordField>(JSContext* aCx, const BerytusSecurePasswordField& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<BerytusKeyField>(JSContext* aCx, const BerytusKeyField& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
   JS::Rooted<JS::Value> memberVal0(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<StaticString23>(aCx, aValue.mType, &memberVal0)))) {
+  if (NS_WARN_IF(!(ToJSVal<StaticString22>(aCx, aValue.mType, &memberVal0)))) {
     return false;
   }
   if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "type", memberVal0))) {
@@ -9829,7 +9875,7 @@ bool ToJSVal<BerytusSecurePasswordField>(JSContext* aCx, const BerytusSecurePass
 
   JS::Rooted<JS::Value> memberVal1(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<BerytusSecurePasswordFieldOptions>(aCx, aValue.mOptions, &memberVal1)))) {
+  if (NS_WARN_IF(!(ToJSVal<BerytusKeyFieldOptions>(aCx, aValue.mOptions, &memberVal1)))) {
     return false;
   }
   if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "options", memberVal1))) {
@@ -9841,7 +9887,7 @@ bool ToJSVal<BerytusSecurePasswordField>(JSContext* aCx, const BerytusSecurePass
   if (NS_WARN_IF(!aValue.mValue.Inited())) {
     return false;
   }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(aCx, aValue.mValue, &memberVal2)))) {
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<JSNull, BerytusKeyFieldValue>>(aCx, aValue.mValue, &memberVal2)))) {
     return false;
   }
   if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "value", memberVal2))) {
@@ -9863,53 +9909,55 @@ bool ToJSVal<BerytusSecurePasswordField>(JSContext* aCx, const BerytusSecurePass
 }
 
 template<>
-bool JSValIs<StaticString24>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
-  if (!aValue.isString()) {
+bool JSValIs<BerytusPasswordField>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
     aRv = false;
     return true;
   }
-  nsString val;
-  if (NS_WARN_IF((!FromJSVal<nsString>(aCx, aValue, val)))) {
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isValid = false;
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
     return false;
   }
-  if (!val.Equals(StaticString24::mLiteral)) {
+  if (NS_WARN_IF(!(JSValIs<StaticString14>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
     aRv = false;
     return true;
   }
-  aRv = true;
-  return true;
-}
-template<>
-bool FromJSVal<StaticString24>(JSContext* aCx, JS::Handle<JS::Value> aValue, StaticString24& aRv) {
-  bool rv;
-  if (NS_WARN_IF(!(JSValIs<StaticString24>(aCx, aValue, rv)))) {
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!rv)) {
+  if (NS_WARN_IF(!(JSValIs<BerytusPasswordFieldOptions>(aCx, propVal, isValid)))) {
     return false;
   }
-  return true;
-}
-template<>
-bool ToJSVal<StaticString24>(JSContext* aCx, const StaticString24& aValue, JS::MutableHandle<JS::Value> aRv) {
-  JS::Rooted<JSString*> rStr(aCx, JS_NewUCStringCopyN(aCx, aValue.GetString().BeginReading(), aValue.GetString().Length()));
-  aRv.setString(rStr);
-  return true;
-}
-template<>
-bool JSValIs<BerytusSharedKeyFieldValue>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
-  if (!aValue.isObject()) {
+  if (!isValid) {
     aRv = false;
     return true;
   }
-  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
-  bool isValid = false;
-  JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "privateKey", &propVal))) {
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "id", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<nsString>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -9923,45 +9971,229 @@ bool JSValIs<BerytusSharedKeyFieldValue>(JSContext *aCx, const JS::Handle<JS::Va
 
 }
 template<>
-bool FromJSVal<BerytusSharedKeyFieldValue>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusSharedKeyFieldValue& aRv) {
+bool FromJSVal<BerytusPasswordField>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusPasswordField& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "privateKey", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, aRv.mPrivateKey)))) {
+  if (NS_WARN_IF(!(FromJSVal<StaticString14>(aCx, propVal, aRv.mType)))) {
     return false;
   }
   
-  return true;
-}
-            
-template<>
-bool ToJSVal<BerytusSharedKeyFieldValue>(JSContext* aCx, const BerytusSharedKeyFieldValue& aValue, JS::MutableHandle<JS::Value> aRv) {
-  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
-  
-  JS::Rooted<JS::Value> memberVal0(aCx);
-  if (NS_WARN_IF(!aValue.mPrivateKey.Inited())) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, aValue.mPrivateKey, &memberVal0)))) {
+  if (NS_WARN_IF(!(FromJSVal<BerytusPasswordFieldOptions>(aCx, propVal, aRv.mOptions)))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "privateKey", memberVal0))) {
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(aCx, propVal, aRv.mValue)))) {
     return false;
   }
   
-  aRv.setObject(*obj);
-  return true;
-}
 
-template<>
-bool JSValIs<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "id", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, propVal, aRv.mId)))) {
+    return false;
+  }
+  
+  return true;
+}
+            
+template<>
+bool ToJSVal<BerytusPasswordField>(JSContext* aCx, const BerytusPasswordField& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
+
+  
+  JS::Rooted<JS::Value> memberVal0(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<StaticString14>(aCx, aValue.mType, &memberVal0)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "type", memberVal0))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal1(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<BerytusPasswordFieldOptions>(aCx, aValue.mOptions, &memberVal1)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "options", memberVal1))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal2(aCx);
+  if (NS_WARN_IF(!aValue.mValue.Inited())) {
+    return false;
+  }
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket>>(aCx, aValue.mValue, &memberVal2)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "value", memberVal2))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal3(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mId, &memberVal3)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "id", memberVal3))) {
+    return false;
+  }
+  
+  aRv.setObject(*obj);
+  return true;
+}
+
+template<>
+bool JSValIs<StaticString23>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isString()) {
+    aRv = false;
+    return true;
+  }
+  nsString val;
+  if (NS_WARN_IF((!FromJSVal<nsString>(aCx, aValue, val)))) {
+    return false;
+  }
+  if (!val.Equals(StaticString23::mLiteral)) {
+    aRv = false;
+    return true;
+  }
+  aRv = true;
+  return true;
+}
+template<>
+bool FromJSVal<StaticString23>(JSContext* aCx, JS::Handle<JS::Value> aValue, StaticString23& aRv) {
+  bool rv;
+  if (NS_WARN_IF(!(JSValIs<StaticString23>(aCx, aValue, rv)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!rv)) {
+    return false;
+  }
+  return true;
+}
+template<>
+bool ToJSVal<StaticString23>(JSContext* aCx, const StaticString23& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSString*> rStr(aCx, JS_NewUCStringCopyN(aCx, aValue.GetString().BeginReading(), aValue.GetString().Length()));
+  aRv.setString(rStr);
+  return true;
+}
+template<>
+bool JSValIs<BerytusSecurePasswordFieldValue>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
+    aRv = false;
+    return true;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isValid = false;
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "salt", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "verifier", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+  aRv = true;
+  return true;
+
+
+}
+template<>
+bool FromJSVal<BerytusSecurePasswordFieldValue>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusSecurePasswordFieldValue& aRv) {
+  if (NS_WARN_IF(!aValue.isObject())) {
+    return false;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "salt", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, aRv.mSalt)))) {
+    return false;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "verifier", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, aRv.mVerifier)))) {
+    return false;
+  }
+  
+  return true;
+}
+            
+template<>
+bool ToJSVal<BerytusSecurePasswordFieldValue>(JSContext* aCx, const BerytusSecurePasswordFieldValue& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
+
+  
+  JS::Rooted<JS::Value> memberVal0(aCx);
+  if (NS_WARN_IF(!aValue.mSalt.Inited())) {
+    return false;
+  }
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, aValue.mSalt, &memberVal0)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "salt", memberVal0))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal1(aCx);
+  if (NS_WARN_IF(!aValue.mVerifier.Inited())) {
+    return false;
+  }
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, aValue.mVerifier, &memberVal1)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "verifier", memberVal1))) {
+    return false;
+  }
+  
+  aRv.setObject(*obj);
+  return true;
+}
+
+template<>
+bool JSValIs<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   
   do {
     bool isValid = false;
@@ -9977,7 +10209,7 @@ bool JSValIs<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(JSContext *aCx, co
 
   do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyFieldValue>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordFieldValue>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
@@ -9990,7 +10222,7 @@ bool JSValIs<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(JSContext *aCx, co
   return true;
 }
 template<>
-bool FromJSVal<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<JSNull, BerytusSharedKeyFieldValue>& aRv) {
+bool FromJSVal<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<JSNull, BerytusSecurePasswordFieldValue>& aRv) {
   do {
     bool isValid = false;
     if (NS_WARN_IF(!(JSValIs<JSNull>(aCx, aValue, isValid)))) {
@@ -10008,12 +10240,12 @@ bool FromJSVal<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(JSContext* aCx,
   
 do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyFieldValue>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordFieldValue>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      BerytusSharedKeyFieldValue nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusSharedKeyFieldValue>(aCx, aValue, nv)))) {
+      BerytusSecurePasswordFieldValue nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusSecurePasswordFieldValue>(aCx, aValue, nv)))) {
         return false;
       }
       aRv.Init(VariantIndex<1>(), std::move(nv));
@@ -10026,7 +10258,7 @@ do {
   return false;
 }
 template<>
-bool ToJSVal<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(JSContext* aCx, const SafeVariant<JSNull, BerytusSharedKeyFieldValue>& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(JSContext* aCx, const SafeVariant<JSNull, BerytusSecurePasswordFieldValue>& aValue, JS::MutableHandle<JS::Value> aRv) {
   struct Matcher {
     JSContext* mCx;
     JS::MutableHandle<JS::Value> mRv;
@@ -10036,14 +10268,14 @@ bool ToJSVal<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(JSContext* aCx, co
       return ToJSVal<JSNull>(mCx, aVal, mRv);
     }
 
-    bool operator()(const BerytusSharedKeyFieldValue& aVal) {
-      return ToJSVal<BerytusSharedKeyFieldValue>(mCx, aVal, mRv);
+    bool operator()(const BerytusSecurePasswordFieldValue& aVal) {
+      return ToJSVal<BerytusSecurePasswordFieldValue>(mCx, aVal, mRv);
     }
   };
   return aValue.InternalValue()->match(Matcher(aCx, aRv));
 }
 template<>
-bool JSValIs<BerytusSharedKeyField>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<BerytusSecurePasswordField>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -10055,7 +10287,7 @@ bool JSValIs<BerytusSharedKeyField>(JSContext *aCx, const JS::Handle<JS::Value>
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<StaticString24>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<StaticString23>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -10067,7 +10299,7 @@ bool JSValIs<BerytusSharedKeyField>(JSContext *aCx, const JS::Handle<JS::Value>
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyFieldOptions>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordFieldOptions>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -10079,7 +10311,7 @@ bool JSValIs<BerytusSharedKeyField>(JSContext *aCx, const JS::Handle<JS::Value>
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -10105,7 +10337,7 @@ bool JSValIs<BerytusSharedKeyField>(JSContext *aCx, const JS::Handle<JS::Value>
 
 }
 template<>
-bool FromJSVal<BerytusSharedKeyField>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusSharedKeyField& aRv) {
+bool FromJSVal<BerytusSecurePasswordField>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusSecurePasswordField& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
@@ -10115,7 +10347,7 @@ bool FromJSVal<BerytusSharedKeyField>(JSContext* aCx, JS::Handle<JS::Value> aVal
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<StaticString24>(aCx, propVal, aRv.mType)))) {
+  if (NS_WARN_IF(!(FromJSVal<StaticString23>(aCx, propVal, aRv.mType)))) {
     return false;
   }
   
@@ -10123,7 +10355,7 @@ bool FromJSVal<BerytusSharedKeyField>(JSContext* aCx, JS::Handle<JS::Value> aVal
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<BerytusSharedKeyFieldOptions>(aCx, propVal, aRv.mOptions)))) {
+  if (NS_WARN_IF(!(FromJSVal<BerytusSecurePasswordFieldOptions>(aCx, propVal, aRv.mOptions)))) {
     return false;
   }
   
@@ -10131,7 +10363,7 @@ bool FromJSVal<BerytusSharedKeyField>(JSContext* aCx, JS::Handle<JS::Value> aVal
   if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(aCx, propVal, aRv.mValue)))) {
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(aCx, propVal, aRv.mValue)))) {
     return false;
   }
   
@@ -10147,13 +10379,13 @@ bool FromJSVal<BerytusSharedKeyField>(JSContext* aCx, JS::Handle<JS::Value> aVal
 }
             
 template<>
-bool ToJSVal<BerytusSharedKeyField>(JSContext* aCx, const BerytusSharedKeyField& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<BerytusSecurePasswordField>(JSContext* aCx, const BerytusSecurePasswordField& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
   JS::Rooted<JS::Value> memberVal0(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<StaticString24>(aCx, aValue.mType, &memberVal0)))) {
+  if (NS_WARN_IF(!(ToJSVal<StaticString23>(aCx, aValue.mType, &memberVal0)))) {
     return false;
   }
   if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "type", memberVal0))) {
@@ -10163,7 +10395,7 @@ bool ToJSVal<BerytusSharedKeyField>(JSContext* aCx, const BerytusSharedKeyField&
 
   JS::Rooted<JS::Value> memberVal1(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<BerytusSharedKeyFieldOptions>(aCx, aValue.mOptions, &memberVal1)))) {
+  if (NS_WARN_IF(!(ToJSVal<BerytusSecurePasswordFieldOptions>(aCx, aValue.mOptions, &memberVal1)))) {
     return false;
   }
   if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "options", memberVal1))) {
@@ -10175,7 +10407,7 @@ bool ToJSVal<BerytusSharedKeyField>(JSContext* aCx, const BerytusSharedKeyField&
   if (NS_WARN_IF(!aValue.mValue.Inited())) {
     return false;
   }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(aCx, aValue.mValue, &memberVal2)))) {
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<JSNull, BerytusSecurePasswordFieldValue>>(aCx, aValue.mValue, &memberVal2)))) {
     return false;
   }
   if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "value", memberVal2))) {
@@ -10197,213 +10429,41 @@ bool ToJSVal<BerytusSharedKeyField>(JSContext* aCx, const BerytusSharedKeyField&
 }
 
 template<>
-bool JSValIs<SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
-  
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusForeignIdentityField>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
-
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusIdentityField>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
-
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusKeyField>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
-
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusPasswordField>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
-
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordField>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
-
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyField>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
-  aRv = false;
+bool JSValIs<StaticString24>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isString()) {
+    aRv = false;
+    return true;
+  }
+  nsString val;
+  if (NS_WARN_IF((!FromJSVal<nsString>(aCx, aValue, val)))) {
+    return false;
+  }
+  if (!val.Equals(StaticString24::mLiteral)) {
+    aRv = false;
+    return true;
+  }
+  aRv = true;
   return true;
 }
 template<>
-bool FromJSVal<SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>& aRv) {
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusForeignIdentityField>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      BerytusForeignIdentityField nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusForeignIdentityField>(aCx, aValue, nv)))) {
-        return false;
-      }
-      aRv.Init(VariantIndex<0>(), std::move(nv));
-      return true;
-    }
-  } while (false);
-  
-do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusIdentityField>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      BerytusIdentityField nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusIdentityField>(aCx, aValue, nv)))) {
-        return false;
-      }
-      aRv.Init(VariantIndex<1>(), std::move(nv));
-      return true;
-    }
-  } while (false);
-  
-do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusKeyField>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      BerytusKeyField nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusKeyField>(aCx, aValue, nv)))) {
-        return false;
-      }
-      aRv.Init(VariantIndex<2>(), std::move(nv));
-      return true;
-    }
-  } while (false);
-  
-do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusPasswordField>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      BerytusPasswordField nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusPasswordField>(aCx, aValue, nv)))) {
-        return false;
-      }
-      aRv.Init(VariantIndex<3>(), std::move(nv));
-      return true;
-    }
-  } while (false);
-  
-do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordField>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      BerytusSecurePasswordField nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusSecurePasswordField>(aCx, aValue, nv)))) {
-        return false;
-      }
-      aRv.Init(VariantIndex<4>(), std::move(nv));
-      return true;
-    }
-  } while (false);
-  
-do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyField>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      BerytusSharedKeyField nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusSharedKeyField>(aCx, aValue, nv)))) {
-        return false;
-      }
-      aRv.Init(VariantIndex<5>(), std::move(nv));
-      return true;
-    }
-  } while (false);
-  
-
-  NS_WARNING_ASSERTION(true, "None of the subtypes returned a truthful IsValid()");
-  return false;
+bool FromJSVal<StaticString24>(JSContext* aCx, JS::Handle<JS::Value> aValue, StaticString24& aRv) {
+  bool rv;
+  if (NS_WARN_IF(!(JSValIs<StaticString24>(aCx, aValue, rv)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!rv)) {
+    return false;
+  }
+  return true;
 }
 template<>
-bool ToJSVal<SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>>(JSContext* aCx, const SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>& aValue, JS::MutableHandle<JS::Value> aRv) {
-  struct Matcher {
-    JSContext* mCx;
-    JS::MutableHandle<JS::Value> mRv;
-    Matcher(JSContext* aCx, JS::MutableHandle<JS::Value> aRv) : mCx(aCx), mRv(aRv) {}
-    
-    bool operator()(const BerytusForeignIdentityField& aVal) {
-      return ToJSVal<BerytusForeignIdentityField>(mCx, aVal, mRv);
-    }
-
-    bool operator()(const BerytusIdentityField& aVal) {
-      return ToJSVal<BerytusIdentityField>(mCx, aVal, mRv);
-    }
-
-    bool operator()(const BerytusKeyField& aVal) {
-      return ToJSVal<BerytusKeyField>(mCx, aVal, mRv);
-    }
-
-    bool operator()(const BerytusPasswordField& aVal) {
-      return ToJSVal<BerytusPasswordField>(mCx, aVal, mRv);
-    }
-
-    bool operator()(const BerytusSecurePasswordField& aVal) {
-      return ToJSVal<BerytusSecurePasswordField>(mCx, aVal, mRv);
-    }
-
-    bool operator()(const BerytusSharedKeyField& aVal) {
-      return ToJSVal<BerytusSharedKeyField>(mCx, aVal, mRv);
-    }
-  };
-  return aValue.InternalValue()->match(Matcher(aCx, aRv));
+bool ToJSVal<StaticString24>(JSContext* aCx, const StaticString24& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSString*> rStr(aCx, JS_NewUCStringCopyN(aCx, aValue.GetString().BeginReading(), aValue.GetString().Length()));
+  aRv.setString(rStr);
+  return true;
 }
 template<>
-bool JSValIs<AddFieldArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<BerytusSharedKeyFieldValue>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -10412,10 +10472,10 @@ bool JSValIs<AddFieldArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, b
   bool isValid = false;
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "field", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "privateKey", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -10429,17 +10489,17 @@ bool JSValIs<AddFieldArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, b
 
 }
 template<>
-bool FromJSVal<AddFieldArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, AddFieldArgs& aRv) {
+bool FromJSVal<BerytusSharedKeyFieldValue>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusSharedKeyFieldValue& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "field", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "privateKey", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>>(aCx, propVal, aRv.mField)))) {
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, propVal, aRv.mPrivateKey)))) {
     return false;
   }
   
@@ -10447,18 +10507,18 @@ bool FromJSVal<AddFieldArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, AddFi
 }
             
 template<>
-bool ToJSVal<AddFieldArgs>(JSContext* aCx, const AddFieldArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<BerytusSharedKeyFieldValue>(JSContext* aCx, const BerytusSharedKeyFieldValue& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
   JS::Rooted<JS::Value> memberVal0(aCx);
-  if (NS_WARN_IF(!aValue.mField.Inited())) {
+  if (NS_WARN_IF(!aValue.mPrivateKey.Inited())) {
     return false;
   }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>>(aCx, aValue.mField, &memberVal0)))) {
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<ArrayBuffer, BerytusEncryptedPacket>>(aCx, aValue.mPrivateKey, &memberVal0)))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "field", memberVal0))) {
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "privateKey", memberVal0))) {
     return false;
   }
   
@@ -10467,11 +10527,11 @@ bool ToJSVal<AddFieldArgs>(JSContext* aCx, const AddFieldArgs& aValue, JS::Mutab
 }
 
 template<>
-bool JSValIs<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   
   do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<JSNull>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
@@ -10483,7 +10543,7 @@ bool JSValIs<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue,
 
   do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusEncryptedPacket>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyFieldValue>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
@@ -10492,34 +10552,222 @@ bool JSValIs<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue,
     }
   } while (false);
 
-
+  aRv = false;
+  return true;
+}
+template<>
+bool FromJSVal<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<JSNull, BerytusSharedKeyFieldValue>& aRv) {
   do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusKeyFieldValue>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<JSNull>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      aRv = true;
+      JSNull nv;
+      if (NS_WARN_IF(!(FromJSVal<JSNull>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<0>(), std::move(nv));
       return true;
     }
   } while (false);
-
-
-  do {
+  
+do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordFieldValue>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyFieldValue>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      aRv = true;
+      BerytusSharedKeyFieldValue nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusSharedKeyFieldValue>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<1>(), std::move(nv));
       return true;
     }
   } while (false);
+  
 
+  NS_WARNING_ASSERTION(true, "None of the subtypes returned a truthful IsValid()");
+  return false;
+}
+template<>
+bool ToJSVal<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(JSContext* aCx, const SafeVariant<JSNull, BerytusSharedKeyFieldValue>& aValue, JS::MutableHandle<JS::Value> aRv) {
+  struct Matcher {
+    JSContext* mCx;
+    JS::MutableHandle<JS::Value> mRv;
+    Matcher(JSContext* aCx, JS::MutableHandle<JS::Value> aRv) : mCx(aCx), mRv(aRv) {}
+    
+    bool operator()(const JSNull& aVal) {
+      return ToJSVal<JSNull>(mCx, aVal, mRv);
+    }
+
+    bool operator()(const BerytusSharedKeyFieldValue& aVal) {
+      return ToJSVal<BerytusSharedKeyFieldValue>(mCx, aVal, mRv);
+    }
+  };
+  return aValue.InternalValue()->match(Matcher(aCx, aRv));
+}
+template<>
+bool JSValIs<BerytusSharedKeyField>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
+    aRv = false;
+    return true;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isValid = false;
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<StaticString24>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyFieldOptions>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "id", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<nsString>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+  aRv = true;
+  return true;
+
+
+}
+template<>
+bool FromJSVal<BerytusSharedKeyField>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusSharedKeyField& aRv) {
+  if (NS_WARN_IF(!aValue.isObject())) {
+    return false;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "type", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<StaticString24>(aCx, propVal, aRv.mType)))) {
+    return false;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "options", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<BerytusSharedKeyFieldOptions>(aCx, propVal, aRv.mOptions)))) {
+    return false;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "value", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(aCx, propVal, aRv.mValue)))) {
+    return false;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "id", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, propVal, aRv.mId)))) {
+    return false;
+  }
+  
+  return true;
+}
+            
+template<>
+bool ToJSVal<BerytusSharedKeyField>(JSContext* aCx, const BerytusSharedKeyField& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
+
+  
+  JS::Rooted<JS::Value> memberVal0(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<StaticString24>(aCx, aValue.mType, &memberVal0)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "type", memberVal0))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal1(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<BerytusSharedKeyFieldOptions>(aCx, aValue.mOptions, &memberVal1)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "options", memberVal1))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal2(aCx);
+  if (NS_WARN_IF(!aValue.mValue.Inited())) {
+    return false;
+  }
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<JSNull, BerytusSharedKeyFieldValue>>(aCx, aValue.mValue, &memberVal2)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "value", memberVal2))) {
+    return false;
+  }
+  
 
+  JS::Rooted<JS::Value> memberVal3(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mId, &memberVal3)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "id", memberVal3))) {
+    return false;
+  }
+  
+  aRv.setObject(*obj);
+  return true;
+}
+
+template<>
+bool JSValIs<SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  
   do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyFieldValue>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusForeignIdentityField>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
@@ -10528,206 +10776,79 @@ bool JSValIs<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue,
     }
   } while (false);
 
-  aRv = false;
-  return true;
-}
-template<>
-bool FromJSVal<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>& aRv) {
+
   do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusIdentityField>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      nsString nv;
-      if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, aValue, nv)))) {
-        return false;
-      }
-      aRv.Init(VariantIndex<0>(), std::move(nv));
+      aRv = true;
       return true;
     }
   } while (false);
-  
-do {
+
+
+  do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusEncryptedPacket>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusKeyField>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      BerytusEncryptedPacket nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusEncryptedPacket>(aCx, aValue, nv)))) {
-        return false;
-      }
-      aRv.Init(VariantIndex<1>(), std::move(nv));
+      aRv = true;
       return true;
     }
   } while (false);
-  
-do {
+
+
+  do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusKeyFieldValue>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusPasswordField>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      BerytusKeyFieldValue nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusKeyFieldValue>(aCx, aValue, nv)))) {
-        return false;
-      }
-      aRv.Init(VariantIndex<2>(), std::move(nv));
+      aRv = true;
       return true;
     }
   } while (false);
-  
-do {
+
+
+  do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordFieldValue>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordField>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      BerytusSecurePasswordFieldValue nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusSecurePasswordFieldValue>(aCx, aValue, nv)))) {
-        return false;
-      }
-      aRv.Init(VariantIndex<3>(), std::move(nv));
+      aRv = true;
       return true;
     }
   } while (false);
-  
-do {
+
+
+  do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyFieldValue>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyField>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      BerytusSharedKeyFieldValue nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusSharedKeyFieldValue>(aCx, aValue, nv)))) {
-        return false;
-      }
-      aRv.Init(VariantIndex<4>(), std::move(nv));
+      aRv = true;
       return true;
     }
   } while (false);
-  
 
-  NS_WARNING_ASSERTION(true, "None of the subtypes returned a truthful IsValid()");
-  return false;
+  aRv = false;
+  return true;
 }
 template<>
-bool ToJSVal<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>>(JSContext* aCx, const SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>& aValue, JS::MutableHandle<JS::Value> aRv) {
-  struct Matcher {
-    JSContext* mCx;
-    JS::MutableHandle<JS::Value> mRv;
-    Matcher(JSContext* aCx, JS::MutableHandle<JS::Value> aRv) : mCx(aCx), mRv(aRv) {}
-    
-    bool operator()(const nsString& aVal) {
-      return ToJSVal<nsString>(mCx, aVal, mRv);
-    }
-
-    bool operator()(const BerytusEncryptedPacket& aVal) {
-      return ToJSVal<BerytusEncryptedPacket>(mCx, aVal, mRv);
-    }
-
-    bool operator()(const BerytusKeyFieldValue& aVal) {
-      return ToJSVal<BerytusKeyFieldValue>(mCx, aVal, mRv);
-    }
-
-    bool operator()(const BerytusSecurePasswordFieldValue& aVal) {
-      return ToJSVal<BerytusSecurePasswordFieldValue>(mCx, aVal, mRv);
-    }
-
-    bool operator()(const BerytusSharedKeyFieldValue& aVal) {
-      return ToJSVal<BerytusSharedKeyFieldValue>(mCx, aVal, mRv);
-    }
-  };
-  return aValue.InternalValue()->match(Matcher(aCx, aRv));
-}
-template<>
-bool JSValIs<SafeVariant<JSNull, nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
-  
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<JSNull>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
-
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
-
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusEncryptedPacket>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
-
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusKeyFieldValue>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
-
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordFieldValue>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
-
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyFieldValue>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
-  aRv = false;
-  return true;
-}
-template<>
-bool FromJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<JSNull, nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>& aRv) {
+bool FromJSVal<SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>& aRv) {
   do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<JSNull>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusForeignIdentityField>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      JSNull nv;
-      if (NS_WARN_IF(!(FromJSVal<JSNull>(aCx, aValue, nv)))) {
+      BerytusForeignIdentityField nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusForeignIdentityField>(aCx, aValue, nv)))) {
         return false;
       }
       aRv.Init(VariantIndex<0>(), std::move(nv));
@@ -10737,12 +10858,12 @@ bool FromJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket, BerytusKeyF
   
 do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusIdentityField>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      nsString nv;
-      if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, aValue, nv)))) {
+      BerytusIdentityField nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusIdentityField>(aCx, aValue, nv)))) {
         return false;
       }
       aRv.Init(VariantIndex<1>(), std::move(nv));
@@ -10752,12 +10873,12 @@ do {
   
 do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusEncryptedPacket>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusKeyField>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      BerytusEncryptedPacket nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusEncryptedPacket>(aCx, aValue, nv)))) {
+      BerytusKeyField nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusKeyField>(aCx, aValue, nv)))) {
         return false;
       }
       aRv.Init(VariantIndex<2>(), std::move(nv));
@@ -10767,12 +10888,12 @@ do {
   
 do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusKeyFieldValue>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusPasswordField>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      BerytusKeyFieldValue nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusKeyFieldValue>(aCx, aValue, nv)))) {
+      BerytusPasswordField nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusPasswordField>(aCx, aValue, nv)))) {
         return false;
       }
       aRv.Init(VariantIndex<3>(), std::move(nv));
@@ -10782,12 +10903,12 @@ do {
   
 do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordFieldValue>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordField>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      BerytusSecurePasswordFieldValue nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusSecurePasswordFieldValue>(aCx, aValue, nv)))) {
+      BerytusSecurePasswordField nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusSecurePasswordField>(aCx, aValue, nv)))) {
         return false;
       }
       aRv.Init(VariantIndex<4>(), std::move(nv));
@@ -10797,12 +10918,12 @@ do {
   
 do {
     bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyFieldValue>(aCx, aValue, isValid)))) {
+    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyField>(aCx, aValue, isValid)))) {
       return false;
     }
     if (isValid) {
-      BerytusSharedKeyFieldValue nv;
-      if (NS_WARN_IF(!(FromJSVal<BerytusSharedKeyFieldValue>(aCx, aValue, nv)))) {
+      BerytusSharedKeyField nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusSharedKeyField>(aCx, aValue, nv)))) {
         return false;
       }
       aRv.Init(VariantIndex<5>(), std::move(nv));
@@ -10815,41 +10936,40 @@ do {
   return false;
 }
 template<>
-bool ToJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>>(JSContext* aCx, const SafeVariant<JSNull, nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>>(JSContext* aCx, const SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>& aValue, JS::MutableHandle<JS::Value> aRv) {
   struct Matcher {
     JSContext* mCx;
     JS::MutableHandle<JS::Value> mRv;
     Matcher(JSContext* aCx, JS::MutableHandle<JS::Value> aRv) : mCx(aCx), mRv(aRv) {}
     
-    bool operator()(const JSNull& aVal) {
-      return ToJSVal<JSNull>(mCx, aVal, mRv);
+    bool operator()(const BerytusForeignIdentityField& aVal) {
+      return ToJSVal<BerytusForeignIdentityField>(mCx, aVal, mRv);
     }
 
-    bool operator()(const nsString& aVal) {
-      return ToJSVal<nsString>(mCx, aVal, mRv);
+    bool operator()(const BerytusIdentityField& aVal) {
+      return ToJSVal<BerytusIdentityField>(mCx, aVal, mRv);
     }
 
-    bool operator()(const BerytusEncryptedPacket& aVal) {
-      return ToJSVal<BerytusEncryptedPacket>(mCx, aVal, mRv);
+    bool operator()(const BerytusKeyField& aVal) {
+      return ToJSVal<BerytusKeyField>(mCx, aVal, mRv);
     }
 
-    bool operator()(const BerytusKeyFieldValue& aVal) {
-      return ToJSVal<BerytusKeyFieldValue>(mCx, aVal, mRv);
+    bool operator()(const BerytusPasswordField& aVal) {
+      return ToJSVal<BerytusPasswordField>(mCx, aVal, mRv);
     }
 
-    bool operator()(const BerytusSecurePasswordFieldValue& aVal) {
-      return ToJSVal<BerytusSecurePasswordFieldValue>(mCx, aVal, mRv);
+    bool operator()(const BerytusSecurePasswordField& aVal) {
+      return ToJSVal<BerytusSecurePasswordField>(mCx, aVal, mRv);
     }
 
-    bool operator()(const BerytusSharedKeyFieldValue& aVal) {
-      return ToJSVal<BerytusSharedKeyFieldValue>(mCx, aVal, mRv);
+    bool operator()(const BerytusSharedKeyField& aVal) {
+      return ToJSVal<BerytusSharedKeyField>(mCx, aVal, mRv);
     }
   };
   return aValue.InternalValue()->match(Matcher(aCx, aRv));
 }
-
 template<>
-bool JSValIs<FieldValueRejectionReason>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<AddFieldArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -10858,10 +10978,10 @@ bool JSValIs<FieldValueRejectionReason>(JSContext *aCx, const JS::Handle<JS::Val
   bool isValid = false;
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "code", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "field", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<nsString>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -10875,17 +10995,17 @@ bool JSValIs<FieldValueRejectionReason>(JSContext *aCx, const JS::Handle<JS::Val
 
 }
 template<>
-bool FromJSVal<FieldValueRejectionReason>(JSContext* aCx, JS::Handle<JS::Value> aValue, FieldValueRejectionReason& aRv) {
+bool FromJSVal<AddFieldArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, AddFieldArgs& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "code", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "field", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, propVal, aRv.mCode)))) {
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>>(aCx, propVal, aRv.mField)))) {
     return false;
   }
   
@@ -10893,16 +11013,18 @@ bool FromJSVal<FieldValueRejectionReason>(JSContext* aCx, JS::Handle<JS::Value>
 }
             
 template<>
-bool ToJSVal<FieldValueRejectionReason>(JSContext* aCx, const FieldValueRejectionReason& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<AddFieldArgs>(JSContext* aCx, const AddFieldArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
   JS::Rooted<JS::Value> memberVal0(aCx);
-  
-  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mCode, &memberVal0)))) {
+  if (NS_WARN_IF(!aValue.mField.Inited())) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "code", memberVal0))) {
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<BerytusForeignIdentityField, BerytusIdentityField, BerytusKeyField, BerytusPasswordField, BerytusSecurePasswordField, BerytusSharedKeyField>>(aCx, aValue.mField, &memberVal0)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "field", memberVal0))) {
     return false;
   }
   
@@ -10911,7 +11033,7 @@ bool ToJSVal<FieldValueRejectionReason>(JSContext* aCx, const FieldValueRejectio
 }
 
 template<>
-bool JSValIs<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   
   do {
     bool isValid = false;
@@ -10972,23 +11094,11 @@ bool JSValIs<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue,
     }
   } while (false);
 
-
-  do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<Nothing>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      aRv = true;
-      return true;
-    }
-  } while (false);
-
   aRv = false;
   return true;
 }
 template<>
-bool FromJSVal<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>& aRv) {
+bool FromJSVal<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>& aRv) {
   do {
     bool isValid = false;
     if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
@@ -11064,27 +11174,12 @@ do {
     }
   } while (false);
   
-do {
-    bool isValid = false;
-    if (NS_WARN_IF(!(JSValIs<Nothing>(aCx, aValue, isValid)))) {
-      return false;
-    }
-    if (isValid) {
-      Nothing nv;
-      if (NS_WARN_IF(!(FromJSVal<Nothing>(aCx, aValue, nv)))) {
-        return false;
-      }
-      aRv.Init(VariantIndex<5>(), std::move(nv));
-      return true;
-    }
-  } while (false);
-  
 
   NS_WARNING_ASSERTION(true, "None of the subtypes returned a truthful IsValid()");
   return false;
 }
 template<>
-bool ToJSVal<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>>(JSContext* aCx, const SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>>(JSContext* aCx, const SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>& aValue, JS::MutableHandle<JS::Value> aRv) {
   struct Matcher {
     JSContext* mCx;
     JS::MutableHandle<JS::Value> mRv;
@@ -11109,51 +11204,230 @@ bool ToJSVal<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue,
     bool operator()(const BerytusSharedKeyFieldValue& aVal) {
       return ToJSVal<BerytusSharedKeyFieldValue>(mCx, aVal, mRv);
     }
-
-    bool operator()(const Nothing& aVal) {
-      return ToJSVal<Nothing>(mCx, aVal, mRv);
-    }
   };
   return aValue.InternalValue()->match(Matcher(aCx, aRv));
 }
 template<>
-bool JSValIs<RejectFieldValueArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
-  if (!aValue.isObject()) {
-    aRv = false;
-    return true;
-  }
-  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
-  bool isValid = false;
-  JS::Rooted<JS::Value> propVal(aCx);
-  
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "fieldId", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(JSValIs<nsString>(aCx, propVal, isValid)))) {
-    return false;
-  }
-  if (!isValid) {
-    aRv = false;
-    return true;
-  }
+bool JSValIs<SafeVariant<JSNull, nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<JSNull>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
 
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "reason", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(JSValIs<FieldValueRejectionReason>(aCx, propVal, isValid)))) {
-    return false;
-  }
-  if (!isValid) {
+
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
+
+
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusEncryptedPacket>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
+
+
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusKeyFieldValue>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
+
+
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordFieldValue>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
+
+
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyFieldValue>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
+
+  aRv = false;
+  return true;
+}
+template<>
+bool FromJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<JSNull, nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>& aRv) {
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<JSNull>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      JSNull nv;
+      if (NS_WARN_IF(!(FromJSVal<JSNull>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<0>(), std::move(nv));
+      return true;
+    }
+  } while (false);
+  
+do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      nsString nv;
+      if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<1>(), std::move(nv));
+      return true;
+    }
+  } while (false);
+  
+do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusEncryptedPacket>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      BerytusEncryptedPacket nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusEncryptedPacket>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<2>(), std::move(nv));
+      return true;
+    }
+  } while (false);
+  
+do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusKeyFieldValue>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      BerytusKeyFieldValue nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusKeyFieldValue>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<3>(), std::move(nv));
+      return true;
+    }
+  } while (false);
+  
+do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordFieldValue>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      BerytusSecurePasswordFieldValue nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusSecurePasswordFieldValue>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<4>(), std::move(nv));
+      return true;
+    }
+  } while (false);
+  
+do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyFieldValue>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      BerytusSharedKeyFieldValue nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusSharedKeyFieldValue>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<5>(), std::move(nv));
+      return true;
+    }
+  } while (false);
+  
+
+  NS_WARNING_ASSERTION(true, "None of the subtypes returned a truthful IsValid()");
+  return false;
+}
+template<>
+bool ToJSVal<SafeVariant<JSNull, nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>>(JSContext* aCx, const SafeVariant<JSNull, nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue>& aValue, JS::MutableHandle<JS::Value> aRv) {
+  struct Matcher {
+    JSContext* mCx;
+    JS::MutableHandle<JS::Value> mRv;
+    Matcher(JSContext* aCx, JS::MutableHandle<JS::Value> aRv) : mCx(aCx), mRv(aRv) {}
+    
+    bool operator()(const JSNull& aVal) {
+      return ToJSVal<JSNull>(mCx, aVal, mRv);
+    }
+
+    bool operator()(const nsString& aVal) {
+      return ToJSVal<nsString>(mCx, aVal, mRv);
+    }
+
+    bool operator()(const BerytusEncryptedPacket& aVal) {
+      return ToJSVal<BerytusEncryptedPacket>(mCx, aVal, mRv);
+    }
+
+    bool operator()(const BerytusKeyFieldValue& aVal) {
+      return ToJSVal<BerytusKeyFieldValue>(mCx, aVal, mRv);
+    }
+
+    bool operator()(const BerytusSecurePasswordFieldValue& aVal) {
+      return ToJSVal<BerytusSecurePasswordFieldValue>(mCx, aVal, mRv);
+    }
+
+    bool operator()(const BerytusSharedKeyFieldValue& aVal) {
+      return ToJSVal<BerytusSharedKeyFieldValue>(mCx, aVal, mRv);
+    }
+  };
+  return aValue.InternalValue()->match(Matcher(aCx, aRv));
+}
+
+template<>
+bool JSValIs<FieldValueRejectionReason>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
     aRv = false;
     return true;
   }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isValid = false;
+  JS::Rooted<JS::Value> propVal(aCx);
   
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "optionalNewValue", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "code", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<nsString>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -11167,33 +11441,17 @@ bool JSValIs<RejectFieldValueArgs>(JSContext *aCx, const JS::Handle<JS::Value> a
 
 }
 template<>
-bool FromJSVal<RejectFieldValueArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, RejectFieldValueArgs& aRv) {
+bool FromJSVal<FieldValueRejectionReason>(JSContext* aCx, JS::Handle<JS::Value> aValue, FieldValueRejectionReason& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "fieldId", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, propVal, aRv.mFieldId)))) {
-    return false;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "reason", &propVal))) {
-    return false;
-  }
-  if (NS_WARN_IF(!(FromJSVal<FieldValueRejectionReason>(aCx, propVal, aRv.mReason)))) {
-    return false;
-  }
-  
-
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "optionalNewValue", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "code", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>>(aCx, propVal, aRv.mOptionalNewValue)))) {
+  if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, propVal, aRv.mCode)))) {
     return false;
   }
   
@@ -11201,48 +11459,231 @@ bool FromJSVal<RejectFieldValueArgs>(JSContext* aCx, JS::Handle<JS::Value> aValu
 }
             
 template<>
-bool ToJSVal<RejectFieldValueArgs>(JSContext* aCx, const RejectFieldValueArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
+bool ToJSVal<FieldValueRejectionReason>(JSContext* aCx, const FieldValueRejectionReason& aValue, JS::MutableHandle<JS::Value> aRv) {
   JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
   
   JS::Rooted<JS::Value> memberVal0(aCx);
   
-  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mFieldId, &memberVal0)))) {
+  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mCode, &memberVal0)))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "fieldId", memberVal0))) {
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "code", memberVal0))) {
     return false;
   }
   
+  aRv.setObject(*obj);
+  return true;
+}
 
-  JS::Rooted<JS::Value> memberVal1(aCx);
-  
-  if (NS_WARN_IF(!(ToJSVal<FieldValueRejectionReason>(aCx, aValue.mReason, &memberVal1)))) {
-    return false;
-  }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "reason", memberVal1))) {
-    return false;
-  }
+template<>
+bool JSValIs<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   
-
-  JS::Rooted<JS::Value> memberVal2(aCx);
-  if (NS_WARN_IF(!aValue.mOptionalNewValue.Inited())) {
-    return false;
-  }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>>(aCx, aValue.mOptionalNewValue, &memberVal2)))) {
-    return false;
-  }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "optionalNewValue", memberVal2))) {
-    return false;
-  }
-  
-  aRv.setObject(*obj);
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
+
+
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusEncryptedPacket>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
+
+
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusKeyFieldValue>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
+
+
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordFieldValue>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
+
+
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyFieldValue>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
+
+
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<Nothing>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      aRv = true;
+      return true;
+    }
+  } while (false);
+
+  aRv = false;
   return true;
 }
+template<>
+bool FromJSVal<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>& aRv) {
+  do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<nsString>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      nsString nv;
+      if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<0>(), std::move(nv));
+      return true;
+    }
+  } while (false);
+  
+do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusEncryptedPacket>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      BerytusEncryptedPacket nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusEncryptedPacket>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<1>(), std::move(nv));
+      return true;
+    }
+  } while (false);
+  
+do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusKeyFieldValue>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      BerytusKeyFieldValue nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusKeyFieldValue>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<2>(), std::move(nv));
+      return true;
+    }
+  } while (false);
+  
+do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusSecurePasswordFieldValue>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      BerytusSecurePasswordFieldValue nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusSecurePasswordFieldValue>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<3>(), std::move(nv));
+      return true;
+    }
+  } while (false);
+  
+do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<BerytusSharedKeyFieldValue>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      BerytusSharedKeyFieldValue nv;
+      if (NS_WARN_IF(!(FromJSVal<BerytusSharedKeyFieldValue>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<4>(), std::move(nv));
+      return true;
+    }
+  } while (false);
+  
+do {
+    bool isValid = false;
+    if (NS_WARN_IF(!(JSValIs<Nothing>(aCx, aValue, isValid)))) {
+      return false;
+    }
+    if (isValid) {
+      Nothing nv;
+      if (NS_WARN_IF(!(FromJSVal<Nothing>(aCx, aValue, nv)))) {
+        return false;
+      }
+      aRv.Init(VariantIndex<5>(), std::move(nv));
+      return true;
+    }
+  } while (false);
+  
+
+  NS_WARNING_ASSERTION(true, "None of the subtypes returned a truthful IsValid()");
+  return false;
+}
+template<>
+bool ToJSVal<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>>(JSContext* aCx, const SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>& aValue, JS::MutableHandle<JS::Value> aRv) {
+  struct Matcher {
+    JSContext* mCx;
+    JS::MutableHandle<JS::Value> mRv;
+    Matcher(JSContext* aCx, JS::MutableHandle<JS::Value> aRv) : mCx(aCx), mRv(aRv) {}
+    
+    bool operator()(const nsString& aVal) {
+      return ToJSVal<nsString>(mCx, aVal, mRv);
+    }
+
+    bool operator()(const BerytusEncryptedPacket& aVal) {
+      return ToJSVal<BerytusEncryptedPacket>(mCx, aVal, mRv);
+    }
+
+    bool operator()(const BerytusKeyFieldValue& aVal) {
+      return ToJSVal<BerytusKeyFieldValue>(mCx, aVal, mRv);
+    }
 
+    bool operator()(const BerytusSecurePasswordFieldValue& aVal) {
+      return ToJSVal<BerytusSecurePasswordFieldValue>(mCx, aVal, mRv);
+    }
+
+    bool operator()(const BerytusSharedKeyFieldValue& aVal) {
+      return ToJSVal<BerytusSharedKeyFieldValue>(mCx, aVal, mRv);
+    }
 
+    bool operator()(const Nothing& aVal) {
+      return ToJSVal<Nothing>(mCx, aVal, mRv);
+    }
+  };
+  return aValue.InternalValue()->match(Matcher(aCx, aRv));
+}
 template<>
-bool JSValIs<ApproveChallengeRequestArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+bool JSValIs<RejectFieldValueArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
   if (!aValue.isObject()) {
     aRv = false;
     return true;
@@ -11251,10 +11692,34 @@ bool JSValIs<ApproveChallengeRequestArgs>(JSContext *aCx, const JS::Handle<JS::V
   bool isValid = false;
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "challenge", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "fieldId", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(JSValIs<SafeVariant<BerytusIdentificationChallengeInfo, BerytusPasswordChallengeInfo, BerytusDigitalSignatureChallengeInfo, BerytusSecureRemotePasswordChallengeInfo, BerytusOffChannelOtpChallengeInfo>>(aCx, propVal, isValid)))) {
+  if (NS_WARN_IF(!(JSValIs<nsString>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "reason", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<FieldValueRejectionReason>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "optionalNewValue", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>>(aCx, propVal, isValid)))) {
     return false;
   }
   if (!isValid) {
@@ -11268,36 +11733,137 @@ bool JSValIs<ApproveChallengeRequestArgs>(JSContext *aCx, const JS::Handle<JS::V
 
 }
 template<>
-bool FromJSVal<ApproveChallengeRequestArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, ApproveChallengeRequestArgs& aRv) {
+bool FromJSVal<RejectFieldValueArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, RejectFieldValueArgs& aRv) {
   if (NS_WARN_IF(!aValue.isObject())) {
     return false;
   }
   JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
   JS::Rooted<JS::Value> propVal(aCx);
   
-  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "challenge", &propVal))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "fieldId", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!(FromJSVal<SafeVariant<BerytusIdentificationChallengeInfo, BerytusPasswordChallengeInfo, BerytusDigitalSignatureChallengeInfo, BerytusSecureRemotePasswordChallengeInfo, BerytusOffChannelOtpChallengeInfo>>(aCx, propVal, aRv.mChallenge)))) {
+  if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, propVal, aRv.mFieldId)))) {
     return false;
   }
   
-  return true;
-}
-            
-template<>
-bool ToJSVal<ApproveChallengeRequestArgs>(JSContext* aCx, const ApproveChallengeRequestArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
-  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
-  
-  JS::Rooted<JS::Value> memberVal0(aCx);
-  if (NS_WARN_IF(!aValue.mChallenge.Inited())) {
-    return false;
-  }
-  if (NS_WARN_IF(!(ToJSVal<SafeVariant<BerytusIdentificationChallengeInfo, BerytusPasswordChallengeInfo, BerytusDigitalSignatureChallengeInfo, BerytusSecureRemotePasswordChallengeInfo, BerytusOffChannelOtpChallengeInfo>>(aCx, aValue.mChallenge, &memberVal0)))) {
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "reason", &propVal))) {
     return false;
   }
-  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "challenge", memberVal0))) {
+  if (NS_WARN_IF(!(FromJSVal<FieldValueRejectionReason>(aCx, propVal, aRv.mReason)))) {
+    return false;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "optionalNewValue", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>>(aCx, propVal, aRv.mOptionalNewValue)))) {
+    return false;
+  }
+  
+  return true;
+}
+            
+template<>
+bool ToJSVal<RejectFieldValueArgs>(JSContext* aCx, const RejectFieldValueArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
+
+  
+  JS::Rooted<JS::Value> memberVal0(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<nsString>(aCx, aValue.mFieldId, &memberVal0)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "fieldId", memberVal0))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal1(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<FieldValueRejectionReason>(aCx, aValue.mReason, &memberVal1)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "reason", memberVal1))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal2(aCx);
+  if (NS_WARN_IF(!aValue.mOptionalNewValue.Inited())) {
+    return false;
+  }
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<nsString, BerytusEncryptedPacket, BerytusKeyFieldValue, BerytusSecurePasswordFieldValue, BerytusSharedKeyFieldValue, Nothing>>(aCx, aValue.mOptionalNewValue, &memberVal2)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "optionalNewValue", memberVal2))) {
+    return false;
+  }
+  
+  aRv.setObject(*obj);
+  return true;
+}
+
+
+template<>
+bool JSValIs<ApproveChallengeRequestArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
+    aRv = false;
+    return true;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isValid = false;
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "challenge", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<BerytusIdentificationChallengeInfo, BerytusPasswordChallengeInfo, BerytusDigitalSignatureChallengeInfo, BerytusSecureRemotePasswordChallengeInfo, BerytusOffChannelOtpChallengeInfo>>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+  aRv = true;
+  return true;
+
+
+}
+template<>
+bool FromJSVal<ApproveChallengeRequestArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, ApproveChallengeRequestArgs& aRv) {
+  if (NS_WARN_IF(!aValue.isObject())) {
+    return false;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "challenge", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<BerytusIdentificationChallengeInfo, BerytusPasswordChallengeInfo, BerytusDigitalSignatureChallengeInfo, BerytusSecureRemotePasswordChallengeInfo, BerytusOffChannelOtpChallengeInfo>>(aCx, propVal, aRv.mChallenge)))) {
+    return false;
+  }
+  
+  return true;
+}
+            
+template<>
+bool ToJSVal<ApproveChallengeRequestArgs>(JSContext* aCx, const ApproveChallengeRequestArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
+
+  
+  JS::Rooted<JS::Value> memberVal0(aCx);
+  if (NS_WARN_IF(!aValue.mChallenge.Inited())) {
+    return false;
+  }
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<BerytusIdentificationChallengeInfo, BerytusPasswordChallengeInfo, BerytusDigitalSignatureChallengeInfo, BerytusSecureRemotePasswordChallengeInfo, BerytusOffChannelOtpChallengeInfo>>(aCx, aValue.mChallenge, &memberVal0)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "challenge", memberVal0))) {
     return false;
   }
   
@@ -14946,17 +15512,717 @@ bool ToJSVal<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, Beryt
       return ToJSVal<BerytusChallengeComputeClientProofMessageResponse>(mCx, aVal, mRv);
     }
 
-    bool operator()(const BerytusChallengeVerifyServerProofMessageResponse& aVal) {
-      return ToJSVal<BerytusChallengeVerifyServerProofMessageResponse>(mCx, aVal, mRv);
-    }
+    bool operator()(const BerytusChallengeVerifyServerProofMessageResponse& aVal) {
+      return ToJSVal<BerytusChallengeVerifyServerProofMessageResponse>(mCx, aVal, mRv);
+    }
+
+    bool operator()(const BerytusChallengeGetOtpMessageResponse& aVal) {
+      return ToJSVal<BerytusChallengeGetOtpMessageResponse>(mCx, aVal, mRv);
+    }
+  };
+  return aValue.InternalValue()->match(Matcher(aCx, aRv));
+}
+
+
+template<>
+bool JSValIs<ApproveOperationAndSnapshotArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
+    aRv = false;
+    return true;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isValid = false;
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "operation", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<LoginOperationMetadata>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "userAttributeProjection", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<Maybe<nsTArray<nsString>>>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+  aRv = true;
+  return true;
+
+
+}
+template<>
+bool FromJSVal<ApproveOperationAndSnapshotArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, ApproveOperationAndSnapshotArgs& aRv) {
+  if (NS_WARN_IF(!aValue.isObject())) {
+    return false;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "operation", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<LoginOperationMetadata>(aCx, propVal, aRv.mOperation)))) {
+    return false;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "userAttributeProjection", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<Maybe<nsTArray<nsString>>>(aCx, propVal, aRv.mUserAttributeProjection)))) {
+    return false;
+  }
+  
+  return true;
+}
+            
+template<>
+bool ToJSVal<ApproveOperationAndSnapshotArgs>(JSContext* aCx, const ApproveOperationAndSnapshotArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
+
+  
+  JS::Rooted<JS::Value> memberVal0(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<LoginOperationMetadata>(aCx, aValue.mOperation, &memberVal0)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "operation", memberVal0))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal1(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<Maybe<nsTArray<nsString>>>(aCx, aValue.mUserAttributeProjection, &memberVal1)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "userAttributeProjection", memberVal1))) {
+    return false;
+  }
+  
+  aRv.setObject(*obj);
+  return true;
+}
+
+template<>
+bool JSValIs<Maybe<RecordMetadata>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (aValue.isUndefined()) {
+    aRv = true;
+    return true;
+  }
+  return JSValIs<RecordMetadata>(aCx, aValue, aRv);
+}
+template<>
+bool FromJSVal<Maybe<RecordMetadata>>(JSContext* aCx, const JS::Handle<JS::Value> aValue, Maybe<RecordMetadata>& aRv) {
+  if (aValue.isUndefined()) {
+    aRv.reset();
+    return true;
+  }
+  aRv.emplace();
+  if (NS_WARN_IF(!(FromJSVal<RecordMetadata>(aCx, aValue, *aRv)))) {
+    return false;
+  }
+  return true;
+}
+template<>
+bool ToJSVal<Maybe<RecordMetadata>>(JSContext* aCx, const Maybe<RecordMetadata>& aValue, JS::MutableHandle<JS::Value> aRv) {
+  if (!aValue) {
+    aRv.setUndefined();
+    return true;
+  }
+
+  return ToJSVal<RecordMetadata>(aCx, aValue.ref(), aRv);
+}
+template<>
+bool JSValIs<Maybe<nsTArray<UserAttribute>>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (aValue.isUndefined()) {
+    aRv = true;
+    return true;
+  }
+  return JSValIs<nsTArray<UserAttribute>>(aCx, aValue, aRv);
+}
+template<>
+bool FromJSVal<Maybe<nsTArray<UserAttribute>>>(JSContext* aCx, const JS::Handle<JS::Value> aValue, Maybe<nsTArray<UserAttribute>>& aRv) {
+  if (aValue.isUndefined()) {
+    aRv.reset();
+    return true;
+  }
+  aRv.emplace();
+  if (NS_WARN_IF(!(FromJSVal<nsTArray<UserAttribute>>(aCx, aValue, *aRv)))) {
+    return false;
+  }
+  return true;
+}
+template<>
+bool ToJSVal<Maybe<nsTArray<UserAttribute>>>(JSContext* aCx, const Maybe<nsTArray<UserAttribute>>& aValue, JS::MutableHandle<JS::Value> aRv) {
+  if (!aValue) {
+    aRv.setUndefined();
+    return true;
+  }
+
+  return ToJSVal<nsTArray<UserAttribute>>(aCx, aValue.ref(), aRv);
+}
+template<>
+bool JSValIs<UserAttributeInfo>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
+    aRv = false;
+    return true;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isValid = false;
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "id", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<SafeVariant<StaticString0, StaticString1, StaticString2, StaticString3, StaticString4, StaticString5, StaticString6, StaticString7, StaticString8, StaticString9, StaticString10, StaticString11, StaticString12, nsString>>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "info", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<Maybe<nsString>>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "mimeType", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<Maybe<nsString>>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+  aRv = true;
+  return true;
+
+
+}
+template<>
+bool FromJSVal<UserAttributeInfo>(JSContext* aCx, JS::Handle<JS::Value> aValue, UserAttributeInfo& aRv) {
+  if (NS_WARN_IF(!aValue.isObject())) {
+    return false;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "id", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<SafeVariant<StaticString0, StaticString1, StaticString2, StaticString3, StaticString4, StaticString5, StaticString6, StaticString7, StaticString8, StaticString9, StaticString10, StaticString11, StaticString12, nsString>>(aCx, propVal, aRv.mId)))) {
+    return false;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "info", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<Maybe<nsString>>(aCx, propVal, aRv.mInfo)))) {
+    return false;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "mimeType", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<Maybe<nsString>>(aCx, propVal, aRv.mMimeType)))) {
+    return false;
+  }
+  
+  return true;
+}
+            
+template<>
+bool ToJSVal<UserAttributeInfo>(JSContext* aCx, const UserAttributeInfo& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
+
+  
+  JS::Rooted<JS::Value> memberVal0(aCx);
+  if (NS_WARN_IF(!aValue.mId.Inited())) {
+    return false;
+  }
+  if (NS_WARN_IF(!(ToJSVal<SafeVariant<StaticString0, StaticString1, StaticString2, StaticString3, StaticString4, StaticString5, StaticString6, StaticString7, StaticString8, StaticString9, StaticString10, StaticString11, StaticString12, nsString>>(aCx, aValue.mId, &memberVal0)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "id", memberVal0))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal1(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<Maybe<nsString>>(aCx, aValue.mInfo, &memberVal1)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "info", memberVal1))) {
+    return false;
+  }
+  
+
+  JS::Rooted<JS::Value> memberVal2(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<Maybe<nsString>>(aCx, aValue.mMimeType, &memberVal2)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "mimeType", memberVal2))) {
+    return false;
+  }
+  
+  aRv.setObject(*obj);
+  return true;
+}
+
+template<>
+bool JSValIs<nsTArray<UserAttributeInfo>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS::IsArrayObject(aCx, aValue, &aRv))) {
+    return false;
+  }
+  // TODO(berytus): What about the values inside the array?
+  return true;
+}
+template<>
+bool FromJSVal<nsTArray<UserAttributeInfo>>(JSContext* aCx, const JS::Handle<JS::Value> aValue, nsTArray<UserAttributeInfo>& aRv) {
+  if (NS_WARN_IF(!aValue.isObject())) {
+    return false;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isArray;
+  if (NS_WARN_IF(!JS::IsArrayObject(aCx, obj, &isArray))) {
+    return false;
+  }
+  if (NS_WARN_IF(!isArray)) {
+    return false;
+  }
+  uint32_t length;
+  if (NS_WARN_IF(!JS::GetArrayLength(aCx, obj, &length))) {
+    return false;
+  }
+  for (uint32_t i = 0; i < length; i++) {
+    JS::Rooted<JS::Value> value(aCx);
+
+    if (NS_WARN_IF(!JS_GetElement(aCx, obj, i, &value))) {
+      return false;
+    }
+
+    UserAttributeInfo item;
+    if (NS_WARN_IF(!(FromJSVal<UserAttributeInfo>(aCx, value, item)))) {
+      return false;
+    }
+    aRv.AppendElement(std::move(item));
+  }
+  return true;
+}
+template<>
+bool ToJSVal<nsTArray<UserAttributeInfo>>(JSContext* aCx, const nsTArray<UserAttributeInfo>& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSObject*> array(aCx, JS::NewArrayObject(aCx, 0));
+
+  for (uint32_t i = 0; i < aValue.Length(); i++) {
+    const UserAttributeInfo& item = aValue.ElementAt(i);
+
+    JS::Rooted<JS::Value> value(aCx);
+    if (NS_WARN_IF(!(ToJSVal<UserAttributeInfo>(aCx, item, &value)))) {
+      return false;
+    }
+    if (NS_WARN_IF(!JS_DefineElement(aCx, array, i, value, JSPROP_ENUMERATE))) {
+      return false;
+    }
+  }
+  aRv.setObject(*array);
+  return true;
+}
+
+template<>
+bool JSValIs<Maybe<nsTArray<UserAttributeInfo>>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (aValue.isUndefined()) {
+    aRv = true;
+    return true;
+  }
+  return JSValIs<nsTArray<UserAttributeInfo>>(aCx, aValue, aRv);
+}
+template<>
+bool FromJSVal<Maybe<nsTArray<UserAttributeInfo>>>(JSContext* aCx, const JS::Handle<JS::Value> aValue, Maybe<nsTArray<UserAttributeInfo>>& aRv) {
+  if (aValue.isUndefined()) {
+    aRv.reset();
+    return true;
+  }
+  aRv.emplace();
+  if (NS_WARN_IF(!(FromJSVal<nsTArray<UserAttributeInfo>>(aCx, aValue, *aRv)))) {
+    return false;
+  }
+  return true;
+}
+template<>
+bool ToJSVal<Maybe<nsTArray<UserAttributeInfo>>>(JSContext* aCx, const Maybe<nsTArray<UserAttributeInfo>>& aValue, JS::MutableHandle<JS::Value> aRv) {
+  if (!aValue) {
+    aRv.setUndefined();
+    return true;
+  }
+
+  return ToJSVal<nsTArray<UserAttributeInfo>>(aCx, aValue.ref(), aRv);
+}
+template<>
+bool JSValIs<OperationSnapshot>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
+    aRv = false;
+    return true;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isValid = false;
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "intent", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<ELoginUserIntent>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "metadata", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<Maybe<RecordMetadata>>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "userAttributes", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<Maybe<nsTArray<UserAttribute>>>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "unloadedUserAttributes", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<Maybe<nsTArray<UserAttributeInfo>>>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+  aRv = true;
+  return true;
+
+
+}
+template<>
+bool FromJSVal<OperationSnapshot>(JSContext* aCx, JS::Handle<JS::Value> aValue, OperationSnapshot& aRv) {
+  if (NS_WARN_IF(!aValue.isObject())) {
+    return false;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "intent", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<ELoginUserIntent>(aCx, propVal, aRv.mIntent)))) {
+    return false;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "metadata", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<Maybe<RecordMetadata>>(aCx, propVal, aRv.mMetadata)))) {
+    return false;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "userAttributes", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<Maybe<nsTArray<UserAttribute>>>(aCx, propVal, aRv.mUserAttributes)))) {
+    return false;
+  }
+  
+
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "unloadedUserAttributes", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<Maybe<nsTArray<UserAttributeInfo>>>(aCx, propVal, aRv.mUnloadedUserAttributes)))) {
+    return false;
+  }
+  
+  return true;
+}
+            
+template<>
+bool ToJSVal<OperationSnapshot>(JSContext* aCx, const OperationSnapshot& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
+
+  
+  JS::Rooted<JS::Value> memberVal0(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<ELoginUserIntent>(aCx, aValue.mIntent, &memberVal0)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "intent", memberVal0))) {
+    return false;
+  }
+  
+  JS::Rooted<JS::Value> memberVal1(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<Maybe<RecordMetadata>>(aCx, aValue.mMetadata, &memberVal1)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "metadata", memberVal1))) {
+    return false;
+  }
+  
+  JS::Rooted<JS::Value> memberVal2(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<Maybe<nsTArray<UserAttribute>>>(aCx, aValue.mUserAttributes, &memberVal2)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "userAttributes", memberVal2))) {
+    return false;
+  }
+  
+  JS::Rooted<JS::Value> memberVal3(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<Maybe<nsTArray<UserAttributeInfo>>>(aCx, aValue.mUnloadedUserAttributes, &memberVal3)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "unloadedUserAttributes", memberVal3))) {
+    return false;
+  }
+  
+  aRv.setObject(*obj);
+  return true;
+}
+
+template<>
+bool JSValIs<nsTArray<SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS::IsArrayObject(aCx, aValue, &aRv))) {
+    return false;
+  }
+  // TODO(berytus): What about the values inside the array?
+  return true;
+}
+template<>
+bool FromJSVal<nsTArray<SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>>>(JSContext* aCx, const JS::Handle<JS::Value> aValue, nsTArray<SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>>& aRv) {
+  if (NS_WARN_IF(!aValue.isObject())) {
+    return false;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isArray;
+  if (NS_WARN_IF(!JS::IsArrayObject(aCx, obj, &isArray))) {
+    return false;
+  }
+  if (NS_WARN_IF(!isArray)) {
+    return false;
+  }
+  uint32_t length;
+  if (NS_WARN_IF(!JS::GetArrayLength(aCx, obj, &length))) {
+    return false;
+  }
+  for (uint32_t i = 0; i < length; i++) {
+    JS::Rooted<JS::Value> value(aCx);
+
+    if (NS_WARN_IF(!JS_GetElement(aCx, obj, i, &value))) {
+      return false;
+    }
+
+    SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage> item;
+    if (NS_WARN_IF(!(FromJSVal<SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>>(aCx, value, item)))) {
+      return false;
+    }
+    aRv.AppendElement(std::move(item));
+  }
+  return true;
+}
+template<>
+bool ToJSVal<nsTArray<SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>>>(JSContext* aCx, const nsTArray<SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>>& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSObject*> array(aCx, JS::NewArrayObject(aCx, 0));
+
+  for (uint32_t i = 0; i < aValue.Length(); i++) {
+    const SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>& item = aValue.ElementAt(i);
+
+    JS::Rooted<JS::Value> value(aCx);
+    if (NS_WARN_IF(!(ToJSVal<SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>>(aCx, item, &value)))) {
+      return false;
+    }
+    if (NS_WARN_IF(!JS_DefineElement(aCx, array, i, value, JSPROP_ENUMERATE))) {
+      return false;
+    }
+  }
+  aRv.setObject(*array);
+  return true;
+}
+
+template<>
+bool JSValIs<nsTArray<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS::IsArrayObject(aCx, aValue, &aRv))) {
+    return false;
+  }
+  // TODO(berytus): What about the values inside the array?
+  return true;
+}
+template<>
+bool FromJSVal<nsTArray<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>>(JSContext* aCx, const JS::Handle<JS::Value> aValue, nsTArray<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>& aRv) {
+  if (NS_WARN_IF(!aValue.isObject())) {
+    return false;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isArray;
+  if (NS_WARN_IF(!JS::IsArrayObject(aCx, obj, &isArray))) {
+    return false;
+  }
+  if (NS_WARN_IF(!isArray)) {
+    return false;
+  }
+  uint32_t length;
+  if (NS_WARN_IF(!JS::GetArrayLength(aCx, obj, &length))) {
+    return false;
+  }
+  for (uint32_t i = 0; i < length; i++) {
+    JS::Rooted<JS::Value> value(aCx);
+
+    if (NS_WARN_IF(!JS_GetElement(aCx, obj, i, &value))) {
+      return false;
+    }
+
+    SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse> item;
+    if (NS_WARN_IF(!(FromJSVal<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>(aCx, value, item)))) {
+      return false;
+    }
+    aRv.AppendElement(std::move(item));
+  }
+  return true;
+}
+template<>
+bool ToJSVal<nsTArray<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>>(JSContext* aCx, const nsTArray<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSObject*> array(aCx, JS::NewArrayObject(aCx, 0));
+
+  for (uint32_t i = 0; i < aValue.Length(); i++) {
+    const SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>& item = aValue.ElementAt(i);
+
+    JS::Rooted<JS::Value> value(aCx);
+    if (NS_WARN_IF(!(ToJSVal<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>(aCx, item, &value)))) {
+      return false;
+    }
+    if (NS_WARN_IF(!JS_DefineElement(aCx, array, i, value, JSPROP_ENUMERATE))) {
+      return false;
+    }
+  }
+  aRv.setObject(*array);
+  return true;
+}
+
+template<>
+bool JSValIs<GetUserAttributeValuesArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv) {
+  if (!aValue.isObject()) {
+    aRv = false;
+    return true;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  bool isValid = false;
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "ids", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(JSValIs<nsTArray<nsString>>(aCx, propVal, isValid)))) {
+    return false;
+  }
+  if (!isValid) {
+    aRv = false;
+    return true;
+  }
+  
+  aRv = true;
+  return true;
+
 
-    bool operator()(const BerytusChallengeGetOtpMessageResponse& aVal) {
-      return ToJSVal<BerytusChallengeGetOtpMessageResponse>(mCx, aVal, mRv);
-    }
-  };
-  return aValue.InternalValue()->match(Matcher(aCx, aRv));
 }
+template<>
+bool FromJSVal<GetUserAttributeValuesArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, GetUserAttributeValuesArgs& aRv) {
+  if (NS_WARN_IF(!aValue.isObject())) {
+    return false;
+  }
+  JS::Rooted<JSObject*> obj(aCx, &aValue.toObject());
+  JS::Rooted<JS::Value> propVal(aCx);
+  
+  if (NS_WARN_IF(!JS_GetProperty(aCx, obj, "ids", &propVal))) {
+    return false;
+  }
+  if (NS_WARN_IF(!(FromJSVal<nsTArray<nsString>>(aCx, propVal, aRv.mIds)))) {
+    return false;
+  }
+  
+  return true;
+}
+            
+template<>
+bool ToJSVal<GetUserAttributeValuesArgs>(JSContext* aCx, const GetUserAttributeValuesArgs& aValue, JS::MutableHandle<JS::Value> aRv) {
+  JS::Rooted<JSObject*> obj(aCx, JS_NewPlainObject(aCx));
 
+  
+  JS::Rooted<JS::Value> memberVal0(aCx);
+  
+  if (NS_WARN_IF(!(ToJSVal<nsTArray<nsString>>(aCx, aValue.mIds, &memberVal0)))) {
+    return false;
+  }
+  if (NS_WARN_IF(!JS_SetProperty(aCx, obj, "ids", memberVal0))) {
+    return false;
+  }
+  
+  aRv.setObject(*obj);
+  return true;
+}
 
 RefPtr<ManagerGetSigningKeyResult> AgentProxy::Manager_GetSigningKey(const PreliminaryRequestContext& aContext, const GetSigningKeyArgs& aArgs) {
   RefPtr<ManagerGetSigningKeyResult::Private> outPromise = new ManagerGetSigningKeyResult::Private(__func__);
@@ -15097,6 +16363,54 @@ RefPtr<ChannelCreateChannelResult> AgentProxy::Channel_CreateChannel(const Preli
   }
   return outPromise;
 }
+RefPtr<ChannelBootstrapChannelResult> AgentProxy::Channel_BootstrapChannel(const PreliminaryRequestContext& aContext, const BootstrapChannelArgs& aArgs) {
+  RefPtr<ChannelBootstrapChannelResult::Private> outPromise = new ChannelBootstrapChannelResult::Private(__func__);
+  dom::AutoEntryScript aes(mGlobal, "AgentProxy messaging interface");
+  JSContext* cx = aes.cx();
+
+  ErrorResult err;
+  RefPtr<dom::Promise> prom = CallSendQuery(cx,
+                                            u"channel"_ns,
+                                            u"bootstrapChannel"_ns,
+                                            aContext,
+                                            &aArgs,
+                                            err);
+  if (NS_WARN_IF(err.Failed())) {
+    outPromise->Reject(Failure(err.StealNSResult()), __func__);
+    return outPromise;
+  }
+  auto onResolve = [outPromise](JSContext* aCx, JS::Handle<JS::Value> aValue,
+                      ErrorResult& aRv,
+                      const nsCOMPtr<nsIGlobalObject>& aGlobal) {
+    MOZ_LOG(sLogger, LogLevel::Debug, ("Channel_BootstrapChannel:onResolve()"));
+    nsString out;
+    if (NS_WARN_IF(!(FromJSVal<nsString>(aCx, aValue, out)))) {
+      outPromise->Reject(Failure(), __func__);
+    } else {
+      outPromise->Resolve(std::move(out), __func__);
+    }
+    
+    return dom::Promise::CreateResolvedWithUndefined(aGlobal, aRv);
+  };
+  auto onReject = [outPromise](JSContext* aCx, JS::Handle<JS::Value> aValue,
+                     ErrorResult& aRv,
+                     const nsCOMPtr<nsIGlobalObject>& aGlobal) {
+    MOZ_LOG(sLogger, LogLevel::Debug, ("Channel_BootstrapChannel:onReject()"));
+    Failure fr;
+    FromJSVal(aCx, aValue, fr);
+    outPromise->Reject(std::move(fr), __func__);
+    return dom::Promise::CreateResolvedWithUndefined(aGlobal, aRv);
+  };
+  Result<RefPtr<dom::Promise>, nsresult> thenRes =
+    prom->ThenCatchWithCycleCollectedArgs(std::move(onResolve), std::move(onReject), nsCOMPtr{mGlobal});
+  if (NS_WARN_IF(thenRes.isErr())) {
+    outPromise->Reject(Failure(), __func__);
+  } else {
+    MOZ_ASSERT(thenRes.unwrap());
+    prom->AppendNativeHandler(new MozPromiseRejectWithBerytusFailureOnDestruction(outPromise, __func__));
+  }
+  return outPromise;
+}
 RefPtr<ChannelGenerateX25519KeyResult> AgentProxy::Channel_GenerateX25519Key(const RequestContext& aContext) {
   RefPtr<ChannelGenerateX25519KeyResult::Private> outPromise = new ChannelGenerateX25519KeyResult::Private(__func__);
   dom::AutoEntryScript aes(mGlobal, "AgentProxy messaging interface");
@@ -15193,6 +16507,54 @@ RefPtr<ChannelSignKeyExchangeParametersResult> AgentProxy::Channel_SignKeyExchan
   }
   return outPromise;
 }
+RefPtr<ChannelEstablishEndToEndEncryptionResult> AgentProxy::Channel_EstablishEndToEndEncryption(const RequestContext& aContext, const SignKeyAgreementParametersArgs& aArgs) {
+  RefPtr<ChannelEstablishEndToEndEncryptionResult::Private> outPromise = new ChannelEstablishEndToEndEncryptionResult::Private(__func__);
+  dom::AutoEntryScript aes(mGlobal, "AgentProxy messaging interface");
+  JSContext* cx = aes.cx();
+
+  ErrorResult err;
+  RefPtr<dom::Promise> prom = CallSendQuery(cx,
+                                            u"channel"_ns,
+                                            u"establishEndToEndEncryption"_ns,
+                                            aContext,
+                                            &aArgs,
+                                            err);
+  if (NS_WARN_IF(err.Failed())) {
+    outPromise->Reject(Failure(err.StealNSResult()), __func__);
+    return outPromise;
+  }
+  auto onResolve = [outPromise](JSContext* aCx, JS::Handle<JS::Value> aValue,
+                      ErrorResult& aRv,
+                      const nsCOMPtr<nsIGlobalObject>& aGlobal) {
+    MOZ_LOG(sLogger, LogLevel::Debug, ("Channel_EstablishEndToEndEncryption:onResolve()"));
+    SignKeyAgreementParametersResult out;
+    if (NS_WARN_IF(!(FromJSVal<SignKeyAgreementParametersResult>(aCx, aValue, out)))) {
+      outPromise->Reject(Failure(), __func__);
+    } else {
+      outPromise->Resolve(std::move(out), __func__);
+    }
+    
+    return dom::Promise::CreateResolvedWithUndefined(aGlobal, aRv);
+  };
+  auto onReject = [outPromise](JSContext* aCx, JS::Handle<JS::Value> aValue,
+                     ErrorResult& aRv,
+                     const nsCOMPtr<nsIGlobalObject>& aGlobal) {
+    MOZ_LOG(sLogger, LogLevel::Debug, ("Channel_EstablishEndToEndEncryption:onReject()"));
+    Failure fr;
+    FromJSVal(aCx, aValue, fr);
+    outPromise->Reject(std::move(fr), __func__);
+    return dom::Promise::CreateResolvedWithUndefined(aGlobal, aRv);
+  };
+  Result<RefPtr<dom::Promise>, nsresult> thenRes =
+    prom->ThenCatchWithCycleCollectedArgs(std::move(onResolve), std::move(onReject), nsCOMPtr{mGlobal});
+  if (NS_WARN_IF(thenRes.isErr())) {
+    outPromise->Reject(Failure(), __func__);
+  } else {
+    MOZ_ASSERT(thenRes.unwrap());
+    prom->AppendNativeHandler(new MozPromiseRejectWithBerytusFailureOnDestruction(outPromise, __func__));
+  }
+  return outPromise;
+}
 RefPtr<ChannelVerifySignedKeyExchangeParametersResult> AgentProxy::Channel_VerifySignedKeyExchangeParameters(const RequestContext& aContext, const VerifySignedKeyExchangeParametersArgs& aArgs) {
   RefPtr<ChannelVerifySignedKeyExchangeParametersResult::Private> outPromise = new ChannelVerifySignedKeyExchangeParametersResult::Private(__func__);
   dom::AutoEntryScript aes(mGlobal, "AgentProxy messaging interface");
@@ -15911,5 +17273,149 @@ RefPtr<AccountAuthenticationRespondToChallengeMessageResult> AgentProxy::Account
   }
   return outPromise;
 }
+RefPtr<LoginApproveOperationAndSnapshotResult> AgentProxy::Login_ApproveOperationAndSnapshot(const RequestContext& aContext, const ApproveOperationAndSnapshotArgs& aArgs) {
+  RefPtr<LoginApproveOperationAndSnapshotResult::Private> outPromise = new LoginApproveOperationAndSnapshotResult::Private(__func__);
+  dom::AutoEntryScript aes(mGlobal, "AgentProxy messaging interface");
+  JSContext* cx = aes.cx();
+
+  ErrorResult err;
+  RefPtr<dom::Promise> prom = CallSendQuery(cx,
+                                            u"login"_ns,
+                                            u"approveOperationAndSnapshot"_ns,
+                                            aContext,
+                                            &aArgs,
+                                            err);
+  if (NS_WARN_IF(err.Failed())) {
+    outPromise->Reject(Failure(err.StealNSResult()), __func__);
+    return outPromise;
+  }
+  auto onResolve = [outPromise](JSContext* aCx, JS::Handle<JS::Value> aValue,
+                      ErrorResult& aRv,
+                      const nsCOMPtr<nsIGlobalObject>& aGlobal) {
+    MOZ_LOG(sLogger, LogLevel::Debug, ("Login_ApproveOperationAndSnapshot:onResolve()"));
+    OperationSnapshot out;
+    if (NS_WARN_IF(!(FromJSVal<OperationSnapshot>(aCx, aValue, out)))) {
+      outPromise->Reject(Failure(), __func__);
+    } else {
+      outPromise->Resolve(std::move(out), __func__);
+    }
+    
+    return dom::Promise::CreateResolvedWithUndefined(aGlobal, aRv);
+  };
+  auto onReject = [outPromise](JSContext* aCx, JS::Handle<JS::Value> aValue,
+                     ErrorResult& aRv,
+                     const nsCOMPtr<nsIGlobalObject>& aGlobal) {
+    MOZ_LOG(sLogger, LogLevel::Debug, ("Login_ApproveOperationAndSnapshot:onReject()"));
+    Failure fr;
+    FromJSVal(aCx, aValue, fr);
+    outPromise->Reject(std::move(fr), __func__);
+    return dom::Promise::CreateResolvedWithUndefined(aGlobal, aRv);
+  };
+  Result<RefPtr<dom::Promise>, nsresult> thenRes =
+    prom->ThenCatchWithCycleCollectedArgs(std::move(onResolve), std::move(onReject), nsCOMPtr{mGlobal});
+  if (NS_WARN_IF(thenRes.isErr())) {
+    outPromise->Reject(Failure(), __func__);
+  } else {
+    MOZ_ASSERT(thenRes.unwrap());
+    prom->AppendNativeHandler(new MozPromiseRejectWithBerytusFailureOnDestruction(outPromise, __func__));
+  }
+  return outPromise;
+}
+RefPtr<AccountAuthenticationRespondToChallengeMessagesResult> AgentProxy::AccountAuthentication_RespondToChallengeMessages(const RequestContextWithLoginOperation& aContext, const nsTArray<SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>>& aArgs) {
+  RefPtr<AccountAuthenticationRespondToChallengeMessagesResult::Private> outPromise = new AccountAuthenticationRespondToChallengeMessagesResult::Private(__func__);
+  dom::AutoEntryScript aes(mGlobal, "AgentProxy messaging interface");
+  JSContext* cx = aes.cx();
+
+  ErrorResult err;
+  RefPtr<dom::Promise> prom = CallSendQuery(cx,
+                                            u"accountAuthentication"_ns,
+                                            u"respondToChallengeMessages"_ns,
+                                            aContext,
+                                            &aArgs,
+                                            err);
+  if (NS_WARN_IF(err.Failed())) {
+    outPromise->Reject(Failure(err.StealNSResult()), __func__);
+    return outPromise;
+  }
+  auto onResolve = [outPromise](JSContext* aCx, JS::Handle<JS::Value> aValue,
+                      ErrorResult& aRv,
+                      const nsCOMPtr<nsIGlobalObject>& aGlobal) {
+    MOZ_LOG(sLogger, LogLevel::Debug, ("AccountAuthentication_RespondToChallengeMessages:onResolve()"));
+    nsTArray<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>> out;
+    if (NS_WARN_IF(!(FromJSVal<nsTArray<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>>(aCx, aValue, out)))) {
+      outPromise->Reject(Failure(), __func__);
+    } else {
+      outPromise->Resolve(std::move(out), __func__);
+    }
+    
+    return dom::Promise::CreateResolvedWithUndefined(aGlobal, aRv);
+  };
+  auto onReject = [outPromise](JSContext* aCx, JS::Handle<JS::Value> aValue,
+                     ErrorResult& aRv,
+                     const nsCOMPtr<nsIGlobalObject>& aGlobal) {
+    MOZ_LOG(sLogger, LogLevel::Debug, ("AccountAuthentication_RespondToChallengeMessages:onReject()"));
+    Failure fr;
+    FromJSVal(aCx, aValue, fr);
+    outPromise->Reject(std::move(fr), __func__);
+    return dom::Promise::CreateResolvedWithUndefined(aGlobal, aRv);
+  };
+  Result<RefPtr<dom::Promise>, nsresult> thenRes =
+    prom->ThenCatchWithCycleCollectedArgs(std::move(onResolve), std::move(onReject), nsCOMPtr{mGlobal});
+  if (NS_WARN_IF(thenRes.isErr())) {
+    outPromise->Reject(Failure(), __func__);
+  } else {
+    MOZ_ASSERT(thenRes.unwrap());
+    prom->AppendNativeHandler(new MozPromiseRejectWithBerytusFailureOnDestruction(outPromise, __func__));
+  }
+  return outPromise;
+}
+
+RefPtr<AccountCreationGetUserAttributeValuesResult> AgentProxy::AccountCreation_GetUserAttributeValues(const RequestContextWithLoginOperation& aContext, const GetUserAttributeValuesArgs& aArgs) {
+  RefPtr<AccountCreationGetUserAttributeValuesResult::Private> outPromise = new AccountCreationGetUserAttributeValuesResult::Private(__func__);
+  dom::AutoEntryScript aes(mGlobal, "AgentProxy messaging interface");
+  JSContext* cx = aes.cx();
 
+  ErrorResult err;
+  RefPtr<dom::Promise> prom = CallSendQuery(cx,
+                                            u"accountCreation"_ns,
+                                            u"getUserAttributeValues"_ns,
+                                            aContext,
+                                            &aArgs,
+                                            err);
+  if (NS_WARN_IF(err.Failed())) {
+    outPromise->Reject(Failure(err.StealNSResult()), __func__);
+    return outPromise;
+  }
+  auto onResolve = [outPromise](JSContext* aCx, JS::Handle<JS::Value> aValue,
+                      ErrorResult& aRv,
+                      const nsCOMPtr<nsIGlobalObject>& aGlobal) {
+    MOZ_LOG(sLogger, LogLevel::Debug, ("AccountCreation_GetUserAttributeValues:onResolve()"));
+    nsTArray<UserAttribute> out;
+    if (NS_WARN_IF(!(FromJSVal<nsTArray<UserAttribute>>(aCx, aValue, out)))) {
+      outPromise->Reject(Failure(), __func__);
+    } else {
+      outPromise->Resolve(std::move(out), __func__);
+    }
+    
+    return dom::Promise::CreateResolvedWithUndefined(aGlobal, aRv);
+  };
+  auto onReject = [outPromise](JSContext* aCx, JS::Handle<JS::Value> aValue,
+                     ErrorResult& aRv,
+                     const nsCOMPtr<nsIGlobalObject>& aGlobal) {
+    MOZ_LOG(sLogger, LogLevel::Debug, ("AccountCreation_GetUserAttributeValues:onReject()"));
+    Failure fr;
+    FromJSVal(aCx, aValue, fr);
+    outPromise->Reject(std::move(fr), __func__);
+    return dom::Promise::CreateResolvedWithUndefined(aGlobal, aRv);
+  };
+  Result<RefPtr<dom::Promise>, nsresult> thenRes =
+    prom->ThenCatchWithCycleCollectedArgs(std::move(onResolve), std::move(onReject), nsCOMPtr{mGlobal});
+  if (NS_WARN_IF(thenRes.isErr())) {
+    outPromise->Reject(Failure(), __func__);
+  } else {
+    MOZ_ASSERT(thenRes.unwrap());
+    prom->AppendNativeHandler(new MozPromiseRejectWithBerytusFailureOnDestruction(outPromise, __func__));
+  }
+  return outPromise;
+}
 }  // namespace mozilla::berytus
\ No newline at end of file
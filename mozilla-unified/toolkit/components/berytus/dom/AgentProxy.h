@@ -9,9 +9,13 @@
 #include "nsCycleCollectionParticipant.h"
 #include "nsIGlobalObject.h"
 #include "mozilla/dom/TypedArray.h" // ArrayBuffer
+#include "mozilla/dom/Blob.h"
+#include "mozilla/Maybe.h"
 #include "mozilla/Variant.h"
 #include "mozilla/dom/DOMException.h" // for Failure's Exception
 #include "mozilla/Logging.h"
+#include "mozilla/MemoryReporting.h"
+#include "mozilla/TimeStamp.h"
 #include "mozilla/dom/Record.h"
 #include "mozilla/dom/PromiseNativeHandler.h"
 
@@ -21,6 +25,7 @@ namespace mozilla::berytus {
 
 using ArrayBuffer = mozilla::dom::ArrayBuffer;
 using ArrayBufferView = mozilla::dom::ArrayBufferView;
+using Blob = mozilla::dom::Blob;
 template <typename K, typename V>
 using Record = mozilla::dom::Record<K, V>;
 
@@ -231,7 +236,7 @@ struct Failure {
   RefPtr<mozilla::dom::Exception> mException;
 
   Failure() : Failure(NS_ERROR_FAILURE) {}
-  Failure(nsresult res) : mException(new mozilla::dom::Exception(BERYTUS_AGENT_DEFAULT_EXCEPTION_MESSAGE, NS_ERROR_FAILURE, BERYTUS_AGENT_DEFAULT_EXCEPTION_NAME)) {}
+  Failure(nsresult res) : mException(new mozilla::dom::Exception(BERYTUS_AGENT_DEFAULT_EXCEPTION_MESSAGE, res, BERYTUS_AGENT_DEFAULT_EXCEPTION_NAME)) {}
 
   ErrorResult ToErrorResult() const;
 };
@@ -416,6 +421,29 @@ bool FromJSVal<CreateChannelArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue,
 template<>
 bool ToJSVal<CreateChannelArgs>(JSContext* aCx, const CreateChannelArgs& aValue, JS::MutableHandle<JS::Value> aRv);
 using ChannelCreateChannelResult = MozPromise<void*, Failure, true>;
+struct BootstrapChannelArgs {
+  nsString mChannelId;
+  ChannelConstraints mConstraints;
+  SafeVariant<CryptoActor, OriginActor> mWebAppActor;
+  BootstrapChannelArgs() = default;
+  BootstrapChannelArgs(nsString&& aChannelId, ChannelConstraints&& aConstraints, SafeVariant<CryptoActor, OriginActor>&& aWebAppActor) : mChannelId(std::move(aChannelId)), mConstraints(std::move(aConstraints)), mWebAppActor(std::move(aWebAppActor)) {}
+  BootstrapChannelArgs(BootstrapChannelArgs&& aOther) : mChannelId(std::move(aOther.mChannelId)), mConstraints(std::move(aOther.mConstraints)), mWebAppActor(std::move(aOther.mWebAppActor))  {}
+  BootstrapChannelArgs& operator=(BootstrapChannelArgs&& aOther) {
+    mChannelId = std::move(aOther.mChannelId);
+  mConstraints = std::move(aOther.mConstraints);
+  mWebAppActor = std::move(aOther.mWebAppActor);
+    return *this;
+  }
+  
+  ~BootstrapChannelArgs() {}
+};
+template<>
+bool JSValIs<BootstrapChannelArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+template<>
+bool FromJSVal<BootstrapChannelArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, BootstrapChannelArgs& aRv);
+template<>
+bool ToJSVal<BootstrapChannelArgs>(JSContext* aCx, const BootstrapChannelArgs& aValue, JS::MutableHandle<JS::Value> aRv);
+using ChannelBootstrapChannelResult = MozPromise<nsString, Failure, true>;
 struct RequestContext {
   ChannelMetadata mChannel;
   DocumentMetadata mDocument;
@@ -455,15 +483,19 @@ bool FromJSVal<GenerateX25519KeyResult>(JSContext* aCx, JS::Handle<JS::Value> aV
 template<>
 bool ToJSVal<GenerateX25519KeyResult>(JSContext* aCx, const GenerateX25519KeyResult& aValue, JS::MutableHandle<JS::Value> aRv);
 using ChannelGenerateX25519KeyResult = MozPromise<GenerateX25519KeyResult, Failure, true>;
+template<>
+bool JSValIs<ArrayBuffer>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+template<>
+bool FromJSVal<ArrayBuffer>(JSContext* aCx, JS::Handle<JS::Value> aValue, ArrayBuffer& aRv);
+template<>
+bool ToJSVal<ArrayBuffer>(JSContext* aCx, const ArrayBuffer& aValue, JS::MutableHandle<JS::Value> aRv);
 struct SignKeyAgreementParametersArgs {
   nsString mCanonicalJson;
+  ArrayBuffer mWebAppSignature;
   SignKeyAgreementParametersArgs() = default;
-  SignKeyAgreementParametersArgs(nsString&& aCanonicalJson) : mCanonicalJson(std::move(aCanonicalJson)) {}
-  SignKeyAgreementParametersArgs(SignKeyAgreementParametersArgs&& aOther) : mCanonicalJson(std::move(aOther.mCanonicalJson))  {}
-  SignKeyAgreementParametersArgs& operator=(SignKeyAgreementParametersArgs&& aOther) {
-    mCanonicalJson = std::move(aOther.mCanonicalJson);
-    return *this;
-  }
+  SignKeyAgreementParametersArgs(nsString&& aCanonicalJson, ArrayBuffer&& aWebAppSignature) : mCanonicalJson(std::move(aCanonicalJson)), mWebAppSignature(std::move(aWebAppSignature)) {}
+  SignKeyAgreementParametersArgs(SignKeyAgreementParametersArgs&& aOther) : mCanonicalJson(std::move(aOther.mCanonicalJson)), mWebAppSignature(std::move(aOther.mWebAppSignature))  {}
+  
   
   ~SignKeyAgreementParametersArgs() {}
 };
@@ -473,12 +505,6 @@ template<>
 bool FromJSVal<SignKeyAgreementParametersArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, SignKeyAgreementParametersArgs& aRv);
 template<>
 bool ToJSVal<SignKeyAgreementParametersArgs>(JSContext* aCx, const SignKeyAgreementParametersArgs& aValue, JS::MutableHandle<JS::Value> aRv);
-template<>
-bool JSValIs<ArrayBuffer>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
-template<>
-bool FromJSVal<ArrayBuffer>(JSContext* aCx, JS::Handle<JS::Value> aValue, ArrayBuffer& aRv);
-template<>
-bool ToJSVal<ArrayBuffer>(JSContext* aCx, const ArrayBuffer& aValue, JS::MutableHandle<JS::Value> aRv);
 struct SignKeyAgreementParametersResult {
   ArrayBuffer mScmSignature;
   SignKeyAgreementParametersResult() = default;
@@ -495,6 +521,7 @@ bool FromJSVal<SignKeyAgreementParametersResult>(JSContext* aCx, JS::Handle<JS::
 template<>
 bool ToJSVal<SignKeyAgreementParametersResult>(JSContext* aCx, const SignKeyAgreementParametersResult& aValue, JS::MutableHandle<JS::Value> aRv);
 using ChannelSignKeyExchangeParametersResult = MozPromise<SignKeyAgreementParametersResult, Failure, true>;
+using ChannelEstablishEndToEndEncryptionResult = MozPromise<SignKeyAgreementParametersResult, Failure, true>;
 struct VerifySignedKeyExchangeParametersArgs {
   nsString mCanonicalJson;
   ArrayBuffer mWebAppSignature;
@@ -1790,35 +1817,37 @@ template<>
 bool FromJSVal<SafeVariant<ArrayBuffer, ArrayBufferView, Nothing>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<ArrayBuffer, ArrayBufferView, Nothing>& aRv);
 template<>
 bool ToJSVal<SafeVariant<ArrayBuffer, ArrayBufferView, Nothing>>(JSContext* aCx, const SafeVariant<ArrayBuffer, ArrayBufferView, Nothing>& aValue, JS::MutableHandle<JS::Value> aRv);
-struct AesGcmParams {
+struct BerytusEncryptionParams {
+  Maybe<double> mChunkSize;
   SafeVariant<ArrayBuffer, ArrayBufferView> mIv;
   SafeVariant<ArrayBuffer, ArrayBufferView, Nothing> mAdditionalData;
   Maybe<double> mTagLength;
   nsString mName;
-  AesGcmParams() = default;
-  AesGcmParams(SafeVariant<ArrayBuffer, ArrayBufferView>&& aIv, SafeVariant<ArrayBuffer, ArrayBufferView, Nothing>&& aAdditionalData, Maybe<double>&& aTagLength, nsString&& aName) : mIv(std::move(aIv)), mAdditionalData(std::move(aAdditionalData)), mTagLength(std::move(aTagLength)), mName(std::move(aName)) {}
-  AesGcmParams(AesGcmParams&& aOther) : mIv(std::move(aOther.mIv)), mAdditionalData(std::move(aOther.mAdditionalData)), mTagLength(std::move(aOther.mTagLength)), mName(std::move(aOther.mName))  {}
-  AesGcmParams& operator=(AesGcmParams&& aOther) {
-    mIv = std::move(aOther.mIv);
+  BerytusEncryptionParams() = default;
+  BerytusEncryptionParams(Maybe<double>&& aChunkSize, SafeVariant<ArrayBuffer, ArrayBufferView>&& aIv, SafeVariant<ArrayBuffer, ArrayBufferView, Nothing>&& aAdditionalData, Maybe<double>&& aTagLength, nsString&& aName) : mChunkSize(std::move(aChunkSize)), mIv(std::move(aIv)), mAdditionalData(std::move(aAdditionalData)), mTagLength(std::move(aTagLength)), mName(std::move(aName)) {}
+  BerytusEncryptionParams(BerytusEncryptionParams&& aOther) : mChunkSize(std::move(aOther.mChunkSize)), mIv(std::move(aOther.mIv)), mAdditionalData(std::move(aOther.mAdditionalData)), mTagLength(std::move(aOther.mTagLength)), mName(std::move(aOther.mName))  {}
+  BerytusEncryptionParams& operator=(BerytusEncryptionParams&& aOther) {
+    mChunkSize = std::move(aOther.mChunkSize);
+  mIv = std::move(aOther.mIv);
   mAdditionalData = std::move(aOther.mAdditionalData);
   mTagLength = std::move(aOther.mTagLength);
   mName = std::move(aOther.mName);
     return *this;
   }
   
-  ~AesGcmParams() {}
+  ~BerytusEncryptionParams() {}
 };
 template<>
-bool JSValIs<AesGcmParams>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+bool JSValIs<BerytusEncryptionParams>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
 template<>
-bool FromJSVal<AesGcmParams>(JSContext* aCx, JS::Handle<JS::Value> aValue, AesGcmParams& aRv);
+bool FromJSVal<BerytusEncryptionParams>(JSContext* aCx, JS::Handle<JS::Value> aValue, BerytusEncryptionParams& aRv);
 template<>
-bool ToJSVal<AesGcmParams>(JSContext* aCx, const AesGcmParams& aValue, JS::MutableHandle<JS::Value> aRv);
+bool ToJSVal<BerytusEncryptionParams>(JSContext* aCx, const BerytusEncryptionParams& aValue, JS::MutableHandle<JS::Value> aRv);
 struct BerytusEncryptedPacket {
-  AesGcmParams mParameters;
+  BerytusEncryptionParams mParameters;
   ArrayBuffer mCiphertext;
   BerytusEncryptedPacket() = default;
-  BerytusEncryptedPacket(AesGcmParams&& aParameters, ArrayBuffer&& aCiphertext) : mParameters(std::move(aParameters)), mCiphertext(std::move(aCiphertext)) {}
+  BerytusEncryptedPacket(BerytusEncryptionParams&& aParameters, ArrayBuffer&& aCiphertext) : mParameters(std::move(aParameters)), mCiphertext(std::move(aCiphertext)) {}
   BerytusEncryptedPacket(BerytusEncryptedPacket&& aOther) : mParameters(std::move(aOther.mParameters)), mCiphertext(std::move(aOther.mCiphertext))  {}
   
   
@@ -1865,13 +1894,54 @@ template<>
 bool FromJSVal<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, BerytusEncryptedPacket>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<nsString, ArrayBuffer, ArrayBufferView, BerytusEncryptedPacket>& aRv);
 template<>
 bool ToJSVal<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, BerytusEncryptedPacket>>(JSContext* aCx, const SafeVariant<nsString, ArrayBuffer, ArrayBufferView, BerytusEncryptedPacket>& aValue, JS::MutableHandle<JS::Value> aRv);
+template<>
+bool JSValIs<RefPtr<Blob>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+template<>
+bool FromJSVal<RefPtr<Blob>>(JSContext* aCx, JS::Handle<JS::Value> aValue, RefPtr<Blob>& aRv);
+template<>
+bool ToJSVal<RefPtr<Blob>>(JSContext* aCx, const RefPtr<Blob>& aValue, JS::MutableHandle<JS::Value> aRv);
+template<>
+class SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket> {
+public:
+  SafeVariant() : mVariant(nullptr) {}
+  SafeVariant(SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>&& aOther) : mVariant(std::move(aOther.mVariant)) {
+    aOther.mVariant = nullptr;
+  }
+  SafeVariant& operator=(SafeVariant&& aOther) {
+    mVariant = std::move(aOther.mVariant);
+    aOther.mVariant = nullptr;
+    return *this;
+  }
+  ~SafeVariant() {
+    delete mVariant;
+  };
+  template <typename... Args>
+  void Init(Args&&... aTs) {
+    MOZ_ASSERT(!mVariant);
+    mVariant = new Variant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>(std::forward<Args>(aTs)...);
+  }
+  bool Inited() const {
+    return mVariant;
+  }
+  mozilla::Variant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket> const* InternalValue() const { return mVariant; }
+  mozilla::Variant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>* InternalValue() { return mVariant; }
+  
+protected:
+  mozilla::Variant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>* mVariant;
+};
+template<>
+bool JSValIs<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+template<>
+bool FromJSVal<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>>(JSContext* aCx, JS::Handle<JS::Value> aValue, SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>& aRv);
+template<>
+bool ToJSVal<SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>>(JSContext* aCx, const SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>& aValue, JS::MutableHandle<JS::Value> aRv);
 struct UserAttribute {
   SafeVariant<StaticString0, StaticString1, StaticString2, StaticString3, StaticString4, StaticString5, StaticString6, StaticString7, StaticString8, StaticString9, StaticString10, StaticString11, StaticString12, nsString> mId;
   Maybe<nsString> mInfo;
   Maybe<nsString> mMimeType;
-  SafeVariant<nsString, ArrayBuffer, ArrayBufferView, BerytusEncryptedPacket> mValue;
+  SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket> mValue;
   UserAttribute() = default;
-  UserAttribute(SafeVariant<StaticString0, StaticString1, StaticString2, StaticString3, StaticString4, StaticString5, StaticString6, StaticString7, StaticString8, StaticString9, StaticString10, StaticString11, StaticString12, nsString>&& aId, Maybe<nsString>&& aInfo, Maybe<nsString>&& aMimeType, SafeVariant<nsString, ArrayBuffer, ArrayBufferView, BerytusEncryptedPacket>&& aValue) : mId(std::move(aId)), mInfo(std::move(aInfo)), mMimeType(std::move(aMimeType)), mValue(std::move(aValue)) {}
+  UserAttribute(SafeVariant<StaticString0, StaticString1, StaticString2, StaticString3, StaticString4, StaticString5, StaticString6, StaticString7, StaticString8, StaticString9, StaticString10, StaticString11, StaticString12, nsString>&& aId, Maybe<nsString>&& aInfo, Maybe<nsString>&& aMimeType, SafeVariant<nsString, ArrayBuffer, ArrayBufferView, RefPtr<Blob>, BerytusEncryptedPacket>&& aValue) : mId(std::move(aId)), mInfo(std::move(aInfo)), mMimeType(std::move(aMimeType)), mValue(std::move(aValue)) {}
   UserAttribute(UserAttribute&& aOther) : mId(std::move(aOther.mId)), mInfo(std::move(aOther.mInfo)), mMimeType(std::move(aOther.mMimeType)), mValue(std::move(aOther.mValue))  {}
   UserAttribute& operator=(UserAttribute&& aOther) {
     mId = std::move(aOther.mId);
@@ -3492,6 +3562,138 @@ bool FromJSVal<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, Ber
 template<>
 bool ToJSVal<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>(JSContext* aCx, const SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>& aValue, JS::MutableHandle<JS::Value> aRv);
 using AccountAuthenticationRespondToChallengeMessageResult = MozPromise<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>, Failure, true>;
+struct ApproveOperationAndSnapshotArgs {
+  LoginOperationMetadata mOperation;
+  Maybe<nsTArray<nsString>> mUserAttributeProjection;
+  ApproveOperationAndSnapshotArgs() = default;
+  ApproveOperationAndSnapshotArgs(LoginOperationMetadata&& aOperation, Maybe<nsTArray<nsString>>&& aUserAttributeProjection) : mOperation(std::move(aOperation)), mUserAttributeProjection(std::move(aUserAttributeProjection)) {}
+  ApproveOperationAndSnapshotArgs(ApproveOperationAndSnapshotArgs&& aOther) : mOperation(std::move(aOther.mOperation)), mUserAttributeProjection(std::move(aOther.mUserAttributeProjection))  {}
+  ApproveOperationAndSnapshotArgs& operator=(ApproveOperationAndSnapshotArgs&& aOther) {
+    mOperation = std::move(aOther.mOperation);
+  mUserAttributeProjection = std::move(aOther.mUserAttributeProjection);
+    return *this;
+  }
+  
+  ~ApproveOperationAndSnapshotArgs() {}
+};
+template<>
+bool JSValIs<ApproveOperationAndSnapshotArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+template<>
+bool FromJSVal<ApproveOperationAndSnapshotArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, ApproveOperationAndSnapshotArgs& aRv);
+template<>
+bool ToJSVal<ApproveOperationAndSnapshotArgs>(JSContext* aCx, const ApproveOperationAndSnapshotArgs& aValue, JS::MutableHandle<JS::Value> aRv);
+template<>
+bool JSValIs<Maybe<RecordMetadata>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+template<>
+bool FromJSVal<Maybe<RecordMetadata>>(JSContext* aCx, const JS::Handle<JS::Value> aValue, Maybe<RecordMetadata>& aRv);
+template<>
+bool ToJSVal<Maybe<RecordMetadata>>(JSContext* aCx, const Maybe<RecordMetadata>& aValue, JS::MutableHandle<JS::Value> aRv);
+template<>
+bool JSValIs<Maybe<nsTArray<UserAttribute>>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+template<>
+bool FromJSVal<Maybe<nsTArray<UserAttribute>>>(JSContext* aCx, const JS::Handle<JS::Value> aValue, Maybe<nsTArray<UserAttribute>>& aRv);
+template<>
+bool ToJSVal<Maybe<nsTArray<UserAttribute>>>(JSContext* aCx, const Maybe<nsTArray<UserAttribute>>& aValue, JS::MutableHandle<JS::Value> aRv);
+struct UserAttributeInfo {
+  SafeVariant<StaticString0, StaticString1, StaticString2, StaticString3, StaticString4, StaticString5, StaticString6, StaticString7, StaticString8, StaticString9, StaticString10, StaticString11, StaticString12, nsString> mId;
+  Maybe<nsString> mInfo;
+  Maybe<nsString> mMimeType;
+  UserAttributeInfo() = default;
+  UserAttributeInfo(SafeVariant<StaticString0, StaticString1, StaticString2, StaticString3, StaticString4, StaticString5, StaticString6, StaticString7, StaticString8, StaticString9, StaticString10, StaticString11, StaticString12, nsString>&& aId, Maybe<nsString>&& aInfo, Maybe<nsString>&& aMimeType) : mId(std::move(aId)), mInfo(std::move(aInfo)), mMimeType(std::move(aMimeType)) {}
+  UserAttributeInfo(UserAttributeInfo&& aOther) : mId(std::move(aOther.mId)), mInfo(std::move(aOther.mInfo)), mMimeType(std::move(aOther.mMimeType))  {}
+  UserAttributeInfo& operator=(UserAttributeInfo&& aOther) {
+    mId = std::move(aOther.mId);
+  mInfo = std::move(aOther.mInfo);
+  mMimeType = std::move(aOther.mMimeType);
+    return *this;
+  }
+  
+  ~UserAttributeInfo() {}
+};
+template<>
+bool JSValIs<UserAttributeInfo>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+template<>
+bool FromJSVal<UserAttributeInfo>(JSContext* aCx, JS::Handle<JS::Value> aValue, UserAttributeInfo& aRv);
+template<>
+bool ToJSVal<UserAttributeInfo>(JSContext* aCx, const UserAttributeInfo& aValue, JS::MutableHandle<JS::Value> aRv);
+template<>
+bool JSValIs<nsTArray<UserAttributeInfo>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+template<>
+bool FromJSVal<nsTArray<UserAttributeInfo>>(JSContext* aCx, const JS::Handle<JS::Value> aValue, nsTArray<UserAttributeInfo>& aRv);
+template<>
+bool ToJSVal<nsTArray<UserAttributeInfo>>(JSContext* aCx, const nsTArray<UserAttributeInfo>& aValue, JS::MutableHandle<JS::Value> aRv);
+template<>
+bool JSValIs<Maybe<nsTArray<UserAttributeInfo>>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+template<>
+bool FromJSVal<Maybe<nsTArray<UserAttributeInfo>>>(JSContext* aCx, const JS::Handle<JS::Value> aValue, Maybe<nsTArray<UserAttributeInfo>>& aRv);
+template<>
+bool ToJSVal<Maybe<nsTArray<UserAttributeInfo>>>(JSContext* aCx, const Maybe<nsTArray<UserAttributeInfo>>& aValue, JS::MutableHandle<JS::Value> aRv);
+struct OperationSnapshot {
+  ELoginUserIntent mIntent;
+  Maybe<RecordMetadata> mMetadata;
+  Maybe<nsTArray<UserAttribute>> mUserAttributes;
+  Maybe<nsTArray<UserAttributeInfo>> mUnloadedUserAttributes;
+  OperationSnapshot() = default;
+  OperationSnapshot(ELoginUserIntent&& aIntent, Maybe<RecordMetadata>&& aMetadata, Maybe<nsTArray<UserAttribute>>&& aUserAttributes, Maybe<nsTArray<UserAttributeInfo>>&& aUnloadedUserAttributes) : mIntent(std::move(aIntent)), mMetadata(std::move(aMetadata)), mUserAttributes(std::move(aUserAttributes)), mUnloadedUserAttributes(std::move(aUnloadedUserAttributes)) {}
+  OperationSnapshot(OperationSnapshot&& aOther) : mIntent(std::move(aOther.mIntent)), mMetadata(std::move(aOther.mMetadata)), mUserAttributes(std::move(aOther.mUserAttributes)), mUnloadedUserAttributes(std::move(aOther.mUnloadedUserAttributes))  {}
+  OperationSnapshot& operator=(OperationSnapshot&& aOther) {
+    mIntent = std::move(aOther.mIntent);
+  mMetadata = std::move(aOther.mMetadata);
+  mUserAttributes = std::move(aOther.mUserAttributes);
+  mUnloadedUserAttributes = std::move(aOther.mUnloadedUserAttributes);
+    return *this;
+  }
+  
+  ~OperationSnapshot() {}
+};
+template<>
+bool JSValIs<OperationSnapshot>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+template<>
+bool FromJSVal<OperationSnapshot>(JSContext* aCx, JS::Handle<JS::Value> aValue, OperationSnapshot& aRv);
+template<>
+bool ToJSVal<OperationSnapshot>(JSContext* aCx, const OperationSnapshot& aValue, JS::MutableHandle<JS::Value> aRv);
+using LoginApproveOperationAndSnapshotResult = MozPromise<OperationSnapshot, Failure, true>;
+template<>
+bool JSValIs<nsTArray<SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+template<>
+bool FromJSVal<nsTArray<SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>>>(JSContext* aCx, const JS::Handle<JS::Value> aValue, nsTArray<SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>>& aRv);
+template<>
+bool ToJSVal<nsTArray<SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>>>(JSContext* aCx, const nsTArray<SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>>& aValue, JS::MutableHandle<JS::Value> aRv);
+template<>
+bool JSValIs<nsTArray<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+template<>
+bool FromJSVal<nsTArray<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>>(JSContext* aCx, const JS::Handle<JS::Value> aValue, nsTArray<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>& aRv);
+template<>
+bool ToJSVal<nsTArray<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>>(JSContext* aCx, const nsTArray<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>& aValue, JS::MutableHandle<JS::Value> aRv);
+using AccountAuthenticationRespondToChallengeMessagesResult = MozPromise<nsTArray<SafeVariant<BerytusChallengeGetIdentityFieldsMessageResponse, BerytusChallengeGetPasswordFieldsMessageResponse, BerytusChallengeSelectKeyMessageResponse, BerytusChallengeSignNonceMessageResponse, BerytusChallengeSelectSecurePasswordMessageResponse, BerytusChallengeExchangePublicKeysMessageResponse, BerytusChallengeComputeClientProofMessageResponse, BerytusChallengeVerifyServerProofMessageResponse, BerytusChallengeGetOtpMessageResponse>>, Failure, true>;
+struct GetUserAttributeValuesArgs {
+  nsTArray<nsString> mIds;
+  GetUserAttributeValuesArgs() = default;
+  GetUserAttributeValuesArgs(nsTArray<nsString>&& aIds) : mIds(std::move(aIds)) {}
+  GetUserAttributeValuesArgs(GetUserAttributeValuesArgs&& aOther) : mIds(std::move(aOther.mIds))  {}
+  GetUserAttributeValuesArgs& operator=(GetUserAttributeValuesArgs&& aOther) {
+    mIds = std::move(aOther.mIds);
+    return *this;
+  }
+  
+  ~GetUserAttributeValuesArgs() {}
+};
+template<>
+bool JSValIs<GetUserAttributeValuesArgs>(JSContext *aCx, const JS::Handle<JS::Value> aValue, bool& aRv);
+template<>
+bool FromJSVal<GetUserAttributeValuesArgs>(JSContext* aCx, JS::Handle<JS::Value> aValue, GetUserAttributeValuesArgs& aRv);
+template<>
+bool ToJSVal<GetUserAttributeValuesArgs>(JSContext* aCx, const GetUserAttributeValuesArgs& aValue, JS::MutableHandle<JS::Value> aRv);
+using AccountCreationGetUserAttributeValuesResult = MozPromise<nsTArray<UserAttribute>, Failure, true>;
+
+/**
+ * Per-agent overrides of the request timeouts, in milliseconds;
+ * 0 disables the timeout.
+ */
+struct RequestTimeouts {
+  Maybe<uint32_t> mRequestTimeoutMs;
+  Maybe<uint32_t> mInteractiveRequestTimeoutMs;
+};
 
 class AgentProxy : public nsISupports {
   NS_DECL_CYCLE_COLLECTING_ISUPPORTS
@@ -3500,6 +3702,52 @@ class AgentProxy : public nsISupports {
 public:
   AgentProxy(nsIGlobalObject* aGlobal, const nsAString& aManagerId);
   bool IsDisabled() const;
+  /**
+   * Whether a query was sent and has not settled yet.
+   */
+  bool HasPendingQueries() const;
+  /**
+   * The number of queries that were sent and have not settled yet.
+   */
+  uint32_t PendingQueryCount() const;
+  /**
+   * When a query was last sent or settled.
+   */
+  TimeStamp LastActivity() const;
+  /**
+   * Asks the parent to cancel the pending queries; the secret
+   * manager is notified and the queries are rejected with
+   * NS_BINDING_ABORTED.
+   */
+  void CancelPendingQueries();
+  /**
+   * Same as CancelPendingQueries(), for the passed queries only;
+   * those that have settled already are skipped.
+   */
+  void CancelQueries(const nsTArray<nsString>& aRequestIds);
+  /**
+   * Appends the ids of the queries sent while in scope to
+   * aRequestIds, so that an operation sharing the agent with
+   * others can cancel its own queries, see CancelQueries().
+   */
+  class MOZ_RAII AutoRecordQueries final {
+  public:
+    AutoRecordQueries(AgentProxy& aAgent, nsTArray<nsString>& aRequestIds);
+    ~AutoRecordQueries();
+
+  private:
+    AgentProxy& mAgent;
+  };
+  /**
+   * Overrides the dom.berytus.agent.request_timeout_ms and
+   * dom.berytus.agent.interactive_request_timeout_ms defaults.
+   */
+  void SetRequestTimeouts(const RequestTimeouts& aTimeouts);
+  /**
+   * The pending queries' MozPromises are held by their JS promise
+   * handlers and are not measured; see PendingQueryCount().
+   */
+  size_t SizeOfIncludingThis(MallocSizeOf aMallocSizeOf) const;
 
   template <typename W1, typename W2>
   already_AddRefed<dom::Promise> CallSendQuery(JSContext *aCx,
@@ -3521,13 +3769,33 @@ protected:
   nsCOMPtr<nsIGlobalObject> mGlobal;
   nsString mManagerId;
   bool mDisabled;
+  /**
+   * The ids of the queries that were sent and have not settled yet.
+   */
+  nsTArray<nsString> mPendingRequestIds;
+  /**
+   * Set while an AutoRecordQueries is in scope.
+   */
+  nsTArray<nsString>* mQueryRecorder;
+  TimeStamp mLastActivity;
+  RequestTimeouts mRequestTimeouts;
+
+  void QuerySettled(const nsAString& aRequestId);
+  /**
+   * The time the secret manager is given to settle the query,
+   * in milliseconds; 0 if unbounded.
+   */
+  uint32_t RequestTimeoutMs(const nsAString& aGroup,
+                            const nsAString& aMethod) const;
 
 public:
   RefPtr<ManagerGetSigningKeyResult> Manager_GetSigningKey(const PreliminaryRequestContext& aContext, const GetSigningKeyArgs& aArgs);
   RefPtr<ManagerGetCredentialsMetadataResult> Manager_GetCredentialsMetadata(const PreliminaryRequestContext& aContext, const GetCredentialsMetadataArgs& aArgs);
   RefPtr<ChannelCreateChannelResult> Channel_CreateChannel(const PreliminaryRequestContext& aContext, const CreateChannelArgs& aArgs);
+  RefPtr<ChannelBootstrapChannelResult> Channel_BootstrapChannel(const PreliminaryRequestContext& aContext, const BootstrapChannelArgs& aArgs);
   RefPtr<ChannelGenerateX25519KeyResult> Channel_GenerateX25519Key(const RequestContext& aContext);
   RefPtr<ChannelSignKeyExchangeParametersResult> Channel_SignKeyExchangeParameters(const RequestContext& aContext, const SignKeyAgreementParametersArgs& aArgs);
+  RefPtr<ChannelEstablishEndToEndEncryptionResult> Channel_EstablishEndToEndEncryption(const RequestContext& aContext, const SignKeyAgreementParametersArgs& aArgs);
   RefPtr<ChannelVerifySignedKeyExchangeParametersResult> Channel_VerifySignedKeyExchangeParameters(const RequestContext& aContext, const VerifySignedKeyExchangeParametersArgs& aArgs);
   RefPtr<ChannelEnableEndToEndEncryptionResult> Channel_EnableEndToEndEncryption(const RequestContext& aContext);
   RefPtr<ChannelCloseChannelResult> Channel_CloseChannel(const RequestContext& aContext);
@@ -3544,6 +3812,9 @@ public:
   RefPtr<AccountAuthenticationAbortChallengeResult> AccountAuthentication_AbortChallenge(const RequestContextWithOperation& aContext, const AbortChallengeArgs& aArgs);
   RefPtr<AccountAuthenticationCloseChallengeResult> AccountAuthentication_CloseChallenge(const RequestContextWithOperation& aContext, const CloseChallengeArgs& aArgs);
   RefPtr<AccountAuthenticationRespondToChallengeMessageResult> AccountAuthentication_RespondToChallengeMessage(const RequestContextWithLoginOperation& aContext, const SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>& aArgs);
+  RefPtr<LoginApproveOperationAndSnapshotResult> Login_ApproveOperationAndSnapshot(const RequestContext& aContext, const ApproveOperationAndSnapshotArgs& aArgs);
+  RefPtr<AccountAuthenticationRespondToChallengeMessagesResult> AccountAuthentication_RespondToChallengeMessages(const RequestContextWithLoginOperation& aContext, const nsTArray<SafeVariant<BerytusSendGetIdentityFieldsMessage, BerytusSendGetPasswordFieldsMessage, BerytusSendSelectKeyMessage, BerytusSendSignNonceMessage, BerytusSendSelectSecurePasswordMessage, BerytusSendExchangePublicKeysMessage, BerytusSendComputeClientProofMessage, BerytusSendVerifyServerProofMessage, BerytusSendGetOtpMessage>>& aArgs);
+  RefPtr<AccountCreationGetUserAttributeValuesResult> AccountCreation_GetUserAttributeValues(const RequestContextWithLoginOperation& aContext, const GetUserAttributeValuesArgs& aArgs);
 
 };
 
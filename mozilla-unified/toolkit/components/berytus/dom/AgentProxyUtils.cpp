@@ -8,6 +8,8 @@
 #include "ErrorList.h"
 #include "js/Value.h"
 #include "mozilla/AlreadyAddRefed.h"
+#include "mozilla/FloatingPoint.h"
+#include "mozilla/UniquePtr.h"
 #include "mozilla/berytus/AgentProxy.h"
 #include "mozilla/dom/BerytusBuffer.h"
 #include "mozilla/dom/BerytusChallengeBinding.h"
@@ -40,6 +42,7 @@
 #include "mozilla/dom/BerytusChallenge.h"
 #include "mozilla/dom/BerytusSecureRemotePasswordChallenge.h"
 #include "mozilla/dom/Document.h"
+#include "mozilla/dom/WebCryptoCommon.h" // WEBCRYPTO_ALG_AES_GCM
 
 namespace mozilla::berytus {
 
@@ -69,41 +72,46 @@ nsresult Utils_ChannelMetadata(nsIGlobalObject* aGlobal, const RefPtr<const dom:
                                aRetVal);
 }
 
-nsresult Utils_ChannelMetadata(nsIGlobalObject* aGlobal,
-                               const nsString& aChannelId,
-                               const dom::BerytusChannelConstraints& aCts,
-                               const RefPtr<const dom::BerytusWebAppActor>& aWebAppActor,
-                               const RefPtr<const dom::BerytusSecretManagerActor>& aScmActor,
-                               berytus::ChannelMetadata& aRetVal) {
-  aRetVal.mId.Assign(aChannelId);
+static void Utils_ChannelConstraints(const dom::BerytusChannelConstraints& aCts,
+                                     berytus::ChannelConstraints& aRetVal) {
   if (aCts.mAccount.WasPassed()) {
-    aRetVal.mConstraints.mAccount.emplace();
+    aRetVal.mAccount.emplace();
     if (aCts.mAccount.Value().mCategory.WasPassed()) {
-      aRetVal.mConstraints.mAccount->mCategory.emplace(aCts.mAccount.Value().mCategory.Value());
+      aRetVal.mAccount->mCategory.emplace(aCts.mAccount.Value().mCategory.Value());
     }
     if (aCts.mAccount.Value().mSchemaVersion.WasPassed()) {
-      aRetVal.mConstraints.mAccount->mSchemaVersion.emplace(aCts.mAccount.Value().mSchemaVersion.Value());
+      aRetVal.mAccount->mSchemaVersion.emplace(aCts.mAccount.Value().mSchemaVersion.Value());
     }
     if (aCts.mAccount.Value().mIdentity.WasPassed()) {
-      aRetVal.mConstraints.mAccount->mIdentity.emplace();
+      aRetVal.mAccount->mIdentity.emplace();
       for (const auto& identity : aCts.mAccount.Value().mIdentity.Value().Entries()) {
         PartialAccountIdentity entry;
         entry.mFieldId.Assign(identity.mKey);
         entry.mFieldValue.Assign(identity.mValue);
-        aRetVal.mConstraints.mAccount->mIdentity->AppendElement(std::move(entry));
+        aRetVal.mAccount->mIdentity->AppendElement(std::move(entry));
       }
     }
   }
   if (aCts.mEnableEndToEndEncryption.WasPassed()) {
-    aRetVal.mConstraints.mEnableEndToEndEncryption =
+    aRetVal.mEnableEndToEndEncryption =
     aCts.mEnableEndToEndEncryption.Value();
   }
   if (aCts.mSecretManagerPublicKey.WasPassed()) {
-    aRetVal.mConstraints.mSecretManagerPublicKey.emplace();
+    aRetVal.mSecretManagerPublicKey.emplace();
     for (const auto& key : aCts.mSecretManagerPublicKey.Value()) {
-      aRetVal.mConstraints.mSecretManagerPublicKey->AppendElement(nsString(key));
+      aRetVal.mSecretManagerPublicKey->AppendElement(nsString(key));
     }
   }
+}
+
+nsresult Utils_ChannelMetadata(nsIGlobalObject* aGlobal,
+                               const nsString& aChannelId,
+                               const dom::BerytusChannelConstraints& aCts,
+                               const RefPtr<const dom::BerytusWebAppActor>& aWebAppActor,
+                               const RefPtr<const dom::BerytusSecretManagerActor>& aScmActor,
+                               berytus::ChannelMetadata& aRetVal) {
+  aRetVal.mId.Assign(aChannelId);
+  Utils_ChannelConstraints(aCts, aRetVal.mConstraints);
   nsresult rv;
   rv = berytus::Utils_WebAppActorToVariant(aWebAppActor, aRetVal.mWebAppActor);
   if (NS_WARN_IF(NS_FAILED(rv))) {
@@ -114,6 +122,21 @@ nsresult Utils_ChannelMetadata(nsIGlobalObject* aGlobal,
   return NS_OK;
 }
 
+nsresult Utils_BootstrapChannelArgs(const nsString& aChannelId,
+                                    const dom::BerytusChannelConstraints& aCts,
+                                    const RefPtr<const dom::BerytusWebAppActor>& aWebAppActor,
+                                    berytus::BootstrapChannelArgs& aRetVal) {
+  aRetVal.mChannelId.Assign(aChannelId);
+  Utils_ChannelConstraints(aCts, aRetVal.mConstraints);
+  nsresult rv;
+  rv = berytus::Utils_WebAppActorToVariant(aWebAppActor, aRetVal.mWebAppActor);
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    return rv;
+  }
+  MOZ_ASSERT(aRetVal.mWebAppActor.Inited());
+  return NS_OK;
+}
+
 void Utils_OperationMetadata(const RefPtr<const dom::BerytusLoginOperation>& aOperation, berytus::OperationMetadata& aRv) {
   nsString id;
   aOperation->GetID(aRv.mId);
@@ -165,7 +188,7 @@ void Utils_LoginOperationMetadata(const RefPtr<const dom::BerytusLoginOperation>
       EntryType entry;
       ch->GetId(entry.mKey);
       auto& info = entry.mValue;
-      utils::ToProxy::BerytusChallengeInfoUnion(ch, info);
+      utils::ToProxy::CopyChallengeInfoUnion(ch->Info(), info);
       aRetVal.mChallenges.Entries().AppendElement(std::move(entry));
     }
   }
@@ -340,7 +363,24 @@ dom::BerytusAesGcmParams_Impl* FromProxy::BerytusAesGcmParams_Impl(
 }
 dom::BerytusEncryptionParams_Impl* FromProxy::BerytusEncryptionParams_Impl(
     const EncryptedPacketParametersProxy& aProxy, nsresult& aRv) {
-  return FromProxy::BerytusAesGcmParams_Impl(aProxy, aRv);
+  UniquePtr<dom::BerytusAesGcmParams_Impl> aesGcm(
+    FromProxy::BerytusAesGcmParams_Impl(aProxy, aRv));
+  if (NS_FAILED(aRv)) {
+    return nullptr;
+  }
+  if (!aProxy.mName.EqualsASCII(
+        dom::BerytusChunkedAesGcmParams_Impl::kAlgorithm)) {
+    return aesGcm.release();
+  }
+  int32_t chunkSize;
+  if (aProxy.mChunkSize.isNothing() ||
+      !NumberIsInt32(aProxy.mChunkSize.value(), &chunkSize) ||
+      chunkSize <= 0) {
+    aRv = NS_ERROR_INVALID_ARG;
+    return nullptr;
+  }
+  return dom::BerytusChunkedAesGcmParams_Impl::Create(
+    std::move(*aesGcm), static_cast<uint32_t>(chunkSize), aRv);
 }
 already_AddRefed<dom::BerytusEncryptedPacket> FromProxy::BerytusEncryptedPacket(
     nsIGlobalObject* aGlobal, const EncryptedPacketProxy& aProxy,
@@ -823,6 +863,19 @@ nsresult FromProxy::UserAttributeValueMatcher::operator()(const ArrayBufferView&
   }
   return NS_OK;
 }
+nsresult FromProxy::UserAttributeValueMatcher::operator()(const RefPtr<Blob>& aBlob) {
+  if (NS_WARN_IF(!aBlob)) {
+    return NS_ERROR_INVALID_ARG;
+  }
+  // The blob came from the agent; rebind its implementation to the
+  // web app's global.
+  RefPtr<Blob> blob = Blob::Create(mGlobal, aBlob->Impl());
+  if (NS_WARN_IF(!blob)) {
+    return NS_ERROR_FAILURE;
+  }
+  mRetVal.SetAsBlob() = blob;
+  return NS_OK;
+}
 
 
 void FromProxy::SetFieldValueMatcher::operator()(const JSNull&) {
@@ -904,76 +957,242 @@ void FromProxy::SetFieldValueMatcher::operator()(
 }
 
 
-bool ToProxy::BerytusField(JSContext* aCx,
-                           const RefPtr<dom::BerytusField>& aField,
-                           FieldProxy& aRetVal) {
-  JS::Rooted<JS::Value> jsField(aCx);
-  // TODO(berytus): Investigate whether using DOMReflectors
-  // is a security risk -- could a mal web app override properties
-  // in the reflector?
-  if (NS_WARN_IF(!GetOrCreateDOMReflector(aCx, aField, &jsField))) {
+namespace {
+
+bool CryptoBufferToArrayBuffer(JSContext* aCx,
+                               const CryptoBuffer& aBuffer,
+                               ArrayBuffer& aRetVal) {
+  ErrorResult rv;
+  JS::Rooted<JSObject*> obj(aCx, ArrayBuffer::Create(aCx, aBuffer, rv));
+  if (NS_WARN_IF(rv.Failed())) {
+    rv.SuppressException();
     return false;
   }
-  if (aField->Type() == dom::BerytusFieldType::Identity) {
-    berytus::BerytusIdentityField proxyField;
-    if (NS_WARN_IF(!berytus::FromJSVal(aCx, jsField, proxyField))) {
+  return aRetVal.Init(obj);
+}
+
+bool BerytusBufferToProxy(
+    JSContext* aCx,
+    const dom::BerytusBuffer& aBuffer,
+    SafeVariant<ArrayBuffer, berytus::BerytusEncryptedPacket>& aRetVal) {
+  if (RefPtr<dom::BerytusEncryptedPacket> packet = aBuffer.AsPacket()) {
+    EncryptedPacketProxy packetProxy;
+    if (NS_WARN_IF(!ToProxy::BerytusEncryptedPacket(aCx, packet, packetProxy))) {
       return false;
     }
-    aRetVal.Init(VariantType<berytus::BerytusIdentityField>{}, std::move(proxyField));
+    aRetVal.Init(VariantType<berytus::BerytusEncryptedPacket>(),
+                 std::move(packetProxy));
     return true;
   }
-  if (aField->Type() == dom::BerytusFieldType::ForeignIdentity) {
-    berytus::BerytusForeignIdentityField proxyField;
-    if (NS_WARN_IF(!berytus::FromJSVal(aCx, jsField, proxyField))) {
-      return false;
-    }
-    aRetVal.Init(std::move(proxyField));
+  ArrayBuffer buf;
+  if (NS_WARN_IF(!CryptoBufferToArrayBuffer(aCx, aBuffer.AsBuffer(), buf))) {
+    return false;
+  }
+  aRetVal.Init(VariantType<ArrayBuffer>(), std::move(buf));
+  return true;
+}
+
+template <typename T>
+bool FieldValueDictionaryToProxy(JSContext* aCx,
+                                 const dom::BerytusFieldValueDictionary& aDict,
+                                 T& aRetVal);
+
+template <>
+bool FieldValueDictionaryToProxy(
+    JSContext* aCx,
+    const dom::BerytusFieldValueDictionary& aDict,
+    SecurePasswordFieldValueProxy& aRetVal) {
+  const auto& value =
+    static_cast<const dom::BerytusSecurePasswordFieldValue&>(aDict);
+  return !NS_WARN_IF(!BerytusBufferToProxy(aCx, value.Salt(), aRetVal.mSalt)) &&
+         !NS_WARN_IF(!BerytusBufferToProxy(aCx, value.Verifier(), aRetVal.mVerifier));
+}
+
+template <>
+bool FieldValueDictionaryToProxy(
+    JSContext* aCx,
+    const dom::BerytusFieldValueDictionary& aDict,
+    KeyFieldValueProxy& aRetVal) {
+  const auto& value = static_cast<const dom::BerytusKeyFieldValue&>(aDict);
+  return !NS_WARN_IF(!BerytusBufferToProxy(aCx, value.PublicKey(), aRetVal.mPublicKey));
+}
+
+template <>
+bool FieldValueDictionaryToProxy(
+    JSContext* aCx,
+    const dom::BerytusFieldValueDictionary& aDict,
+    SharedKeyFieldValueProxy& aRetVal) {
+  const auto& value =
+    static_cast<const dom::BerytusSharedKeyFieldValue&>(aDict);
+  return !NS_WARN_IF(!BerytusBufferToProxy(aCx, value.PrivateKey(), aRetVal.mPrivateKey));
+}
+
+/**
+ * Identity, ForeignIdentity and Password field values:
+ * null, a string or an encrypted packet.
+ */
+bool FieldValueToProxy(
+    JSContext* aCx,
+    const FieldValueUnion& aValue,
+    SafeVariant<JSNull, nsString, berytus::BerytusEncryptedPacket>& aRetVal) {
+  if (aValue.IsNull()) {
+    aRetVal.Init(VariantType<JSNull>());
     return true;
   }
-  if (aField->Type() == dom::BerytusFieldType::Password) {
-    berytus::BerytusPasswordField proxyField;
-    if (NS_WARN_IF(!berytus::FromJSVal(aCx, jsField, proxyField))) {
-      return false;
-    }
-    aRetVal.Init(std::move(proxyField));
+  const auto& value = aValue.Value();
+  if (value.IsString()) {
+    aRetVal.Init(VariantType<nsString>(), value.GetAsString());
     return true;
   }
-  if (aField->Type() == dom::BerytusFieldType::SecurePassword) {
-    berytus::BerytusSecurePasswordField proxyField;
-    if (NS_WARN_IF(!berytus::FromJSVal(aCx, jsField, proxyField))) {
+  if (value.IsBerytusEncryptedPacket()) {
+    EncryptedPacketProxy packetProxy;
+    if (NS_WARN_IF(!ToProxy::BerytusEncryptedPacket(
+          aCx, value.GetAsBerytusEncryptedPacket(), packetProxy))) {
       return false;
     }
-    aRetVal.Init(std::move(proxyField));
+    aRetVal.Init(VariantType<berytus::BerytusEncryptedPacket>(),
+                 std::move(packetProxy));
     return true;
   }
-  if (aField->Type() == dom::BerytusFieldType::Key) {
-    berytus::BerytusKeyField proxyField;
-    if (NS_WARN_IF(!berytus::FromJSVal(aCx, jsField, proxyField))) {
-      return false;
-    }
-    aRetVal.Init(std::move(proxyField));
+  MOZ_ASSERT(false, "Field value does not match the field type");
+  return false;
+}
+
+/**
+ * SecurePassword, Key and SharedKey field values: null or
+ * a field value dictionary.
+ */
+template <typename T>
+bool FieldValueToProxy(JSContext* aCx,
+                       const FieldValueUnion& aValue,
+                       SafeVariant<JSNull, T>& aRetVal) {
+  if (aValue.IsNull()) {
+    aRetVal.Init(VariantType<JSNull>());
     return true;
   }
-  if (aField->Type() == dom::BerytusFieldType::SharedKey) {
-    berytus::BerytusSharedKeyField proxyField;
-    if (NS_WARN_IF(!berytus::FromJSVal(aCx, jsField, proxyField))) {
-      return false;
+  const auto& value = aValue.Value();
+  if (NS_WARN_IF(!value.IsBerytusFieldValueDictionary())) {
+    MOZ_ASSERT(false, "Field value does not match the field type");
+    return false;
+  }
+  T valueProxy;
+  if (NS_WARN_IF(!FieldValueDictionaryToProxy(
+        aCx, *value.GetAsBerytusFieldValueDictionary(), valueProxy))) {
+    return false;
+  }
+  aRetVal.Init(VariantType<T>(), std::move(valueProxy));
+  return true;
+}
+
+template <typename F, typename P>
+bool FieldToProxy(JSContext* aCx, const dom::BerytusField& aField,
+                  P& aRetVal) {
+  const F& field = static_cast<const F&>(aField);
+  field.GetId(aRetVal.mId);
+  aRetVal.mOptions = ToProxy::BerytusFieldOptions(field.Options());
+  return FieldValueToProxy(aCx, field.GetValue(), aRetVal.mValue);
+}
+
+} // namespace
+
+bool ToProxy::BerytusField(JSContext* aCx,
+                           const RefPtr<dom::BerytusField>& aField,
+                           FieldProxy& aRetVal) {
+  // NOTE(berytus): The proxy is built from the native field, and not
+  // from its reflector, so that script cannot interfere with the
+  // field sent to the secret manager.
+  switch (aField->Type()) {
+    case dom::BerytusFieldType::Identity: {
+      IdentityFieldProxy proxyField;
+      if (NS_WARN_IF(!(FieldToProxy<dom::BerytusIdentityField>(aCx, *aField, proxyField)))) {
+        return false;
+      }
+      aRetVal.Init(VariantType<IdentityFieldProxy>{}, std::move(proxyField));
+      return true;
     }
-    aRetVal.Init(std::move(proxyField));
-    return true;
+    case dom::BerytusFieldType::ForeignIdentity: {
+      ForeignIdentityFieldProxy proxyField;
+      if (NS_WARN_IF(!(FieldToProxy<dom::BerytusForeignIdentityField>(aCx, *aField, proxyField)))) {
+        return false;
+      }
+      aRetVal.Init(std::move(proxyField));
+      return true;
+    }
+    case dom::BerytusFieldType::Password: {
+      PasswordFieldProxy proxyField;
+      if (NS_WARN_IF(!(FieldToProxy<dom::BerytusPasswordField>(aCx, *aField, proxyField)))) {
+        return false;
+      }
+      aRetVal.Init(std::move(proxyField));
+      return true;
+    }
+    case dom::BerytusFieldType::SecurePassword: {
+      SecurePasswordFieldProxy proxyField;
+      if (NS_WARN_IF(!(FieldToProxy<dom::BerytusSecurePasswordField>(aCx, *aField, proxyField)))) {
+        return false;
+      }
+      aRetVal.Init(std::move(proxyField));
+      return true;
+    }
+    case dom::BerytusFieldType::Key: {
+      KeyFieldProxy proxyField;
+      if (NS_WARN_IF(!(FieldToProxy<dom::BerytusKeyField>(aCx, *aField, proxyField)))) {
+        return false;
+      }
+      aRetVal.Init(std::move(proxyField));
+      return true;
+    }
+    case dom::BerytusFieldType::SharedKey: {
+      SharedKeyFieldProxy proxyField;
+      if (NS_WARN_IF(!(FieldToProxy<dom::BerytusSharedKeyField>(aCx, *aField, proxyField)))) {
+        return false;
+      }
+      aRetVal.Init(std::move(proxyField));
+      return true;
+    }
+    default:
+      MOZ_ASSERT(false, "Unrecognised Berytus Field Type");
+      return false;
   }
-  MOZ_ASSERT(false, "Unrecognised Berytus Field Type");
-  return false;
 }
 
 bool ToProxy::BerytusEncryptedPacket(JSContext* aCx,
                                      const RefPtr<dom::BerytusEncryptedPacket>& aPacket,
                                      EncryptedPacketProxy& aRetVal) {
-  JS::Rooted<JS::Value> jsPacket(aCx);
-  if (NS_WARN_IF(!GetOrCreateDOMReflector(aCx, aPacket, &jsPacket))) {
+  const dom::BerytusChunkedAesGcmParams_Impl* chunkedParams =
+    aPacket->GetEncryptionParams()->AsChunkedAesGcmParams();
+  const dom::BerytusAesGcmParams_Impl* params = chunkedParams
+    ? &chunkedParams->AesGcm()
+    : aPacket->GetEncryptionParams()->AsAesGcmParams();
+  if (NS_WARN_IF(!params)) {
     return false;
   }
-  if (NS_WARN_IF(!berytus::FromJSVal(aCx, jsPacket, aRetVal))) {
+  if (chunkedParams) {
+    aRetVal.mParameters.mChunkSize.emplace(chunkedParams->ChunkSize());
+  }
+  ArrayBuffer iv;
+  if (NS_WARN_IF(!CryptoBufferToArrayBuffer(aCx, params->Iv(), iv))) {
+    return false;
+  }
+  aRetVal.mParameters.mIv.Init(VariantType<ArrayBuffer>(), std::move(iv));
+  if (params->AdditionalData().Length() > 0) {
+    ArrayBuffer additionalData;
+    if (NS_WARN_IF(!CryptoBufferToArrayBuffer(aCx, params->AdditionalData(), additionalData))) {
+      return false;
+    }
+    aRetVal.mParameters.mAdditionalData.Init(VariantType<ArrayBuffer>(),
+                                             std::move(additionalData));
+  } else {
+    aRetVal.mParameters.mAdditionalData.Init(VariantType<Nothing>());
+  }
+  aRetVal.mParameters.mTagLength.emplace(params->TagLength());
+  if (chunkedParams) {
+    aRetVal.mParameters.mName.AssignASCII(
+      dom::BerytusChunkedAesGcmParams_Impl::kAlgorithm);
+  } else {
+    aRetVal.mParameters.mName.Assign(NS_ConvertASCIItoUTF16(WEBCRYPTO_ALG_AES_GCM));
+  }
+  if (NS_WARN_IF(!CryptoBufferToArrayBuffer(aCx, aPacket->GetCiphertextBuffer(), aRetVal.mCiphertext))) {
     return false;
   }
   return true;
@@ -989,30 +1208,26 @@ bool ToProxy::BerytusOptionalFieldValueUnion(JSContext* aCx,
   const auto& value = aFieldValue.Value();
   if (value.IsBerytusFieldValueDictionary()) {
     const auto& dict = value.GetAsBerytusFieldValueDictionary();
-    JS::Rooted<JS::Value> jsDict(aCx);
-    if (NS_WARN_IF(!GetOrCreateDOMReflector(aCx, dict, &jsDict))) {
-      return false;
-    }
     switch (dict->Type()) {
       case dom::BerytusFieldType::SecurePassword: {
-        BerytusSecurePasswordFieldValue fvProxy;
-        if (NS_WARN_IF(!berytus::FromJSVal(aCx, jsDict, fvProxy))) {
+        SecurePasswordFieldValueProxy fvProxy;
+        if (NS_WARN_IF(!FieldValueDictionaryToProxy(aCx, *dict, fvProxy))) {
           return false;
         }
         aRetVal.Init(std::move(fvProxy));
         break;
       }
       case dom::BerytusFieldType::Key: {
-        BerytusKeyFieldValue fvProxy;
-        if (NS_WARN_IF(!berytus::FromJSVal(aCx, jsDict, fvProxy))) {
+        KeyFieldValueProxy fvProxy;
+        if (NS_WARN_IF(!FieldValueDictionaryToProxy(aCx, *dict, fvProxy))) {
           return false;
         }
         aRetVal.Init(std::move(fvProxy));
         break;
       }
       case dom::BerytusFieldType::SharedKey: {
-        BerytusSharedKeyFieldValue fvProxy;
-        if (NS_WARN_IF(!berytus::FromJSVal(aCx, jsDict, fvProxy))) {
+        SharedKeyFieldValueProxy fvProxy;
+        if (NS_WARN_IF(!FieldValueDictionaryToProxy(aCx, *dict, fvProxy))) {
           return false;
         }
         aRetVal.Init(std::move(fvProxy));
@@ -1059,6 +1274,10 @@ bool ToProxy::BerytusUserAttributeDefinition(
   if (aAttr.mValue.IsArrayBufferView()) {
     return !NS_WARN_IF(!berytus::Utils_ArrayBufferViewToSafeVariant(aAttr.mValue.GetAsArrayBufferView(), aRetVal.mValue));
   }
+  if (aAttr.mValue.IsBlob()) {
+    aRetVal.mValue.Init(RefPtr<Blob>(aAttr.mValue.GetAsBlob()));
+    return true;
+  }
   if (aAttr.mValue.IsBerytusEncryptedPacket()) {
     EncryptedPacketProxy packetProxy;
     if (NS_WARN_IF(!ToProxy::BerytusEncryptedPacket(aCx, aAttr.mValue.GetAsBerytusEncryptedPacket(), packetProxy))) {
@@ -1075,178 +1294,148 @@ bool ToProxy::BerytusUserAttributeDefinition(
   return false;
 }
 
+namespace {
+
+template <typename T>
+Maybe<berytus::BerytusFieldCategoryOptions> FieldCategoryOptions(
+    const T& aOptions) {
+  if (!aOptions.mCategory.WasPassed()) {
+    return Nothing();
+  }
+  const auto& category = aOptions.mCategory.Value();
+  Maybe<double> pos;
+  if (category.mPosition.WasPassed()) {
+    pos.emplace(category.mPosition.Value());
+  }
+  return Some(berytus::BerytusFieldCategoryOptions(
+    nsString(category.mCategoryId), std::move(pos)));
+}
+
+} // namespace
+
+berytus::BerytusIdentityFieldOptions ToProxy::BerytusFieldOptions(
+    const dom::BerytusIdentityFieldOptions& aOptions) {
+  Maybe<nsString> allowedCharacters;
+  if (aOptions.mAllowedCharacters.WasPassed()) {
+    allowedCharacters.emplace(aOptions.mAllowedCharacters.Value());
+  }
+  return berytus::BerytusIdentityFieldOptions(
+    bool(aOptions.mHumanReadable),
+    bool(aOptions.mPrivate),
+    double(aOptions.mMaxLength),
+    std::move(allowedCharacters),
+    FieldCategoryOptions(aOptions)
+  );
+}
+
+berytus::BerytusForeignIdentityFieldOptions ToProxy::BerytusFieldOptions(
+    const dom::BerytusForeignIdentityFieldOptions& aOptions) {
+  return berytus::BerytusForeignIdentityFieldOptions(
+    bool(aOptions.mPrivate),
+    nsString(aOptions.mKind),
+    FieldCategoryOptions(aOptions)
+  );
+}
+
+berytus::BerytusPasswordFieldOptions ToProxy::BerytusFieldOptions(
+    const dom::BerytusPasswordFieldOptions& aOptions) {
+  Maybe<nsString> rules;
+  if (aOptions.mPasswordRules.WasPassed()) {
+    rules.emplace(aOptions.mPasswordRules.Value());
+  }
+  return berytus::BerytusPasswordFieldOptions(
+    std::move(rules),
+    FieldCategoryOptions(aOptions)
+  );
+}
+
+berytus::BerytusSecurePasswordFieldOptions ToProxy::BerytusFieldOptions(
+    const dom::BerytusSecurePasswordFieldOptions& aOptions) {
+  return berytus::BerytusSecurePasswordFieldOptions(
+    nsString(aOptions.mIdentityFieldId),
+    FieldCategoryOptions(aOptions)
+  );
+}
+
+berytus::BerytusKeyFieldOptions ToProxy::BerytusFieldOptions(
+    const dom::BerytusKeyFieldOptions& aOptions) {
+  return berytus::BerytusKeyFieldOptions(
+    double(aOptions.mAlg),
+    FieldCategoryOptions(aOptions)
+  );
+}
+
+berytus::BerytusSharedKeyFieldOptions ToProxy::BerytusFieldOptions(
+    const dom::BerytusSharedKeyFieldOptions& aOptions) {
+  return berytus::BerytusSharedKeyFieldOptions(
+    double(aOptions.mAlg),
+    FieldCategoryOptions(aOptions)
+  );
+}
+
 void ToProxy::BerytusFieldOptionsUnion(
     const RefPtr<dom::BerytusField>& aField,
     FieldOptionsUnionProxy& aRetVal
 ) {
-  // NOTE(berytus): Repitition below.
   switch (aField->Type()) {
-    case dom::BerytusFieldType::Identity: {
-      RefPtr<dom::BerytusIdentityField> field =
-        static_cast<dom::BerytusIdentityField*>(aField.get());
-      const auto& options = field->Options();
-      Maybe<nsString> allowedCharacters;
-      Maybe<berytus::BerytusFieldCategoryOptions> categoryOpts;
-      if (options.mAllowedCharacters.WasPassed()) {
-        allowedCharacters.emplace(options.mAllowedCharacters.Value());
-      }
-      if (options.mCategory.WasPassed()) {
-        nsString categoryId(options.mCategory.Value().mCategoryId);
-        Maybe<double> pos;
-        if (options.mCategory.Value().mPosition.WasPassed()) {
-          pos.emplace(options.mCategory.Value().mPosition.Value());
-        }
-        categoryOpts.emplace(std::move(categoryId), std::move(pos));
-      }
-      berytus::BerytusIdentityFieldOptions proxy(
-        bool(options.mHumanReadable),
-        bool(options.mPrivate),
-        double(options.mMaxLength),
-        std::move(allowedCharacters),
-        std::move(categoryOpts)
-      );
-      aRetVal.Init(std::move(proxy));
+    case dom::BerytusFieldType::Identity:
+      aRetVal.Init(BerytusFieldOptions(
+        static_cast<dom::BerytusIdentityField*>(aField.get())->Options()));
       break;
-    }
-    case dom::BerytusFieldType::ForeignIdentity: {
-      RefPtr<dom::BerytusForeignIdentityField> field =
-        static_cast<dom::BerytusForeignIdentityField*>(aField.get());
-      const auto& options = field->Options();
-      Maybe<berytus::BerytusFieldCategoryOptions> categoryOpts;
-      if (options.mCategory.WasPassed()) {
-        nsString categoryId(options.mCategory.Value().mCategoryId);
-        Maybe<double> pos;
-        if (options.mCategory.Value().mPosition.WasPassed()) {
-          pos.emplace(options.mCategory.Value().mPosition.Value());
-        }
-        categoryOpts.emplace(std::move(categoryId), std::move(pos));
-      }
-      berytus::BerytusForeignIdentityFieldOptions proxy(
-        bool(options.mPrivate),
-        nsString(options.mKind),
-        std::move(categoryOpts)
-      );
-      aRetVal.Init(std::move(proxy));
+    case dom::BerytusFieldType::ForeignIdentity:
+      aRetVal.Init(BerytusFieldOptions(
+        static_cast<dom::BerytusForeignIdentityField*>(aField.get())->Options()));
       break;
-    }
-    case dom::BerytusFieldType::Password: {
-      RefPtr<dom::BerytusPasswordField> field =
-        static_cast<dom::BerytusPasswordField*>(aField.get());
-      const auto& options = field->Options();
-      Maybe<berytus::BerytusFieldCategoryOptions> categoryOpts;
-      if (options.mCategory.WasPassed()) {
-        nsString categoryId(options.mCategory.Value().mCategoryId);
-        Maybe<double> pos;
-        if (options.mCategory.Value().mPosition.WasPassed()) {
-          pos.emplace(options.mCategory.Value().mPosition.Value());
-        }
-        categoryOpts.emplace(std::move(categoryId), std::move(pos));
-      }
-      Maybe<nsString> rules;
-      if (options.mPasswordRules.WasPassed()) {
-        rules.emplace(options.mPasswordRules.Value());
-      }
-      berytus::BerytusPasswordFieldOptions proxy(
-        std::move(rules),
-        std::move(categoryOpts)
-      );
-      aRetVal.Init(std::move(proxy));
+    case dom::BerytusFieldType::Password:
+      aRetVal.Init(BerytusFieldOptions(
+        static_cast<dom::BerytusPasswordField*>(aField.get())->Options()));
       break;
-    }
-    case dom::BerytusFieldType::SecurePassword: {
-      RefPtr<dom::BerytusSecurePasswordField> field =
-        static_cast<dom::BerytusSecurePasswordField*>(aField.get());
-      const auto& options = field->Options();
-      Maybe<berytus::BerytusFieldCategoryOptions> categoryOpts;
-      if (options.mCategory.WasPassed()) {
-        nsString categoryId(options.mCategory.Value().mCategoryId);
-        Maybe<double> pos;
-        if (options.mCategory.Value().mPosition.WasPassed()) {
-          pos.emplace(options.mCategory.Value().mPosition.Value());
-        }
-        categoryOpts.emplace(std::move(categoryId), std::move(pos));
-      }
-      berytus::BerytusSecurePasswordFieldOptions proxy(
-        nsString(options.mIdentityFieldId),
-        std::move(categoryOpts)
-      );
-      aRetVal.Init(std::move(proxy));
+    case dom::BerytusFieldType::SecurePassword:
+      aRetVal.Init(BerytusFieldOptions(
+        static_cast<dom::BerytusSecurePasswordField*>(aField.get())->Options()));
       break;
-    }
-    case dom::BerytusFieldType::Key: {
-      RefPtr<dom::BerytusKeyField> field =
-        static_cast<dom::BerytusKeyField*>(aField.get());
-      const auto& options = field->Options();
-      Maybe<berytus::BerytusFieldCategoryOptions> categoryOpts;
-      if (options.mCategory.WasPassed()) {
-        nsString categoryId(options.mCategory.Value().mCategoryId);
-        Maybe<double> pos;
-        if (options.mCategory.Value().mPosition.WasPassed()) {
-          pos.emplace(options.mCategory.Value().mPosition.Value());
-        }
-        categoryOpts.emplace(std::move(categoryId), std::move(pos));
-      }
-      berytus::BerytusKeyFieldOptions proxy(
-        double(options.mAlg),
-        std::move(categoryOpts)
-      );
-      aRetVal.Init(std::move(proxy));
+    case dom::BerytusFieldType::Key:
+      aRetVal.Init(BerytusFieldOptions(
+        static_cast<dom::BerytusKeyField*>(aField.get())->Options()));
       break;
-    }
-    case dom::BerytusFieldType::SharedKey: {
-      RefPtr<dom::BerytusSharedKeyField> field =
-        static_cast<dom::BerytusSharedKeyField*>(aField.get());
-      const auto& options = field->Options();
-      Maybe<berytus::BerytusFieldCategoryOptions> categoryOpts;
-      if (options.mCategory.WasPassed()) {
-        nsString categoryId(options.mCategory.Value().mCategoryId);
-        Maybe<double> pos;
-        if (options.mCategory.Value().mPosition.WasPassed()) {
-          pos.emplace(options.mCategory.Value().mPosition.Value());
-        }
-        categoryOpts.emplace(std::move(categoryId), std::move(pos));
-      }
-      berytus::BerytusSharedKeyFieldOptions proxy(
-        double(options.mAlg),
-        std::move(categoryOpts)
-      );
-      aRetVal.Init(std::move(proxy));
+    case dom::BerytusFieldType::SharedKey:
+      aRetVal.Init(BerytusFieldOptions(
+        static_cast<dom::BerytusSharedKeyField*>(aField.get())->Options()));
       break;
-    }
     default:
       MOZ_RELEASE_ASSERT(false, "Unrecognised Field Type");
   }
 }
 
 void ToProxy::BerytusChallengeInfoUnion(
-    const RefPtr<dom::BerytusChallenge>& aChallenge,
+    const dom::BerytusChallenge& aChallenge,
     ChallengeInfoUnionProxy& aRetVal
 ) {
-  switch (aChallenge->Type()) {
+  switch (aChallenge.Type()) {
     case dom::BerytusChallengeType::Identification: {
       berytus::BerytusIdentificationChallengeInfo info;
-      aChallenge->GetId(info.mId);
+      aChallenge.GetId(info.mId);
       aRetVal.Init(std::move(info));
       return;
     }
     case dom::BerytusChallengeType::DigitalSignature: {
       berytus::BerytusDigitalSignatureChallengeInfo info;
-      aChallenge->GetId(info.mId);
+      aChallenge.GetId(info.mId);
       aRetVal.Init(std::move(info));
       return;
     }
     case dom::BerytusChallengeType::Password: {
       berytus::BerytusPasswordChallengeInfo info;
-      aChallenge->GetId(info.mId);
+      aChallenge.GetId(info.mId);
       aRetVal.Init(std::move(info));
       return;
     }
     case dom::BerytusChallengeType::SecureRemotePassword: {
       berytus::BerytusSecureRemotePasswordChallengeInfo info;
-      aChallenge->GetId(info.mId);
-      RefPtr<dom::BerytusSecureRemotePasswordChallenge> ch =
-        static_cast<dom::BerytusSecureRemotePasswordChallenge*>(aChallenge.get());
-      const auto& params = ch->Parameters();
+      aChallenge.GetId(info.mId);
+      const auto& params =
+        static_cast<const dom::BerytusSecureRemotePasswordChallenge&>(aChallenge)
+          .Parameters();
       if (!params.mEncoding.WasPassed()) {
         info.mParameters.mEncoding.Init(Nothing());
       } else {
@@ -1273,7 +1462,7 @@ void ToProxy::BerytusChallengeInfoUnion(
     }
     case dom::BerytusChallengeType::OffChannelOtp: {
       berytus::BerytusOffChannelOtpChallengeInfo info;
-      aChallenge->GetId(info.mId);
+      aChallenge.GetId(info.mId);
       aRetVal.Init(std::move(info));
       return;
     }
@@ -1282,6 +1471,27 @@ void ToProxy::BerytusChallengeInfoUnion(
   }
 }
 
+void ToProxy::CopyChallengeInfoUnion(
+    const ChallengeInfoUnionProxy& aInfo,
+    ChallengeInfoUnionProxy& aRetVal
+) {
+  MOZ_ASSERT(aInfo.Inited());
+  aInfo.InternalValue()->match([&aRetVal](const auto& aSrc) {
+    using InfoT = std::decay_t<decltype(aSrc)>;
+    InfoT info;
+    info.mId.Assign(aSrc.mId);
+    if constexpr (std::is_same_v<InfoT,
+        berytus::BerytusSecureRemotePasswordChallengeInfo>) {
+      aSrc.mParameters.mEncoding.InternalValue()->match(
+          [&info](const auto& aEncoding) {
+            info.mParameters.mEncoding.Init(
+              std::decay_t<decltype(aEncoding)>());
+          });
+    }
+    aRetVal.Init(std::move(info));
+  });
+}
+
 }
 
 };
\ No newline at end of file
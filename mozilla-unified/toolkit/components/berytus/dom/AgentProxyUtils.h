@@ -11,7 +11,7 @@
 #include "mozilla/berytus/AgentProxy.h"
 #include "mozilla/dom/BerytusAccountBinding.h" // BerytusFieldRejectionParameters
 #include "mozilla/dom/BerytusField.h"
-#include "mozilla/dom/BerytusUserAttributeBinding.h" // OwningStringOrArrayBufferViewOrArrayBufferOrBerytusEncryptedPacket
+#include "mozilla/dom/BerytusUserAttributeBinding.h" // OwningStringOrArrayBufferViewOrArrayBufferOrBlobOrBerytusEncryptedPacket
 #include "mozilla/dom/BerytusUserAttribute.h"
 
 namespace mozilla::dom {
@@ -37,6 +37,13 @@ namespace mozilla::dom {
 
   struct BerytusChannelConstraints;
   class BerytusSecretManagerActor;
+
+  struct BerytusIdentityFieldOptions;
+  struct BerytusForeignIdentityFieldOptions;
+  struct BerytusPasswordFieldOptions;
+  struct BerytusSecurePasswordFieldOptions;
+  struct BerytusKeyFieldOptions;
+  struct BerytusSharedKeyFieldOptions;
 }
 
 namespace mozilla::berytus {
@@ -53,6 +60,12 @@ nsresult Utils_ChannelMetadata(
     const RefPtr<const dom::BerytusWebAppActor>& aWebAppActor,
     const RefPtr<const mozilla::dom::BerytusSecretManagerActor>& aScmActor,
     berytus::ChannelMetadata& aRetVal);
+[[nodiscard]]
+nsresult Utils_BootstrapChannelArgs(
+    const nsString& aChannelId,
+    const mozilla::dom::BerytusChannelConstraints& aCts,
+    const RefPtr<const dom::BerytusWebAppActor>& aWebAppActor,
+    berytus::BootstrapChannelArgs& aRetVal);
 void Utils_OperationMetadata(const RefPtr<const dom::BerytusLoginOperation>& aOperation, berytus::OperationMetadata& aRv);
 void Utils_LoginOperationMetadata(const RefPtr<const dom::BerytusLoginOperation>& aOperation, const dom::BerytusAccount* aAccount, berytus::LoginOperationMetadata& aRetVal);
 
@@ -89,7 +102,7 @@ bool Utils_ArrayBufferViewToSafeVariant(const ArrayBufferView& aBuf, SafeVariant
 namespace utils {
 
 using WebAppActorProxy = SafeVariant<berytus::CryptoActor, berytus::OriginActor>;
-using AesGcmParams_ImplProxy = berytus::AesGcmParams;
+using AesGcmParams_ImplProxy = berytus::BerytusEncryptionParams;
 using EncryptedPacketParametersProxy = decltype(berytus::BerytusEncryptedPacket::mParameters);
 using EncryptedPacketProxy = berytus::BerytusEncryptedPacket;
 using FieldProxy = decltype(berytus::AddFieldArgs::mField);
@@ -187,6 +200,7 @@ protected:
         nsresult operator()(const EncryptedPacketProxy& aPacketProxy);
         nsresult operator()(const ArrayBuffer& aBuf);
         nsresult operator()(const ArrayBufferView& aBuf);
+        nsresult operator()(const RefPtr<Blob>& aBlob);
     };
     struct FieldValueMatcher {
         nsIGlobalObject* mGlobal;
@@ -230,6 +244,10 @@ protected:
 
 class ToProxy {
 public:
+    /**
+     * Converts the native field, its options and its value; the
+     * field's reflector is neither created nor accessed.
+     */
     static bool BerytusField(JSContext* aCx,
                              const RefPtr<dom::BerytusField>& aField,
                              FieldProxy& aRetVal);
@@ -247,13 +265,36 @@ public:
         UserAttributeProxy& aRetVal
     );
 
+    static berytus::BerytusIdentityFieldOptions BerytusFieldOptions(
+        const dom::BerytusIdentityFieldOptions& aOptions);
+    static berytus::BerytusForeignIdentityFieldOptions BerytusFieldOptions(
+        const dom::BerytusForeignIdentityFieldOptions& aOptions);
+    static berytus::BerytusPasswordFieldOptions BerytusFieldOptions(
+        const dom::BerytusPasswordFieldOptions& aOptions);
+    static berytus::BerytusSecurePasswordFieldOptions BerytusFieldOptions(
+        const dom::BerytusSecurePasswordFieldOptions& aOptions);
+    static berytus::BerytusKeyFieldOptions BerytusFieldOptions(
+        const dom::BerytusKeyFieldOptions& aOptions);
+    static berytus::BerytusSharedKeyFieldOptions BerytusFieldOptions(
+        const dom::BerytusSharedKeyFieldOptions& aOptions);
+
     static void BerytusFieldOptionsUnion(
         const RefPtr<dom::BerytusField>& aField,
         FieldOptionsUnionProxy& aRetVal
     );
 
+    /**
+     * Builds the info of aChallenge from its id, type and parameters.
+     * Only meant for BerytusChallenge::InitInfo; elsewhere, the
+     * challenge's Info() should be copied instead.
+     */
     static void BerytusChallengeInfoUnion(
-        const RefPtr<dom::BerytusChallenge>& aChallenge,
+        const dom::BerytusChallenge& aChallenge,
+        ChallengeInfoUnionProxy& aRetVal
+    );
+
+    static void CopyChallengeInfoUnion(
+        const ChallengeInfoUnionProxy& aInfo,
         ChallengeInfoUnionProxy& aRetVal
     );
 };
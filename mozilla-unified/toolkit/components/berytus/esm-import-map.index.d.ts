@@ -1,6 +1,7 @@
 // This file is automatically generated; do not edit.
 export type ModuleMap = {
     "resource://gre/modules/BerytusAgent.sys.mjs": typeof import("./src/Agent.sys.mts"),
+	"resource://gre/modules/BerytusChannelSessionStore.sys.mjs": typeof import("./src/ChannelSessionStore.sys.mts"),
 	"resource://gre/modules/BerytusChildProxyUtils.sys.mjs": typeof import("./src/ChildProxyUtils.sys.mts"),
 	"resource://gre/modules/BerytusLiaison.sys.mjs": typeof import("./src/Liaison.sys.mts"),
 	"resource://gre/modules/BerytusNativeManager.sys.mjs": typeof import("./src/NativeManager.sys.mts"),
@@ -3,8 +3,25 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 import { PublicRequestHandler, SequentialRequestHandler } from "resource://gre/modules/BerytusRequestHandler.sys.mjs";
 import { NativeManager } from "resource://gre/modules/BerytusNativeManager.sys.mjs";
+import { channelSessionStore } from "resource://gre/modules/BerytusChannelSessionStore.sys.mjs";
 class Liaison {
     #managers = {};
+    /**
+     * Signing keys are long-lived, thus they are cached per
+     * manager. An entry is dropped when the manager is
+     * (re-)registered or erased, or when it signals a key rotation.
+     */
+    #signingKeys = new Map();
+    /**
+     * The user attributes of registration operations, cached for the
+     * lifetime of the operation, so that the values left out of the
+     * operation snapshot can be loaded without refetching the whole
+     * set. Keyed by manager id, then by channel and operation id. An
+     * entry is dropped when its operation, channel or document is
+     * closed, when the attributes are updated, or when the manager is
+     * (re-)registered or erased.
+     */
+    #userAttributes = new Map();
     get managers() {
         const res = [];
         Object.values(this.#managers).forEach(manager => {
@@ -18,6 +35,9 @@ class Liaison {
                 ' manager does not exist (invalid id).');
         }
         delete this.#managers[id];
+        this.invalidateSigningKey(id);
+        this.#userAttributes.delete(id);
+        channelSessionStore.revokeManager(id);
     }
     registerManager({ id, type, name, icon }, handler) {
         if (this.#managers[id]) {
@@ -40,6 +60,114 @@ class Liaison {
             metadata: new SecretManagerInfo(id, name, type, icon),
             handler: new SequentialRequestHandler(handler)
         };
+        this.invalidateSigningKey(id);
+        this.#userAttributes.delete(id);
+        channelSessionStore.revokeManager(id);
+    }
+    /**
+     * Returns the cached signing key of the manager, or calls
+     * fetchKey() and caches its result. A failed fetch is not cached.
+     */
+    getSigningKey(id, fetchKey) {
+        const cached = this.#signingKeys.get(id);
+        if (cached) {
+            return cached;
+        }
+        const key = fetchKey();
+        this.#signingKeys.set(id, key);
+        key.catch(() => {
+            if (this.#signingKeys.get(id) === key) {
+                this.#signingKeys.delete(id);
+            }
+        });
+        return key;
+    }
+    setSigningKey(id, key) {
+        if (!this.isManagerRegistered(id)) {
+            return;
+        }
+        this.#signingKeys.set(id, Promise.resolve(key));
+    }
+    invalidateSigningKey(id) {
+        this.#signingKeys.delete(id);
+    }
+    /**
+     * Returns the cached user attributes of the operation, or calls
+     * fetchAttributes() and caches its result. A failed fetch is not
+     * cached.
+     */
+    getUserAttributes(id, context, fetchAttributes) {
+        if (!this.isManagerRegistered(id)) {
+            return fetchAttributes();
+        }
+        let operations = this.#userAttributes.get(id);
+        if (!operations) {
+            operations = new Map();
+            this.#userAttributes.set(id, operations);
+        }
+        const key = JSON.stringify([context.channel.id, context.operation.id]);
+        const cached = operations.get(key);
+        if (cached) {
+            return cached.attributes;
+        }
+        const entry = {
+            documentId: context.document.id,
+            channelId: context.channel.id,
+            attributes: fetchAttributes()
+        };
+        operations.set(key, entry);
+        entry.attributes.catch(() => {
+            if (operations.get(key) === entry) {
+                operations.delete(key);
+            }
+        });
+        return entry.attributes;
+    }
+    /**
+     * Drops the cached user attributes of the operation, or of every
+     * operation of the channel if operationId is not passed.
+     */
+    invalidateUserAttributes(id, channelId, operationId) {
+        const operations = this.#userAttributes.get(id);
+        if (!operations) {
+            return;
+        }
+        if (operationId !== undefined) {
+            operations.delete(JSON.stringify([channelId, operationId]));
+            return;
+        }
+        operations.forEach((entry, key) => {
+            if (entry.channelId === channelId) {
+                operations.delete(key);
+            }
+        });
+    }
+    /**
+     * Releases the per-operation state the managers' request
+     * handlers hold for the document (inner window id).
+     */
+    releaseDocument(documentId) {
+        Object.values(this.#managers).forEach(manager => {
+            manager.handler.releaseDocument(documentId);
+        });
+        this.#userAttributes.forEach(operations => {
+            operations.forEach((entry, key) => {
+                if (entry.documentId === documentId) {
+                    operations.delete(key);
+                }
+            });
+        });
+    }
+    /**
+     * Cancels the manager's request, if it is still pending.
+     * Returns whether a request was cancelled.
+     */
+    cancelRequest(managerId, requestId) {
+        const manager = this.#managers[managerId];
+        if (!manager) {
+            return false;
+        }
+        return manager.handler.cancel(requestId);
     }
     isManagerRegistered(id) {
         return id in this.#managers;
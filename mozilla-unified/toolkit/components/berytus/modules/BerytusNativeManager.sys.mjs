@@ -1,6 +1,53 @@
 /* This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+import { XPCOMUtils } from "resource://gre/modules/XPCOMUtils.sys.mjs";
+const lazy = {};
+// The account the native manager answers with, for testing web apps
+// against a secret manager without an extension.
+XPCOMUtils.defineLazyPreferenceGetter(lazy, "ACCOUNT_USERNAME", "dom.berytus.native_manager.username", "user123");
+XPCOMUtils.defineLazyPreferenceGetter(lazy, "ACCOUNT_PASSWORD", "dom.berytus.native_manager.password", "pass123");
+/**
+ * The SRP clients of the exchanges in progress, by channel, operation
+ * and challenge. Closing an operation or a channel discards the
+ * exchanges it left unfinished.
+ */
+class SrpExchanges {
+    #clients = new Map();
+    get(context, challengeId) {
+        const client = this.#clients.get(context.channel.id)
+            ?.get(context.operation.id)
+            ?.get(challengeId);
+        if (!client) {
+            throw new Error(`No SRP exchange in progress for challenge ${challengeId}`);
+        }
+        return client;
+    }
+    set(context, challengeId, client) {
+        let operations = this.#clients.get(context.channel.id);
+        if (!operations) {
+            operations = new Map();
+            this.#clients.set(context.channel.id, operations);
+        }
+        let challenges = operations.get(context.operation.id);
+        if (!challenges) {
+            challenges = new Map();
+            operations.set(context.operation.id, challenges);
+        }
+        challenges.set(challengeId, client);
+    }
+    delete(context, challengeId) {
+        this.#clients.get(context.channel.id)
+            ?.get(context.operation.id)
+            ?.delete(challengeId);
+    }
+    deleteOperation(context) {
+        this.#clients.get(context.channel.id)?.delete(context.operation.id);
+    }
+    deleteChannel(context) {
+        this.#clients.delete(context.channel.id);
+    }
+}
 class ManagerRequestHandler {
     getSigningKey(context, args) {
         // priv: MC4CAQAwBQYDK2VwBCIEINceTfVAd0DzkZKmfmGurcoljjOPm6Ix9CTNBXLcWt3b
@@ -11,6 +58,10 @@ class ManagerRequestHandler {
     }
 }
 class LoginRequestHandler {
+    #srpExchanges;
+    constructor(srpExchanges) {
+        this.#srpExchanges = srpExchanges;
+    }
     approveOperation(context, args) {
         if (args.operation.intent === "PendingDeclaration") {
             context.response.resolve("Register");
@@ -19,6 +70,7 @@ class LoginRequestHandler {
         context.response.resolve(args.operation.intent);
     }
     closeOperation(context) {
+        this.#srpExchanges.deleteOperation(context);
         context.response.resolve();
     }
     getRecordMetadata(context) {
@@ -34,16 +86,26 @@ class LoginRequestHandler {
     }
 }
 class ChannelRequestHandler {
+    #srpExchanges;
+    constructor(srpExchanges) {
+        this.#srpExchanges = srpExchanges;
+    }
     createChannel(context, args) {
         // priv: MC4CAQAwBQYDK2VwBCIEINceTfVAd0DzkZKmfmGurcoljjOPm6Ix9CTNBXLcWt3b
         context.response.resolve();
     }
+    bootstrapChannel(context, args) {
+        context.response.resolve("MCowBQYDK2VwAyEAJevlUdx72BF8mxdwurBJI9WNgRDMaoYfb0VqywaLOJE=");
+    }
     generateX25519Key(context) {
         throw new Error('Method not implemented.');
     }
     signKeyExchangeParameters(context, args) {
         throw new Error('Method not implemented.');
     }
+    establishEndToEndEncryption(context, args) {
+        throw new Error('Method not implemented.');
+    }
     verifySignedKeyExchangeParameters(context, args) {
         throw new Error('Method not implemented.');
     }
@@ -51,17 +113,24 @@ class ChannelRequestHandler {
         throw new Error('Method not implemented.');
     }
     closeChannel(context) {
+        this.#srpExchanges.deleteChannel(context);
         context.response.resolve();
     }
 }
 class AccountCreationRequestHandler {
+    #passwordGenerator = Cc["@mozilla.org/berytus/password-generator;1"].getService(Ci.mozIBerytusPasswordGenerator);
     approveTransitionToAuthOp(context, args) {
         context.response.resolve();
     }
     getUserAttributes(context) {
         context.response.resolve([
             { id: "name", value: "Ali", mimeType: "text/plain" },
-            { id: "familyName", value: "Cherry", mimeType: "text/plain" }
+            { id: "familyName", value: "Cherry", mimeType: "text/plain" },
+            {
+                id: "picture",
+                value: new Blob(["\x89PNG"], { type: "image/png" }),
+                mimeType: "image/png"
+            }
         ]);
     }
     updateUserAttributes(context, args) {
@@ -82,7 +151,9 @@ class AccountCreationRequestHandler {
             case "Password":
                 context.response.resolve(args.field.value !== null
                     ? null
-                    : "password1234");
+                    : args.field.options.passwordRules
+                        ? this.#passwordGenerator.generatePassword(args.field.options.passwordRules)
+                        : "password1234");
                 break;
             case "SecurePassword":
                 context.response.resolve(args.field.value !== null
@@ -155,14 +226,54 @@ class AccountCreationRequestHandler {
         }
     }
 }
+// Sizes of the RFC 5054 groups, in bits.
+const SRP_GROUP_BITS = [1024, 1536, 2048, 3072, 4096, 6144, 8192];
+/**
+ * The group is chosen by the web app. B is padded to the length of
+ * the modulus, so the group in use is the smallest one that fits it.
+ */
+const srpGroupBitsFor = (serverPublicKey) => {
+    const groupBits = SRP_GROUP_BITS.find(bits => bits >= serverPublicKey.length * 8);
+    if (groupBits === undefined) {
+        throw new Error("Unsupported SRP group");
+    }
+    return groupBits;
+};
+const srpPayloadToBytes = (payload) => {
+    if (typeof payload === "string") {
+        return (payload.match(/[\da-f]{2}/gi) || []).map(function (h) {
+            return parseInt(h, 16);
+        });
+    }
+    if (payload instanceof ArrayBuffer) {
+        return Array.from(new Uint8Array(payload));
+    }
+    if (ArrayBuffer.isView(payload)) {
+        return Array.from(new Uint8Array(payload.buffer, payload.byteOffset, payload.byteLength));
+    }
+    throw new Error("Unsupported SRP payload type");
+};
+const srpBytesToResponse = (bytes, encoding) => {
+    if (encoding === "Hex") {
+        return bytes.map(b => b.toString(16).padStart(2, "0")).join("");
+    }
+    return new Uint8Array(bytes).buffer;
+};
 class AccountAuthenticationRequestHandler {
+    #srp = Cc["@mozilla.org/berytus/srp-service;1"].getService(Ci.mozIBerytusSrpService);
+    #srpExchanges;
+    constructor(srpExchanges) {
+        this.#srpExchanges = srpExchanges;
+    }
     approveChallengeRequest(context, args) {
         context.response.resolve();
     }
     abortChallenge(context, args) {
+        this.#srpExchanges.delete(context, args.challenge.id);
         context.response.resolve();
     }
     closeChallenge(context, args) {
+        this.#srpExchanges.delete(context, args.challenge.id);
         context.response.resolve();
     }
     respondToChallengeMessage(context, args) {
@@ -170,7 +281,7 @@ class AccountAuthenticationRequestHandler {
             case "Identification": {
                 const result = {};
                 args.payload.forEach(fieldId => {
-                    result[fieldId] = "user123";
+                    result[fieldId] = lazy.ACCOUNT_USERNAME;
                 });
                 context.response.resolve({
                     response: result
@@ -180,7 +291,7 @@ class AccountAuthenticationRequestHandler {
             case "Password": {
                 const result = {};
                 args.payload.forEach(fieldId => {
-                    result[fieldId] = "pass123";
+                    result[fieldId] = lazy.ACCOUNT_PASSWORD;
                 });
                 context.response.resolve({
                     response: result
@@ -211,41 +322,35 @@ class AccountAuthenticationRequestHandler {
                 switch (args.name) {
                     case 'SelectSecurePassword': {
                         context.response.resolve({
-                            response: "user123"
+                            response: lazy.ACCOUNT_USERNAME
                         });
                         return;
                     }
                     case "ExchangePublicKeys": {
-                        const clientPublicKeyHex = "96b608dfa551a481331a18818dd30c69431f86e0438cfa2cca2c1638626fcffbb50bb688b4ef49c47abc2f9da629e88f09a2c306a5fddf2d9c4fe1237c29a6939ad01dd62613f38b5e08fc60da1e63d857324ea2ba7a82bac682a3d425c4a3ece1ba3ea9113d13fbb0a01d2998e95de366bb26243374b2665ff20a40f80534f0b6d2bb2ddc727a877de4725a52bf38f0e9534f1629ff36896b95aab14f19224e8fa7d51c136e2aa1ce321ca1758d53bec97fd5d97d0896f4dd3a4630a62c265a550243b8535dece439e62977da4ed41b914810f03c1f0c7885609e96bd6375d7cafd084dc1b40ddc5f467aae2cfa478bdd89a81caf8ed1de5d4e85dc2c56a7bec60ecd0df57d24a5dbaac049b74fb615f0f4c83420279b4f46cfae93795937f6b6e86a80b8f9a942ffedca93f31c210ccb2956c851aed8d737ab233c54bc87a04ccdf8f885eedefcee6378c54e9090d1e2b1ad9c8ba1898c63e0cf3913e810c6684bb36effa503df0288eef6720330d8cda8ad54194166200d6461b14809380e385afa68e5387188e293d59db1c46b1589ad3c48d99550fc104345b9d61231ac0ff753f28ae150aeaea1cf3fd448017fac7c534d1d608579deb3944bc0555482a0ce2102a19d02fe5fe18c463c460a88a93cc1c6b8052576de1c32c2204a7adc0a4d6fb9648cb93364e44b0c8c80e3f4a50c19c9c41bf771ae4d42e8d508285b";
-                        if (args.challenge.parameters.encoding === "Hex") {
-                            context.response.resolve({
-                                response: clientPublicKeyHex
-                            });
-                            return;
-                        }
+                        const serverPublicKey = srpPayloadToBytes(args.payload);
+                        const client = this.#srp.createClient(srpGroupBitsFor(serverPublicKey), lazy.ACCOUNT_USERNAME, lazy.ACCOUNT_PASSWORD);
+                        client.setServerPublicKey(serverPublicKey);
+                        this.#srpExchanges.set(context, args.challenge.id, client);
                         context.response.resolve({
-                            response: new Uint8Array(clientPublicKeyHex.match(/[\da-f]{2}/gi).map(function (h) {
-                                return parseInt(h, 16);
-                            })).buffer
+                            response: srpBytesToResponse(client.publicKey, args.challenge.parameters.encoding)
                         });
                         return;
                     }
                     case "ComputeClientProof": {
-                        const dummyHex = "AA55";
-                        if (args.challenge.parameters.encoding === "Hex") {
-                            context.response.resolve({
-                                response: dummyHex
-                            });
-                            return;
-                        }
+                        const client = this.#srpExchanges.get(context, args.challenge.id);
+                        const proof = client.computeClientProof(srpPayloadToBytes(args.payload));
                         context.response.resolve({
-                            response: new Uint8Array(dummyHex.match(/[\da-f]{2}/gi).map(function (h) {
-                                return parseInt(h, 16);
-                            })).buffer
+                            response: srpBytesToResponse(proof, args.challenge.parameters.encoding)
                         });
                         return;
                     }
                     case "VerifyServerProof": {
+                        const client = this.#srpExchanges.get(context, args.challenge.id);
+                        this.#srpExchanges.delete(context, args.challenge.id);
+                        if (!client.verifyServerProof(srpPayloadToBytes(args.payload))) {
+                            context.response.reject(new Components.Exception("The server proof does not match", Cr.NS_ERROR_FAILURE));
+                            return;
+                        }
                         context.response.resolve({});
                         return;
                     }
@@ -255,9 +360,10 @@ class AccountAuthenticationRequestHandler {
     }
 }
 export class NativeManager {
+    #srpExchanges = new SrpExchanges();
     manager = new ManagerRequestHandler();
-    login = new LoginRequestHandler();
-    channel = new ChannelRequestHandler();
+    login = new LoginRequestHandler(this.#srpExchanges);
+    channel = new ChannelRequestHandler(this.#srpExchanges);
     accountCreation = new AccountCreationRequestHandler();
-    accountAuthentication = new AccountAuthenticationRequestHandler();
+    accountAuthentication = new AccountAuthenticationRequestHandler(this.#srpExchanges);
 }
@@ -1,7 +1,8 @@
 /* This Source Code Form is subject to the terms of the Mozilla Public
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
-import { ESecretManagerType } from "resource://gre/modules/BerytusLiaison.sys.mjs";
+import { ESecretManagerType, liaison } from "resource://gre/modules/BerytusLiaison.sys.mjs";
+import { channelSessionStore } from "resource://gre/modules/BerytusChannelSessionStore.sys.mjs";
 import { XPCOMUtils } from "resource://gre/modules/XPCOMUtils.sys.mjs";
 import { Agent } from "resource://gre/modules/BerytusAgent.sys.mjs";
 const lazy = {};
@@ -16,7 +17,47 @@ export class PromptService {
             path: browsingContext.currentURI.filePath
         }, args);
         const selectedExtensionId = await Prompter.promptUsingPopupNotification(browsingContext, managerEntries);
-        return selectedExtensionId;
+        const selectedEntry = managerEntries.find(e => e.manager.id === selectedExtensionId);
+        return {
+            id: selectedExtensionId,
+            signingKey: await selectedEntry?.signingKey
+        };
+    }
+    /**
+     * Stores a channel for resumption by subsequent documents of the
+     * same origin; resolves with the resumption token. The origin is
+     * that of the window global of the calling actor, see
+     * BerytusPromptServiceParent.
+     */
+    async storeChannelSession(origin, session) {
+        if (!liaison.isManagerRegistered(session.managerId)) {
+            throw new Error("Cannot store channel session; " +
+                `manager ${session.managerId} is not registered.`);
+        }
+        return channelSessionStore.store({
+            origin,
+            managerId: session.managerId,
+            channelId: session.channelId,
+            scmEd25519Key: session.scmEd25519Key,
+            webAppEd25519Key: session.webAppEd25519Key
+        });
+    }
+    /**
+     * Resolves with the resumed session, or null if the token
+     * does not refer to a live session of this document's origin
+     * that satisfies the passed constraints. The secret manager
+     * is not prompted.
+     */
+    async resumeChannelSession(origin, resumptionToken, webAppEd25519Key, secretManagerPublicKey) {
+        const session = channelSessionStore.resume(resumptionToken, origin, webAppEd25519Key, secretManagerPublicKey);
+        if (session && !liaison.isManagerRegistered(session.managerId)) {
+            channelSessionStore.revokeManager(session.managerId);
+            return null;
+        }
+        return session;
+    }
+    async revokeChannelSession(origin, resumptionToken) {
+        return channelSessionStore.revoke(resumptionToken, origin);
     }
 }
 class Prompter {
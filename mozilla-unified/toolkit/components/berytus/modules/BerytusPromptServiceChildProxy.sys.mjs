@@ -44,11 +44,39 @@ export class XPPromptServiceChildProxy {
                 identity
             }
         };
-        const selectedId = await actor.sendQuery('BerytusPromptService:promptUsingPopupNotification', [
+        const selection = await actor.sendQuery('BerytusPromptService:promptUsingPopupNotification', [
             browsingContext,
             args
         ]);
-        return selectedId;
+        return selection;
+    }
+    async storeChannelSession(innerWindow, args_managerId, args_channelId, args_scmEd25519Key, args_webAppEd25519Key) {
+        const browsingContext = innerWindow.browsingContext;
+        const actor = getChildActor(browsingContext, 'BerytusPromptService');
+        return actor.sendQuery('BerytusPromptService:storeChannelSession', [
+            {
+                managerId: args_managerId,
+                channelId: args_channelId,
+                scmEd25519Key: args_scmEd25519Key,
+                webAppEd25519Key: args_webAppEd25519Key
+            }
+        ]);
+    }
+    async resumeChannelSession(innerWindow, args_resumptionToken, args_webAppEd25519Key, args_channelConstraints_secretManagerPublicKey) {
+        const browsingContext = innerWindow.browsingContext;
+        const actor = getChildActor(browsingContext, 'BerytusPromptService');
+        return actor.sendQuery('BerytusPromptService:resumeChannelSession', [
+            args_resumptionToken,
+            args_webAppEd25519Key,
+            args_channelConstraints_secretManagerPublicKey
+        ]);
+    }
+    async revokeChannelSession(innerWindow, args_resumptionToken) {
+        const browsingContext = innerWindow.browsingContext;
+        const actor = getChildActor(browsingContext, 'BerytusPromptService');
+        return actor.sendQuery('BerytusPromptService:revokeChannelSession', [
+            args_resumptionToken
+        ]);
     }
 }
 // @ts-ignore
@@ -143,6 +143,49 @@ export class IsolatedRequestHandler {
                     return;
                 }
             },
+            async bootstrapChannel(context, args) {
+                try {
+                    await self.preCall("channel", "bootstrapChannel", { context, args });
+                }
+                catch (e) {
+                    context.response.reject(e);
+                    return;
+                }
+                const wrappedResponseCtx = {
+                    response: {
+                        async resolve(val) {
+                            try {
+                                await self.preResolve("channel", "bootstrapChannel", { context, args }, val);
+                            }
+                            catch (e) {
+                                context.response.reject(e);
+                                throw new Error(e.reason || "ResolutionFailure");
+                            }
+                            context.response.resolve(val);
+                        },
+                        async reject(val) {
+                            try {
+                                await self.preReject("channel", "bootstrapChannel", { context, args }, val);
+                            }
+                            catch (e) {
+                                context.response.reject(e);
+                                throw e;
+                            }
+                            context.response.reject(val);
+                        }
+                    }
+                };
+                try {
+                    await self.#impl.channel.bootstrapChannel({
+                        ...context,
+                        ...wrappedResponseCtx
+                    }, args);
+                }
+                catch (e) {
+                    self.handleUnexpectedException("channel", "bootstrapChannel", context.response, e);
+                    return;
+                }
+            },
             async generateX25519Key(context) {
                 try {
                     await self.preCall("channel", "generateX25519Key", { context });
@@ -229,6 +272,49 @@ export class IsolatedRequestHandler {
                     return;
                 }
             },
+            async establishEndToEndEncryption(context, args) {
+                try {
+                    await self.preCall("channel", "establishEndToEndEncryption", { context, args });
+                }
+                catch (e) {
+                    context.response.reject(e);
+                    return;
+                }
+                const wrappedResponseCtx = {
+                    response: {
+                        async resolve(val) {
+                            try {
+                                await self.preResolve("channel", "establishEndToEndEncryption", { context, args }, val);
+                            }
+                            catch (e) {
+                                context.response.reject(e);
+                                throw new Error(e.reason || "ResolutionFailure");
+                            }
+                            context.response.resolve(val);
+                        },
+                        async reject(val) {
+                            try {
+                                await self.preReject("channel", "establishEndToEndEncryption", { context, args }, val);
+                            }
+                            catch (e) {
+                                context.response.reject(e);
+                                throw e;
+                            }
+                            context.response.reject(val);
+                        }
+                    }
+                };
+                try {
+                    await self.#impl.channel.establishEndToEndEncryption({
+                        ...context,
+                        ...wrappedResponseCtx
+                    }, args);
+                }
+                catch (e) {
+                    self.handleUnexpectedException("channel", "establishEndToEndEncryption", context.response, e);
+                    return;
+                }
+            },
             async verifySignedKeyExchangeParameters(context, args) {
                 try {
                     await self.preCall("channel", "verifySignedKeyExchangeParameters", { context, args });
@@ -941,7 +1027,9 @@ export class IsolatedRequestHandler {
 }
 const lazy = {};
 ChromeUtils.defineESModuleGetters(lazy, {
-    Schemas: "resource://gre/modules/Schemas.sys.mjs"
+    Schemas: "resource://gre/modules/Schemas.sys.mjs",
+    setTimeout: "resource://gre/modules/Timer.sys.mjs",
+    clearTimeout: "resource://gre/modules/Timer.sys.mjs"
 });
 const requestIs = (requestType, d) => {
     return d.context.request.type === requestType;
@@ -1047,7 +1135,7 @@ class ResolutionError extends Error {
 class FieldIdValidator {
     /**
      * op id -> field id -> true
-     * TODO(berytus): There should be a cleanup mechanism.
+     * Entries are dropped through release() once the operation ends.
      */
     #fields;
     constructor() {
@@ -1099,6 +1187,9 @@ class FieldIdValidator {
         }
     }
     async digest(group, method, input, output) { }
+    release(operationId) {
+        delete this.#fields[operationId];
+    }
     async rollback(group, method, input) {
         if (inputIs("AccountCreation_AddField", input)) {
             const { operation } = input.context;
@@ -1111,7 +1202,7 @@ class FieldIdValidator {
 class ChallangeMessagingSequenceValidator {
     /**
      * op id -> ch id -> nb of messages sent
-     * TODO(berytus): There should be a cleanup mechanism.
+     * Entries are dropped through release() once the operation ends.
      */
     #counter;
     constructor() {
@@ -1212,6 +1303,9 @@ class ChallangeMessagingSequenceValidator {
         }
     }
     async digest(group, method, input, output) { }
+    release(operationId) {
+        delete this.#counter[operationId];
+    }
     async rollback(group, method, input) {
         if (!inputIs("AccountAuthentication_RespondToChallengeMessage", input)) {
             return;
@@ -1232,6 +1326,7 @@ class ChallangeMessagingSequenceValidator {
 class FieldCreationHandler {
     async consume(group, method, input) { }
     async rollback(group, method, input) { }
+    release(operationId) { }
     async digest(group, method, input, output) {
         const errorPrefix = `Malformed output passed from the request handler's `
             + `${group}:${method} method.`;
@@ -1268,9 +1363,16 @@ class FieldCreationHandler {
 export class ValidatedRequestHandler extends IsolatedRequestHandler {
     #schema;
     #validators;
+    /**
+     * op id -> the channel and the document (inner window id) the
+     * operation belongs to. Used to release the validators' state of
+     * operations whose channel was closed or whose document is gone.
+     */
+    #operations;
     constructor(impl) {
         // TODO(berytus): ensure impl is conformant
         super(impl);
+        this.#operations = new Map();
         this.#validators = [];
         this.#validators.push(new FieldIdValidator(), new ChallangeMessagingSequenceValidator(), new FieldCreationHandler());
     }
@@ -1303,6 +1405,7 @@ export class ValidatedRequestHandler extends IsolatedRequestHandler {
             this.#validateValue(parameters[1].type, input.args, message);
         }
         await this.#consumeValidators(group, method, input);
+        this.#trackOperation(input);
         try {
             await super.preCall(group, method, input);
         }
@@ -1332,6 +1435,47 @@ export class ValidatedRequestHandler extends IsolatedRequestHandler {
             }
         }
         await super.preResolve(group, method, input, output);
+        this.#releaseEndedOperations(input);
+    }
+    /**
+     * Releases the validators' state of the operations that took
+     * place in the document, e.g. once the document is destroyed.
+     */
+    releaseDocument(documentId) {
+        this.#releaseOperations(scope => scope.documentId === documentId);
+    }
+    #trackOperation(input) {
+        const { operation, channel } = input.context;
+        if (!operation || !channel || this.#operations.has(operation.id)) {
+            return;
+        }
+        this.#operations.set(operation.id, {
+            channelId: channel.id,
+            documentId: input.context.document.id
+        });
+    }
+    #releaseEndedOperations(input) {
+        if (inputIs("Login_CloseOperation", input)
+            || inputIs("AccountCreation_ApproveTransitionToAuthOp", input)) {
+            const { operation } = input.context;
+            this.#releaseOperation(operation.id);
+            return;
+        }
+        if (inputIs("Channel_CloseChannel", input)) {
+            const { channel } = input.context;
+            this.#releaseOperations(scope => scope.channelId === channel.id);
+        }
+    }
+    #releaseOperations(predicate) {
+        for (const [operationId, scope] of this.#operations) {
+            if (predicate(scope)) {
+                this.#releaseOperation(operationId);
+            }
+        }
+    }
+    #releaseOperation(operationId) {
+        this.#operations.delete(operationId);
+        this.#validators.forEach(val => val.release(operationId));
     }
     async preReject(group, method, input, value) {
         // TODO(berytus): validate error value
@@ -1392,34 +1536,178 @@ export class ValidatedRequestHandler extends IsolatedRequestHandler {
 }
 export class SequentialRequestHandler extends ValidatedRequestHandler {
     busy = false;
+    #impl;
+    /**
+     * The request sent to the secret manager and not yet settled.
+     * Cleared when the request is settled or cancelled; late
+     * settlements of a cancelled request are refused.
+     */
+    #pending;
+    /**
+     * Requests waiting for the pending one to settle, in arrival
+     * order. The handler of a secret manager is shared by the
+     * channels of all windows, so their requests are queued rather
+     * than refused.
+     */
+    #queue = [];
+    constructor(impl) {
+        super(impl);
+        this.#impl = impl;
+    }
+    #isPending(input) {
+        return this.#pending !== undefined
+            && this.#pending.context === input.context;
+    }
+    #clearPending() {
+        if (this.#pending?.deadlineTimer !== undefined) {
+            // @ts-ignore: TS did not catch assertion for "lazy"
+            lazy.clearTimeout(this.#pending.deadlineTimer);
+        }
+        this.#pending = undefined;
+        this.#proceedWithNext();
+    }
+    /**
+     * Hands the turn to the oldest queued request, if any; the
+     * handler stays busy in that case.
+     */
+    #proceedWithNext() {
+        const next = this.#queue.shift();
+        if (!next) {
+            this.busy = false;
+            return;
+        }
+        if (next.deadlineTimer !== undefined) {
+            // @ts-ignore: TS did not catch assertion for "lazy"
+            lazy.clearTimeout(next.deadlineTimer);
+        }
+        next.proceed();
+    }
+    #dequeue(queued, reason) {
+        const index = this.#queue.indexOf(queued);
+        if (index === -1) {
+            return;
+        }
+        this.#queue.splice(index, 1);
+        if (queued.deadlineTimer !== undefined) {
+            // @ts-ignore: TS did not catch assertion for "lazy"
+            lazy.clearTimeout(queued.deadlineTimer);
+        }
+        queued.fail(reason);
+    }
+    /**
+     * Resolves once the requests ahead are settled. Rejects if the
+     * request is cancelled, or its deadline is passed, while queued.
+     */
+    #waitForTurn(input) {
+        return new Promise((resolve, reject) => {
+            const queued = {
+                requestId: input.context.request.id,
+                proceed: resolve,
+                fail: reject
+            };
+            const { deadline } = input.context.request;
+            if (deadline !== undefined) {
+                // @ts-ignore: TS did not catch assertion for "lazy"
+                queued.deadlineTimer = lazy.setTimeout(() => {
+                    this.#dequeue(queued, new Components.Exception(`Request ${queued.requestId} timed out.`, Cr.NS_ERROR_NET_TIMEOUT));
+                }, Math.max(deadline - Date.now(), 0));
+            }
+            this.#queue.push(queued);
+        });
+    }
+    #refuseStaleSettlement(input) {
+        if (!this.#isPending(input)) {
+            throw new Components.Exception(`Request ${input.context.request.id} is no longer `
+                + 'pending; it was either cancelled or already settled.', Cr.NS_BINDING_ABORTED);
+        }
+        this.#clearPending();
+    }
+    /**
+     * Rejects the pending request with the passed reason, rolls back
+     * the validators and notifies the secret manager so that it can
+     * stop processing the request.
+     */
+    #abort(pending, reason) {
+        const requestId = pending.context.request.id;
+        this.#clearPending();
+        super.preReject(pending.group, pending.method, { context: pending.context }, reason).catch(e => {
+            console.warn(`Unable to roll back aborted request ${requestId}`, e);
+        });
+        pending.context.response.reject(reason);
+        try {
+            this.#impl.cancelRequest?.(requestId);
+        }
+        catch (e) {
+            console.warn(`Secret manager failed to cancel request ${requestId}`, e);
+        }
+    }
     async preCall(group, method, input) {
         if (this.busy) {
-            throw new Components.Exception('Refusing to send request to secret manager, '
-                + 'an existing request is still pending. '
-                + 'make sure to send one request at a time '
-                + 'to the secret manager.', Cr.NS_ERROR_FAILURE);
+            // The turn is handed over with the handler still busy.
+            await this.#waitForTurn(input);
         }
         this.busy = true;
+        const pending = {
+            group,
+            method,
+            context: input.context
+        };
+        const { deadline } = input.context.request;
+        if (deadline !== undefined) {
+            // @ts-ignore: TS did not catch assertion for "lazy"
+            pending.deadlineTimer = lazy.setTimeout(() => {
+                if (this.#pending !== pending) {
+                    return;
+                }
+                this.#abort(pending, new Components.Exception(`Request ${pending.context.request.id} timed out.`, Cr.NS_ERROR_NET_TIMEOUT));
+            }, Math.max(deadline - Date.now(), 0));
+        }
+        this.#pending = pending;
         try {
             await super.preCall(group, method, input);
         }
         catch (e) {
-            this.busy = false;
+            this.#clearPending();
             throw e;
         }
     }
     async preResolve(group, method, input, value) {
-        this.busy = false;
+        this.#refuseStaleSettlement(input);
         await super.preResolve(group, method, input, value);
     }
     async preReject(group, method, input, value) {
-        this.busy = false;
+        this.#refuseStaleSettlement(input);
         await super.preReject(group, method, input, value);
     }
     handleUnexpectedException(group, method, response, excp) {
-        this.busy = false;
+        if (this.#pending?.context.response !== response) {
+            // The request was cancelled; its response is settled.
+            return;
+        }
+        this.#clearPending();
         super.handleUnexpectedException(group, method, response, excp);
     }
+    /**
+     * Cancels the pending or a queued request if its id matches; the
+     * request is rejected with NS_BINDING_ABORTED. A queued request
+     * is dropped before reaching the secret manager. Requests with a
+     * deadline are likewise aborted with NS_ERROR_NET_TIMEOUT once
+     * the deadline is passed. Returns whether a request was cancelled.
+     */
+    cancel(requestId) {
+        const reason = new Components.Exception(`Request ${requestId} was cancelled.`, Cr.NS_BINDING_ABORTED);
+        const pending = this.#pending;
+        if (pending?.context.request.id === requestId) {
+            this.#abort(pending, reason);
+            return true;
+        }
+        const queued = this.#queue.find(q => q.requestId === requestId);
+        if (!queued) {
+            return false;
+        }
+        this.#dequeue(queued, reason);
+        return true;
+    }
 }
 function uuid() {
     // @ts-ignore: TODO(berytus): add to index.d.ts
@@ -1459,6 +1747,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Manager_GetSigningKey"
                         }
                     };
@@ -1484,6 +1773,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Manager_GetCredentialsMetadata"
                         }
                     };
@@ -1511,6 +1801,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Channel_CreateChannel"
                         }
                     };
@@ -1521,6 +1812,32 @@ export class PublicRequestHandler {
                     }, args);
                 });
             },
+            bootstrapChannel(context, args) {
+                return new Promise((_resolve, _reject) => {
+                    const responseCtx = {
+                        response: {
+                            resolve(val) {
+                                _resolve(val);
+                            },
+                            reject(val) {
+                                _reject(val);
+                            }
+                        }
+                    };
+                    const requestCtx = {
+                        request: {
+                            id: uuid(),
+                            ...context.request,
+                            type: "Channel_BootstrapChannel"
+                        }
+                    };
+                    self.#impl.channel.bootstrapChannel({
+                        ...context,
+                        ...responseCtx,
+                        ...requestCtx
+                    }, args);
+                });
+            },
             generateX25519Key(context) {
                 return new Promise((_resolve, _reject) => {
                     const responseCtx = {
@@ -1536,6 +1853,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Channel_GenerateX25519Key"
                         }
                     };
@@ -1561,6 +1879,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Channel_SignKeyExchangeParameters"
                         }
                     };
@@ -1571,6 +1890,32 @@ export class PublicRequestHandler {
                     }, args);
                 });
             },
+            establishEndToEndEncryption(context, args) {
+                return new Promise((_resolve, _reject) => {
+                    const responseCtx = {
+                        response: {
+                            resolve(val) {
+                                _resolve(val);
+                            },
+                            reject(val) {
+                                _reject(val);
+                            }
+                        }
+                    };
+                    const requestCtx = {
+                        request: {
+                            id: uuid(),
+                            ...context.request,
+                            type: "Channel_EstablishEndToEndEncryption"
+                        }
+                    };
+                    self.#impl.channel.establishEndToEndEncryption({
+                        ...context,
+                        ...responseCtx,
+                        ...requestCtx
+                    }, args);
+                });
+            },
             verifySignedKeyExchangeParameters(context, args) {
                 return new Promise((_resolve, _reject) => {
                     const responseCtx = {
@@ -1586,6 +1931,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Channel_VerifySignedKeyExchangeParameters"
                         }
                     };
@@ -1611,6 +1957,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Channel_EnableEndToEndEncryption"
                         }
                     };
@@ -1636,6 +1983,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Channel_CloseChannel"
                         }
                     };
@@ -1663,6 +2011,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Login_ApproveOperation"
                         }
                     };
@@ -1688,6 +2037,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Login_CloseOperation"
                         }
                     };
@@ -1713,6 +2063,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Login_GetRecordMetadata"
                         }
                     };
@@ -1738,6 +2089,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Login_UpdateMetadata"
                         }
                     };
@@ -1765,6 +2117,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountCreation_ApproveTransitionToAuthOp"
                         }
                     };
@@ -1790,6 +2143,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountCreation_GetUserAttributes"
                         }
                     };
@@ -1815,6 +2169,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountCreation_UpdateUserAttributes"
                         }
                     };
@@ -1840,6 +2195,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountCreation_AddField"
                         }
                     };
@@ -1865,6 +2221,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountCreation_RejectFieldValue"
                         }
                     };
@@ -1892,6 +2249,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountAuthentication_ApproveChallengeRequest"
                         }
                     };
@@ -1917,6 +2275,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountAuthentication_AbortChallenge"
                         }
                     };
@@ -1942,6 +2301,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountAuthentication_CloseChallenge"
                         }
                     };
@@ -1967,6 +2327,7 @@ export class PublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountAuthentication_RespondToChallengeMessage"
                         }
                     };
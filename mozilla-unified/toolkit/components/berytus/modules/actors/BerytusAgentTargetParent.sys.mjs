@@ -2,8 +2,19 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 import { Agent } from "resource://gre/modules/BerytusAgent.sys.mjs";
+import { liaison } from "resource://gre/modules/BerytusLiaison.sys.mjs";
 export const Actor = "BerytusAgentTarget";
 export class BerytusAgentTargetParent extends JSWindowActorParent {
+    /**
+     * The inner window id of the window global, which is
+     * the document id of the request contexts.
+     */
+    #innerWindowId;
+    /**
+     * request id -> manager id of the requests sent by the
+     * window global that have not settled yet.
+     */
+    #pendingRequests = new Map();
     #isGroupValid(target, group) {
         if (typeof group !== "string") {
             return false;
@@ -14,11 +25,15 @@ export class BerytusAgentTargetParent extends JSWindowActorParent {
         if (msg.name !== `${Actor}:invokeRequestHandler`) {
             throw new Error(`Received malformed message name (${msg.name})`);
         }
-        const { managerId, group, method, requestContext, requestArgs } = msg.data;
+        const { managerId, group, method, requestId, requestTimeout, requestContext, requestArgs } = msg.data;
         if (typeof managerId !== 'string') {
             throw new Error("Received malformed message data; " +
                 "managerId is not a string.");
         }
+        if (typeof requestId !== 'string' || this.#pendingRequests.has(requestId)) {
+            throw new Error("Received malformed message data; " +
+                `requestId is not valid (${requestId}).`);
+        }
         const target = Agent.target(managerId);
         if (!this.#isGroupValid(target, group)) {
             throw new Error("Received malformed message data; " +
@@ -29,13 +44,51 @@ export class BerytusAgentTargetParent extends JSWindowActorParent {
             throw new Error("Received malformed message data; " +
                 `method is not valid (${method}).`);
         }
-        const result = await fn.apply(target, [requestContext, requestArgs]);
-        return result;
+        const request = { id: requestId };
+        if (typeof requestTimeout === 'number' && requestTimeout > 0) {
+            // The secret manager is given until the deadline to settle
+            // the request; see SequentialRequestHandler.
+            request.deadline = Date.now() + requestTimeout;
+        }
+        this.#pendingRequests.set(requestId, managerId);
+        try {
+            const result = await fn.apply(target, [{ ...requestContext, request }, requestArgs]);
+            return result;
+        }
+        finally {
+            this.#pendingRequests.delete(requestId);
+        }
+    }
+    #cancelRequest(msg) {
+        const { requestId } = msg.data;
+        const managerId = this.#pendingRequests.get(requestId);
+        if (managerId === undefined) {
+            // Already settled.
+            return;
+        }
+        liaison.cancelRequest(managerId, requestId);
+    }
+    actorCreated() {
+        // @ts-ignore: TODO(berytus): add to index.d.ts
+        this.#innerWindowId = this.manager.innerWindowId;
     }
     didDestroy() {
         console.debug(`BerytusAgentTargetParent::didDestroy()`);
+        // Nobody is awaiting the pending requests anymore; let the
+        // secret managers know before releasing the document's state.
+        for (const [requestId, managerId] of this.#pendingRequests) {
+            liaison.cancelRequest(managerId, requestId);
+        }
+        this.#pendingRequests.clear();
+        if (this.#innerWindowId !== undefined) {
+            liaison.releaseDocument(this.#innerWindowId);
+        }
     }
     async receiveMessage(msg) {
+        if (msg.name === `${Actor}:cancelRequest`) {
+            this.#cancelRequest(msg);
+            return;
+        }
         try {
             return (await this.#processMessage(msg));
         }
@@ -4,6 +4,16 @@
 import { PassthroughParent } from "resource://gre/modules/BerytusParentUtils.sys.mjs";
 import { PromptService } from "resource://gre/modules/BerytusPromptService.sys.mjs";
 export const Actor = 'BerytusPromptService';
+/**
+ * Methods keyed by the document's origin. The origin is taken from
+ * the window global of the actor rather than from the child, which
+ * could pass the browsing context of another document.
+ */
+const originBoundMethods = new Set([
+    "storeChannelSession",
+    "resumeChannelSession",
+    "revokeChannelSession"
+]);
 /* Class name must match Actor name */
 export class BerytusPromptServiceParent extends PassthroughParent {
     Actor = Actor;
@@ -14,4 +24,13 @@ export class BerytusPromptServiceParent extends PassthroughParent {
         }
         return this.#inst;
     }
+    doCall(messageName, args) {
+        if (!originBoundMethods.has(this.extractMethod(messageName))
+            || !Array.isArray(args)) {
+            return super.doCall(messageName, args);
+        }
+        // @ts-ignore: TODO(berytus): add to index.d.ts
+        const { origin } = this.manager.documentPrincipal;
+        return super.doCall(messageName, [origin, ...args]);
+    }
 }
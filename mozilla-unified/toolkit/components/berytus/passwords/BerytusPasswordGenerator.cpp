@@ -0,0 +1,57 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/berytus/BerytusPasswordGenerator.h"
+
+namespace mozilla::berytus {
+
+NS_IMPL_ISUPPORTS(PasswordGenerator, mozIBerytusPasswordGenerator)
+
+const PasswordRules* PasswordGenerator::GetRules(const nsACString& aRules) {
+  if (const auto entry = mRules.Lookup(aRules)) {
+    return entry.Data().get();
+  }
+  UniquePtr<PasswordRules> rules = PasswordRules::Compile(aRules);
+  if (!rules) {
+    return nullptr;
+  }
+  if (mRules.Count() >= kMaxCachedRules) {
+    mRules.Clear();
+  }
+  return mRules.InsertOrUpdate(aRules, std::move(rules)).get();
+}
+
+NS_IMETHODIMP
+PasswordGenerator::GeneratePassword(const nsACString& aPasswordRules,
+                                    nsACString& aRetVal) {
+  const PasswordRules* rules = GetRules(aPasswordRules);
+  if (!rules) {
+    return NS_ERROR_INVALID_ARG;
+  }
+  return rules->Generate(aRetVal);
+}
+
+NS_IMETHODIMP
+PasswordGenerator::GeneratePasswords(const nsACString& aPasswordRules,
+                                     uint32_t aCount,
+                                     nsTArray<nsCString>& aRetVal) {
+  if (aCount == 0 || aCount > kMaxBatchSize) {
+    return NS_ERROR_INVALID_ARG;
+  }
+  const PasswordRules* rules = GetRules(aPasswordRules);
+  if (!rules) {
+    return NS_ERROR_INVALID_ARG;
+  }
+  nsTArray<nsCString> passwords(aCount);
+  for (uint32_t i = 0; i < aCount; i++) {
+    nsresult rv = rules->Generate(*passwords.AppendElement());
+    NS_ENSURE_SUCCESS(rv, rv);
+  }
+  aRetVal = std::move(passwords);
+  return NS_OK;
+}
+
+} // namespace mozilla::berytus
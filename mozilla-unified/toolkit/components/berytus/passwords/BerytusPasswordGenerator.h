@@ -0,0 +1,45 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BERYTUS_PASSWORDGENERATOR_H_
+#define BERYTUS_PASSWORDGENERATOR_H_
+
+#include "mozIBerytusPasswordGenerator.h"
+#include "mozilla/UniquePtr.h"
+#include "mozilla/berytus/BerytusPasswordRules.h"
+#include "nsHashKeys.h"
+#include "nsTHashMap.h"
+
+namespace mozilla::berytus {
+
+class PasswordGenerator final : public mozIBerytusPasswordGenerator {
+public:
+  NS_DECL_ISUPPORTS
+  NS_DECL_MOZIBERYTUSPASSWORDGENERATOR
+
+  static constexpr uint32_t kMaxBatchSize = 64;
+
+  PasswordGenerator() = default;
+
+private:
+  // Pages rarely use more than a few distinct rule strings; the cache
+  // is simply emptied once it holds this many.
+  static constexpr uint32_t kMaxCachedRules = 32;
+
+  ~PasswordGenerator() = default;
+
+  /**
+   * Returns the compiled aRules, compiling them on first use; nullptr
+   * if no password satisfies them.
+   */
+  const PasswordRules* GetRules(const nsACString& aRules);
+
+  nsTHashMap<nsCStringHashKey, UniquePtr<PasswordRules>> mRules;
+};
+
+} // namespace mozilla::berytus
+
+#endif // BERYTUS_PASSWORDGENERATOR_H_
@@ -0,0 +1,362 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/berytus/BerytusPasswordRules.h"
+#include <bitset>
+#include "ScopedNSSTypes.h"
+#include "mozilla/Assertions.h"
+#include "mozilla/TextUtils.h"
+#include "nsCRT.h"
+#include "nsReadableUtils.h"
+#include "pk11pub.h"
+
+namespace mozilla::berytus {
+
+namespace {
+
+using CharSet = std::bitset<128>;
+
+constexpr char kFirstPrintable = 0x20;
+constexpr char kLastPrintable = 0x7e;
+// As defined by the proposal.
+constexpr char kSpecial[] = "-~!@#$%^&*_+=`|(){}[:;\"'<>,.? ]";
+
+CharSet Range(char aFirst, char aLast) {
+  CharSet set;
+  for (char c = aFirst; c <= aLast; c++) {
+    set.set(size_t(c));
+  }
+  return set;
+}
+
+bool NamedClass(const nsACString& aName, CharSet& aRetVal) {
+  if (aName.EqualsLiteral("upper")) {
+    aRetVal = Range('A', 'Z');
+  } else if (aName.EqualsLiteral("lower")) {
+    aRetVal = Range('a', 'z');
+  } else if (aName.EqualsLiteral("digit")) {
+    aRetVal = Range('0', '9');
+  } else if (aName.EqualsLiteral("special")) {
+    aRetVal.reset();
+    for (const char* c = kSpecial; *c; c++) {
+      aRetVal.set(size_t(*c));
+    }
+  } else if (aName.EqualsLiteral("ascii-printable") ||
+             aName.EqualsLiteral("unicode")) {
+    aRetVal = Range(kFirstPrintable, kLastPrintable);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+nsCString ToChars(const CharSet& aSet) {
+  nsCString chars;
+  for (size_t c = 0; c < aSet.size(); c++) {
+    if (aSet.test(c)) {
+      chars.Append(char(c));
+    }
+  }
+  return chars;
+}
+
+struct ParsedRules {
+  nsTArray<CharSet> mRequired;
+  CharSet mAllowed;
+  uint32_t mMinLength = 0;
+  uint32_t mMaxLength = 0;
+  uint32_t mMaxConsecutive = 0;
+};
+
+class Parser final {
+public:
+  explicit Parser(const nsACString& aRules)
+      : mIter(aRules.BeginReading()), mEnd(aRules.EndReading()) {}
+
+  void Parse(ParsedRules& aRetVal) {
+    while (true) {
+      SkipWhitespace();
+      if (AtEnd()) {
+        return;
+      }
+      if (*mIter == ';') {
+        ++mIter;
+        continue;
+      }
+      nsAutoCString name;
+      ParseIdentifier(name);
+      SkipWhitespace();
+      if (name.IsEmpty() || AtEnd() || *mIter != ':') {
+        SkipRule();
+        continue;
+      }
+      ++mIter;
+      CharSet set;
+      uint32_t number = 0;
+      bool parsed;
+      if (name.EqualsLiteral("required") || name.EqualsLiteral("allowed")) {
+        parsed = ParseClassList(set);
+      } else if (name.EqualsLiteral("minlength") ||
+                 name.EqualsLiteral("maxlength") ||
+                 name.EqualsLiteral("max-consecutive")) {
+        parsed = ParseNumber(number);
+      } else {
+        parsed = false;
+      }
+      SkipWhitespace();
+      if (!parsed || (!AtEnd() && *mIter != ';')) {
+        SkipRule();
+        continue;
+      }
+
+      if (name.EqualsLiteral("required")) {
+        aRetVal.mRequired.AppendElement(set);
+      } else if (name.EqualsLiteral("allowed")) {
+        aRetVal.mAllowed |= set;
+      } else if (name.EqualsLiteral("minlength")) {
+        aRetVal.mMinLength = std::max(aRetVal.mMinLength, number);
+      } else if (name.EqualsLiteral("maxlength")) {
+        aRetVal.mMaxLength = aRetVal.mMaxLength
+          ? std::min(aRetVal.mMaxLength, number)
+          : number;
+      } else {
+        aRetVal.mMaxConsecutive = aRetVal.mMaxConsecutive
+          ? std::min(aRetVal.mMaxConsecutive, number)
+          : number;
+      }
+    }
+  }
+
+private:
+  bool AtEnd() const { return mIter == mEnd; }
+
+  void SkipWhitespace() {
+    while (!AtEnd() && NS_IsAsciiWhitespace(*mIter)) {
+      ++mIter;
+    }
+  }
+
+  // Skips past the next `;` that is not in a custom class.
+  void SkipRule() {
+    bool inClass = false;
+    while (!AtEnd()) {
+      const char c = *mIter++;
+      if (c == '[') {
+        inClass = true;
+      } else if (c == ']') {
+        inClass = false;
+      } else if (c == ';' && !inClass) {
+        return;
+      }
+    }
+  }
+
+  void ParseIdentifier(nsACString& aRetVal) {
+    while (!AtEnd() && (IsAsciiAlpha(*mIter) || *mIter == '-')) {
+      aRetVal.Append(*mIter);
+      ++mIter;
+    }
+    ToLowerCase(aRetVal);
+  }
+
+  bool ParseNumber(uint32_t& aRetVal) {
+    SkipWhitespace();
+    if (AtEnd() || !IsAsciiDigit(*mIter)) {
+      return false;
+    }
+    uint64_t value = 0;
+    while (!AtEnd() && IsAsciiDigit(*mIter)) {
+      value = std::min<uint64_t>(value * 10 + AsciiAlphanumericToNumber(*mIter),
+                                 UINT32_MAX);
+      ++mIter;
+    }
+    aRetVal = uint32_t(value);
+    return true;
+  }
+
+  // A `]` followed by another `]` is part of the class, e.g. `[-]]`.
+  bool ParseCustomClass(CharSet& aRetVal) {
+    MOZ_ASSERT(*mIter == '[');
+    ++mIter;
+    while (!AtEnd()) {
+      const char c = *mIter++;
+      if (c == ']' && (AtEnd() || *mIter != ']')) {
+        return true;
+      }
+      if (c >= kFirstPrintable && c <= kLastPrintable) {
+        aRetVal.set(size_t(c));
+      }
+    }
+    return false;
+  }
+
+  bool ParseClassList(CharSet& aRetVal) {
+    while (true) {
+      SkipWhitespace();
+      if (AtEnd()) {
+        return false;
+      }
+      if (*mIter == '[') {
+        if (!ParseCustomClass(aRetVal)) {
+          return false;
+        }
+      } else {
+        nsAutoCString name;
+        ParseIdentifier(name);
+        CharSet set;
+        if (!NamedClass(name, set)) {
+          return false;
+        }
+        aRetVal |= set;
+      }
+      SkipWhitespace();
+      if (AtEnd() || *mIter != ',') {
+        return true;
+      }
+      ++mIter;
+    }
+  }
+
+  const char* mIter;
+  const char* const mEnd;
+};
+
+// Maps 64 random bits to [0, aBound), as the high half of
+// aRandom * aBound. The bias is below aBound / 2^64, which is
+// negligible for the sizes used here, and unlike rejection sampling
+// it consumes a fixed amount of randomness.
+uint32_t Uniform(uint64_t aRandom, uint32_t aBound) {
+  MOZ_ASSERT(aBound > 0);
+  const uint64_t high = (aRandom >> 32) * aBound;
+  const uint64_t low = ((aRandom & 0xffffffff) * aBound) >> 32;
+  return uint32_t((high + low) >> 32);
+}
+
+} // namespace
+
+UniquePtr<PasswordRules> PasswordRules::Compile(const nsACString& aRules) {
+  ParsedRules parsed;
+  Parser(aRules).Parse(parsed);
+
+  UniquePtr<PasswordRules> rules(new PasswordRules());
+  CharSet allowed = parsed.mAllowed;
+  nsTArray<CharSet> required;
+  bool hasSingleton = false;
+  for (const CharSet& set : parsed.mRequired) {
+    // Identical requirements are satisfied by the same character.
+    if (set.none() || required.Contains(set)) {
+      continue;
+    }
+    required.AppendElement(set);
+    rules->mRequired.AppendElement(ToChars(set));
+    allowed |= set;
+    hasSingleton |= set.count() == 1;
+  }
+  if (allowed.none()) {
+    allowed = Range(kFirstPrintable, kLastPrintable);
+  }
+  rules->mAllowed = ToChars(allowed);
+
+  if (parsed.mMinLength > kMaxLength ||
+      (parsed.mMaxLength && parsed.mMaxLength < parsed.mMinLength)) {
+    return nullptr;
+  }
+  uint32_t length = std::max(parsed.mMinLength, kDefaultLength);
+  if (parsed.mMaxLength) {
+    length = std::min(length, parsed.mMaxLength);
+  }
+  // A required class of a single character may have to move one
+  // position forward to break a run (see Generate), so it is never
+  // placed last.
+  const bool needsSlack = parsed.mMaxConsecutive && hasSingleton;
+  length = std::max<uint32_t>(length, required.Length() + needsSlack);
+  if (length == 0 || (parsed.mMaxLength && length > parsed.mMaxLength)) {
+    return nullptr;
+  }
+  rules->mLength = length;
+
+  if (parsed.mMaxConsecutive && parsed.mMaxConsecutive < length) {
+    // A run can only be broken with a second character.
+    if (rules->mAllowed.Length() < 2) {
+      return nullptr;
+    }
+    rules->mMaxConsecutive = parsed.mMaxConsecutive;
+  }
+  return rules;
+}
+
+nsresult PasswordRules::Generate(nsACString& aRetVal) const {
+  const uint32_t requiredCount = mRequired.Length();
+  nsTArray<uint64_t> random;
+  random.AppendElements(requiredCount + mLength);
+  nsresult rv = MapSECStatus(PK11_GenerateRandom(
+    reinterpret_cast<unsigned char*>(random.Elements()),
+    random.Length() * sizeof(uint64_t)));
+  NS_ENSURE_SUCCESS(rv, rv);
+  size_t draw = 0;
+
+  // The class of each position; -1 for mAllowed. Required classes are
+  // assigned distinct random positions by a partial Fisher-Yates
+  // shuffle, single characters first so that they can be kept off the
+  // last position.
+  nsTArray<int32_t> classes;
+  classes.AppendElements(mLength);
+  nsTArray<uint32_t> slots;
+  slots.AppendElements(mLength);
+  for (uint32_t i = 0; i < mLength; i++) {
+    classes[i] = -1;
+    slots[i] = i;
+  }
+  uint32_t assigned = 0;
+  for (const bool singletons : {true, false}) {
+    for (uint32_t i = 0; i < requiredCount; i++) {
+      if ((mRequired[i].Length() == 1) != singletons) {
+        continue;
+      }
+      const uint32_t end =
+        (singletons && mMaxConsecutive) ? mLength - 1 : mLength;
+      MOZ_ASSERT(assigned < end);
+      const uint32_t j = assigned + Uniform(random[draw++], end - assigned);
+      std::swap(slots[assigned], slots[j]);
+      classes[slots[assigned]] = int32_t(i);
+      assigned++;
+    }
+  }
+
+  aRetVal.SetLength(mLength);
+  char previous = 0;
+  uint32_t run = 0;
+  for (uint32_t i = 0; i < mLength; i++) {
+    const char forbidden =
+      (mMaxConsecutive && run >= mMaxConsecutive) ? previous : 0;
+    if (forbidden && classes[i] >= 0 &&
+        mRequired[classes[i]].Length() == 1 &&
+        mRequired[classes[i]][0] == forbidden) {
+      // The class cannot break the run; swap it with the next
+      // position, which can, and which then restarts the run with it.
+      MOZ_ASSERT(i + 1 < mLength);
+      std::swap(classes[i], classes[i + 1]);
+    }
+    const nsCString& chars =
+      classes[i] >= 0 ? mRequired[classes[i]] : mAllowed;
+    const int32_t skip = forbidden ? chars.FindChar(forbidden) : -1;
+    const uint32_t count = chars.Length() - (skip >= 0 ? 1 : 0);
+    MOZ_ASSERT(count > 0);
+    uint32_t index = Uniform(random[draw++], count);
+    if (skip >= 0 && index >= uint32_t(skip)) {
+      index++;
+    }
+    const char c = chars[index];
+    run = c == previous ? run + 1 : 1;
+    previous = c;
+    aRetVal.BeginWriting()[i] = c;
+  }
+  MOZ_ASSERT(draw == random.Length());
+  memset(random.Elements(), 0, random.Length() * sizeof(uint64_t));
+  return NS_OK;
+}
+
+} // namespace mozilla::berytus
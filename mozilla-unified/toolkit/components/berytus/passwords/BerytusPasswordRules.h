@@ -0,0 +1,63 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BERYTUS_PASSWORDRULES_H_
+#define BERYTUS_PASSWORDRULES_H_
+
+#include "mozilla/UniquePtr.h"
+#include "nsString.h"
+#include "nsTArray.h"
+
+namespace mozilla::berytus {
+
+/**
+ * A passwordRules string, as passed in BerytusPasswordFieldOptions,
+ * compiled into the character classes of each position of the
+ * generated passwords.
+ *
+ * The syntax is that of the passwordRules attribute proposal
+ * (https://github.com/whatwg/html/issues/3518): `;`-separated
+ * required, allowed, minlength, maxlength and max-consecutive rules.
+ * The classes are upper, lower, digit, special, ascii-printable,
+ * unicode (generated as ascii-printable) and custom `[...]` classes.
+ * Malformed rules are ignored, as browsers do.
+ */
+class PasswordRules final {
+public:
+  // The length of the generated passwords when the rules allow it.
+  static constexpr uint32_t kDefaultLength = 20;
+  static constexpr uint32_t kMaxLength = 1024;
+
+  /**
+   * Returns nullptr if no password can satisfy aRules, e.g. if
+   * maxlength is lower than the number of required classes.
+   */
+  static UniquePtr<PasswordRules> Compile(const nsACString& aRules);
+
+  uint32_t Length() const { return mLength; }
+
+  /**
+   * Generates a password satisfying the rules. Each character is
+   * drawn once from the CSPRNG; there is no generate-and-check loop.
+   */
+  nsresult Generate(nsACString& aRetVal) const;
+
+private:
+  PasswordRules() = default;
+
+  // The characters of each required class; one character of each is
+  // placed at a random position.
+  nsTArray<nsCString> mRequired;
+  // The characters of every other position.
+  nsCString mAllowed;
+  uint32_t mLength = 0;
+  // 0 if unbounded.
+  uint32_t mMaxConsecutive = 0;
+};
+
+} // namespace mozilla::berytus
+
+#endif // BERYTUS_PASSWORDRULES_H_
@@ -0,0 +1,165 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "mozilla/berytus/BerytusPasswordGenerator.h"
+#include "mozilla/berytus/BerytusPasswordRules.h"
+#include "nsError.h"
+#include "nss.h"
+
+using namespace mozilla;
+using namespace mozilla::berytus;
+
+static constexpr uint32_t kIterations = 200;
+
+static bool ContainsAny(const nsACString& aPassword, const char* aChars) {
+  for (char c : aPassword) {
+    if (strchr(aChars, c)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool OnlyContains(const nsACString& aPassword, const char* aChars) {
+  for (char c : aPassword) {
+    if (!strchr(aChars, c)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static uint32_t LongestRun(const nsACString& aPassword) {
+  uint32_t longest = 0;
+  uint32_t run = 0;
+  char previous = 0;
+  for (char c : aPassword) {
+    run = c == previous ? run + 1 : 1;
+    previous = c;
+    longest = std::max(longest, run);
+  }
+  return longest;
+}
+
+TEST(BerytusPasswordRules, DefaultLength)
+{
+  ASSERT_EQ(NSS_NoDB_Init(nullptr), SECSuccess);
+  UniquePtr<PasswordRules> rules = PasswordRules::Compile(""_ns);
+  ASSERT_TRUE(rules);
+  EXPECT_EQ(rules->Length(), PasswordRules::kDefaultLength);
+
+  rules = PasswordRules::Compile("minlength: 8; maxlength: 16;"_ns);
+  ASSERT_TRUE(rules);
+  EXPECT_EQ(rules->Length(), 16u);
+
+  rules = PasswordRules::Compile("minlength: 32"_ns);
+  ASSERT_TRUE(rules);
+  EXPECT_EQ(rules->Length(), 32u);
+  nsAutoCString password;
+  ASSERT_EQ(rules->Generate(password), NS_OK);
+  EXPECT_EQ(password.Length(), 32u);
+}
+
+TEST(BerytusPasswordRules, RequiredClasses)
+{
+  ASSERT_EQ(NSS_NoDB_Init(nullptr), SECSuccess);
+  UniquePtr<PasswordRules> rules = PasswordRules::Compile(
+    "required: upper; required: lower; required: digit; "
+    "required: [-_]; maxlength: 4"_ns);
+  ASSERT_TRUE(rules);
+  ASSERT_EQ(rules->Length(), 4u);
+  for (uint32_t i = 0; i < kIterations; i++) {
+    nsAutoCString password;
+    ASSERT_EQ(rules->Generate(password), NS_OK);
+    EXPECT_TRUE(ContainsAny(password, "ABCDEFGHIJKLMNOPQRSTUVWXYZ"));
+    EXPECT_TRUE(ContainsAny(password, "abcdefghijklmnopqrstuvwxyz"));
+    EXPECT_TRUE(ContainsAny(password, "0123456789"));
+    EXPECT_TRUE(ContainsAny(password, "-_"));
+  }
+}
+
+TEST(BerytusPasswordRules, AllowedClasses)
+{
+  ASSERT_EQ(NSS_NoDB_Init(nullptr), SECSuccess);
+  UniquePtr<PasswordRules> rules =
+    PasswordRules::Compile("allowed: digit, [-]]; required: [x]"_ns);
+  ASSERT_TRUE(rules);
+  for (uint32_t i = 0; i < kIterations; i++) {
+    nsAutoCString password;
+    ASSERT_EQ(rules->Generate(password), NS_OK);
+    EXPECT_TRUE(OnlyContains(password, "0123456789-]x"));
+    EXPECT_TRUE(ContainsAny(password, "x"));
+  }
+}
+
+TEST(BerytusPasswordRules, MaxConsecutive)
+{
+  ASSERT_EQ(NSS_NoDB_Init(nullptr), SECSuccess);
+  UniquePtr<PasswordRules> rules = PasswordRules::Compile(
+    "allowed: [ab]; required: [a]; required: [b]; max-consecutive: 1"_ns);
+  ASSERT_TRUE(rules);
+  for (uint32_t i = 0; i < kIterations; i++) {
+    nsAutoCString password;
+    ASSERT_EQ(rules->Generate(password), NS_OK);
+    EXPECT_EQ(LongestRun(password), 1u);
+  }
+
+  rules = PasswordRules::Compile(
+    "allowed: [a]; required: digit; max-consecutive: 2"_ns);
+  ASSERT_TRUE(rules);
+  for (uint32_t i = 0; i < kIterations; i++) {
+    nsAutoCString password;
+    ASSERT_EQ(rules->Generate(password), NS_OK);
+    EXPECT_LE(LongestRun(password), 2u);
+    EXPECT_TRUE(ContainsAny(password, "0123456789"));
+  }
+}
+
+TEST(BerytusPasswordRules, MalformedRulesAreIgnored)
+{
+  ASSERT_EQ(NSS_NoDB_Init(nullptr), SECSuccess);
+  UniquePtr<PasswordRules> rules = PasswordRules::Compile(
+    "required: nonsense; minlength: ten; unknown: 3; allowed: digit"_ns);
+  ASSERT_TRUE(rules);
+  EXPECT_EQ(rules->Length(), PasswordRules::kDefaultLength);
+  nsAutoCString password;
+  ASSERT_EQ(rules->Generate(password), NS_OK);
+  EXPECT_TRUE(OnlyContains(password, "0123456789"));
+}
+
+TEST(BerytusPasswordRules, UnsatisfiableRules)
+{
+  EXPECT_FALSE(PasswordRules::Compile("minlength: 10; maxlength: 8"_ns));
+  EXPECT_FALSE(PasswordRules::Compile(
+    "maxlength: 2; required: upper; required: lower; required: digit"_ns));
+  EXPECT_FALSE(PasswordRules::Compile("allowed: [a]; max-consecutive: 1"_ns));
+  EXPECT_FALSE(PasswordRules::Compile("minlength: 100000"_ns));
+}
+
+TEST(BerytusPasswordGenerator, GeneratePasswords)
+{
+  ASSERT_EQ(NSS_NoDB_Init(nullptr), SECSuccess);
+  RefPtr<PasswordGenerator> generator = new PasswordGenerator();
+  nsTArray<nsCString> passwords;
+  ASSERT_EQ(generator->GeneratePasswords("required: digit"_ns, 3, passwords),
+            NS_OK);
+  ASSERT_EQ(passwords.Length(), 3u);
+  for (const nsCString& password : passwords) {
+    EXPECT_EQ(password.Length(), PasswordRules::kDefaultLength);
+    EXPECT_TRUE(ContainsAny(password, "0123456789"));
+  }
+  EXPECT_NE(passwords[0], passwords[1]);
+
+  EXPECT_EQ(generator->GeneratePasswords(""_ns, 0, passwords),
+            NS_ERROR_INVALID_ARG);
+  EXPECT_EQ(generator->GeneratePasswords(
+              ""_ns, PasswordGenerator::kMaxBatchSize + 1, passwords),
+            NS_ERROR_INVALID_ARG);
+  nsAutoCString password;
+  EXPECT_EQ(generator->GeneratePassword("minlength: 9; maxlength: 8"_ns,
+                                        password),
+            NS_ERROR_INVALID_ARG);
+}
@@ -2,7 +2,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
-import type { CredentialsMetadata, GetCredentialsMetadataArgs, IPublicRequestHandler, UriParams } from "./types";
+import type { AgentRequestHandler, CredentialsMetadata, ELoginUserIntent, EOperationStatus, EOperationType, GetCredentialsMetadataArgs, IPublicRequestHandler, OperationSnapshot, PublicRequestContext, RespondToChallengeMessagesResult, UriParams } from "./types";
 import type { ISecretManagerInfo, Liaison } from './Liaison.sys.mjs';
 
 let lazy = {};
@@ -13,6 +13,11 @@ ChromeUtils.defineESModuleGetters(lazy, {
 export interface CollectCredentialsMetadataEntry {
     manager: ISecretManagerInfo;
     credentialsMetadata: CredentialsMetadata | Promise<CredentialsMetadata>
+    /**
+     * The manager's signing key, prefetched while the user is
+     * prompted; undefined if the manager failed to return it.
+     */
+    signingKey: Promise<string | undefined>;
 };
 
 export function Agent() { }
@@ -35,16 +40,25 @@ Agent.collectCredentialsMetadata = async (
             uri
         },
     };
+    // Signing keys are requested from every manager up front, so
+    // that the selected manager's key is at hand once the user
+    // makes their choice and the channel can be created right away.
+    // A manager handles one request at a time, hence its credentials
+    // metadata is only requested once its key has been returned;
+    // distinct managers are still queried in parallel.
+    const signingKeys: Record<string, Promise<string | undefined>> = {};
+    managers.forEach(manager => {
+        signingKeys[manager.id] = Agent.target(manager.id)
+            .manager.getSigningKey(
+                context,
+                { webAppActor: args.webAppActor }
+            )
+            .catch(() => undefined);
+    });
     const relevantManagers = keys && keys.length > 0
         ? (await Promise.all(managers.map(async manager => {
-            const target = Agent.target(manager.id);
-            let key: string;
-            try {
-                key = await target.manager.getSigningKey(
-                    context,
-                    { webAppActor: args.webAppActor }
-                );
-            } catch (e) {
+            const key = await signingKeys[manager.id];
+            if (key === undefined) {
                 return null;
             }
             if (keys.indexOf(key) !== -1) {
@@ -63,16 +77,30 @@ Agent.collectCredentialsMetadata = async (
         const target = Agent.target(manager.id);
         entries.push({
             manager,
-            credentialsMetadata: target.manager.getCredentialsMetadata(
-                context,
-                args
-            )
+            credentialsMetadata: signingKeys[manager.id].then(
+                () => target.manager.getCredentialsMetadata(
+                    context,
+                    args
+                )
+            ),
+            signingKey: signingKeys[manager.id]
         });
     }
     return entries;
 }
 
 
+type PublicAgentRequests = {
+    [group in keyof AgentRequestHandler]: {
+        [method in keyof AgentRequestHandler[group]]:
+            AgentRequestHandler[group][method] extends (...args: any[]) => any
+                ? Parameters<AgentRequestHandler[group][method]> extends [infer context, ...infer tail]
+                    ?   (context: PublicRequestContext<context>, ...rest: tail) => Promise<ReturnType<AgentRequestHandler[group][method]>>
+                    : never
+                : never
+    }
+}
+
 class AgentTarget implements IPublicRequestHandler {
     #liaison: Liaison;
     #managerId: string;
@@ -86,20 +114,169 @@ class AgentTarget implements IPublicRequestHandler {
         return this.#liaison.getRequestHandler(this.#managerId);
     }
 
-    get manager()  {
-        return this.#requestHandler.manager;
+    get manager(): IPublicRequestHandler["manager"] {
+        const manager = this.#requestHandler.manager;
+        const liaison = this.#liaison;
+        const managerId = this.#managerId;
+        return {
+            ...manager,
+            getSigningKey(context, args) {
+                return liaison.getSigningKey(
+                    managerId,
+                    () => manager.getSigningKey(context, args)
+                );
+            }
+        };
     }
-    get channel() {
-        return this.#requestHandler.channel;
+    get channel(): IPublicRequestHandler["channel"] {
+        const channel = this.#requestHandler.channel;
+        const liaison = this.#liaison;
+        const managerId = this.#managerId;
+        return {
+            ...channel,
+            async bootstrapChannel(context, args) {
+                const key = await channel.bootstrapChannel(context, args);
+                liaison.setSigningKey(managerId, key);
+                return key;
+            },
+            async closeChannel(context) {
+                try {
+                    return await channel.closeChannel(context);
+                } finally {
+                    liaison.invalidateUserAttributes(managerId, context.channel.id);
+                }
+            }
+        };
     }
-    get login() {
-        return this.#requestHandler.login;
+    get login(): IPublicRequestHandler["login"] & PublicAgentRequests["login"] {
+        const login = this.#requestHandler.login;
+        const accountCreation = this.#requestHandler.accountCreation;
+        const liaison = this.#liaison;
+        const managerId = this.#managerId;
+        return {
+            ...login,
+            async closeOperation(context) {
+                try {
+                    return await login.closeOperation(context);
+                } finally {
+                    liaison.invalidateUserAttributes(
+                        managerId,
+                        context.channel.id,
+                        context.operation.id
+                    );
+                }
+            },
+            async approveOperationAndSnapshot(context, args) {
+                const intent = await login.approveOperation(context, {
+                    operation: args.operation
+                });
+                const authenticate = intent === "Authenticate" as ELoginUserIntent;
+                const operation = {
+                    ...args.operation,
+                    intent,
+                    type: (authenticate ? "Authentication" : "Registration") as EOperationType,
+                    status: "Created" as EOperationStatus
+                };
+                const snapshot: OperationSnapshot = { intent };
+                if (authenticate) {
+                    snapshot.metadata = await login.getRecordMetadata({
+                        ...context,
+                        operation: {
+                            id: operation.id,
+                            type: operation.type,
+                            status: operation.status,
+                            state: operation.state
+                        }
+                    });
+                } else {
+                    const operationContext = { ...context, operation };
+                    const userAttributes = await liaison.getUserAttributes(
+                        managerId,
+                        operationContext,
+                        () => accountCreation.getUserAttributes(operationContext)
+                    );
+                    const projection = args.userAttributeProjection;
+                    if (projection === undefined) {
+                        snapshot.userAttributes = userAttributes;
+                    } else {
+                        // The values of the other attributes are
+                        // sent when the page asks for them.
+                        snapshot.userAttributes = userAttributes.filter(
+                            attr => projection.includes(attr.id)
+                        );
+                        snapshot.unloadedUserAttributes = userAttributes
+                            .filter(attr => !projection.includes(attr.id))
+                            .map(({ id, info, mimeType }) => ({ id, info, mimeType }));
+                    }
+                }
+                return snapshot;
+            }
+        };
     }
-    get accountCreation() {
-        return this.#requestHandler.accountCreation;
+    get accountCreation(): IPublicRequestHandler["accountCreation"] & PublicAgentRequests["accountCreation"] {
+        const accountCreation = this.#requestHandler.accountCreation;
+        const liaison = this.#liaison;
+        const managerId = this.#managerId;
+        return {
+            ...accountCreation,
+            async approveTransitionToAuthOp(context, args) {
+                try {
+                    return await accountCreation.approveTransitionToAuthOp(context, args);
+                } finally {
+                    liaison.invalidateUserAttributes(
+                        managerId,
+                        context.channel.id,
+                        context.operation.id
+                    );
+                }
+            },
+            getUserAttributes(context) {
+                return liaison.getUserAttributes(
+                    managerId,
+                    context,
+                    () => accountCreation.getUserAttributes(context)
+                );
+            },
+            async updateUserAttributes(context, args) {
+                try {
+                    return await accountCreation.updateUserAttributes(context, args);
+                } finally {
+                    liaison.invalidateUserAttributes(
+                        managerId,
+                        context.channel.id,
+                        context.operation.id
+                    );
+                }
+            },
+            async getUserAttributeValues(context, args) {
+                const userAttributes = await liaison.getUserAttributes(
+                    managerId,
+                    context,
+                    () => accountCreation.getUserAttributes(context)
+                );
+                return userAttributes.filter(attr => args.ids.includes(attr.id));
+            }
+        };
     }
-    get accountAuthentication() {
-        return this.#requestHandler.accountAuthentication;
+    get accountAuthentication(): IPublicRequestHandler["accountAuthentication"] & PublicAgentRequests["accountAuthentication"] {
+        const accountAuthentication = this.#requestHandler.accountAuthentication;
+        return {
+            ...accountAuthentication,
+            async respondToChallengeMessages(context, args) {
+                const responses: RespondToChallengeMessagesResult = [];
+                // Each message may depend on the state left by the
+                // previous one, e.g. the selected key or password.
+                for (const message of args) {
+                    responses.push(
+                        await accountAuthentication.respondToChallengeMessage(
+                            context,
+                            message
+                        )
+                    );
+                }
+                return responses;
+            }
+        };
     }
 }
 
@@ -0,0 +1,196 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+import { XPCOMUtils } from "resource://gre/modules/XPCOMUtils.sys.mjs";
+
+const lazy = {};
+XPCOMUtils.defineLazyPreferenceGetter(
+    lazy,
+    "RESUMPTION_LIFETIME_SECONDS",
+    "dom.berytus.channel.resumption.lifetime_seconds",
+    300
+);
+XPCOMUtils.defineLazyPreferenceGetter(
+    lazy,
+    "RESUMPTION_MAX_SESSIONS",
+    "dom.berytus.channel.resumption.max_sessions",
+    64
+);
+
+export interface ChannelSession {
+    origin: string;
+    managerId: string;
+    channelId: string;
+    scmEd25519Key: string;
+    /**
+     * Empty if the web app actor is an origin actor.
+     */
+    webAppEd25519Key: string;
+}
+
+export interface ResumedChannelSession extends ChannelSession {
+    /**
+     * The token to present on the next resumption; tokens
+     * are single-use.
+     */
+    resumptionToken: string;
+}
+
+interface ChannelSessionEntry extends ChannelSession {
+    expiresAt: number;
+}
+
+/**
+ * Channels that were opted-in for resumption, kept around so that a
+ * subsequent same-origin document can re-attach to the agent-side
+ * channel without going through the secret manager selection prompt.
+ *
+ * Sessions are looked up using an unguessable resumption token handed
+ * out to the web app; presenting the token is the proof that the
+ * document is the continuation of the one that opened the channel.
+ * At most one session is kept per (origin, secret manager key, web
+ * app key). Sessions expire after
+ * dom.berytus.channel.resumption.lifetime_seconds, and at most
+ * dom.berytus.channel.resumption.max_sessions are kept (the oldest
+ * is dropped first).
+ */
+class ChannelSessionStore {
+    /**
+     * Keyed by resumption token; insertion order is the eviction order.
+     */
+    #sessions: Map<string, ChannelSessionEntry> = new Map();
+
+    get size() {
+        this.#purgeExpired();
+        return this.#sessions.size;
+    }
+
+    /**
+     * Stores the session and returns its resumption token.
+     */
+    store(session: ChannelSession): string {
+        this.#purgeExpired();
+        for (const [token, entry] of this.#sessions) {
+            if (entry.origin === session.origin &&
+                entry.scmEd25519Key === session.scmEd25519Key &&
+                entry.webAppEd25519Key === session.webAppEd25519Key) {
+                this.#sessions.delete(token);
+            }
+        }
+        // @ts-ignore: TS does not captures assertion here
+        const maxSessions: number = Math.max(lazy.RESUMPTION_MAX_SESSIONS, 1);
+        while (this.#sessions.size >= maxSessions) {
+            const oldest = this.#sessions.keys().next().value!;
+            this.#sessions.delete(oldest);
+        }
+        const token = generateToken();
+        this.#sessions.set(token, {
+            origin: session.origin,
+            managerId: session.managerId,
+            channelId: session.channelId,
+            scmEd25519Key: session.scmEd25519Key,
+            webAppEd25519Key: session.webAppEd25519Key,
+            // @ts-ignore: TS does not captures assertion here
+            expiresAt: Date.now() + lazy.RESUMPTION_LIFETIME_SECONDS * 1000
+        });
+        return token;
+    }
+
+    /**
+     * Consumes the resumption token. Returns null if the token is
+     * unknown or expired, or if the session does not match the
+     * origin, the web app key or the accepted secret manager keys
+     * (any key is accepted if none were passed). On success, the
+     * session is stored again under a new token.
+     */
+    resume(
+        token: string,
+        origin: string,
+        webAppEd25519Key: string,
+        acceptedScmEd25519Keys: Array<string>
+    ): ResumedChannelSession | null {
+        this.#purgeExpired();
+        const entry = this.#sessions.get(token);
+        if (! entry) {
+            return null;
+        }
+        if (entry.origin !== origin ||
+            entry.webAppEd25519Key !== webAppEd25519Key) {
+            return null;
+        }
+        this.#sessions.delete(token);
+        if (acceptedScmEd25519Keys.length > 0 &&
+            ! acceptedScmEd25519Keys.includes(entry.scmEd25519Key)) {
+            return null;
+        }
+        const session: ChannelSession = {
+            origin: entry.origin,
+            managerId: entry.managerId,
+            channelId: entry.channelId,
+            scmEd25519Key: entry.scmEd25519Key,
+            webAppEd25519Key: entry.webAppEd25519Key
+        };
+        return {
+            ...session,
+            resumptionToken: this.store(session)
+        };
+    }
+
+    /**
+     * Returns whether a session was revoked. Only the origin
+     * that stored the session can revoke it.
+     */
+    revoke(token: string, origin: string): boolean {
+        const entry = this.#sessions.get(token);
+        if (! entry || entry.origin !== origin) {
+            return false;
+        }
+        this.#sessions.delete(token);
+        return true;
+    }
+
+    /**
+     * Revokes all the sessions of the manager, e.g. when
+     * it is unregistered.
+     */
+    revokeManager(managerId: string) {
+        for (const [token, entry] of this.#sessions) {
+            if (entry.managerId === managerId) {
+                this.#sessions.delete(token);
+            }
+        }
+    }
+
+    clear() {
+        this.#sessions.clear();
+    }
+
+    #purgeExpired() {
+        const now = Date.now();
+        for (const [token, entry] of this.#sessions) {
+            if (entry.expiresAt <= now) {
+                this.#sessions.delete(token);
+            }
+        }
+    }
+}
+
+function generateToken(): string {
+    // nsID::GenerateUUID draws from the OS CSPRNG; two v4 UUIDs
+    // amount to 244 random bits.
+    let token = "";
+    for (let i = 0; i < 2; i++) {
+        // @ts-ignore: TODO(berytus): add to index.d.ts
+        token += Services.uuid
+            .generateUUID()
+            .toString()
+            .replace(/[{}-]/g, "");
+    }
+    return token;
+}
+
+const channelSessionStore = new ChannelSessionStore();
+
+export { channelSessionStore };
+export type { ChannelSessionStore };
@@ -2,7 +2,9 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
-import { ESecretManagerType } from "resource://gre/modules/BerytusLiaison.sys.mjs";
+import { ESecretManagerType, liaison } from "resource://gre/modules/BerytusLiaison.sys.mjs";
+import { channelSessionStore } from "resource://gre/modules/BerytusChannelSessionStore.sys.mjs";
+import type { ChannelSession, ResumedChannelSession } from "./ChannelSessionStore.sys.mjs";
 import type { GetCredentialsMetadataArgs } from "./types";
 import { XPCOMUtils } from "resource://gre/modules/XPCOMUtils.sys.mjs";
 import type { CollectCredentialsMetadataEntry } from "./Agent.sys.mjs";
@@ -18,12 +20,21 @@ XPCOMUtils.defineLazyPreferenceGetter(
 
 export interface ManangerSelectionEntry extends CollectCredentialsMetadataEntry  {}
 
+export interface SecretManagerSelection {
+    id: string;
+    /**
+     * The selected manager's signing key, if it was prefetched
+     * successfully during the prompt.
+     */
+    signingKey?: string;
+}
+
 export class PromptService {
 
     async promptUsingPopupNotification(
         browsingContext: BrowsingContext,
         args: GetCredentialsMetadataArgs
-    ): Promise<string> {
+    ): Promise<SecretManagerSelection> {
         const managerEntries = await Agent.collectCredentialsMetadata(
             browsingContext.currentWindowContext.innerWindowId,
             {
@@ -39,7 +50,70 @@ export class PromptService {
             browsingContext,
             managerEntries
         );
-        return selectedExtensionId;
+        const selectedEntry = managerEntries.find(
+            e => e.manager.id === selectedExtensionId
+        );
+        return {
+            id: selectedExtensionId,
+            signingKey: await selectedEntry?.signingKey
+        };
+    }
+
+    /**
+     * Stores a channel for resumption by subsequent documents of the
+     * same origin; resolves with the resumption token. The origin is
+     * that of the window global of the calling actor, see
+     * BerytusPromptServiceParent.
+     */
+    async storeChannelSession(
+        origin: string,
+        session: Omit<ChannelSession, "origin">
+    ): Promise<string> {
+        if (! liaison.isManagerRegistered(session.managerId)) {
+            throw new Error(
+                "Cannot store channel session; " +
+                `manager ${session.managerId} is not registered.`
+            );
+        }
+        return channelSessionStore.store({
+            origin,
+            managerId: session.managerId,
+            channelId: session.channelId,
+            scmEd25519Key: session.scmEd25519Key,
+            webAppEd25519Key: session.webAppEd25519Key
+        });
+    }
+
+    /**
+     * Resolves with the resumed session, or null if the token
+     * does not refer to a live session of this document's origin
+     * that satisfies the passed constraints. The secret manager
+     * is not prompted.
+     */
+    async resumeChannelSession(
+        origin: string,
+        resumptionToken: string,
+        webAppEd25519Key: string,
+        secretManagerPublicKey: Array<string>
+    ): Promise<ResumedChannelSession | null> {
+        const session = channelSessionStore.resume(
+            resumptionToken,
+            origin,
+            webAppEd25519Key,
+            secretManagerPublicKey
+        );
+        if (session && ! liaison.isManagerRegistered(session.managerId)) {
+            channelSessionStore.revokeManager(session.managerId);
+            return null;
+        }
+        return session;
+    }
+
+    async revokeChannelSession(
+        origin: string,
+        resumptionToken: string
+    ): Promise<boolean> {
+        return channelSessionStore.revoke(resumptionToken, origin);
     }
 }
 
@@ -4,6 +4,8 @@
 
 import { getChildActor } from "resource://gre/modules/BerytusChildProxyUtils.sys.mjs";
 import type { PartialAccountIdentity, GetCredentialsMetadataArgs } from "./types";
+import type { SecretManagerSelection } from "./PromptService.sys.mjs";
+import type { ResumedChannelSession } from "./ChannelSessionStore.sys.mjs";
 
 export class XPPromptServiceChildProxy {
 
@@ -15,7 +17,7 @@ export class XPPromptServiceChildProxy {
         args_accountConstraints_category: string,
         args_accountConstraints_schemaVersion: number,
         args_accountConstraints_identity: IPropertyBag,
-    ): Promise<string> {
+    ): Promise<SecretManagerSelection> {
         const currentUri = innerWindow.document.documentURIObject;
         const originalUri = innerWindow.browsingContext.docShell.currentDocumentChannel.originalURI;
 
@@ -61,14 +63,77 @@ export class XPPromptServiceChildProxy {
                 identity
             }
         };
-        const selectedId = await actor.sendQuery(
+        const selection = await actor.sendQuery(
             'BerytusPromptService:promptUsingPopupNotification',
             [
                 browsingContext,
                 args
             ]
         );
-        return selectedId;
+        return selection;
+    }
+
+    async storeChannelSession(
+        innerWindow: IDOMWindow,
+        args_managerId: string,
+        args_channelId: string,
+        args_scmEd25519Key: string,
+        args_webAppEd25519Key: string
+    ): Promise<string> {
+        const browsingContext = innerWindow.browsingContext;
+        const actor = getChildActor(
+            browsingContext,
+            'BerytusPromptService'
+        );
+        return actor.sendQuery(
+            'BerytusPromptService:storeChannelSession',
+            [
+                {
+                    managerId: args_managerId,
+                    channelId: args_channelId,
+                    scmEd25519Key: args_scmEd25519Key,
+                    webAppEd25519Key: args_webAppEd25519Key
+                }
+            ]
+        );
+    }
+
+    async resumeChannelSession(
+        innerWindow: IDOMWindow,
+        args_resumptionToken: string,
+        args_webAppEd25519Key: string,
+        args_channelConstraints_secretManagerPublicKey: Array<string>
+    ): Promise<ResumedChannelSession | null> {
+        const browsingContext = innerWindow.browsingContext;
+        const actor = getChildActor(
+            browsingContext,
+            'BerytusPromptService'
+        );
+        return actor.sendQuery(
+            'BerytusPromptService:resumeChannelSession',
+            [
+                args_resumptionToken,
+                args_webAppEd25519Key,
+                args_channelConstraints_secretManagerPublicKey
+            ]
+        );
+    }
+
+    async revokeChannelSession(
+        innerWindow: IDOMWindow,
+        args_resumptionToken: string
+    ): Promise<boolean> {
+        const browsingContext = innerWindow.browsingContext;
+        const actor = getChildActor(
+            browsingContext,
+            'BerytusPromptService'
+        );
+        return actor.sendQuery(
+            'BerytusPromptService:revokeChannelSession',
+            [
+                args_resumptionToken
+            ]
+        );
     }
 }
 
@@ -3,7 +3,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 // This file is automatically generated; do not edit.
-import type { IUnderlyingRequestHandler, ResponseContext, PreliminaryRequestContext, GetSigningKeyArgs, GetCredentialsMetadataArgs, CreateChannelArgs, RequestContext, SignKeyAgreementParametersArgs, VerifySignedKeyExchangeParametersArgs, ApproveOperationArgs, RequestContextWithOperation, UpdateMetadataArgs, ApproveTransitionToAuthOpArgs, RequestContextWithLoginOperation, UpdateUserAttributesArgs, AddFieldArgs, RejectFieldValueArgs, ApproveChallengeRequestArgs, AbortChallengeArgs, CloseChallengeArgs, BerytusSendMessageUnion, RequestType, RequestHandlerFunctionParameters, RequestHandlerFunctionReturnType, IPublicRequestHandler, RequestHandler } from './types';
+import type { IUnderlyingRequestHandler, ResponseContext, PreliminaryRequestContext, GetSigningKeyArgs, GetCredentialsMetadataArgs, CreateChannelArgs, BootstrapChannelArgs, RequestContext, SignKeyAgreementParametersArgs, VerifySignedKeyExchangeParametersArgs, ApproveOperationArgs, RequestContextWithOperation, UpdateMetadataArgs, ApproveTransitionToAuthOpArgs, RequestContextWithLoginOperation, UpdateUserAttributesArgs, AddFieldArgs, RejectFieldValueArgs, ApproveChallengeRequestArgs, AbortChallengeArgs, CloseChallengeArgs, BerytusSendMessageUnion, RequestType, RequestHandlerFunctionParameters, RequestHandlerFunctionReturnType, ICancellableRequestHandler, IPublicRequestHandler, PublicRequestContext, RequestHandler } from './types';
 export class IsolatedRequestHandler implements IUnderlyingRequestHandler {
     #impl: IUnderlyingRequestHandler;
     manager: IUnderlyingRequestHandler["manager"];
@@ -149,6 +149,50 @@ export class IsolatedRequestHandler implements IUnderlyingRequestHandler {
                     return;
                 }
             },
+            async bootstrapChannel(context: PreliminaryRequestContext & ResponseContext<"channel", "bootstrapChannel">, args: BootstrapChannelArgs): Promise<void> {
+                try {
+                    await self.preCall("channel", "bootstrapChannel", { context, args });
+                } catch (e) {
+                    context.response.reject(e);
+                    return;
+                }
+                const wrappedResponseCtx: ResponseContext<"channel", "bootstrapChannel"> = {
+                    response: {
+                        async resolve(val: Parameters<ResponseContext<"channel", "bootstrapChannel">["response"]["resolve"]>[0]) {
+                            try {
+                                await self.preResolve("channel", "bootstrapChannel", { context, args }, val)
+                            } catch (e: any) {
+                                context.response.reject(e);
+                                throw new Error(e.reason || "ResolutionFailure");
+                            }
+                            context.response.resolve(val);
+                        },
+                        async reject(val: unknown) {
+                            try {
+                                await self.preReject("channel", "bootstrapChannel", { context, args }, val);
+                            } catch (e) {
+                                context.response.reject(e);
+                                throw e;
+                            }
+                            context.response.reject(val);
+                        }
+                    }
+                };
+                try {
+                    await self.#impl.channel.bootstrapChannel({
+                        ...context,
+                        ...wrappedResponseCtx
+                    }, args);
+                } catch (e) {
+                    self.handleUnexpectedException(
+                        "channel",
+                        "bootstrapChannel",
+                        context.response,
+                        e
+                    );
+                    return;
+                }
+            },
             async generateX25519Key(context: RequestContext & ResponseContext<"channel", "generateX25519Key">): Promise<void> {
                 try {
                     await self.preCall("channel", "generateX25519Key", { context });
@@ -237,6 +281,50 @@ export class IsolatedRequestHandler implements IUnderlyingRequestHandler {
                     return;
                 }
             },
+            async establishEndToEndEncryption(context: RequestContext & ResponseContext<"channel", "establishEndToEndEncryption">, args: SignKeyAgreementParametersArgs): Promise<void> {
+                try {
+                    await self.preCall("channel", "establishEndToEndEncryption", { context, args });
+                } catch (e) {
+                    context.response.reject(e);
+                    return;
+                }
+                const wrappedResponseCtx: ResponseContext<"channel", "establishEndToEndEncryption"> = {
+                    response: {
+                        async resolve(val: Parameters<ResponseContext<"channel", "establishEndToEndEncryption">["response"]["resolve"]>[0]) {
+                            try {
+                                await self.preResolve("channel", "establishEndToEndEncryption", { context, args }, val)
+                            } catch (e: any) {
+                                context.response.reject(e);
+                                throw new Error(e.reason || "ResolutionFailure");
+                            }
+                            context.response.resolve(val);
+                        },
+                        async reject(val: unknown) {
+                            try {
+                                await self.preReject("channel", "establishEndToEndEncryption", { context, args }, val);
+                            } catch (e) {
+                                context.response.reject(e);
+                                throw e;
+                            }
+                            context.response.reject(val);
+                        }
+                    }
+                };
+                try {
+                    await self.#impl.channel.establishEndToEndEncryption({
+                        ...context,
+                        ...wrappedResponseCtx
+                    }, args);
+                } catch (e) {
+                    self.handleUnexpectedException(
+                        "channel",
+                        "establishEndToEndEncryption",
+                        context.response,
+                        e
+                    );
+                    return;
+                }
+            },
             async verifySignedKeyExchangeParameters(context: RequestContext & ResponseContext<"channel", "verifySignedKeyExchangeParameters">, args: VerifySignedKeyExchangeParametersArgs): Promise<void> {
                 try {
                     await self.preCall("channel", "verifySignedKeyExchangeParameters", { context, args });
@@ -972,7 +1060,9 @@ interface PreCallInput {
 }
 const lazy = {};
 ChromeUtils.defineESModuleGetters(lazy, {
-    Schemas: "resource://gre/modules/Schemas.sys.mjs"
+    Schemas: "resource://gre/modules/Schemas.sys.mjs",
+    setTimeout: "resource://gre/modules/Timer.sys.mjs",
+    clearTimeout: "resource://gre/modules/Timer.sys.mjs"
 });
 
 const requestIs = <RT extends RequestType>(requestType: RT, d: { context: PreliminaryRequestContext; args?: unknown; output: unknown}): d is { context: PreliminaryRequestContext; args: RequestHandlerFunctionParameters<RT>[1]; output: RequestHandlerFunctionReturnType<RT> } => {
@@ -1098,16 +1188,25 @@ class ResolutionError extends Error {
     }
 }
 
+interface OperationScope {
+    channelId: string;
+    documentId: number;
+}
+
 interface ILogicalValidator {
     consume(group: string, method: string, input: PreCallInput): Promise<void>;
     rollback(group: string, method: string, input: PreCallInput): Promise<void>;
     digest(group: string, method: string, input: PreCallInput, output: unknown): Promise<void>;
+    /**
+     * Drops any state held for the operation.
+     */
+    release(operationId: string): void;
 }
 
 class FieldIdValidator implements ILogicalValidator {
     /**
      * op id -> field id -> true
-     * TODO(berytus): There should be a cleanup mechanism.
+     * Entries are dropped through release() once the operation ends.
      */
     #fields: Record<string, Record<string, true>>;
 
@@ -1166,6 +1265,10 @@ class FieldIdValidator implements ILogicalValidator {
 
     async digest(group: string, method: string, input: PreCallInput, output: unknown): Promise<void> {}
 
+    release(operationId: string): void {
+        delete this.#fields[operationId];
+    }
+
     async rollback(group: string, method: string, input: PreCallInput): Promise<void> {
         if (inputIs("AccountCreation_AddField", input)) {
             const { operation } = input.context as RequestContextWithOperation;
@@ -1178,7 +1281,7 @@ class FieldIdValidator implements ILogicalValidator {
 class ChallangeMessagingSequenceValidator implements ILogicalValidator {
     /**
      * op id -> ch id -> nb of messages sent
-     * TODO(berytus): There should be a cleanup mechanism.
+     * Entries are dropped through release() once the operation ends.
      */
     #counter: Record<string, Record<string, number>>;
 
@@ -1287,6 +1390,10 @@ class ChallangeMessagingSequenceValidator implements ILogicalValidator {
 
     async digest(group: string, method: string, input: PreCallInput, output: unknown): Promise<void> {}
 
+    release(operationId: string): void {
+        delete this.#counter[operationId];
+    }
+
     async rollback(group: string, method: string, input: PreCallInput): Promise<void> {
         if (!inputIs("AccountAuthentication_RespondToChallengeMessage", input)) {
             return;
@@ -1310,6 +1417,8 @@ class FieldCreationHandler implements ILogicalValidator {
 
     async rollback(group: string, method: string, input: PreCallInput): Promise<void> {}
 
+    release(operationId: string): void {}
+
     async digest(group: string, method: string, input: PreCallInput, output: unknown): Promise<void> {
         const errorPrefix = `Malformed output passed from the request handler's `
             + `${group}:${method} method.`;
@@ -1345,10 +1454,17 @@ class FieldCreationHandler implements ILogicalValidator {
 export class ValidatedRequestHandler extends IsolatedRequestHandler {
     #schema: any;
     #validators: ILogicalValidator[];
+    /**
+     * op id -> the channel and the document (inner window id) the
+     * operation belongs to. Used to release the validators' state of
+     * operations whose channel was closed or whose document is gone.
+     */
+    #operations: Map<string, OperationScope>;
 
     constructor(impl: IUnderlyingRequestHandler) {
         // TODO(berytus): ensure impl is conformant
         super(impl);
+        this.#operations = new Map();
         this.#validators = [];
         this.#validators.push(
             new FieldIdValidator(),
@@ -1411,6 +1527,7 @@ export class ValidatedRequestHandler extends IsolatedRequestHandler {
             );
         }
         await this.#consumeValidators(group, method, input);
+        this.#trackOperation(input);
         try {
             await super.preCall(group, method, input);
         } catch (e) {
@@ -1447,6 +1564,52 @@ export class ValidatedRequestHandler extends IsolatedRequestHandler {
             }
         }
         await super.preResolve(group, method, input, output);
+        this.#releaseEndedOperations(input);
+    }
+
+    /**
+     * Releases the validators' state of the operations that took
+     * place in the document, e.g. once the document is destroyed.
+     */
+    releaseDocument(documentId: number) {
+        this.#releaseOperations(scope => scope.documentId === documentId);
+    }
+
+    #trackOperation(input: PreCallInput) {
+        const { operation, channel } = input.context as Partial<RequestContextWithOperation>;
+        if (! operation || ! channel || this.#operations.has(operation.id)) {
+            return;
+        }
+        this.#operations.set(operation.id, {
+            channelId: channel.id,
+            documentId: input.context.document.id
+        });
+    }
+
+    #releaseEndedOperations(input: PreCallInput) {
+        if (inputIs("Login_CloseOperation", input)
+            || inputIs("AccountCreation_ApproveTransitionToAuthOp", input)) {
+            const { operation } = input.context as RequestContextWithOperation;
+            this.#releaseOperation(operation.id);
+            return;
+        }
+        if (inputIs("Channel_CloseChannel", input)) {
+            const { channel } = input.context as RequestContext;
+            this.#releaseOperations(scope => scope.channelId === channel.id);
+        }
+    }
+
+    #releaseOperations(predicate: (scope: OperationScope) => boolean) {
+        for (const [operationId, scope] of this.#operations) {
+            if (predicate(scope)) {
+                this.#releaseOperation(operationId);
+            }
+        }
+    }
+
+    #releaseOperation(operationId: string) {
+        this.#operations.delete(operationId);
+        this.#validators.forEach(val => val.release(operationId));
     }
 
     protected async preReject(group: string, method: string, input: PreCallInput, value: unknown) {
@@ -1522,40 +1685,228 @@ export class ValidatedRequestHandler extends IsolatedRequestHandler {
         return this.#schema;
     }
 }
+interface PendingRequest {
+    group: string;
+    method: string;
+    context: PreliminaryRequestContext & {
+        response: { reject(val: unknown): void }
+    };
+    /**
+     * Set if the request has a deadline.
+     */
+    deadlineTimer?: number;
+}
+
+interface QueuedRequest {
+    requestId: string;
+    proceed(): void;
+    fail(reason: unknown): void;
+    /**
+     * Set if the request has a deadline.
+     */
+    deadlineTimer?: number;
+}
+
 export class SequentialRequestHandler extends ValidatedRequestHandler {
 
     protected busy: boolean = false;
+    #impl: IUnderlyingRequestHandler & Partial<ICancellableRequestHandler>;
+    /**
+     * The request sent to the secret manager and not yet settled.
+     * Cleared when the request is settled or cancelled; late
+     * settlements of a cancelled request are refused.
+     */
+    #pending?: PendingRequest;
+    /**
+     * Requests waiting for the pending one to settle, in arrival
+     * order. The handler of a secret manager is shared by the
+     * channels of all windows, so their requests are queued rather
+     * than refused.
+     */
+    #queue: QueuedRequest[] = [];
 
-    protected async preCall(group: string, method: string, input: PreCallInput) {
-        if (this.busy) {
+    constructor(impl: IUnderlyingRequestHandler & Partial<ICancellableRequestHandler>) {
+        super(impl);
+        this.#impl = impl;
+    }
+
+    #isPending(input: PreCallInput) {
+        return this.#pending !== undefined
+            && this.#pending.context === input.context;
+    }
+
+    #clearPending() {
+        if (this.#pending?.deadlineTimer !== undefined) {
+            // @ts-ignore: TS did not catch assertion for "lazy"
+            lazy.clearTimeout(this.#pending.deadlineTimer);
+        }
+        this.#pending = undefined;
+        this.#proceedWithNext();
+    }
+
+    /**
+     * Hands the turn to the oldest queued request, if any; the
+     * handler stays busy in that case.
+     */
+    #proceedWithNext() {
+        const next = this.#queue.shift();
+        if (! next) {
+            this.busy = false;
+            return;
+        }
+        if (next.deadlineTimer !== undefined) {
+            // @ts-ignore: TS did not catch assertion for "lazy"
+            lazy.clearTimeout(next.deadlineTimer);
+        }
+        next.proceed();
+    }
+
+    #dequeue(queued: QueuedRequest, reason: unknown) {
+        const index = this.#queue.indexOf(queued);
+        if (index === -1) {
+            return;
+        }
+        this.#queue.splice(index, 1);
+        if (queued.deadlineTimer !== undefined) {
+            // @ts-ignore: TS did not catch assertion for "lazy"
+            lazy.clearTimeout(queued.deadlineTimer);
+        }
+        queued.fail(reason);
+    }
+
+    /**
+     * Resolves once the requests ahead are settled. Rejects if the
+     * request is cancelled, or its deadline is passed, while queued.
+     */
+    #waitForTurn(input: PreCallInput) {
+        return new Promise<void>((resolve, reject) => {
+            const queued: QueuedRequest = {
+                requestId: input.context.request.id,
+                proceed: resolve,
+                fail: reject
+            };
+            const { deadline } = input.context.request;
+            if (deadline !== undefined) {
+                // @ts-ignore: TS did not catch assertion for "lazy"
+                queued.deadlineTimer = lazy.setTimeout(() => {
+                    this.#dequeue(queued, new Components.Exception(
+                        `Request ${queued.requestId} timed out.`,
+                        Cr.NS_ERROR_NET_TIMEOUT
+                    ));
+                }, Math.max(deadline - Date.now(), 0));
+            }
+            this.#queue.push(queued);
+        });
+    }
+
+    #refuseStaleSettlement(input: PreCallInput) {
+        if (! this.#isPending(input)) {
             throw new Components.Exception(
-                'Refusing to send request to secret manager, '
-                + 'an existing request is still pending. '
-                + 'make sure to send one request at a time '
-                + 'to the secret manager.',
-                Cr.NS_ERROR_FAILURE
+                `Request ${input.context.request.id} is no longer `
+                + 'pending; it was either cancelled or already settled.',
+                Cr.NS_BINDING_ABORTED
             );
         }
+        this.#clearPending();
+    }
+
+    /**
+     * Rejects the pending request with the passed reason, rolls back
+     * the validators and notifies the secret manager so that it can
+     * stop processing the request.
+     */
+    #abort(pending: PendingRequest, reason: unknown) {
+        const requestId = pending.context.request.id;
+        this.#clearPending();
+        super.preReject(
+            pending.group,
+            pending.method,
+            { context: pending.context },
+            reason
+        ).catch(e => {
+            console.warn(`Unable to roll back aborted request ${requestId}`, e);
+        });
+        pending.context.response.reject(reason);
+        try {
+            this.#impl.cancelRequest?.(requestId);
+        } catch (e) {
+            console.warn(`Secret manager failed to cancel request ${requestId}`, e);
+        }
+    }
+
+    protected async preCall(group: string, method: string, input: PreCallInput) {
+        if (this.busy) {
+            // The turn is handed over with the handler still busy.
+            await this.#waitForTurn(input);
+        }
         this.busy = true;
+        const pending: PendingRequest = {
+            group,
+            method,
+            context: input.context as PendingRequest["context"]
+        };
+        const { deadline } = input.context.request;
+        if (deadline !== undefined) {
+            // @ts-ignore: TS did not catch assertion for "lazy"
+            pending.deadlineTimer = lazy.setTimeout(() => {
+                if (this.#pending !== pending) {
+                    return;
+                }
+                this.#abort(pending, new Components.Exception(
+                    `Request ${pending.context.request.id} timed out.`,
+                    Cr.NS_ERROR_NET_TIMEOUT
+                ));
+            }, Math.max(deadline - Date.now(), 0));
+        }
+        this.#pending = pending;
         try {
             await super.preCall(group, method, input);
         } catch (e) {
-            this.busy = false;
+            this.#clearPending();
             throw e;
         }
     }
     protected async preResolve(group: string, method: string, input: PreCallInput, value: unknown) {
-        this.busy = false;
+        this.#refuseStaleSettlement(input);
         await super.preResolve(group, method, input, value);
     }
     protected async preReject(group: string, method: string, input: PreCallInput, value: unknown) {
-        this.busy = false;
+        this.#refuseStaleSettlement(input);
         await super.preReject(group, method, input, value);
     }
     protected handleUnexpectedException<G extends keyof RequestHandler, M extends keyof RequestHandler[G]>(group: G, method: M, response: ResponseContext<G, M>["response"], excp: unknown) {
-        this.busy = false;
+        if (this.#pending?.context.response !== response) {
+            // The request was cancelled; its response is settled.
+            return;
+        }
+        this.#clearPending();
         super.handleUnexpectedException(group, method, response, excp);
     }
+
+    /**
+     * Cancels the pending or a queued request if its id matches; the
+     * request is rejected with NS_BINDING_ABORTED. A queued request
+     * is dropped before reaching the secret manager. Requests with a
+     * deadline are likewise aborted with NS_ERROR_NET_TIMEOUT once
+     * the deadline is passed. Returns whether a request was cancelled.
+     */
+    cancel(requestId: string): boolean {
+        const reason = new Components.Exception(
+            `Request ${requestId} was cancelled.`,
+            Cr.NS_BINDING_ABORTED
+        );
+        const pending = this.#pending;
+        if (pending?.context.request.id === requestId) {
+            this.#abort(pending, reason);
+            return true;
+        }
+        const queued = this.#queue.find(q => q.requestId === requestId);
+        if (! queued) {
+            return false;
+        }
+        this.#dequeue(queued, reason);
+        return true;
+    }
 }
 
 function uuid(): string {
@@ -1583,7 +1934,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
         this.#impl = impl;
         const self = this;
         this.manager = {
-            getSigningKey(context: Omit<PreliminaryRequestContext, "request">, args: GetSigningKeyArgs): Promise<ReturnType<RequestHandler["manager"]["getSigningKey"]>> {
+            getSigningKey(context: PublicRequestContext<PreliminaryRequestContext>, args: GetSigningKeyArgs): Promise<ReturnType<RequestHandler["manager"]["getSigningKey"]>> {
                 return new Promise<ReturnType<RequestHandler["manager"]["getSigningKey"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"manager", "getSigningKey"> = {
                         response: {
@@ -1598,6 +1949,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Manager_GetSigningKey" as const
                         }
                     };
@@ -1608,7 +1960,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, args);
                 })
             },
-            getCredentialsMetadata(context: Omit<PreliminaryRequestContext, "request">, args: GetCredentialsMetadataArgs): Promise<ReturnType<RequestHandler["manager"]["getCredentialsMetadata"]>> {
+            getCredentialsMetadata(context: PublicRequestContext<PreliminaryRequestContext>, args: GetCredentialsMetadataArgs): Promise<ReturnType<RequestHandler["manager"]["getCredentialsMetadata"]>> {
                 return new Promise<ReturnType<RequestHandler["manager"]["getCredentialsMetadata"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"manager", "getCredentialsMetadata"> = {
                         response: {
@@ -1623,6 +1975,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Manager_GetCredentialsMetadata" as const
                         }
                     };
@@ -1635,7 +1988,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
             },
         };
         this.channel = {
-            createChannel(context: Omit<PreliminaryRequestContext, "request">, args: CreateChannelArgs): Promise<ReturnType<RequestHandler["channel"]["createChannel"]>> {
+            createChannel(context: PublicRequestContext<PreliminaryRequestContext>, args: CreateChannelArgs): Promise<ReturnType<RequestHandler["channel"]["createChannel"]>> {
                 return new Promise<ReturnType<RequestHandler["channel"]["createChannel"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"channel", "createChannel"> = {
                         response: {
@@ -1650,6 +2003,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Channel_CreateChannel" as const
                         }
                     };
@@ -1660,7 +2014,33 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, args);
                 })
             },
-            generateX25519Key(context: Omit<RequestContext, "request">): Promise<ReturnType<RequestHandler["channel"]["generateX25519Key"]>> {
+            bootstrapChannel(context: PublicRequestContext<PreliminaryRequestContext>, args: BootstrapChannelArgs): Promise<ReturnType<RequestHandler["channel"]["bootstrapChannel"]>> {
+                return new Promise<ReturnType<RequestHandler["channel"]["bootstrapChannel"]>>((_resolve, _reject) => {
+                    const responseCtx: ResponseContext<"channel", "bootstrapChannel"> = {
+                        response: {
+                            resolve(val: ReturnType<RequestHandler["channel"]["bootstrapChannel"]>) {
+                                _resolve(val);
+                            },
+                            reject(val: unknown) {
+                                _reject(val);
+                            }
+                        }
+                    }
+                    const requestCtx = {
+                        request: {
+                            id: uuid(),
+                            ...context.request,
+                            type: "Channel_BootstrapChannel" as const
+                        }
+                    };
+                    self.#impl.channel.bootstrapChannel({
+                        ...context,
+                        ...responseCtx,
+                        ...requestCtx
+                    }, args);
+                })
+            },
+            generateX25519Key(context: PublicRequestContext<RequestContext>): Promise<ReturnType<RequestHandler["channel"]["generateX25519Key"]>> {
                 return new Promise<ReturnType<RequestHandler["channel"]["generateX25519Key"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"channel", "generateX25519Key"> = {
                         response: {
@@ -1675,6 +2055,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Channel_GenerateX25519Key" as const
                         }
                     };
@@ -1685,7 +2066,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, );
                 })
             },
-            signKeyExchangeParameters(context: Omit<RequestContext, "request">, args: SignKeyAgreementParametersArgs): Promise<ReturnType<RequestHandler["channel"]["signKeyExchangeParameters"]>> {
+            signKeyExchangeParameters(context: PublicRequestContext<RequestContext>, args: SignKeyAgreementParametersArgs): Promise<ReturnType<RequestHandler["channel"]["signKeyExchangeParameters"]>> {
                 return new Promise<ReturnType<RequestHandler["channel"]["signKeyExchangeParameters"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"channel", "signKeyExchangeParameters"> = {
                         response: {
@@ -1700,6 +2081,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Channel_SignKeyExchangeParameters" as const
                         }
                     };
@@ -1710,7 +2092,33 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, args);
                 })
             },
-            verifySignedKeyExchangeParameters(context: Omit<RequestContext, "request">, args: VerifySignedKeyExchangeParametersArgs): Promise<ReturnType<RequestHandler["channel"]["verifySignedKeyExchangeParameters"]>> {
+            establishEndToEndEncryption(context: PublicRequestContext<RequestContext>, args: SignKeyAgreementParametersArgs): Promise<ReturnType<RequestHandler["channel"]["establishEndToEndEncryption"]>> {
+                return new Promise<ReturnType<RequestHandler["channel"]["establishEndToEndEncryption"]>>((_resolve, _reject) => {
+                    const responseCtx: ResponseContext<"channel", "establishEndToEndEncryption"> = {
+                        response: {
+                            resolve(val: ReturnType<RequestHandler["channel"]["establishEndToEndEncryption"]>) {
+                                _resolve(val);
+                            },
+                            reject(val: unknown) {
+                                _reject(val);
+                            }
+                        }
+                    }
+                    const requestCtx = {
+                        request: {
+                            id: uuid(),
+                            ...context.request,
+                            type: "Channel_EstablishEndToEndEncryption" as const
+                        }
+                    };
+                    self.#impl.channel.establishEndToEndEncryption({
+                        ...context,
+                        ...responseCtx,
+                        ...requestCtx
+                    }, args);
+                })
+            },
+            verifySignedKeyExchangeParameters(context: PublicRequestContext<RequestContext>, args: VerifySignedKeyExchangeParametersArgs): Promise<ReturnType<RequestHandler["channel"]["verifySignedKeyExchangeParameters"]>> {
                 return new Promise<ReturnType<RequestHandler["channel"]["verifySignedKeyExchangeParameters"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"channel", "verifySignedKeyExchangeParameters"> = {
                         response: {
@@ -1725,6 +2133,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Channel_VerifySignedKeyExchangeParameters" as const
                         }
                     };
@@ -1735,7 +2144,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, args);
                 })
             },
-            enableEndToEndEncryption(context: Omit<RequestContext, "request">): Promise<ReturnType<RequestHandler["channel"]["enableEndToEndEncryption"]>> {
+            enableEndToEndEncryption(context: PublicRequestContext<RequestContext>): Promise<ReturnType<RequestHandler["channel"]["enableEndToEndEncryption"]>> {
                 return new Promise<ReturnType<RequestHandler["channel"]["enableEndToEndEncryption"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"channel", "enableEndToEndEncryption"> = {
                         response: {
@@ -1750,6 +2159,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Channel_EnableEndToEndEncryption" as const
                         }
                     };
@@ -1760,7 +2170,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, );
                 })
             },
-            closeChannel(context: Omit<RequestContext, "request">): Promise<ReturnType<RequestHandler["channel"]["closeChannel"]>> {
+            closeChannel(context: PublicRequestContext<RequestContext>): Promise<ReturnType<RequestHandler["channel"]["closeChannel"]>> {
                 return new Promise<ReturnType<RequestHandler["channel"]["closeChannel"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"channel", "closeChannel"> = {
                         response: {
@@ -1775,6 +2185,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Channel_CloseChannel" as const
                         }
                     };
@@ -1787,7 +2198,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
             },
         };
         this.login = {
-            approveOperation(context: Omit<RequestContext, "request">, args: ApproveOperationArgs): Promise<ReturnType<RequestHandler["login"]["approveOperation"]>> {
+            approveOperation(context: PublicRequestContext<RequestContext>, args: ApproveOperationArgs): Promise<ReturnType<RequestHandler["login"]["approveOperation"]>> {
                 return new Promise<ReturnType<RequestHandler["login"]["approveOperation"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"login", "approveOperation"> = {
                         response: {
@@ -1802,6 +2213,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Login_ApproveOperation" as const
                         }
                     };
@@ -1812,7 +2224,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, args);
                 })
             },
-            closeOperation(context: Omit<RequestContextWithOperation, "request">): Promise<ReturnType<RequestHandler["login"]["closeOperation"]>> {
+            closeOperation(context: PublicRequestContext<RequestContextWithOperation>): Promise<ReturnType<RequestHandler["login"]["closeOperation"]>> {
                 return new Promise<ReturnType<RequestHandler["login"]["closeOperation"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"login", "closeOperation"> = {
                         response: {
@@ -1827,6 +2239,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Login_CloseOperation" as const
                         }
                     };
@@ -1837,7 +2250,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, );
                 })
             },
-            getRecordMetadata(context: Omit<RequestContextWithOperation, "request">): Promise<ReturnType<RequestHandler["login"]["getRecordMetadata"]>> {
+            getRecordMetadata(context: PublicRequestContext<RequestContextWithOperation>): Promise<ReturnType<RequestHandler["login"]["getRecordMetadata"]>> {
                 return new Promise<ReturnType<RequestHandler["login"]["getRecordMetadata"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"login", "getRecordMetadata"> = {
                         response: {
@@ -1852,6 +2265,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Login_GetRecordMetadata" as const
                         }
                     };
@@ -1862,7 +2276,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, );
                 })
             },
-            updateMetadata(context: Omit<RequestContextWithOperation, "request">, args: UpdateMetadataArgs): Promise<ReturnType<RequestHandler["login"]["updateMetadata"]>> {
+            updateMetadata(context: PublicRequestContext<RequestContextWithOperation>, args: UpdateMetadataArgs): Promise<ReturnType<RequestHandler["login"]["updateMetadata"]>> {
                 return new Promise<ReturnType<RequestHandler["login"]["updateMetadata"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"login", "updateMetadata"> = {
                         response: {
@@ -1877,6 +2291,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "Login_UpdateMetadata" as const
                         }
                     };
@@ -1889,7 +2304,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
             },
         };
         this.accountCreation = {
-            approveTransitionToAuthOp(context: Omit<RequestContextWithOperation, "request">, args: ApproveTransitionToAuthOpArgs): Promise<ReturnType<RequestHandler["accountCreation"]["approveTransitionToAuthOp"]>> {
+            approveTransitionToAuthOp(context: PublicRequestContext<RequestContextWithOperation>, args: ApproveTransitionToAuthOpArgs): Promise<ReturnType<RequestHandler["accountCreation"]["approveTransitionToAuthOp"]>> {
                 return new Promise<ReturnType<RequestHandler["accountCreation"]["approveTransitionToAuthOp"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"accountCreation", "approveTransitionToAuthOp"> = {
                         response: {
@@ -1904,6 +2319,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountCreation_ApproveTransitionToAuthOp" as const
                         }
                     };
@@ -1914,7 +2330,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, args);
                 })
             },
-            getUserAttributes(context: Omit<RequestContextWithLoginOperation, "request">): Promise<ReturnType<RequestHandler["accountCreation"]["getUserAttributes"]>> {
+            getUserAttributes(context: PublicRequestContext<RequestContextWithLoginOperation>): Promise<ReturnType<RequestHandler["accountCreation"]["getUserAttributes"]>> {
                 return new Promise<ReturnType<RequestHandler["accountCreation"]["getUserAttributes"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"accountCreation", "getUserAttributes"> = {
                         response: {
@@ -1929,6 +2345,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountCreation_GetUserAttributes" as const
                         }
                     };
@@ -1939,7 +2356,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, );
                 })
             },
-            updateUserAttributes(context: Omit<RequestContextWithOperation, "request">, args: UpdateUserAttributesArgs): Promise<ReturnType<RequestHandler["accountCreation"]["updateUserAttributes"]>> {
+            updateUserAttributes(context: PublicRequestContext<RequestContextWithOperation>, args: UpdateUserAttributesArgs): Promise<ReturnType<RequestHandler["accountCreation"]["updateUserAttributes"]>> {
                 return new Promise<ReturnType<RequestHandler["accountCreation"]["updateUserAttributes"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"accountCreation", "updateUserAttributes"> = {
                         response: {
@@ -1954,6 +2371,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountCreation_UpdateUserAttributes" as const
                         }
                     };
@@ -1964,7 +2382,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, args);
                 })
             },
-            addField(context: Omit<RequestContextWithLoginOperation, "request">, args: AddFieldArgs): Promise<ReturnType<RequestHandler["accountCreation"]["addField"]>> {
+            addField(context: PublicRequestContext<RequestContextWithLoginOperation>, args: AddFieldArgs): Promise<ReturnType<RequestHandler["accountCreation"]["addField"]>> {
                 return new Promise<ReturnType<RequestHandler["accountCreation"]["addField"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"accountCreation", "addField"> = {
                         response: {
@@ -1979,6 +2397,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountCreation_AddField" as const
                         }
                     };
@@ -1989,7 +2408,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, args);
                 })
             },
-            rejectFieldValue(context: Omit<RequestContextWithLoginOperation, "request">, args: RejectFieldValueArgs): Promise<ReturnType<RequestHandler["accountCreation"]["rejectFieldValue"]>> {
+            rejectFieldValue(context: PublicRequestContext<RequestContextWithLoginOperation>, args: RejectFieldValueArgs): Promise<ReturnType<RequestHandler["accountCreation"]["rejectFieldValue"]>> {
                 return new Promise<ReturnType<RequestHandler["accountCreation"]["rejectFieldValue"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"accountCreation", "rejectFieldValue"> = {
                         response: {
@@ -2004,6 +2423,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountCreation_RejectFieldValue" as const
                         }
                     };
@@ -2016,7 +2436,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
             },
         };
         this.accountAuthentication = {
-            approveChallengeRequest(context: Omit<RequestContextWithOperation, "request">, args: ApproveChallengeRequestArgs): Promise<ReturnType<RequestHandler["accountAuthentication"]["approveChallengeRequest"]>> {
+            approveChallengeRequest(context: PublicRequestContext<RequestContextWithOperation>, args: ApproveChallengeRequestArgs): Promise<ReturnType<RequestHandler["accountAuthentication"]["approveChallengeRequest"]>> {
                 return new Promise<ReturnType<RequestHandler["accountAuthentication"]["approveChallengeRequest"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"accountAuthentication", "approveChallengeRequest"> = {
                         response: {
@@ -2031,6 +2451,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountAuthentication_ApproveChallengeRequest" as const
                         }
                     };
@@ -2041,7 +2462,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, args);
                 })
             },
-            abortChallenge(context: Omit<RequestContextWithOperation, "request">, args: AbortChallengeArgs): Promise<ReturnType<RequestHandler["accountAuthentication"]["abortChallenge"]>> {
+            abortChallenge(context: PublicRequestContext<RequestContextWithOperation>, args: AbortChallengeArgs): Promise<ReturnType<RequestHandler["accountAuthentication"]["abortChallenge"]>> {
                 return new Promise<ReturnType<RequestHandler["accountAuthentication"]["abortChallenge"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"accountAuthentication", "abortChallenge"> = {
                         response: {
@@ -2056,6 +2477,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountAuthentication_AbortChallenge" as const
                         }
                     };
@@ -2066,7 +2488,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, args);
                 })
             },
-            closeChallenge(context: Omit<RequestContextWithOperation, "request">, args: CloseChallengeArgs): Promise<ReturnType<RequestHandler["accountAuthentication"]["closeChallenge"]>> {
+            closeChallenge(context: PublicRequestContext<RequestContextWithOperation>, args: CloseChallengeArgs): Promise<ReturnType<RequestHandler["accountAuthentication"]["closeChallenge"]>> {
                 return new Promise<ReturnType<RequestHandler["accountAuthentication"]["closeChallenge"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"accountAuthentication", "closeChallenge"> = {
                         response: {
@@ -2081,6 +2503,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountAuthentication_CloseChallenge" as const
                         }
                     };
@@ -2091,7 +2514,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     }, args);
                 })
             },
-            respondToChallengeMessage(context: Omit<RequestContextWithLoginOperation, "request">, args: BerytusSendMessageUnion): Promise<ReturnType<RequestHandler["accountAuthentication"]["respondToChallengeMessage"]>> {
+            respondToChallengeMessage(context: PublicRequestContext<RequestContextWithLoginOperation>, args: BerytusSendMessageUnion): Promise<ReturnType<RequestHandler["accountAuthentication"]["respondToChallengeMessage"]>> {
                 return new Promise<ReturnType<RequestHandler["accountAuthentication"]["respondToChallengeMessage"]>>((_resolve, _reject) => {
                     const responseCtx: ResponseContext<"accountAuthentication", "respondToChallengeMessage"> = {
                         response: {
@@ -2106,6 +2529,7 @@ export class PublicRequestHandler implements IPublicRequestHandler {
                     const requestCtx = {
                         request: {
                             id: uuid(),
+                            ...context.request,
                             type: "AccountAuthentication_RespondToChallengeMessage" as const
                         }
                     };
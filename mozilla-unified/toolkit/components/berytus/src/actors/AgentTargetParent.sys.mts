@@ -3,12 +3,23 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 import { Agent } from "resource://gre/modules/BerytusAgent.sys.mjs";
+import { liaison } from "resource://gre/modules/BerytusLiaison.sys.mjs";
 import type { AgentTarget } from "src/Agent.sys.mjs";
 import type { RequestGroup } from "src/types";
 
 export const Actor = "BerytusAgentTarget";
 
 export class BerytusAgentTargetParent extends JSWindowActorParent {
+    /**
+     * The inner window id of the window global, which is
+     * the document id of the request contexts.
+     */
+    #innerWindowId?: number;
+    /**
+     * request id -> manager id of the requests sent by the
+     * window global that have not settled yet.
+     */
+    #pendingRequests: Map<string, string> = new Map();
 
     #isGroupValid(target: AgentTarget, group: unknown): group is RequestGroup {
         if (typeof group !== "string") {
@@ -27,6 +38,8 @@ export class BerytusAgentTargetParent extends JSWindowActorParent {
             managerId,
             group,
             method,
+            requestId,
+            requestTimeout,
             requestContext,
             requestArgs
         } = msg.data;
@@ -36,6 +49,12 @@ export class BerytusAgentTargetParent extends JSWindowActorParent {
                 "managerId is not a string."
             );
         }
+        if (typeof requestId !== 'string' || this.#pendingRequests.has(requestId)) {
+            throw new Error(
+                "Received malformed message data; " +
+                `requestId is not valid (${requestId}).`
+            );
+        }
         const target = Agent.target(managerId);
         if (! this.#isGroupValid(target, group)) {
             throw new Error(
@@ -50,18 +69,57 @@ export class BerytusAgentTargetParent extends JSWindowActorParent {
                 `method is not valid (${method}).`
             );
         }
-        const result = await fn.apply(
-            target,
-            [requestContext, requestArgs]
-        );
-        return result;
+        const request: { id: string; deadline?: number } = { id: requestId };
+        if (typeof requestTimeout === 'number' && requestTimeout > 0) {
+            // The secret manager is given until the deadline to settle
+            // the request; see SequentialRequestHandler.
+            request.deadline = Date.now() + requestTimeout;
+        }
+        this.#pendingRequests.set(requestId, managerId);
+        try {
+            const result = await fn.apply(
+                target,
+                [{ ...requestContext, request }, requestArgs]
+            );
+            return result;
+        } finally {
+            this.#pendingRequests.delete(requestId);
+        }
+    }
+
+    #cancelRequest(msg: ActorMessage) {
+        const { requestId } = msg.data;
+        const managerId = this.#pendingRequests.get(requestId);
+        if (managerId === undefined) {
+            // Already settled.
+            return;
+        }
+        liaison.cancelRequest(managerId, requestId);
+    }
+
+    actorCreated() {
+        // @ts-ignore: TODO(berytus): add to index.d.ts
+        this.#innerWindowId = this.manager.innerWindowId;
     }
 
     didDestroy() {
         console.debug(`BerytusAgentTargetParent::didDestroy()`);
+        // Nobody is awaiting the pending requests anymore; let the
+        // secret managers know before releasing the document's state.
+        for (const [requestId, managerId] of this.#pendingRequests) {
+            liaison.cancelRequest(managerId, requestId);
+        }
+        this.#pendingRequests.clear();
+        if (this.#innerWindowId !== undefined) {
+            liaison.releaseDocument(this.#innerWindowId);
+        }
     }
 
     async receiveMessage(msg: ActorMessage) {
+        if (msg.name === `${Actor}:cancelRequest`) {
+            this.#cancelRequest(msg);
+            return;
+        }
         try {
             return (await this.#processMessage(msg));
         } catch (e: any) {
@@ -8,6 +8,17 @@ import { PromptService } from "resource://gre/modules/BerytusPromptService.sys.m
 export const Actor = 'BerytusPromptService';
 type Actor = typeof Actor;
 
+/**
+ * Methods keyed by the document's origin. The origin is taken from
+ * the window global of the actor rather than from the child, which
+ * could pass the browsing context of another document.
+ */
+const originBoundMethods = new Set([
+    "storeChannelSession",
+    "resumeChannelSession",
+    "revokeChannelSession"
+]);
+
 /* Class name must match Actor name */
 export class BerytusPromptServiceParent extends PassthroughParent<PromptService> {
     protected Actor = Actor;
@@ -19,4 +30,14 @@ export class BerytusPromptServiceParent extends PassthroughParent<PromptService>
         }
         return this.#inst;
     }
+
+    protected doCall(messageName: string, args: any[]) {
+        if (! originBoundMethods.has(this.extractMethod(messageName))
+            || ! Array.isArray(args)) {
+            return super.doCall(messageName, args);
+        }
+        // @ts-ignore: TODO(berytus): add to index.d.ts
+        const { origin } = this.manager.documentPrincipal;
+        return super.doCall(messageName, [origin, ...args]);
+    }
 }
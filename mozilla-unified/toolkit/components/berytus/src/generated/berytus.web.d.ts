@@ -120,19 +120,23 @@ type BerytusPlaintextSource = BerytusPlaintextStringSource | BerytusPlaintextBuf
 type BerytusCiphertextSource = BerytusEncryptedPacket;
 type BerytusDataSource = BerytusPlaintextSource | BerytusCiphertextSource;
 type BerytusDataType = string | ArrayBuffer | BerytusEncryptedPacket;
-type BerytusEncryptionParams = AesGcmParams;
+export interface BerytusEncryptionParams extends AesGcmParams {
+    chunkSize?: number;
+}
 export interface AesGcmParamsJSON extends Algorithm {
     iv: Base64URLString;
     additionalData?: Base64URLString;
     tagLength?: number;
 }
-type BerytusEncryptionParamsJSON = AesGcmParamsJSON;
+export interface BerytusEncryptionParamsJSON extends AesGcmParamsJSON {
+    chunkSize?: number;
+}
 export interface BerytusEncryptedPacketJSON {
     parameters: BerytusEncryptionParamsJSON;
     ciphertext: Base64URLString;
 }
 export interface BerytusEncryptedPacket {
-    readonly parameters: AesGcmParams;
+    readonly parameters: BerytusEncryptionParams;
     readonly ciphertext: ArrayBuffer;
 }
 type BerytusFieldType = "Identity" | "ForeignIdentity" | "Password" | "SecurePassword" | "ConsumablePassword" | "Key" | "SharedKey" | "Custom";
@@ -2,7 +2,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
-import type { BerytusChallengeAbortionCode, BerytusChallengeInfoUnion, BerytusFieldOptionsUnion, BerytusFieldUnion, BerytusFieldValue, BerytusFieldValueUnion, BerytusKeyDerivationParams, BerytusKeyExchangeAuthentication, BerytusKeyExchangeParams, BerytusKeyExchangeSession, BerytusKeyGenParams, BerytusReceiveMessageUnion, BerytusSendMessageUnion, BerytusUserAttributeDefinition, EBerytusChallengeType, EBerytusFieldType } from "./generated/berytus.web.d.ts";
+import type { BerytusChallengeAbortionCode, BerytusChallengeInfoUnion, BerytusFieldOptionsUnion, BerytusFieldUnion, BerytusFieldValue, BerytusFieldValueUnion, BerytusKeyDerivationParams, BerytusKeyExchangeAuthentication, BerytusKeyExchangeParams, BerytusKeyExchangeSession, BerytusKeyGenParams, BerytusReceiveMessageUnion, BerytusSendMessageUnion, BerytusEncryptedPacket, BerytusUserAttributeDefinition, EBerytusChallengeType, EBerytusFieldType } from "./generated/berytus.web.d.ts";
 
 export interface ChannelConstraints {
     secretManagerPublicKey?: string[];
@@ -50,6 +50,12 @@ export interface CryptoActor {
 export interface Request {
     id: string;
     type: string;
+    /**
+     * When the requester stops awaiting the response, in milliseconds
+     * since the epoch. The request is cancelled once the deadline is
+     * passed.
+     */
+    deadline?: number;
 }
 
 export interface DocumentMetadata {
@@ -219,8 +225,16 @@ export type UserAttributeKey = "name" | "givenName" | "familyName" | "middleName
     "locale" |/* "phoneNumber" |*/ "address" | `custom:${string}`;
 
 
-export interface UserAttribute extends BerytusUserAttributeDefinition {
+/**
+ * Large binary values, e.g. scanned identity documents, can be passed
+ * as a Blob. A Blob is cloned by reference to its data, which is only
+ * read, in chunks, by whoever consumes it.
+ */
+export type UserAttributeValue = string | ArrayBuffer | ArrayBufferView | Blob | BerytusEncryptedPacket;
+
+export interface UserAttribute extends Omit<BerytusUserAttributeDefinition, "value"> {
     id: UserAttributeKey;
+    value: UserAttributeValue;
 };
 
 export interface RequestedUserAttribute {
@@ -228,7 +242,17 @@ export interface RequestedUserAttribute {
     required: boolean;
 }
 
+/**
+ * A user attribute without its value.
+ */
+export interface UserAttributeInfo {
+    id: UserAttributeKey;
+    info?: string;
+    mimeType?: string;
+}
+
 export type UserAttributes = Array<UserAttribute>;
+export type UserAttributeInfos = Array<UserAttributeInfo>;
 export type RequestedUserAttributes = Array<RequestedUserAttribute>;
 
 enum EFieldType {
@@ -298,6 +322,13 @@ export type CreateChannelArgs = {
     channel: ChannelMetadata;
 };
 
+export type BootstrapChannelArgs = {
+    channelId: string;
+    constraints: ChannelConstraints;
+    webAppActor: WebAppActor;
+};
+export type BootstrapChannelResult = GetSigningKeyResult;
+
 export interface KeyAgreementParameters {
     authentication: BerytusKeyExchangeAuthentication;
     session: BerytusKeyExchangeSession;
@@ -310,6 +341,11 @@ export type SignKeyAgreementParametersArgs = {
      * CanonicalJSON-stringified KeyAgreementParameters
      */
     canonicalJson: string;
+    /**
+     * The web app's signature of the canonical JSON. Berytus
+     * verifies it prior to sending the request.
+     */
+    webAppSignature: ArrayBuffer;
 }
 export type SignKeyAgreementParametersResult = {
     scmSignature: ArrayBuffer;
@@ -328,6 +364,14 @@ export type VerifySignedKeyExchangeParametersArgs = {
 export type ApproveOperationArgs = {
     operation: LoginOperationMetadata
 }
+export type ApproveOperationAndSnapshotArgs = {
+    operation: LoginOperationMetadata;
+    /**
+     * The keys of the user attributes whose values are to be
+     * included in the snapshot. If unspecified, all values are.
+     */
+    userAttributeProjection?: Array<string>;
+}
 export type UpdateMetadataArgs = {
     metadata: RecordMetadata
 }
@@ -336,6 +380,29 @@ export interface UpdateUserAttributesArgs {
     userAttributes: Array<UserAttribute>;
 };
 
+/**
+ * The state of a freshly approved operation: the record metadata
+ * is present for authentication operations, and the user attributes
+ * for registration operations.
+ */
+export type OperationSnapshot = {
+    intent: ELoginUserIntent;
+    metadata?: RecordMetadata;
+    userAttributes?: UserAttributes;
+    /**
+     * The user attributes left out by the projection, without
+     * their values; see accountCreation.getUserAttributeValues.
+     */
+    unloadedUserAttributes?: UserAttributeInfos;
+}
+
+export type GetUserAttributeValuesArgs = {
+    /**
+     * User attribute keys.
+     */
+    ids: Array<string>;
+}
+
 export type ApproveTransitionToAuthOpArgs = {
     newAuthOp: LoginOperationMetadata
 }
@@ -374,6 +441,12 @@ export type CloseChallengeArgs = {
 export type RespondToChallengeMessageArgs = BerytusSendMessageUnion;
 export type { BerytusSendMessageUnion };
 export type RespondToChallengeMessageResult = BerytusReceiveMessageUnion;
+/**
+ * Messages of the same challenge, in the order they are to be
+ * responded to.
+ */
+export type RespondToChallengeMessagesArgs = RespondToChallengeMessageArgs[];
+export type RespondToChallengeMessagesResult = RespondToChallengeMessageResult[];
 export type { BerytusReceiveMessageUnion };
 export type { BerytusChallengeInfoUnion };
 export { EBerytusChallengeType };
@@ -395,11 +468,31 @@ export interface RequestHandler {
             context: PreliminaryRequestContext,
             args: CreateChannelArgs
         ): void;
+        /**
+         * Creates the channel and returns the secret manager's signing
+         * key in one request; equivalent to manager.getSigningKey
+         * followed by createChannel, where args.channelId, args.constraints
+         * and args.webAppActor form the ChannelMetadata along with the
+         * returned key (scmActor).
+         */
+        bootstrapChannel(
+            context: PreliminaryRequestContext,
+            args: BootstrapChannelArgs
+        ): BootstrapChannelResult;
         generateX25519Key(context: RequestContext): GenerateX25519KeyResult;
         signKeyExchangeParameters(
             context: RequestContext,
             args: SignKeyAgreementParametersArgs
         ): SignKeyAgreementParametersResult;
+        /**
+         * Signs the key agreement parameters and enables end-to-end
+         * encryption in one request; equivalent to
+         * signKeyExchangeParameters followed by enableEndToEndEncryption.
+         */
+        establishEndToEndEncryption(
+            context: RequestContext,
+            args: SignKeyAgreementParametersArgs
+        ): SignKeyAgreementParametersResult;
         verifySignedKeyExchangeParameters(
             context: RequestContext,
             args: VerifySignedKeyExchangeParametersArgs
@@ -469,6 +562,48 @@ export interface RequestHandler {
     }
 }
 
+/**
+ * Requests served by the Agent on top of the secret manager's request
+ * handler; secret managers do not implement these. They exist so that
+ * the content process can get done in a single round trip what would
+ * otherwise take several RequestHandler requests.
+ */
+export interface AgentRequestHandler {
+    login: {
+        /**
+         * Equivalent to login.approveOperation followed by
+         * login.getRecordMetadata (authentication) or
+         * accountCreation.getUserAttributes (registration).
+         */
+        approveOperationAndSnapshot(
+            context: RequestContext,
+            args: ApproveOperationAndSnapshotArgs
+        ): OperationSnapshot;
+    }
+    accountCreation: {
+        /**
+         * Equivalent to accountCreation.getUserAttributes, keeping
+         * only the attributes with the passed ids.
+         */
+        getUserAttributeValues(
+            context: RequestContextWithLoginOperation,
+            args: GetUserAttributeValuesArgs
+        ): UserAttributes;
+    }
+    accountAuthentication: {
+        /**
+         * Equivalent to accountAuthentication.respondToChallengeMessage
+         * for each of the passed messages, in order. Resolves with the
+         * responses in the same order. Stops at the first message that
+         * fails, and rejects with its failure.
+         */
+        respondToChallengeMessages(
+            context: RequestContextWithLoginOperation,
+            args: RespondToChallengeMessagesArgs
+        ): RespondToChallengeMessagesResult;
+    }
+}
+
 export type ResponseContext<G extends keyof RequestHandler, M extends keyof RequestHandler[G]> = {
     response:
         RequestHandler[G][M] extends (...args: any[]) => any
@@ -490,12 +625,30 @@ export type IUnderlyingRequestHandler = {
     }
 }
 
+/**
+ * Request handlers that can be told that a request they are
+ * processing is no longer awaited, e.g. the requesting document
+ * is gone or the web app aborted the call.
+ */
+export interface ICancellableRequestHandler {
+    cancelRequest(requestId: string): void;
+}
+
+/**
+ * The request id is generated by the public request handler,
+ * unless the requester passes one to be able to cancel the
+ * request later on.
+ */
+export type PublicRequestContext<C> = Omit<C, 'request'> & {
+    request?: Pick<Request, 'id' | 'deadline'>
+};
+
 export type IPublicRequestHandler = {
     [group in keyof RequestHandler]: {
         [method in keyof RequestHandler[group]]:
             RequestHandler[group][method] extends (...args: any[]) => any
                 ? Parameters<RequestHandler[group][method]> extends [infer context, ...infer tail]
-                    ?   (context: Omit<context, 'request'>, ...rest: tail) => Promise<ReturnType<RequestHandler[group][method]>>
+                    ?   (context: PublicRequestContext<context>, ...rest: tail) => Promise<ReturnType<RequestHandler[group][method]>>
                     : never
                 : never
     }
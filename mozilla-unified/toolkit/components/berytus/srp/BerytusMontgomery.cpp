@@ -0,0 +1,287 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/berytus/BerytusMontgomery.h"
+#include "mozilla/Assertions.h"
+
+namespace mozilla::berytus {
+
+namespace {
+
+using Limb = MontgomeryContext::Limb;
+using Number = MontgomeryContext::Number;
+
+// Enough for the 8192-bit group, plus the two limbs of headroom
+// needed by Mul.
+constexpr size_t kInlineLimbs = 8192 / 32 + 2;
+
+constexpr uint32_t kWindowBits = 4;
+constexpr uint32_t kWindowSize = 1 << kWindowBits;
+
+// All ones if aA == aB, zero otherwise.
+Limb MaskIfEqual(Limb aA, Limb aB) {
+  const uint64_t diff = aA ^ aB;
+  return Limb(0) - Limb((diff - 1) >> 63);
+}
+
+void ParseBigEndian(Span<const uint8_t> aBytes, size_t aLimbs,
+                    Number& aRetVal) {
+  MOZ_ASSERT(aBytes.Length() <= aLimbs * sizeof(Limb));
+  aRetVal.ClearAndRetainStorage();
+  aRetVal.AppendElements(aLimbs);
+  for (size_t i = 0; i < aLimbs; i++) {
+    aRetVal[i] = 0;
+  }
+  for (size_t i = 0; i < aBytes.Length(); i++) {
+    const uint8_t byte = aBytes[aBytes.Length() - 1 - i];
+    aRetVal[i / sizeof(Limb)] |= Limb(byte) << (8 * (i % sizeof(Limb)));
+  }
+}
+
+} // namespace
+
+UniquePtr<MontgomeryContext> MontgomeryContext::Create(
+    Span<const uint8_t> aModulus) {
+  // Leading zeros do not count towards the size of N.
+  size_t offset = 0;
+  while (offset < aModulus.Length() && aModulus[offset] == 0) {
+    offset++;
+  }
+  Span<const uint8_t> modulus = aModulus.From(offset);
+  if (modulus.IsEmpty() || !(modulus[modulus.Length() - 1] & 1) ||
+      (modulus.Length() == 1 && modulus[0] == 1)) {
+    return nullptr;
+  }
+  const size_t limbs = (modulus.Length() + sizeof(Limb) - 1) / sizeof(Limb);
+  Number n;
+  ParseBigEndian(modulus, limbs, n);
+
+  // Newton's iteration; each step doubles the number of correct
+  // low bits of the inverse, starting from 3 (N is odd).
+  Limb inv = n[0];
+  for (int i = 0; i < 4; i++) {
+    inv *= 2 - n[0] * inv;
+  }
+  MOZ_ASSERT(Limb(n[0] * inv) == 1);
+
+  UniquePtr<MontgomeryContext> ctx(
+    new MontgomeryContext(std::move(n), modulus.Length(), Limb(0) - inv));
+
+  // R mod N and R^2 mod N, by doubling one 32 * Limbs() times, then as
+  // many times again.
+  Number r;
+  r.AppendElements(limbs);
+  for (size_t i = 0; i < limbs; i++) {
+    r[i] = 0;
+  }
+  r[0] = 1;
+  for (size_t i = 0; i < 2 * 32 * limbs; i++) {
+    Limb carry = 0;
+    for (size_t j = 0; j < limbs; j++) {
+      const Limb top = r[j] >> 31;
+      r[j] = (r[j] << 1) | carry;
+      carry = top;
+    }
+    ctx->SubtractModulusIf(carry, r);
+    if (i + 1 == 32 * limbs) {
+      ctx->mOne = r.Clone();
+    }
+  }
+  ctx->mRR = std::move(r);
+  return ctx;
+}
+
+MontgomeryContext::MontgomeryContext(Number&& aModulus, size_t aBytes,
+                                     Limb aN0Inv)
+    : mModulus(std::move(aModulus)), mBytes(aBytes), mN0Inv(aN0Inv) {}
+
+void MontgomeryContext::SubtractModulusIf(Limb aCarry, Number& aValue) const {
+  const size_t n = Limbs();
+  AutoTArray<Limb, kInlineLimbs> diff;
+  diff.AppendElements(n);
+  uint64_t borrow = 0;
+  for (size_t i = 0; i < n; i++) {
+    const uint64_t d = uint64_t(aValue[i]) - mModulus[i] - borrow;
+    diff[i] = Limb(d);
+    borrow = (d >> 32) & 1;
+  }
+  // Keep the difference if it did not underflow, or if the value had
+  // a carry out of its top limb (in which case it underflowed
+  // exactly once).
+  const Limb keep = Limb(0) - (aCarry | Limb(borrow ^ 1));
+  for (size_t i = 0; i < n; i++) {
+    aValue[i] = (diff[i] & keep) | (aValue[i] & ~keep);
+  }
+}
+
+bool MontgomeryContext::ToMontgomery(Span<const uint8_t> aValue,
+                                     Number& aRetVal) const {
+  if (aValue.Length() > Limbs() * sizeof(Limb)) {
+    return false;
+  }
+  Number value;
+  ParseBigEndian(aValue, Limbs(), value);
+  // value < R and mRR < N, so the product is reduced below N.
+  Mul(value, mRR, aRetVal);
+  return true;
+}
+
+void MontgomeryContext::FromMontgomery(const Number& aValue,
+                                       nsTArray<uint8_t>& aRetVal) const {
+  Number one;
+  one.AppendElements(Limbs());
+  for (size_t i = 0; i < Limbs(); i++) {
+    one[i] = 0;
+  }
+  one[0] = 1;
+  Number value;
+  Mul(aValue, one, value);
+  aRetVal.ClearAndRetainStorage();
+  aRetVal.AppendElements(mBytes);
+  for (size_t i = 0; i < mBytes; i++) {
+    aRetVal[mBytes - 1 - i] =
+      uint8_t(value[i / sizeof(Limb)] >> (8 * (i % sizeof(Limb))));
+  }
+}
+
+void MontgomeryContext::Mul(const Number& aA, const Number& aB,
+                            Number& aRetVal) const {
+  // Coarsely Integrated Operand Scanning (Koc, Acar & Kaliski).
+  const size_t n = Limbs();
+  MOZ_ASSERT(aA.Length() == n && aB.Length() == n);
+  AutoTArray<Limb, kInlineLimbs> t;
+  t.AppendElements(n + 2);
+  for (size_t i = 0; i < n + 2; i++) {
+    t[i] = 0;
+  }
+  for (size_t i = 0; i < n; i++) {
+    const uint64_t b = aB[i];
+    uint64_t carry = 0;
+    for (size_t j = 0; j < n; j++) {
+      const uint64_t s = uint64_t(t[j]) + aA[j] * b + carry;
+      t[j] = Limb(s);
+      carry = s >> 32;
+    }
+    uint64_t s = uint64_t(t[n]) + carry;
+    t[n] = Limb(s);
+    t[n + 1] = Limb(s >> 32);
+
+    const uint64_t m = Limb(t[0] * mN0Inv);
+    s = uint64_t(t[0]) + m * mModulus[0];
+    carry = s >> 32;
+    for (size_t j = 1; j < n; j++) {
+      s = uint64_t(t[j]) + m * mModulus[j] + carry;
+      t[j - 1] = Limb(s);
+      carry = s >> 32;
+    }
+    s = uint64_t(t[n]) + carry;
+    t[n - 1] = Limb(s);
+    t[n] = t[n + 1] + Limb(s >> 32);
+  }
+  aRetVal.ClearAndRetainStorage();
+  aRetVal.AppendElements(Span(t).To(n));
+  SubtractModulusIf(t[n], aRetVal);
+}
+
+void MontgomeryContext::Add(const Number& aA, const Number& aB,
+                            Number& aRetVal) const {
+  const size_t n = Limbs();
+  MOZ_ASSERT(aA.Length() == n && aB.Length() == n);
+  AutoTArray<Limb, kInlineLimbs> sum;
+  sum.AppendElements(n);
+  uint64_t carry = 0;
+  for (size_t i = 0; i < n; i++) {
+    const uint64_t s = uint64_t(aA[i]) + aB[i] + carry;
+    sum[i] = Limb(s);
+    carry = s >> 32;
+  }
+  aRetVal.ClearAndRetainStorage();
+  aRetVal.AppendElements(sum);
+  SubtractModulusIf(Limb(carry), aRetVal);
+}
+
+void MontgomeryContext::Sub(const Number& aA, const Number& aB,
+                            Number& aRetVal) const {
+  const size_t n = Limbs();
+  MOZ_ASSERT(aA.Length() == n && aB.Length() == n);
+  AutoTArray<Limb, kInlineLimbs> diff;
+  diff.AppendElements(n);
+  uint64_t borrow = 0;
+  for (size_t i = 0; i < n; i++) {
+    const uint64_t d = uint64_t(aA[i]) - aB[i] - borrow;
+    diff[i] = Limb(d);
+    borrow = (d >> 32) & 1;
+  }
+  // Add N back if it underflowed.
+  const Limb mask = Limb(0) - Limb(borrow);
+  uint64_t carry = 0;
+  for (size_t i = 0; i < n; i++) {
+    const uint64_t s = uint64_t(diff[i]) + (mModulus[i] & mask) + carry;
+    diff[i] = Limb(s);
+    carry = s >> 32;
+  }
+  aRetVal.ClearAndRetainStorage();
+  aRetVal.AppendElements(diff);
+}
+
+void MontgomeryContext::Pow(const Number& aBase,
+                            Span<const uint8_t> aExponent,
+                            Number& aRetVal) const {
+  const size_t n = Limbs();
+  // Fixed 4-bit window; table[i] = aBase ^ i.
+  nsTArray<Number> table(kWindowSize);
+  table.AppendElement(mOne.Clone());
+  table.AppendElement(aBase.Clone());
+  for (uint32_t i = 2; i < kWindowSize; i++) {
+    Number next;
+    Mul(table[i - 1], aBase, next);
+    table.AppendElement(std::move(next));
+  }
+
+  Number result = mOne.Clone();
+  Number selected;
+  selected.AppendElements(n);
+  for (size_t i = 0; i < aExponent.Length() * 2; i++) {
+    for (uint32_t j = 0; j < kWindowBits; j++) {
+      Mul(result, result, result);
+    }
+    const uint8_t byte = aExponent[i / 2];
+    const Limb window = (i % 2 == 0) ? (byte >> 4) : (byte & 0xf);
+    // Read every entry so that the memory access pattern does not
+    // reveal the window.
+    for (size_t k = 0; k < n; k++) {
+      selected[k] = 0;
+    }
+    for (uint32_t w = 0; w < kWindowSize; w++) {
+      const Limb mask = MaskIfEqual(w, window);
+      for (size_t k = 0; k < n; k++) {
+        selected[k] |= table[w][k] & mask;
+      }
+    }
+    Mul(result, selected, result);
+  }
+  aRetVal = std::move(result);
+
+  for (Number& entry : table) {
+    for (size_t k = 0; k < n; k++) {
+      entry[k] = 0;
+    }
+  }
+  for (size_t k = 0; k < n; k++) {
+    selected[k] = 0;
+  }
+}
+
+bool MontgomeryContext::IsZero(const Number& aValue) const {
+  MOZ_ASSERT(aValue.Length() == Limbs());
+  Limb acc = 0;
+  for (const Limb limb : aValue) {
+    acc |= limb;
+  }
+  return acc == 0;
+}
+
+} // namespace mozilla::berytus
@@ -0,0 +1,87 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BERYTUS_MONTGOMERY_H_
+#define BERYTUS_MONTGOMERY_H_
+
+#include "mozilla/Span.h"
+#include "mozilla/UniquePtr.h"
+#include "nsTArray.h"
+
+namespace mozilla::berytus {
+
+/**
+ * Arithmetic modulo a fixed odd modulus N, with the operands kept in
+ * Montgomery form (x * R mod N, R = 2^(32 * Limbs())).
+ *
+ * The operations are constant-time: the sequence of instructions and
+ * memory accesses depends on the size of N (and, for Pow, on the size
+ * of the exponent), but never on the values of the operands. Only N
+ * is treated as public.
+ */
+class MontgomeryContext final {
+public:
+  using Limb = uint32_t;
+  // Little-endian limbs; Length() == Limbs().
+  using Number = nsTArray<Limb>;
+
+  /**
+   * aModulus is big-endian. Returns nullptr unless it is odd and
+   * greater than 1.
+   */
+  static UniquePtr<MontgomeryContext> Create(Span<const uint8_t> aModulus);
+
+  size_t Limbs() const { return mModulus.Length(); }
+  // The byte length of N; numbers are serialised to this length.
+  size_t Bytes() const { return mBytes; }
+
+  /**
+   * Sets aRetVal to aValue (big-endian) mod N, in Montgomery form.
+   * aValue may be greater than N, but no longer than 4 * Limbs()
+   * bytes. Returns false if it is too long.
+   */
+  bool ToMontgomery(Span<const uint8_t> aValue, Number& aRetVal) const;
+  /**
+   * Sets aRetVal to aValue (in Montgomery form) as a big-endian
+   * number of Bytes() bytes.
+   */
+  void FromMontgomery(const Number& aValue, nsTArray<uint8_t>& aRetVal) const;
+
+  void Mul(const Number& aA, const Number& aB, Number& aRetVal) const;
+  void Add(const Number& aA, const Number& aB, Number& aRetVal) const;
+  void Sub(const Number& aA, const Number& aB, Number& aRetVal) const;
+  /**
+   * Sets aRetVal to aBase ^ aExponent. aExponent is big-endian; all of
+   * its bits are processed, so leading zeros are not skipped.
+   */
+  void Pow(const Number& aBase,
+           Span<const uint8_t> aExponent,
+           Number& aRetVal) const;
+
+  bool IsZero(const Number& aValue) const;
+
+private:
+  MontgomeryContext(Number&& aModulus, size_t aBytes, Limb aN0Inv);
+
+  /**
+   * Subtracts N from aValue if aCarry is set or aValue >= N; aCarry
+   * is the bit above the top limb of aValue.
+   */
+  void SubtractModulusIf(Limb aCarry, Number& aValue) const;
+
+  const Number mModulus;
+  const size_t mBytes;
+  // -N^-1 mod 2^32
+  const Limb mN0Inv;
+  // R^2 mod N, in normal form, to convert into Montgomery form.
+  Number mRR;
+  // R mod N, i.e. one in Montgomery form.
+  Number mOne;
+};
+
+} // namespace mozilla::berytus
+
+#endif // BERYTUS_MONTGOMERY_H_
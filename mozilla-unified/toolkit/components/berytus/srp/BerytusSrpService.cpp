@@ -0,0 +1,413 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/berytus/BerytusSrpService.h"
+#include <algorithm>
+#include "ScopedNSSTypes.h"
+#include "mozilla/Assertions.h"
+#include "mozilla/Logging.h"
+#include "nsThreadUtils.h"
+#include "pk11pub.h"
+#include "sechash.h"
+#include "secport.h"
+
+namespace mozilla::berytus {
+
+static mozilla::LazyLogModule sLogger("berytus_srp");
+
+namespace {
+
+// The size of the generated private keys, as jsrp.
+constexpr size_t kPrivateKeyLength = 32;
+
+template <typename T>
+void Zeroize(nsTArray<T>& aBuffer) {
+  if (aBuffer.Length() > 0) {
+    memset(aBuffer.Elements(), 0, aBuffer.Length() * sizeof(T));
+  }
+  aBuffer.Clear();
+}
+
+bool HexToBytes(const char* aHex, nsTArray<uint8_t>& aRetVal) {
+  const size_t len = strlen(aHex);
+  if (len % 2 != 0) {
+    return false;
+  }
+  for (size_t i = 0; i < len; i += 2) {
+    char byte[3] = {aHex[i], aHex[i + 1], 0};
+    char* end = nullptr;
+    const unsigned long value = strtoul(byte, &end, 16);
+    if (end != byte + 2) {
+      return false;
+    }
+    aRetVal.AppendElement(uint8_t(value));
+  }
+  return true;
+}
+
+// Left-pads aValue with zeros to aLength bytes.
+void Pad(Span<const uint8_t> aValue, size_t aLength,
+         nsTArray<uint8_t>& aRetVal) {
+  MOZ_ASSERT(aValue.Length() <= aLength);
+  aRetVal.ClearAndRetainStorage();
+  aRetVal.AppendElements(aLength - aValue.Length());
+  memset(aRetVal.Elements(), 0, aRetVal.Length());
+  aRetVal.AppendElements(aValue);
+}
+
+/**
+ * Sets aRetVal to aA + aB * aC, big-endian, as a number of
+ * max(|aA|, |aB| + |aC|) + 1 bytes. The loops only depend on the
+ * lengths of the operands.
+ */
+void MulAdd(Span<const uint8_t> aA, Span<const uint8_t> aB,
+            Span<const uint8_t> aC, nsTArray<uint8_t>& aRetVal) {
+  const size_t len = std::max(aA.Length(), aB.Length() + aC.Length()) + 1;
+  // Little-endian columns; each sums at most min(|aB|, |aC|) products
+  // of two bytes, which fits in 32 bits for any hash length.
+  nsTArray<uint32_t> acc;
+  acc.AppendElements(len);
+  memset(acc.Elements(), 0, len * sizeof(uint32_t));
+  for (size_t i = 0; i < aB.Length(); i++) {
+    for (size_t j = 0; j < aC.Length(); j++) {
+      acc[i + j] += uint32_t(aB[aB.Length() - 1 - i]) *
+                    uint32_t(aC[aC.Length() - 1 - j]);
+    }
+  }
+  for (size_t i = 0; i < aA.Length(); i++) {
+    acc[i] += aA[aA.Length() - 1 - i];
+  }
+  aRetVal.ClearAndRetainStorage();
+  aRetVal.AppendElements(len);
+  uint32_t carry = 0;
+  for (size_t i = 0; i < len; i++) {
+    const uint64_t sum = uint64_t(acc[i]) + carry;
+    aRetVal[len - 1 - i] = uint8_t(sum);
+    carry = uint32_t(sum >> 8);
+  }
+  MOZ_ASSERT(carry == 0);
+  Zeroize(acc);
+}
+
+} // namespace
+
+/* SrpGroupContext */
+
+already_AddRefed<SrpGroupContext> SrpGroupContext::Create(
+    const SrpGroup& aGroup) {
+  nsTArray<uint8_t> modulus;
+  if (NS_WARN_IF(!HexToBytes(aGroup.mModulus, modulus))) {
+    return nullptr;
+  }
+  UniquePtr<MontgomeryContext> montgomery =
+    MontgomeryContext::Create(modulus);
+  if (NS_WARN_IF(!montgomery)) {
+    return nullptr;
+  }
+  RefPtr<SrpGroupContext> group =
+    new SrpGroupContext(aGroup, std::move(montgomery));
+  const MontgomeryContext& mont = group->Montgomery();
+
+  nsTArray<uint8_t> generator;
+  const uint8_t g = aGroup.mGenerator;
+  Pad(Span(&g, 1), mont.Bytes(), generator);
+  if (NS_WARN_IF(!mont.ToMontgomery(generator, group->mGenerator))) {
+    return nullptr;
+  }
+  nsTArray<uint8_t> multiplier;
+  if (NS_WARN_IF(NS_FAILED(group->Hash({modulus, generator}, multiplier)))) {
+    return nullptr;
+  }
+  if (NS_WARN_IF(!mont.ToMontgomery(multiplier, group->mMultiplier))) {
+    return nullptr;
+  }
+  return group.forget();
+}
+
+SrpGroupContext::SrpGroupContext(const SrpGroup& aGroup,
+                                 UniquePtr<MontgomeryContext>&& aMontgomery)
+    : mGroup(aGroup), mMontgomery(std::move(aMontgomery)) {}
+
+nsresult SrpGroupContext::Hash(
+    std::initializer_list<Span<const uint8_t>> aParts,
+    nsTArray<uint8_t>& aRetVal) const {
+  const HASH_HashType type =
+    mGroup.mHash == SrpHash::SHA1 ? HASH_AlgSHA1 : HASH_AlgSHA256;
+  UniqueHASHContext ctx(HASH_Create(type));
+  if (NS_WARN_IF(!ctx)) {
+    return NS_ERROR_OUT_OF_MEMORY;
+  }
+  HASH_Begin(ctx.get());
+  for (const Span<const uint8_t>& part : aParts) {
+    HASH_Update(ctx.get(), part.Elements(), part.Length());
+  }
+  aRetVal.ClearAndRetainStorage();
+  aRetVal.AppendElements(HASH_ResultLenContext(ctx.get()));
+  uint32_t len = 0;
+  HASH_End(ctx.get(), aRetVal.Elements(), &len, aRetVal.Length());
+  MOZ_ASSERT(len == aRetVal.Length());
+  return NS_OK;
+}
+
+nsresult SrpGroupContext::PrivateKey(Span<const uint8_t> aSalt,
+                                     Span<const uint8_t> aIdentityHash,
+                                     nsTArray<uint8_t>& aRetVal) const {
+  return Hash({aSalt, aIdentityHash}, aRetVal);
+}
+
+/* SrpClient */
+
+NS_IMPL_ISUPPORTS(SrpClient, mozIBerytusSrpClient)
+
+nsresult SrpClient::Create(SrpGroupContext* aGroup,
+                           const nsACString& aIdentity,
+                           const nsACString& aPassword,
+                           Span<const uint8_t> aPrivateKey,
+                           SrpClient** aRetVal) {
+  const MontgomeryContext& mont = aGroup->Montgomery();
+  RefPtr<SrpClient> client = new SrpClient(aGroup);
+  nsresult rv = aGroup->Hash(
+    {AsBytes(Span(aIdentity)), AsBytes(Span(":", 1)), AsBytes(Span(aPassword))},
+    client->mIdentityHash);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  if (aPrivateKey.IsEmpty()) {
+    client->mPrivateKey.AppendElements(kPrivateKeyLength);
+    rv = MapSECStatus(PK11_GenerateRandom(client->mPrivateKey.Elements(),
+                                          kPrivateKeyLength));
+    NS_ENSURE_SUCCESS(rv, rv);
+  } else {
+    if (aPrivateKey.Length() > mont.Bytes()) {
+      return NS_ERROR_INVALID_ARG;
+    }
+    client->mPrivateKey.AppendElements(aPrivateKey);
+  }
+
+  MontgomeryContext::Number publicKey;
+  mont.Pow(aGroup->Generator(), client->mPrivateKey, publicKey);
+  mont.FromMontgomery(publicKey, client->mPublicKey);
+  client.forget(aRetVal);
+  return NS_OK;
+}
+
+SrpClient::SrpClient(SrpGroupContext* aGroup) : mGroup(aGroup) {}
+
+SrpClient::~SrpClient() {
+  Zeroize(mIdentityHash);
+  Zeroize(mPrivateKey);
+  Zeroize(mSharedKey);
+}
+
+NS_IMETHODIMP
+SrpClient::GetGroupBits(uint32_t* aRetVal) {
+  *aRetVal = mGroup->Group().mBits;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+SrpClient::GetPublicKey(nsTArray<uint8_t>& aRetVal) {
+  aRetVal = mPublicKey.Clone();
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+SrpClient::SetServerPublicKey(const nsTArray<uint8_t>& aServerPublicKey) {
+  const MontgomeryContext& mont = mGroup->Montgomery();
+  if (aServerPublicKey.Length() > mont.Bytes()) {
+    return NS_ERROR_INVALID_ARG;
+  }
+  MontgomeryContext::Number serverPublicKey;
+  MOZ_ALWAYS_TRUE(mont.ToMontgomery(aServerPublicKey, serverPublicKey));
+  // The client must abort if B mod N is zero (RFC 5054, section 2.5.4).
+  if (mont.IsZero(serverPublicKey)) {
+    MOZ_LOG(sLogger, LogLevel::Warning, ("Rejected B = 0 mod N"));
+    return NS_ERROR_INVALID_ARG;
+  }
+  mServerPublicKey = std::move(serverPublicKey);
+  Pad(aServerPublicKey, mont.Bytes(), mServerPublicKeyBytes);
+  Zeroize(mSharedKey);
+  mClientProof.Clear();
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+SrpClient::ComputeClientProof(const nsTArray<uint8_t>& aSalt,
+                              nsTArray<uint8_t>& aRetVal) {
+  if (mServerPublicKey.IsEmpty()) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+  // u = H(PAD(A) | PAD(B))
+  nsTArray<uint8_t> u;
+  nsresult rv = mGroup->Hash({mPublicKey, mServerPublicKeyBytes}, u);
+  NS_ENSURE_SUCCESS(rv, rv);
+  return ComputeClientProofWithScramblingParameter(aSalt, u, aRetVal);
+}
+
+nsresult SrpClient::ComputeClientProofWithScramblingParameter(
+    Span<const uint8_t> aSalt,
+    Span<const uint8_t> aScramblingParameter,
+    nsTArray<uint8_t>& aRetVal) {
+  if (mServerPublicKey.IsEmpty()) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+  // The client must abort if u is zero; the premaster secret would
+  // not depend on the password verifier.
+  if (std::all_of(aScramblingParameter.begin(), aScramblingParameter.end(),
+                  [](uint8_t aByte) { return aByte == 0; })) {
+    MOZ_LOG(sLogger, LogLevel::Warning, ("Rejected u = 0"));
+    return NS_ERROR_INVALID_ARG;
+  }
+  const MontgomeryContext& mont = mGroup->Montgomery();
+
+  // x = H(salt | H(I ":" P))
+  nsTArray<uint8_t> x;
+  nsresult rv = mGroup->PrivateKey(aSalt, mIdentityHash, x);
+  NS_ENSURE_SUCCESS(rv, rv);
+
+  // S = (B - k * g^x) ^ (a + u * x)
+  MontgomeryContext::Number base;
+  mont.Pow(mGroup->Generator(), x, base);
+  mont.Mul(mGroup->Multiplier(), base, base);
+  mont.Sub(mServerPublicKey, base, base);
+  nsTArray<uint8_t> exponent;
+  MulAdd(mPrivateKey, aScramblingParameter, x, exponent);
+  MontgomeryContext::Number secret;
+  mont.Pow(base, exponent, secret);
+  nsTArray<uint8_t> secretBytes;
+  mont.FromMontgomery(secret, secretBytes);
+
+  // K = H(S), M1 = H(A | B | K)
+  nsTArray<uint8_t> sharedKey;
+  rv = mGroup->Hash({secretBytes}, sharedKey);
+  Zeroize(x);
+  Zeroize(exponent);
+  Zeroize(base);
+  Zeroize(secret);
+  Zeroize(secretBytes);
+  NS_ENSURE_SUCCESS(rv, rv);
+  nsTArray<uint8_t> clientProof;
+  rv = mGroup->Hash({mPublicKey, mServerPublicKeyBytes, sharedKey},
+                    clientProof);
+  if (NS_WARN_IF(NS_FAILED(rv))) {
+    Zeroize(sharedKey);
+    return rv;
+  }
+  Zeroize(mSharedKey);
+  mSharedKey = std::move(sharedKey);
+  mClientProof = std::move(clientProof);
+  aRetVal = mClientProof.Clone();
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+SrpClient::VerifyServerProof(const nsTArray<uint8_t>& aServerProof,
+                             bool* aRetVal) {
+  if (mClientProof.IsEmpty()) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+  // M2 = H(A | M1 | K)
+  nsTArray<uint8_t> expected;
+  nsresult rv = mGroup->Hash({mPublicKey, mClientProof, mSharedKey}, expected);
+  NS_ENSURE_SUCCESS(rv, rv);
+  *aRetVal = aServerProof.Length() == expected.Length() &&
+             NSS_SecureMemcmp(aServerProof.Elements(), expected.Elements(),
+                              expected.Length()) == 0;
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+SrpClient::GetSharedKey(nsTArray<uint8_t>& aRetVal) {
+  if (mSharedKey.IsEmpty()) {
+    return NS_ERROR_NOT_AVAILABLE;
+  }
+  aRetVal = mSharedKey.Clone();
+  return NS_OK;
+}
+
+/* SrpService */
+
+NS_IMPL_ISUPPORTS(SrpService, mozIBerytusSrpService)
+
+SrpService::SrpService() {
+  mGroups.SetLength(std::size(kSrpGroups));
+}
+
+SrpGroupContext* SrpService::GetGroup(uint32_t aBits) {
+  MOZ_ASSERT(NS_IsMainThread());
+  const SrpGroup* group = FindSrpGroup(aBits);
+  if (!group) {
+    return nullptr;
+  }
+  RefPtr<SrpGroupContext>& entry = mGroups[group - kSrpGroups];
+  if (!entry) {
+    entry = SrpGroupContext::Create(*group);
+  }
+  return entry;
+}
+
+NS_IMETHODIMP
+SrpService::CreateClient(uint32_t aGroupBits,
+                         const nsACString& aIdentity,
+                         const nsACString& aPassword,
+                         mozIBerytusSrpClient** aRetVal) {
+  SrpGroupContext* group = GetGroup(aGroupBits);
+  if (!group) {
+    return NS_ERROR_INVALID_ARG;
+  }
+  RefPtr<SrpClient> client;
+  nsresult rv = SrpClient::Create(group, aIdentity, aPassword, {},
+                                  getter_AddRefs(client));
+  NS_ENSURE_SUCCESS(rv, rv);
+  client.forget(aRetVal);
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+SrpService::CreateClientWithPrivateKey(uint32_t aGroupBits,
+                                       const nsACString& aIdentity,
+                                       const nsACString& aPassword,
+                                       const nsTArray<uint8_t>& aPrivateKey,
+                                       mozIBerytusSrpClient** aRetVal) {
+  SrpGroupContext* group = GetGroup(aGroupBits);
+  if (!group || aPrivateKey.IsEmpty()) {
+    return NS_ERROR_INVALID_ARG;
+  }
+  RefPtr<SrpClient> client;
+  nsresult rv = SrpClient::Create(group, aIdentity, aPassword, aPrivateKey,
+                                  getter_AddRefs(client));
+  NS_ENSURE_SUCCESS(rv, rv);
+  client.forget(aRetVal);
+  return NS_OK;
+}
+
+NS_IMETHODIMP
+SrpService::ComputeVerifier(uint32_t aGroupBits,
+                            const nsACString& aIdentity,
+                            const nsACString& aPassword,
+                            const nsTArray<uint8_t>& aSalt,
+                            nsTArray<uint8_t>& aRetVal) {
+  SrpGroupContext* group = GetGroup(aGroupBits);
+  if (!group) {
+    return NS_ERROR_INVALID_ARG;
+  }
+  nsTArray<uint8_t> identityHash;
+  nsresult rv = group->Hash(
+    {AsBytes(Span(aIdentity)), AsBytes(Span(":", 1)), AsBytes(Span(aPassword))},
+    identityHash);
+  NS_ENSURE_SUCCESS(rv, rv);
+  nsTArray<uint8_t> x;
+  rv = group->PrivateKey(aSalt, identityHash, x);
+  Zeroize(identityHash);
+  NS_ENSURE_SUCCESS(rv, rv);
+  const MontgomeryContext& mont = group->Montgomery();
+  MontgomeryContext::Number verifier;
+  mont.Pow(group->Generator(), x, verifier);
+  Zeroize(x);
+  mont.FromMontgomery(verifier, aRetVal);
+  return NS_OK;
+}
+
+} // namespace mozilla::berytus
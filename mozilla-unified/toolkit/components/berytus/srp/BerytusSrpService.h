@@ -0,0 +1,123 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim:set ts=2 sw=2 sts=2 et cindent: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BERYTUS_SRPSERVICE_H_
+#define BERYTUS_SRPSERVICE_H_
+
+#include <initializer_list>
+#include "mozIBerytusSrpService.h"
+#include "mozilla/RefPtr.h"
+#include "mozilla/UniquePtr.h"
+#include "mozilla/berytus/BerytusMontgomery.h"
+#include "mozilla/berytus/BerytusSrpGroups.h"
+#include "nsTArray.h"
+
+namespace mozilla::berytus {
+
+/**
+ * The per-group values shared by the clients of a group: the
+ * Montgomery context of N, and g and k = H(PAD(N) | PAD(g)) in
+ * Montgomery form.
+ */
+class SrpGroupContext final {
+public:
+  NS_INLINE_DECL_REFCOUNTING(SrpGroupContext)
+
+  static already_AddRefed<SrpGroupContext> Create(const SrpGroup& aGroup);
+
+  const SrpGroup& Group() const { return mGroup; }
+  const MontgomeryContext& Montgomery() const { return *mMontgomery; }
+  const MontgomeryContext::Number& Generator() const { return mGenerator; }
+  const MontgomeryContext::Number& Multiplier() const { return mMultiplier; }
+
+  /**
+   * Sets aRetVal to H(aParts[0] | aParts[1] | ...), using the hash of
+   * the group.
+   */
+  nsresult Hash(std::initializer_list<Span<const uint8_t>> aParts,
+                nsTArray<uint8_t>& aRetVal) const;
+  /**
+   * x = H(aSalt | aIdentityHash), where aIdentityHash is
+   * H(identity ":" password).
+   */
+  nsresult PrivateKey(Span<const uint8_t> aSalt,
+                      Span<const uint8_t> aIdentityHash,
+                      nsTArray<uint8_t>& aRetVal) const;
+
+private:
+  SrpGroupContext(const SrpGroup& aGroup,
+                  UniquePtr<MontgomeryContext>&& aMontgomery);
+  ~SrpGroupContext() = default;
+
+  const SrpGroup& mGroup;
+  const UniquePtr<MontgomeryContext> mMontgomery;
+  MontgomeryContext::Number mGenerator;
+  MontgomeryContext::Number mMultiplier;
+};
+
+class SrpClient final : public mozIBerytusSrpClient {
+public:
+  NS_DECL_ISUPPORTS
+  NS_DECL_MOZIBERYTUSSRPCLIENT
+
+  /**
+   * aPrivateKey is the private key a; a random 256-bit key is
+   * generated if it is empty.
+   */
+  static nsresult Create(SrpGroupContext* aGroup,
+                         const nsACString& aIdentity,
+                         const nsACString& aPassword,
+                         Span<const uint8_t> aPrivateKey,
+                         SrpClient** aRetVal);
+
+  /**
+   * ComputeClientProof, given the scrambling parameter
+   * u = H(PAD(A) | PAD(B)). Fails with NS_ERROR_INVALID_ARG if u is
+   * zero. Exposed for testing, as no known A and B hash to zero.
+   */
+  nsresult ComputeClientProofWithScramblingParameter(
+      Span<const uint8_t> aSalt,
+      Span<const uint8_t> aScramblingParameter,
+      nsTArray<uint8_t>& aRetVal);
+
+private:
+  explicit SrpClient(SrpGroupContext* aGroup);
+  ~SrpClient();
+
+  const RefPtr<SrpGroupContext> mGroup;
+  // H(identity ":" password); the password itself is not kept.
+  nsTArray<uint8_t> mIdentityHash;
+  nsTArray<uint8_t> mPrivateKey;
+  nsTArray<uint8_t> mPublicKey;
+  MontgomeryContext::Number mServerPublicKey;
+  nsTArray<uint8_t> mServerPublicKeyBytes;
+  nsTArray<uint8_t> mSharedKey;
+  nsTArray<uint8_t> mClientProof;
+};
+
+class SrpService final : public mozIBerytusSrpService {
+public:
+  NS_DECL_ISUPPORTS
+  NS_DECL_MOZIBERYTUSSRPSERVICE
+
+  SrpService();
+
+private:
+  ~SrpService() = default;
+
+  /**
+   * Returns the context of the aBits group, creating it on first
+   * use; nullptr if there is no such group.
+   */
+  SrpGroupContext* GetGroup(uint32_t aBits);
+
+  // Indexed as kSrpGroups.
+  nsTArray<RefPtr<SrpGroupContext>> mGroups;
+};
+
+} // namespace mozilla::berytus
+
+#endif // BERYTUS_SRPSERVICE_H_
@@ -0,0 +1,194 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gtest/gtest.h"
+#include "mozilla/berytus/BerytusMontgomery.h"
+#include "mozilla/berytus/BerytusSrpService.h"
+#include "nsCOMPtr.h"
+#include "nsError.h"
+#include "nss.h"
+
+using namespace mozilla;
+using namespace mozilla::berytus;
+
+static nsTArray<uint8_t> FromHex(const char* aHex) {
+  nsTArray<uint8_t> buf;
+  size_t len = strlen(aHex);
+  for (size_t i = 0; i + 1 < len; i += 2) {
+    char byte[3] = {aHex[i], aHex[i + 1], 0};
+    buf.AppendElement(static_cast<uint8_t>(strtoul(byte, nullptr, 16)));
+  }
+  return buf;
+}
+
+// RFC 5054, Appendix B.
+static const char* kRfc5054PrivateKeyA =
+  "60975527035CF2AD1989806F0407210BC81EDC04E2762A56AFD529DDDA2D4393";
+static const char* kRfc5054PublicKeyA =
+  "61D5E490F6F1B79547B0704C436F523DD0E560F0C64115BB72557EC44352E890"
+  "3211C04692272D8B2D1A5358A2CF1B6E0BFCF99F921530EC8E39356179EAE45E"
+  "42BA92AEACED825171E1E8B9AF6D9C03E1327F44BE087EF06530E69F66615261"
+  "EEF54073CA11CF5858F0EDFDFE15EFEAB349EF5D76988A3672FAC47B0769447B";
+static const char* kRfc5054PublicKeyB =
+  "BD0C61512C692C0CB6D041FA01BB152D4916A1E77AF46AE105393011BAF38964"
+  "DC46A0670DD125B95A981652236F99D9B681CBF87837EC996C6DA04453728610"
+  "D0C6DDB58B318885D7D82C7F8DEB75CE7BD4FBAA37089E6F9C6059F388838E7A"
+  "00030B331EB76840910440B1B27AAEAEEB4012B7D7665238A8E3FB004B117B58";
+static const char* kRfc5054Verifier =
+  "7E273DE8696FFC4F4E337D05B4B375BEB0DDE1569E8FA00A9886D8129BADA1F1"
+  "822223CA1A605B530E379BA4729FDC59F105B4787E5186F5C671085A1447B52A"
+  "48CF1970B4FB6F8400BBF4CEBFBB168152E08AB5EA53D15C1AFF87B2B9DA6E04"
+  "E058AD51CC72BFC9033B564E26480D78E955A5E29E7AB245DB2BE315E2099AFB";
+static const char* kRfc5054Salt = "BEB25379D1A8581EB5A727673A2441EE";
+// H(S), H(A | B | K) and H(A | M1 | K), from the premaster secret S
+// of the RFC.
+static const char* kRfc5054SharedKey =
+  "017EEFA1CEFC5C2E626E21598987F31E0F1B11BB";
+static const char* kRfc5054ClientProof =
+  "7C1605558A4E7A5AE79A7F254CB6D04F72608044";
+static const char* kRfc5054ServerProof =
+  "BDAD4993FFA5D60FD0DA4929C5EDB8D9E887E69C";
+
+TEST(BerytusMontgomery, TestCreateRejectsEvenModulus)
+{
+  ASSERT_FALSE(MontgomeryContext::Create(FromHex("F0")));
+  ASSERT_FALSE(MontgomeryContext::Create(FromHex("0001")));
+  ASSERT_TRUE(MontgomeryContext::Create(FromHex("0003")));
+}
+
+TEST(BerytusMontgomery, TestPow)
+{
+  UniquePtr<MontgomeryContext> ctx =
+    MontgomeryContext::Create(FromHex("0F123456789ABCDEF1"));
+  ASSERT_TRUE(ctx);
+  ASSERT_EQ(ctx->Bytes(), 9u);
+  MontgomeryContext::Number base;
+  ASSERT_TRUE(ctx->ToMontgomery(FromHex("03"), base));
+  MontgomeryContext::Number result;
+  ctx->Pow(base, FromHex("010001"), result);
+  nsTArray<uint8_t> out;
+  ctx->FromMontgomery(result, out);
+  ASSERT_EQ(out, FromHex("0E2AF3DF8E6FA2F9D4"));
+}
+
+TEST(BerytusMontgomery, TestAddSubWrap)
+{
+  UniquePtr<MontgomeryContext> ctx = MontgomeryContext::Create(FromHex("65"));
+  ASSERT_TRUE(ctx);
+  MontgomeryContext::Number a, b, result;
+  ASSERT_TRUE(ctx->ToMontgomery(FromHex("60"), a));
+  ASSERT_TRUE(ctx->ToMontgomery(FromHex("10"), b));
+  nsTArray<uint8_t> out;
+  ctx->Add(a, b, result);
+  ctx->FromMontgomery(result, out);
+  ASSERT_EQ(out, FromHex("0B"));
+  ctx->Sub(b, a, result);
+  ctx->FromMontgomery(result, out);
+  ASSERT_EQ(out, FromHex("15"));
+  ctx->Sub(a, a, result);
+  ASSERT_TRUE(ctx->IsZero(result));
+}
+
+TEST(BerytusSrpService, TestRfc5054Client)
+{
+  ASSERT_TRUE(NSS_NoDB_Init(nullptr) == SECSuccess);
+  RefPtr<SrpService> service = new SrpService();
+  nsCOMPtr<mozIBerytusSrpClient> client;
+  nsresult rv = service->CreateClientWithPrivateKey(
+    1024, "alice"_ns, "password123"_ns, FromHex(kRfc5054PrivateKeyA),
+    getter_AddRefs(client));
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+
+  nsTArray<uint8_t> publicKey;
+  ASSERT_TRUE(NS_SUCCEEDED(client->GetPublicKey(publicKey)));
+  ASSERT_EQ(publicKey, FromHex(kRfc5054PublicKeyA));
+
+  nsTArray<uint8_t> proof;
+  ASSERT_EQ(client->ComputeClientProof(FromHex(kRfc5054Salt), proof),
+            NS_ERROR_NOT_AVAILABLE);
+  ASSERT_TRUE(
+    NS_SUCCEEDED(client->SetServerPublicKey(FromHex(kRfc5054PublicKeyB))));
+  ASSERT_TRUE(
+    NS_SUCCEEDED(client->ComputeClientProof(FromHex(kRfc5054Salt), proof)));
+  ASSERT_EQ(proof, FromHex(kRfc5054ClientProof));
+
+  nsTArray<uint8_t> sharedKey;
+  ASSERT_TRUE(NS_SUCCEEDED(client->GetSharedKey(sharedKey)));
+  ASSERT_EQ(sharedKey, FromHex(kRfc5054SharedKey));
+
+  bool verified = false;
+  ASSERT_TRUE(NS_SUCCEEDED(
+    client->VerifyServerProof(FromHex(kRfc5054ServerProof), &verified)));
+  ASSERT_TRUE(verified);
+  ASSERT_TRUE(NS_SUCCEEDED(
+    client->VerifyServerProof(FromHex(kRfc5054ClientProof), &verified)));
+  ASSERT_FALSE(verified);
+}
+
+TEST(BerytusSrpService, TestRfc5054Verifier)
+{
+  ASSERT_TRUE(NSS_NoDB_Init(nullptr) == SECSuccess);
+  RefPtr<SrpService> service = new SrpService();
+  nsTArray<uint8_t> verifier;
+  nsresult rv = service->ComputeVerifier(1024, "alice"_ns, "password123"_ns,
+                                         FromHex(kRfc5054Salt), verifier);
+  ASSERT_TRUE(NS_SUCCEEDED(rv));
+  ASSERT_EQ(verifier, FromHex(kRfc5054Verifier));
+}
+
+TEST(BerytusSrpService, TestRejectsInvalidServerPublicKey)
+{
+  ASSERT_TRUE(NSS_NoDB_Init(nullptr) == SECSuccess);
+  RefPtr<SrpService> service = new SrpService();
+  nsCOMPtr<mozIBerytusSrpClient> client;
+  ASSERT_EQ(service->CreateClient(1000, "alice"_ns, "password123"_ns,
+                                  getter_AddRefs(client)),
+            NS_ERROR_INVALID_ARG);
+  ASSERT_TRUE(NS_SUCCEEDED(service->CreateClient(
+    1024, "alice"_ns, "password123"_ns, getter_AddRefs(client))));
+  nsTArray<uint8_t> publicKey;
+  ASSERT_TRUE(NS_SUCCEEDED(client->GetPublicKey(publicKey)));
+  ASSERT_EQ(publicKey.Length(), 128u);
+
+  // Zero, N and a value longer than N.
+  ASSERT_EQ(client->SetServerPublicKey(FromHex("00")), NS_ERROR_INVALID_ARG);
+  ASSERT_EQ(client->SetServerPublicKey(FromHex(
+              "EEAF0AB9ADB38DD69C33F80AFA8FC5E86072618775FF3C0B9EA2314C9C256576"
+              "D674DF7496EA81D3383B4813D692C6E0E0D5D8E250B98BE48E495C1D6089DAD1"
+              "5DC7D7B46154D6B6CE8EF4AD69B15D4982559B297BCF1885C529F566660E57EC"
+              "68EDBC3C05726CC02FD4CBF4976EAA9AFD5138FE8376435B9FC61D2FC0EB06E3")),
+            NS_ERROR_INVALID_ARG);
+  nsTArray<uint8_t> tooLong = FromHex(kRfc5054PublicKeyB);
+  tooLong.InsertElementAt(0, 1);
+  ASSERT_EQ(client->SetServerPublicKey(tooLong), NS_ERROR_INVALID_ARG);
+}
+
+TEST(BerytusSrpService, TestRejectsZeroScramblingParameter)
+{
+  ASSERT_TRUE(NSS_NoDB_Init(nullptr) == SECSuccess);
+  RefPtr<SrpService> service = new SrpService();
+  nsCOMPtr<mozIBerytusSrpClient> client;
+  ASSERT_TRUE(NS_SUCCEEDED(service->CreateClientWithPrivateKey(
+    1024, "alice"_ns, "password123"_ns, FromHex(kRfc5054PrivateKeyA),
+    getter_AddRefs(client))));
+  ASSERT_TRUE(
+    NS_SUCCEEDED(client->SetServerPublicKey(FromHex(kRfc5054PublicKeyB))));
+  SrpClient* srpClient = static_cast<SrpClient*>(client.get());
+
+  nsTArray<uint8_t> proof;
+  ASSERT_EQ(srpClient->ComputeClientProofWithScramblingParameter(
+              FromHex(kRfc5054Salt),
+              FromHex("0000000000000000000000000000000000000000"), proof),
+            NS_ERROR_INVALID_ARG);
+  ASSERT_TRUE(proof.IsEmpty());
+  nsTArray<uint8_t> sharedKey;
+  ASSERT_EQ(client->GetSharedKey(sharedKey), NS_ERROR_NOT_AVAILABLE);
+
+  // Any other u is accepted.
+  ASSERT_TRUE(NS_SUCCEEDED(srpClient->ComputeClientProofWithScramblingParameter(
+    FromHex(kRfc5054Salt),
+    FromHex("0000000000000000000000000000000000000001"), proof)));
+  ASSERT_EQ(proof.Length(), 20u);
+}
@@ -0,0 +1,126 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+"use strict";
+
+/**
+ * @type {import('../../src/Agent.sys.mjs')}
+ */
+const { Agent } = ChromeUtils.importESModule(
+    "resource://gre/modules/BerytusAgent.sys.mjs"
+);
+
+const sampleSigningKey =
+    "MCowBQYDK2VwAyEAJevlUdx72BF8mxdwurBJI9WNgRDMaoYfb0VqywaLOJE=";
+
+add_task(async function test_collect_credentials_metadata_cold_cache() {
+    // Need a profile to be setup; otherwise ValidatedRequestHandler
+    // would not be able to retrieve the Schema.
+    do_get_profile();
+
+    const calls = [];
+    const handlerProxy = createRequestHandlerProxy(
+        (group, method, cx, args) => {
+            calls.push(method);
+            // Settled asynchronously, so that a request sent before
+            // this one is settled would be refused.
+            do_timeout(0, () => {
+                cx.response.resolve(
+                    method === "getSigningKey" ? sampleSigningKey : 7
+                );
+            });
+        }
+    );
+    const { context, args } = sampleRequests.getCredentialsMetadata();
+    const filteredArgs = {
+        ...args,
+        channelConstraints: {
+            ...args.channelConstraints,
+            secretManagerPublicKey: [sampleSigningKey]
+        }
+    };
+    for (const collectArgs of [args, filteredArgs]) {
+        // (Re-)registering the manager drops its cached signing key.
+        liaison.registerManager(
+            {
+                id: "alichry@sample-manager",
+                name: "SampleManager",
+                type: 1
+            },
+            handlerProxy
+        );
+        calls.length = 0;
+        const entries = await Agent.collectCredentialsMetadata(
+            context.document.id,
+            context.document.uri,
+            collectArgs
+        );
+        const entry = entries.find(
+            e => e.manager.id === "alichry@sample-manager"
+        );
+        Assert.ok(entry);
+        Assert.equal(await entry.credentialsMetadata, 7);
+        Assert.equal(await entry.signingKey, sampleSigningKey);
+        Assert.deepEqual(calls, ["getSigningKey", "getCredentialsMetadata"]);
+        liaison.ereaseManager("alichry@sample-manager");
+    }
+});
+
+add_task(async function test_user_attributes_fetched_once_per_operation() {
+    do_get_profile();
+
+    const userAttributes = [
+        { id: "name", value: "Ali", mimeType: "text/plain" },
+        { id: "familyName", value: "Cherry", mimeType: "text/plain" }
+    ];
+    const calls = [];
+    liaison.registerManager(
+        {
+            id: "alichry@sample-manager",
+            name: "SampleManager",
+            type: 1
+        },
+        createRequestHandlerProxy((group, method, cx) => {
+            calls.push(method);
+            do_timeout(0, () => {
+                cx.response.resolve(
+                    method === "getUserAttributes" ? userAttributes : undefined
+                );
+            });
+        })
+    );
+    const target = Agent.target("alichry@sample-manager");
+    const { context } = sampleRequests.addField();
+    Assert.deepEqual(
+        await target.accountCreation.getUserAttributeValues(
+            context,
+            { ids: ["name"] }
+        ),
+        [userAttributes[0]]
+    );
+    Assert.deepEqual(
+        await target.accountCreation.getUserAttributeValues(
+            context,
+            { ids: ["familyName"] }
+        ),
+        [userAttributes[1]]
+    );
+    Assert.deepEqual(calls, ["getUserAttributes"]);
+
+    // Closing the operation drops its cached attributes.
+    const { id, type, status, state } = context.operation;
+    await target.login.closeOperation({
+        ...context,
+        operation: { id, type, status, state }
+    });
+    await target.accountCreation.getUserAttributeValues(
+        context,
+        { ids: ["name"] }
+    );
+    Assert.deepEqual(
+        calls,
+        ["getUserAttributes", "closeOperation", "getUserAttributes"]
+    );
+    liaison.ereaseManager("alichry@sample-manager");
+});
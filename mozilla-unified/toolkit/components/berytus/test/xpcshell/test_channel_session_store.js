@@ -0,0 +1,116 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+"use strict";
+
+/**
+ * @type {import('../../src/ChannelSessionStore.sys.mjs')}
+ */
+const { channelSessionStore } = ChromeUtils.importESModule(
+    "resource://gre/modules/BerytusChannelSessionStore.sys.mjs"
+);
+
+const LIFETIME_PREF = "dom.berytus.channel.resumption.lifetime_seconds";
+const MAX_SESSIONS_PREF = "dom.berytus.channel.resumption.max_sessions";
+
+const sampleSession = (overrides = {}) => ({
+    origin: "https://example.com",
+    managerId: "alichry@sample-manager",
+    channelId: "channel-1",
+    scmEd25519Key: "scm-key",
+    webAppEd25519Key: "webapp-key",
+    ...overrides
+});
+
+registerCleanupFunction(() => {
+    channelSessionStore.clear();
+    Services.prefs.clearUserPref(LIFETIME_PREF);
+    Services.prefs.clearUserPref(MAX_SESSIONS_PREF);
+});
+
+add_task(async function test_resume_rotates_token() {
+    channelSessionStore.clear();
+    const token = channelSessionStore.store(sampleSession());
+    const resumed = channelSessionStore.resume(
+        token,
+        "https://example.com",
+        "webapp-key",
+        []
+    );
+    Assert.ok(resumed);
+    Assert.equal(resumed.channelId, "channel-1");
+    Assert.equal(resumed.managerId, "alichry@sample-manager");
+    Assert.equal(resumed.scmEd25519Key, "scm-key");
+    Assert.notEqual(resumed.resumptionToken, token);
+    Assert.equal(
+        channelSessionStore.resume(token, "https://example.com", "webapp-key", []),
+        null,
+        "Tokens are single-use"
+    );
+    Assert.ok(channelSessionStore.resume(
+        resumed.resumptionToken,
+        "https://example.com",
+        "webapp-key",
+        ["scm-key"]
+    ));
+});
+
+add_task(async function test_resume_checks_session() {
+    channelSessionStore.clear();
+    const token = channelSessionStore.store(sampleSession());
+    Assert.equal(
+        channelSessionStore.resume(token, "https://example.org", "webapp-key", []),
+        null
+    );
+    Assert.equal(
+        channelSessionStore.resume(token, "https://example.com", "other-key", []),
+        null
+    );
+    Assert.equal(channelSessionStore.size, 1);
+    Assert.equal(
+        channelSessionStore.resume(token, "https://example.com", "webapp-key", ["other-scm-key"]),
+        null
+    );
+    Assert.equal(channelSessionStore.size, 0);
+});
+
+add_task(async function test_store_is_bounded() {
+    channelSessionStore.clear();
+    Services.prefs.setIntPref(MAX_SESSIONS_PREF, 2);
+    const t1 = channelSessionStore.store(sampleSession({ scmEd25519Key: "k1" }));
+    channelSessionStore.store(sampleSession({ scmEd25519Key: "k2" }));
+    channelSessionStore.store(sampleSession({ scmEd25519Key: "k3" }));
+    Assert.equal(channelSessionStore.size, 2);
+    Assert.equal(
+        channelSessionStore.resume(t1, "https://example.com", "webapp-key", []),
+        null
+    );
+    // One session per (origin, scm key, web app key)
+    channelSessionStore.store(sampleSession({ scmEd25519Key: "k3", channelId: "channel-2" }));
+    Assert.equal(channelSessionStore.size, 2);
+    Services.prefs.clearUserPref(MAX_SESSIONS_PREF);
+});
+
+add_task(async function test_session_expiry_and_revocation() {
+    channelSessionStore.clear();
+    Services.prefs.setIntPref(LIFETIME_PREF, 0);
+    const expired = channelSessionStore.store(sampleSession());
+    Assert.equal(
+        channelSessionStore.resume(expired, "https://example.com", "webapp-key", []),
+        null
+    );
+    Services.prefs.clearUserPref(LIFETIME_PREF);
+
+    const token = channelSessionStore.store(sampleSession());
+    Assert.ok(!channelSessionStore.revoke(token, "https://example.org"));
+    Assert.ok(channelSessionStore.revoke(token, "https://example.com"));
+    Assert.equal(
+        channelSessionStore.resume(token, "https://example.com", "webapp-key", []),
+        null
+    );
+
+    channelSessionStore.store(sampleSession());
+    channelSessionStore.revokeManager("alichry@sample-manager");
+    Assert.equal(channelSessionStore.size, 0);
+});
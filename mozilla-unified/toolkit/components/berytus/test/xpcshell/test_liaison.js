@@ -197,4 +197,50 @@ add_task(async function test_isolation() {
         h1.manager.getCredentialsMetadata,
         h2.manager.getCredentialsMetadata,
     );
-});
\ No newline at end of file
+});
+add_task(async function test_signing_key_cache() {
+    let fetches = 0;
+    const fetchKey = async () => {
+        fetches++;
+        return "key" + fetches;
+    };
+    const handlerProxy = createRequestHandlerProxy();
+    liaison.registerManager(
+        {
+            id: "alichry@sample-manager",
+            name: "SampleManager",
+            type: 1
+        },
+        handlerProxy
+    );
+    Assert.equal(await liaison.getSigningKey("alichry@sample-manager", fetchKey), "key1");
+    Assert.equal(await liaison.getSigningKey("alichry@sample-manager", fetchKey), "key1");
+    Assert.equal(fetches, 1);
+
+    liaison.invalidateSigningKey("alichry@sample-manager");
+    Assert.equal(await liaison.getSigningKey("alichry@sample-manager", fetchKey), "key2");
+    Assert.equal(fetches, 2);
+
+    liaison.ereaseManager("alichry@sample-manager");
+    liaison.registerManager(
+        {
+            id: "alichry@sample-manager",
+            name: "SampleManager",
+            type: 1
+        },
+        handlerProxy
+    );
+    Assert.equal(await liaison.getSigningKey("alichry@sample-manager", fetchKey), "key3");
+    Assert.equal(fetches, 3);
+
+    // failed fetches are not cached
+    await Assert.rejects(
+        liaison.getSigningKey("alichry@2nd-sample-manager", async () => {
+            throw new Error("Unavailable");
+        }),
+        /Unavailable/
+    );
+    Assert.equal(await liaison.getSigningKey("alichry@2nd-sample-manager", fetchKey), "key4");
+
+    liaison.ereaseManager("alichry@sample-manager");
+});
@@ -48,15 +48,21 @@ add_task(async function test_calls_requesthandler() {
     liaison.ereaseManager("alichry@sample-manager");
 });
 
-add_task(async function test_noconcurrent_requests() {
+add_task(async function test_queues_concurrent_requests() {
     // Need a profile to be setup; otherwise ValidatedRequestHandler
     // would not be able to retrieve the Schema.
     do_get_profile();
 
+    const received = [];
+    let inFlight = 0;
     const handlerProxy = createRequestHandlerProxy(
         (group, method, cx, args) => {
+            inFlight++;
+            Assert.equal(inFlight, 1, "One request at a time reaches the manager");
+            received.push(cx.request.id);
             do_timeout(0, () => {
-                cx.response.resolve(7);
+                inFlight--;
+                cx.response.resolve(received.length);
             });
         }
     );
@@ -68,29 +74,75 @@ add_task(async function test_noconcurrent_requests() {
         },
         handlerProxy
     );
+    // Each channel obtains its own public handler, while the
+    // sequential handler of the manager is shared.
+    const { context, args } = sampleRequests.getCredentialsMetadata();
+    const results = await Promise.all(["request-1", "request-2", "request-3"].map(
+        id => liaison.getRequestHandler("alichry@sample-manager")
+            .manager.getCredentialsMetadata(
+                { ...context, request: { id } },
+                args
+            )
+    ));
+    Assert.deepEqual(received, ["request-1", "request-2", "request-3"]);
+    Assert.deepEqual(results, [1, 2, 3]);
+
+    liaison.ereaseManager("alichry@sample-manager");
+});
+
+add_task(async function test_cancel_queued_request() {
+    // Need a profile to be setup; otherwise ValidatedRequestHandler
+    // would not be able to retrieve the Schema.
+    do_get_profile();
+
+    let called = new PromiseReference();
+    const received = [];
+    const cancelled = [];
+    liaison.registerManager(
+        {
+            id: "alichry@sample-manager",
+            name: "SampleManager",
+            type: 1
+        },
+        {
+            manager: {
+                getCredentialsMetadata(cx) {
+                    received.push(cx);
+                    called.resolve(cx);
+                }
+            },
+            cancelRequest(requestId) {
+                cancelled.push(requestId);
+            }
+        }
+    );
     const publicHandler = liaison.getRequestHandler(
         "alichry@sample-manager"
     );
-    const credPromise = publicHandler.manager.getCredentialsMetadata(
-        sampleRequests.getCredentialsMetadata().context,
-        sampleRequests.getCredentialsMetadata().args
-    );
-    await Assert.rejects(
-        publicHandler.manager.getCredentialsMetadata(
-            sampleRequests.getCredentialsMetadata().context,
-            sampleRequests.getCredentialsMetadata().args
-        ), /an existing request is still pending/i
+    const { context, args } = sampleRequests.getCredentialsMetadata();
+    const [first, second, third] = ["request-1", "request-2", "request-3"].map(
+        (id, i) => publicHandler.manager.getCredentialsMetadata(
+            {
+                ...context,
+                request: i === 2 ? { id, deadline: Date.now() + 50 } : { id }
+            },
+            args
+        )
     );
-    Assert.equal(await credPromise, 7);
+    const firstCx = await called.finished;
+    Assert.ok(liaison.cancelRequest("alichry@sample-manager", "request-2"));
+    await Assert.rejects(second, /was cancelled/i);
+    await Assert.rejects(third, /timed out/i);
+    // Neither reached the secret manager.
+    Assert.deepEqual(cancelled, []);
+    Assert.deepEqual(received.map(cx => cx.request.id), ["request-1"]);
 
-    // send another request to test if the 3rd request is fulfilledd
-    Assert.equal(
-        await publicHandler.manager.getCredentialsMetadata(
-            sampleRequests.getCredentialsMetadata().context,
-            sampleRequests.getCredentialsMetadata().args
-        ),
-        7
-    );
+    called = new PromiseReference();
+    firstCx.response.resolve(7);
+    Assert.equal(await first, 7);
+    const next = publicHandler.manager.getCredentialsMetadata(context, args);
+    (await called.finished).response.resolve(8);
+    Assert.equal(await next, 8);
 
     liaison.ereaseManager("alichry@sample-manager");
 });
@@ -239,4 +291,145 @@ add_task(async function test_handle_invalid_output_addFields() {
 
 // TODO(berytus): Add test that the request handler
 // can solve addFields with null when the web app dictates
-// a field value.
\ No newline at end of file
+// a field value.
+add_task(async function test_release_field_ids_on_close_operation() {
+    // Need a profile to be setup; otherwise ValidatedRequestHandler
+    // would not be able to retrieve the Schema.
+    do_get_profile();
+
+    const handlerProxy = createRequestHandlerProxy(
+        (group, method, cx, args) => {
+            if (method === "addField") {
+                cx.response.resolve({ ...args.field, value: "john" });
+                return;
+            }
+            Assert.equal(method, "closeOperation");
+            cx.response.resolve();
+        }
+    );
+    liaison.registerManager(
+        {
+            id: "alichry@sample-manager",
+            name: "SampleManager",
+            type: 1,
+        },
+        handlerProxy
+    );
+    const publicHandler = liaison.getRequestHandler(
+        "alichry@sample-manager"
+    );
+    const { context, args } = sampleRequests.addField();
+    await publicHandler.accountCreation.addField(context, args);
+    await Assert.rejects(
+        publicHandler.accountCreation.addField(context, args),
+        /already exists/i
+    );
+    await publicHandler.login.closeOperation(context);
+    // The operation id is no longer tracked once the operation is closed.
+    await publicHandler.accountCreation.addField(context, args);
+    liaison.ereaseManager("alichry@sample-manager");
+});
+
+add_task(async function test_cancel_request() {
+    // Need a profile to be setup; otherwise ValidatedRequestHandler
+    // would not be able to retrieve the Schema.
+    do_get_profile();
+
+    let called = new PromiseReference();
+    const cancelled = [];
+    liaison.registerManager(
+        {
+            id: "alichry@sample-manager",
+            name: "SampleManager",
+            type: 1
+        },
+        {
+            manager: {
+                getCredentialsMetadata(cx) {
+                    called.resolve(cx);
+                }
+            },
+            cancelRequest(requestId) {
+                cancelled.push(requestId);
+            }
+        }
+    );
+    const publicHandler = liaison.getRequestHandler(
+        "alichry@sample-manager"
+    );
+    const { context, args } = sampleRequests.getCredentialsMetadata();
+    const credPromise = publicHandler.manager.getCredentialsMetadata(
+        { ...context, request: { id: "request-1" } },
+        args
+    );
+    const cancelledCx = await called.finished;
+    Assert.equal(cancelledCx.request.id, "request-1");
+    Assert.ok(!liaison.cancelRequest("alichry@sample-manager", "request-2"));
+    Assert.ok(liaison.cancelRequest("alichry@sample-manager", "request-1"));
+    await Assert.rejects(credPromise, /was cancelled/i);
+    Assert.deepEqual(cancelled, ["request-1"]);
+
+    // A late settlement is refused and the handler accepts
+    // new requests.
+    await Assert.rejects(cancelledCx.response.resolve(7), /ResolutionFailure/);
+    called = new PromiseReference();
+    const nextPromise = publicHandler.manager.getCredentialsMetadata(
+        context,
+        args
+    );
+    (await called.finished).response.resolve(7);
+    Assert.equal(await nextPromise, 7);
+
+    liaison.ereaseManager("alichry@sample-manager");
+});
+
+add_task(async function test_request_deadline() {
+    // Need a profile to be setup; otherwise ValidatedRequestHandler
+    // would not be able to retrieve the Schema.
+    do_get_profile();
+
+    let called = new PromiseReference();
+    const cancelled = [];
+    liaison.registerManager(
+        {
+            id: "alichry@sample-manager",
+            name: "SampleManager",
+            type: 1
+        },
+        {
+            manager: {
+                getCredentialsMetadata(cx) {
+                    called.resolve(cx);
+                }
+            },
+            cancelRequest(requestId) {
+                cancelled.push(requestId);
+            }
+        }
+    );
+    const publicHandler = liaison.getRequestHandler(
+        "alichry@sample-manager"
+    );
+    const { context, args } = sampleRequests.getCredentialsMetadata();
+    const credPromise = publicHandler.manager.getCredentialsMetadata(
+        { ...context, request: { id: "request-1", deadline: Date.now() + 50 } },
+        args
+    );
+    const timedOutCx = await called.finished;
+    Assert.equal(typeof timedOutCx.request.deadline, "number");
+    await Assert.rejects(credPromise, /timed out/i);
+    Assert.deepEqual(cancelled, ["request-1"]);
+    await Assert.rejects(timedOutCx.response.resolve(7), /ResolutionFailure/);
+
+    // A request settled before its deadline is unaffected.
+    called = new PromiseReference();
+    const nextPromise = publicHandler.manager.getCredentialsMetadata(
+        { ...context, request: { id: "request-2", deadline: Date.now() + 60000 } },
+        args
+    );
+    (await called.finished).response.resolve(7);
+    Assert.equal(await nextPromise, 7);
+    Assert.deepEqual(cancelled, ["request-1"]);
+
+    liaison.ereaseManager("alichry@sample-manager");
+});
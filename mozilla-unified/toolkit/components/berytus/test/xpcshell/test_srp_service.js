@@ -0,0 +1,248 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+"use strict";
+
+Cu.importGlobalProperties(["crypto"]);
+
+const srp = Cc["@mozilla.org/berytus/srp-service;1"].getService(
+    Ci.mozIBerytusSrpService
+);
+
+// RFC 5054, Appendix A.
+const N_2048 = BigInt("0x" +
+    "AC6BDB41324A9A9BF166DE5E1389582FAF72B6651987EE07FC3192943DB56050" +
+    "A37329CBB4A099ED8193E0757767A13DD52312AB4B03310DCD7F48A9DA04FD50" +
+    "E8083969EDB767B0CF6095179A163AB3661A05FBD5FAAAE82918A9962F0B93B8" +
+    "55F97993EC975EEAA80D740ADBF4FF747359D041D5C33EA71D281E446B14773B" +
+    "CA97B43A23FB801676BD207A436C6481F1D2B9078717461A5B9D32E688F87748" +
+    "544523B524B0D57D5EA77A2775D2ECFA032CFBDBF52FB3786160279004E57AE6" +
+    "AF874E7303CE53299CCC041C7BC308D82A5698F3A8D0C38271AE35F8E9DBFBB6" +
+    "94B5C803D89F7AE435DE236D525F54759B65E372FCD68EF20FA7111F9E4AFF73");
+const G_2048 = 2n;
+const BYTES_2048 = 256;
+
+const randomBytes = (length) => {
+    const bytes = new Uint8Array(length);
+    crypto.getRandomValues(bytes);
+    return Array.from(bytes);
+};
+
+const sha256 = (...parts) => {
+    const hasher = Cc["@mozilla.org/security/hash;1"].createInstance(
+        Ci.nsICryptoHash
+    );
+    hasher.init(Ci.nsICryptoHash.SHA256);
+    for (const part of parts) {
+        hasher.update(part, part.length);
+    }
+    return Array.from(hasher.finish(false), c => c.charCodeAt(0));
+};
+
+const toBigInt = (bytes) => {
+    let value = 0n;
+    for (const byte of bytes) {
+        value = (value << 8n) | BigInt(byte);
+    }
+    return value;
+};
+
+const toBytes = (value, length) => {
+    const bytes = new Array(length).fill(0);
+    for (let i = length - 1; i >= 0 && value > 0n; i--) {
+        bytes[i] = Number(value & 0xffn);
+        value >>= 8n;
+    }
+    return bytes;
+};
+
+const modPow = (base, exponent, modulus) => {
+    let result = 1n;
+    base %= modulus;
+    while (exponent > 0n) {
+        if (exponent & 1n) {
+            result = (result * base) % modulus;
+        }
+        base = (base * base) % modulus;
+        exponent >>= 1n;
+    }
+    return result;
+};
+
+const fromHex = (hex) => hex.match(/[\da-f]{2}/gi).map(h => parseInt(h, 16));
+
+const utf8 = (str) => Array.from(new TextEncoder().encode(str));
+
+/**
+ * The server side of the exchange, computed with BigInts.
+ */
+const createReferenceServer = (identity, password, salt) => {
+    const k = toBigInt(sha256(
+        toBytes(N_2048, BYTES_2048),
+        toBytes(G_2048, BYTES_2048)
+    ));
+    const x = toBigInt(sha256(
+        salt,
+        sha256(utf8(identity), utf8(":"), utf8(password))
+    ));
+    const v = modPow(G_2048, x, N_2048);
+    const b = toBigInt(randomBytes(32));
+    const B = (k * v + modPow(G_2048, b, N_2048)) % N_2048;
+    return {
+        verifier: toBytes(v, BYTES_2048),
+        publicKey: toBytes(B, BYTES_2048),
+        finish(clientPublicKey) {
+            const A = toBigInt(clientPublicKey);
+            const u = toBigInt(sha256(
+                toBytes(A, BYTES_2048),
+                toBytes(B, BYTES_2048)
+            ));
+            const S = modPow(A * modPow(v, u, N_2048), b, N_2048);
+            const K = sha256(toBytes(S, BYTES_2048));
+            const M1 = sha256(
+                toBytes(A, BYTES_2048),
+                toBytes(B, BYTES_2048),
+                K
+            );
+            return { K, M1, M2: sha256(toBytes(A, BYTES_2048), M1, K) };
+        }
+    };
+};
+
+add_task(async function test_srp_client_matches_reference_server() {
+    const salt = randomBytes(16);
+    const server = createReferenceServer("user123", "pass123", salt);
+    Assert.deepEqual(
+        srp.computeVerifier(2048, "user123", "pass123", salt),
+        server.verifier
+    );
+
+    const client = srp.createClient(2048, "user123", "pass123");
+    Assert.equal(client.groupBits, 2048);
+    Assert.equal(client.publicKey.length, BYTES_2048);
+    Assert.throws(
+        () => client.computeClientProof(salt),
+        /NS_ERROR_NOT_AVAILABLE/
+    );
+    client.setServerPublicKey(server.publicKey);
+    const M1 = client.computeClientProof(salt);
+
+    const expected = server.finish(client.publicKey);
+    Assert.deepEqual(M1, expected.M1);
+    Assert.deepEqual(client.sharedKey, expected.K);
+    Assert.ok(client.verifyServerProof(expected.M2));
+    Assert.ok(!client.verifyServerProof(expected.M1));
+});
+
+add_task(async function test_srp_client_rejects_wrong_password() {
+    const salt = randomBytes(16);
+    const server = createReferenceServer("user123", "pass123", salt);
+    const client = srp.createClient(2048, "user123", "pass1234");
+    client.setServerPublicKey(server.publicKey);
+    const M1 = client.computeClientProof(salt);
+    Assert.notDeepEqual(M1, server.finish(client.publicKey).M1);
+});
+
+add_task(async function test_srp_service_rejects_unknown_group() {
+    Assert.throws(
+        () => srp.createClient(2047, "user123", "pass123"),
+        /NS_ERROR_INVALID_ARG/
+    );
+});
+
+// RFC 5054, Appendix B.
+add_task(async function test_srp_client_rfc5054_vectors() {
+    const a = fromHex(
+        "60975527035CF2AD1989806F0407210BC81EDC04E2762A56AFD529DDDA2D4393");
+    const salt = fromHex("BEB25379D1A8581EB5A727673A2441EE");
+    const client = srp.createClientWithPrivateKey(
+        1024, "alice", "password123", a
+    );
+    Assert.equal(client.groupBits, 1024);
+    Assert.deepEqual(client.publicKey, fromHex(
+        "61D5E490F6F1B79547B0704C436F523DD0E560F0C64115BB72557EC44352E890" +
+        "3211C04692272D8B2D1A5358A2CF1B6E0BFCF99F921530EC8E39356179EAE45E" +
+        "42BA92AEACED825171E1E8B9AF6D9C03E1327F44BE087EF06530E69F66615261" +
+        "EEF54073CA11CF5858F0EDFDFE15EFEAB349EF5D76988A3672FAC47B0769447B"));
+    Assert.deepEqual(
+        srp.computeVerifier(1024, "alice", "password123", salt),
+        fromHex(
+        "7E273DE8696FFC4F4E337D05B4B375BEB0DDE1569E8FA00A9886D8129BADA1F1" +
+        "822223CA1A605B530E379BA4729FDC59F105B4787E5186F5C671085A1447B52A" +
+        "48CF1970B4FB6F8400BBF4CEBFBB168152E08AB5EA53D15C1AFF87B2B9DA6E04" +
+        "E058AD51CC72BFC9033B564E26480D78E955A5E29E7AB245DB2BE315E2099AFB")
+    );
+
+    client.setServerPublicKey(fromHex(
+        "BD0C61512C692C0CB6D041FA01BB152D4916A1E77AF46AE105393011BAF38964" +
+        "DC46A0670DD125B95A981652236F99D9B681CBF87837EC996C6DA04453728610" +
+        "D0C6DDB58B318885D7D82C7F8DEB75CE7BD4FBAA37089E6F9C6059F388838E7A" +
+        "00030B331EB76840910440B1B27AAEAEEB4012B7D7665238A8E3FB004B117B58"));
+    // H(A | B | K), H(S) and H(A | M1 | K), from the premaster secret S
+    // of the RFC.
+    const M1 = fromHex("7C1605558A4E7A5AE79A7F254CB6D04F72608044");
+    Assert.deepEqual(client.computeClientProof(salt), M1);
+    Assert.deepEqual(
+        client.sharedKey,
+        fromHex("017EEFA1CEFC5C2E626E21598987F31E0F1B11BB")
+    );
+    Assert.ok(client.verifyServerProof(
+        fromHex("BDAD4993FFA5D60FD0DA4929C5EDB8D9E887E69C")
+    ));
+    Assert.ok(!client.verifyServerProof(M1));
+});
+
+add_task(async function bench_srp_client_against_bigint() {
+    const iterations = 5;
+    const salt = randomBytes(16);
+    const server = createReferenceServer("user123", "pass123", salt);
+    const privateKeys = Array.from({ length: iterations }, () => randomBytes(32));
+
+    const native = [];
+    let start = Cu.now();
+    for (const a of privateKeys) {
+        const client = srp.createClientWithPrivateKey(
+            2048, "user123", "pass123", a
+        );
+        client.setServerPublicKey(server.publicKey);
+        const M1 = client.computeClientProof(salt);
+        native.push({ M1, K: client.sharedKey });
+    }
+    const nativeMs = (Cu.now() - start) / iterations;
+
+    const bigInt = [];
+    start = Cu.now();
+    for (const aBytes of privateKeys) {
+        const x = toBigInt(sha256(
+            salt,
+            sha256(utf8("user123"), utf8(":"), utf8("pass123"))
+        ));
+        const a = toBigInt(aBytes);
+        const A = modPow(G_2048, a, N_2048);
+        const B = toBigInt(server.publicKey);
+        const u = toBigInt(sha256(
+            toBytes(A, BYTES_2048),
+            toBytes(B, BYTES_2048)
+        ));
+        const k = toBigInt(sha256(
+            toBytes(N_2048, BYTES_2048),
+            toBytes(G_2048, BYTES_2048)
+        ));
+        const base = ((B - k * modPow(G_2048, x, N_2048)) % N_2048 + N_2048)
+            % N_2048;
+        const S = modPow(base, a + u * x, N_2048);
+        const K = sha256(toBytes(S, BYTES_2048));
+        const M1 = sha256(
+            toBytes(A, BYTES_2048),
+            toBytes(B, BYTES_2048),
+            K
+        );
+        bigInt.push({ M1, K });
+    }
+    const bigIntMs = (Cu.now() - start) / iterations;
+
+    Assert.deepEqual(native, bigInt);
+    info(`SRP-6a client, 2048-bit group: native ${nativeMs.toFixed(1)}ms, ` +
+        `BigInt ${bigIntMs.toFixed(1)}ms per exchange`);
+});
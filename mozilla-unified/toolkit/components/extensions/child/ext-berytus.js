@@ -31,6 +31,11 @@ this.berytus = class BerytusExtensionAPI extends ExtensionAPI {
         this.extensionRegistered = false;
         this.listeners = null;
         this.requestContexts = {};
+        /**
+         * request id -> the AbortController of the signal passed
+         * to the handler in the request context.
+         */
+        this.abortControllers = {};
         console.debug(
             `ext-berytus(child)::constructor(${extension.id})`
         );
@@ -126,8 +131,14 @@ this.berytus = class BerytusExtensionAPI extends ExtensionAPI {
                 if (requestMethod !== method) {
                     throw new ExtensionError('Request Method did not match with that of the Listener\'s Method');
                 }
+                const abortController = new context.cloneScope.AbortController();
+                this.abortControllers[request.id] = abortController;
+                const settled = () => {
+                    delete this.abortControllers[request.id];
+                };
                 const promise = ExtensionCommon.withHandlingUserInput(context.contentWindow, () => {
                     const reject = (e) => {
+                        settled();
                         context.childManager.callParentFunctionNoReturn("berytus.rejectRequest", [request.id, e || "GeneralError"]);
                     }
 
@@ -135,15 +146,18 @@ this.berytus = class BerytusExtensionAPI extends ExtensionAPI {
                     try {
                         result = handler[group][method](Cu.cloneInto({
                             ...ctx,
+                            signal: abortController.signal,
                             response: {
                                 async resolve(val) {
+                                    settled();
                                     await context.childManager.callParentAsyncFunction("berytus.resolveRequest", [request.id, val]);
                                 },
                                 async reject(reason) {
+                                    settled();
                                     await context.childManager.callParentAsyncFunction("berytus.rejectRequest", [request.id, reason]);
                                 }
                             }
-                        }, context.cloneScope, { cloneFunctions: true }), ...args);
+                        }, context.cloneScope, { cloneFunctions: true, wrapReflectors: true }), ...args);
                     } catch (e) {
                         reject(e);
                         return;
@@ -161,6 +175,16 @@ this.berytus = class BerytusExtensionAPI extends ExtensionAPI {
             }
             listeners[key] = listener;
         });
+        // Aborts the signal of a request the handler is processing
+        // once nobody awaits it anymore.
+        listeners["request:cancelled"] = (requestId) => {
+            const abortController = this.abortControllers[requestId];
+            if (!abortController) {
+                return;
+            }
+            delete this.abortControllers[requestId];
+            abortController.abort();
+        };
         return listeners;
     }
 
@@ -15,6 +15,12 @@ ChromeUtils.defineESModuleGetters(lazy, {
   Schemas: "resource://gre/modules/Schemas.sys.mjs"
 });
 
+ChromeUtils.defineLazyGetter(lazy, "passwordGenerator", () =>
+  Cc["@mozilla.org/berytus/password-generator;1"].getService(
+    Ci.mozIBerytusPasswordGenerator
+  )
+);
+
 /**
  * @type {import('../../berytus/src/Liaison.sys.mjs')}
  */
@@ -24,6 +30,12 @@ const { liaison } = ChromeUtils.importESModule(
 
 const isInTest = Services.env.get("MOZ_TEST_BERYTUS_WEBEXT");
 
+/**
+ * Fired with the request id when a request is no longer awaited,
+ * e.g. the requesting document navigated away.
+ */
+const REQUEST_CANCELLED_EVENT = "request:cancelled";
+
 function findTabByInnerWindowId(innerWindowId) {
   // TODO(berytus): From ext-authRealm: use windowTracker.browserWindows() iterator
   const chromeWindows = Services.wm.getEnumerator("navigator:browser");
@@ -51,6 +63,7 @@ function findTabByInnerWindowId(innerWindowId) {
 /**
  * @typedef {import("../../berytus/src/types.ts").RequestHandler} RequestHandler
  * @typedef {import("../../berytus/src/types.ts").IUnderlyingRequestHandler} IUnderlyingRequestHandler
+ * @typedef {import("../../berytus/src/types.ts").ICancellableRequestHandler} ICancellableRequestHandler
  * @typedef {import("../../berytus/src/types.ts").ResponseContext<keyof RequestHandler, keyof RequestHandler[keyof RequestHandler]>} ResponseContext
  * @typedef {import("../../berytus/src/types.ts").PreliminaryRequestContext & ResponseContext} Context
  */
@@ -72,7 +85,7 @@ this.berytus = class BerytusExtensionAPI extends ExtensionAPIPersistent {
   listeners;
 
   /**
-   * @type {IUnderlyingRequestHandler}
+   * @type {IUnderlyingRequestHandler & ICancellableRequestHandler}
    */
   #liaisonHandler;
 
@@ -123,18 +136,25 @@ this.berytus = class BerytusExtensionAPI extends ExtensionAPIPersistent {
     types.forEach(type => {
       this.listeners[type.key] = new Map();
     });
+    this.listeners[REQUEST_CANCELLED_EVENT] = new Map();
+  }
+
+  #getEventNames() {
+    return [
+      ...this.#getRequestTypes().map(type => type.key),
+      REQUEST_CANCELLED_EVENT
+    ];
   }
 
   #initPersistentEvents() {
-    const types = this.#getRequestTypes();
     this.PERSISTENT_EVENTS = {};
-    types.forEach(requestType => {
+    this.#getEventNames().forEach(eventName => {
       /**
        * @param {PersistentEventHandlerArg} param0
        * @returns {PersistentEventHandlerResult}
        */
       const handler = ({ fire, context }) => {
-        const requestTypeListeners = this.listeners[requestType.key];
+        const requestTypeListeners = this.listeners[eventName];
         requestTypeListeners.set(fire, { fire, context });
         return {
           unregister: () => {
@@ -149,7 +169,7 @@ this.berytus = class BerytusExtensionAPI extends ExtensionAPIPersistent {
           }
         }
       };
-      this.PERSISTENT_EVENTS[requestType.key] = handler;
+      this.PERSISTENT_EVENTS[eventName] = handler;
     });
   }
 
@@ -166,6 +186,15 @@ this.berytus = class BerytusExtensionAPI extends ExtensionAPIPersistent {
       }
       groupHandler[requestType.method] = methodHandler;
     });
+    this.#liaisonHandler.cancelRequest = (requestId) => {
+      if (!this.#requests[requestId]) {
+        return;
+      }
+      delete this.#requests[requestId];
+      this.listeners[REQUEST_CANCELLED_EVENT].forEach(({ fire }) => {
+        fire.async(requestId);
+      });
+    };
   }
 
   /**
@@ -271,8 +300,7 @@ this.berytus = class BerytusExtensionAPI extends ExtensionAPIPersistent {
      * @type {Record<string, any>}
      */
     const events = {};
-    this.#getRequestTypes().forEach(type => {
-      const eventName = type.key;
+    this.#getEventNames().forEach(eventName => {
       const manager = new EventManager({
         context,
         module: "berytus",
@@ -290,7 +318,7 @@ this.berytus = class BerytusExtensionAPI extends ExtensionAPIPersistent {
         resolveRequest: (requestId, value) => {
           const cx = this.#requests[requestId];
           if (!cx) {
-            throw new Error('Invalid request id; cannot resolve request.');
+            throw new Error('Invalid request id; cannot resolve request. The request might have been cancelled.');
           }
           cx.response.resolve(value);
           // TODO(berytus): the above should be async, and we should
@@ -299,7 +327,7 @@ this.berytus = class BerytusExtensionAPI extends ExtensionAPIPersistent {
         rejectRequest: (requestId, reason) => {
           const cx = this.#requests[requestId];
           if (!cx) {
-            throw new Error('Invalid request id; cannot reject request.');
+            throw new Error('Invalid request id; cannot reject request. The request might have been cancelled.');
           }
           cx.response.reject(reason);
         },
@@ -338,6 +366,23 @@ this.berytus = class BerytusExtensionAPI extends ExtensionAPIPersistent {
           }
           liaison.ereaseManager(this.extension.id);
         },
+        signingKeyRotated: () => {
+          liaison.invalidateSigningKey(this.extension.id);
+        },
+        generatePassword: (passwordRules) => {
+          try {
+            return lazy.passwordGenerator.generatePassword(passwordRules);
+          } catch (e) {
+            throw new ExtensionError("No password satisfies the passed passwordRules");
+          }
+        },
+        generatePasswords: (passwordRules, count) => {
+          try {
+            return lazy.passwordGenerator.generatePasswords(passwordRules, count);
+          } catch (e) {
+            throw new ExtensionError("No password satisfies the passed passwordRules, or the count is not between 1 and 64");
+          }
+        },
         isListenerRegistered: (eventName) => {
           const eventManager = eventManagers[eventName];
           if (!eventManager) {
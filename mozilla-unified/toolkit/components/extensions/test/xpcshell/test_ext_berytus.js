@@ -218,5 +218,38 @@ add_task(async function test_berytus_handler_getSigningKey() {
     "MCowBQYDK2VwAyEAJevlUdx72BF8mxdwurBJI9WNgRDMaoYfb0VqywaLOJE="
   );
 
+  await extension.unload();
+});
+
+add_task(async function test_berytus_generatePassword() {
+  const extension = ExtensionTestUtils.loadExtension({
+    background: async () => {
+      const password = await browser.berytus.generatePassword(
+        "minlength: 8; maxlength: 16; required: digit;"
+      );
+      browser.test.assertEq(16, password.length, "Password should be of maxlength");
+      browser.test.assertTrue(/[0-9]/.test(password), "Password should contain a digit");
+      const passwords = await browser.berytus.generatePasswords(
+        "required: upper; allowed: lower;", 3
+      );
+      browser.test.assertEq(3, passwords.length, "A password should be generated per field");
+      for (const p of passwords) {
+        browser.test.assertTrue(/^[a-zA-Z]*[A-Z][a-zA-Z]*$/.test(p), "Password should satisfy the rules");
+      }
+      await browser.test.assertRejects(
+        browser.berytus.generatePassword("minlength: 10; maxlength: 8;"),
+        /No password satisfies the passed passwordRules/,
+        "Unsatisfiable rules should be rejected"
+      );
+      browser.test.sendMessage("done");
+    },
+    manifest: {
+      manifest_version: 2,
+      permissions: ["berytus"]
+    },
+  });
+
+  await extension.startup();
+  await extension.awaitMessage("done");
   await extension.unload();
 });
\ No newline at end of file